@@ -0,0 +1,51 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# Note that FFmpeg does not have a single version number; we use the version of
+# libavformat (e.g. 58.x for FFmpeg 4.x) as `FFmpeg_VERSION`.
+
+include(FindPackageHandleStandardArgs)
+
+find_package(PkgConfig QUIET)
+
+set(ffmpeg_required_vars)
+
+foreach(lib IN ITEMS avformat avcodec avutil swscale)
+    if(PKG_CONFIG_FOUND)
+        pkg_check_modules(FFmpeg_${lib} QUIET lib${lib})
+    endif()
+
+    find_library(FFmpeg_${lib}_LIBRARY ${lib} HINTS ${FFmpeg_${lib}_LIBRARY_DIRS})
+
+    find_path(FFmpeg_${lib}_INCLUDE_DIR lib${lib}/${lib}.h HINTS ${FFmpeg_${lib}_INCLUDE_DIRS})
+
+    mark_as_advanced(FFmpeg_${lib}_LIBRARY FFmpeg_${lib}_INCLUDE_DIR)
+
+    list(APPEND ffmpeg_required_vars FFmpeg_${lib}_LIBRARY FFmpeg_${lib}_INCLUDE_DIR)
+endforeach()
+
+set(FFmpeg_VERSION ${FFmpeg_avformat_VERSION})
+
+find_package_handle_standard_args(FFmpeg
+    REQUIRED_VARS
+        ${ffmpeg_required_vars}
+    VERSION_VAR
+        FFmpeg_VERSION
+)
+
+if(NOT FFmpeg_FOUND)
+    return()
+endif()
+
+foreach(lib IN ITEMS avformat avcodec avutil swscale)
+    if(NOT TARGET FFmpeg::${lib})
+        add_library(FFmpeg::${lib} SHARED IMPORTED)
+
+        set_property(TARGET FFmpeg::${lib} PROPERTY IMPORTED_LOCATION ${FFmpeg_${lib}_LIBRARY})
+
+        target_include_directories(FFmpeg::${lib} INTERFACE ${FFmpeg_${lib}_INCLUDE_DIR})
+    endif()
+endforeach()
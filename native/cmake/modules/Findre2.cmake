@@ -0,0 +1,88 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+include(FindPackageHandleStandardArgs)
+
+find_package(re2 QUIET CONFIG)
+if(re2_FOUND)
+    find_package_handle_standard_args(re2 CONFIG_MODE)
+
+    return()
+endif()
+
+find_package(PkgConfig QUIET)
+if(PKG_CONFIG_FOUND)
+    pkg_check_modules(re2 QUIET re2)
+endif()
+
+find_library(re2_LIBRARY re2 HINTS ${re2_LIBRARY_DIRS})
+
+find_path(re2_INCLUDE_DIR re2/re2.h HINTS ${re2_INCLUDE_DIRS})
+
+mark_as_advanced(re2_LIBRARY re2_INCLUDE_DIR)
+
+find_package_handle_standard_args(re2
+    REQUIRED_VARS
+        re2_LIBRARY re2_INCLUDE_DIR
+)
+
+if(NOT re2_FOUND)
+    return()
+endif()
+
+if(NOT TARGET re2::re2)
+    add_library(re2::re2 SHARED IMPORTED)
+
+    set_property(TARGET re2::re2 PROPERTY IMPORTED_LOCATION ${re2_LIBRARY})
+
+    # Recent versions of RE2 depend on Abseil, whose headers and flags are
+    # reported by pkg-config.
+    target_include_directories(re2::re2 INTERFACE ${re2_INCLUDE_DIR} ${re2_INCLUDE_DIRS})
+
+    target_compile_options(re2::re2 INTERFACE ${re2_CFLAGS_OTHER})
+
+    # The Abseil libraries are listed in the `Requires` field of re2.pc. Use
+    # the imported Abseil targets if available; otherwise fall back to the
+    # library paths resolved by pkg-config.
+    if(PKG_CONFIG_FOUND)
+        execute_process(
+            COMMAND
+                ${PKG_CONFIG_EXECUTABLE} --print-requires re2
+            OUTPUT_VARIABLE
+                re2_REQUIRES
+            OUTPUT_STRIP_TRAILING_WHITESPACE
+            ERROR_QUIET
+        )
+
+        string(REGEX MATCHALL "absl_[A-Za-z0-9_]+" re2_absl_modules "${re2_REQUIRES}")
+    endif()
+
+    if(re2_absl_modules)
+        find_package(absl QUIET CONFIG)
+
+        set(re2_absl_targets)
+
+        foreach(module IN LISTS re2_absl_modules)
+            string(REGEX REPLACE "^absl_" "absl::" target ${module})
+
+            if(NOT TARGET ${target})
+                set(re2_absl_targets)
+
+                break()
+            endif()
+
+            list(APPEND re2_absl_targets ${target})
+        endforeach()
+
+        if(re2_absl_targets)
+            target_link_libraries(re2::re2 INTERFACE ${re2_absl_targets})
+        else()
+            list(REMOVE_ITEM re2_LINK_LIBRARIES ${re2_LIBRARY})
+
+            target_link_libraries(re2::re2 INTERFACE ${re2_LINK_LIBRARIES})
+        endif()
+    endif()
+endif()
@@ -35,6 +35,7 @@ function(fairseq2n_print_project_summary)
     endif()
     message(STATUS "  FAIRSEQ2N_TREAT_WARNINGS_AS_ERRORS : ${FAIRSEQ2N_TREAT_WARNINGS_AS_ERRORS}")
     message(STATUS "  FAIRSEQ2N_SUPPORT_IMAGE            : ${FAIRSEQ2N_SUPPORT_IMAGE}")
+    message(STATUS "  FAIRSEQ2N_SUPPORT_VIDEO            : ${FAIRSEQ2N_SUPPORT_VIDEO}")
     message(STATUS "  FAIRSEQ2N_USE_LIBTORCH             : ${FAIRSEQ2N_USE_LIBTORCH}")
     message(STATUS "  FAIRSEQ2N_USE_CUDA                 : ${FAIRSEQ2N_USE_CUDA}")
     if(FAIRSEQ2N_USE_CUDA)
@@ -52,5 +53,8 @@ function(fairseq2n_print_project_summary)
         message(STATUS "    Intel oneTBB                     : ${TBB_VERSION}")
     endif()
     message(STATUS "    libsndfile                       : ${SndFile_VERSION}")
+    if(FAIRSEQ2N_SUPPORT_VIDEO)
+        message(STATUS "    FFmpeg (libavformat)             : ${FFmpeg_VERSION}")
+    endif()
     message(STATUS "")
 endfunction()
@@ -15,6 +15,9 @@ from fairseq2n.config import (
     _CUDA_VERSION,
     _SUPPORTS_CUDA,
     _SUPPORTS_IMAGE,
+    _SUPPORTS_REGEX,
+    _SUPPORTS_TEXT_NORMALIZATION,
+    _SUPPORTS_VIDEO,
     _TORCH_VARIANT,
     _TORCH_VERSION,
 )
@@ -52,6 +55,21 @@ def supports_image() -> bool:
     return _SUPPORTS_IMAGE
 
 
+def supports_regex() -> bool:
+    """Return ``True`` if fairseq2n supports regular expression matching."""
+    return _SUPPORTS_REGEX
+
+
+def supports_text_normalization() -> bool:
+    """Return ``True`` if fairseq2n supports Unicode text normalization."""
+    return _SUPPORTS_TEXT_NORMALIZATION
+
+
+def supports_video() -> bool:
+    """Return ``True`` if fairseq2n supports video decoding."""
+    return _SUPPORTS_VIDEO
+
+
 def supports_cuda() -> bool:
     """Return ``True`` if fairseq2n supports CUDA."""
     return _SUPPORTS_CUDA
@@ -7,14 +7,24 @@
 #include "fairseq2n/bindings/module.h"
 
 #include <cstdint>
+#include <filesystem>
 #include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <ATen/Device.h>
 #include <ATen/ScalarType.h>
 
 #include <fairseq2n/float.h>
+#include <fairseq2n/data/data_pipeline.h>
+#include <fairseq2n/data/audio/audio_augmenter.h>
 #include <fairseq2n/data/audio/audio_decoder.h>
+#include <fairseq2n/data/audio/voice_activity_segmenter.h>
 #include <fairseq2n/data/audio/waveform_to_fbank_converter.h>
+#include <fairseq2n/data/audio/waveform_to_log_mel_converter.h>
+#include <fairseq2n/data/audio/waveform_to_mfcc_converter.h>
 
 namespace py = pybind11;
 
@@ -25,6 +35,47 @@ def_audio(py::module_ &data_module)
 {
     py::module_ m = data_module.def_submodule("audio");
 
+    // AudioAugmenter
+    py::class_<audio_augmenter, std::shared_ptr<audio_augmenter>>(m, "AudioAugmenter")
+        .def(
+            py::init([](
+                const std::vector<std::string> &noise_pathnames,
+                const std::vector<std::string> &rir_pathnames,
+                float32 noise_probability,
+                float32 min_snr,
+                float32 max_snr,
+                float32 reverb_probability,
+                bool channel_last,
+                std::optional<std::filesystem::path> maybe_root_dir,
+                std::optional<std::uint64_t> maybe_seed)
+            {
+                auto opts = audio_augmenter_options()
+                    .noise_probability(noise_probability)
+                    .min_snr(min_snr)
+                    .max_snr(max_snr)
+                    .reverb_probability(reverb_probability)
+                    .channel_last(channel_last)
+                    .maybe_root_dir(std::move(maybe_root_dir))
+                    .maybe_seed(maybe_seed);
+
+                return std::make_shared<audio_augmenter>(noise_pathnames, rir_pathnames, opts);
+            }),
+            py::arg("noise_pathnames") = std::vector<std::string>(),
+            py::arg("rir_pathnames") = std::vector<std::string>(),
+            py::arg("noise_probability") = 1.0,
+            py::arg("min_snr") = 5.0,
+            py::arg("max_snr") = 20.0,
+            py::arg("reverb_probability") = 1.0,
+            py::arg("channel_last") = false,
+            py::arg("root_dir") = std::nullopt,
+            py::arg("seed") = std::nullopt)
+        .def(
+            "__call__",
+            &audio_augmenter::operator(),
+            py::call_guard<py::gil_scoped_release>{});
+
+    map_functors().register_<audio_augmenter>();
+
     // AudioDecoder
     py::class_<audio_decoder, std::shared_ptr<audio_decoder>>(m, "AudioDecoder")
         .def(
@@ -86,6 +137,139 @@ def_audio(py::module_ &data_module)
         .def("__call__", &waveform_to_fbank_converter::operator());
 
     map_functors().register_<waveform_to_fbank_converter>();
+
+    // WaveformToLogMelConverter
+    py::class_<waveform_to_log_mel_converter, std::shared_ptr<waveform_to_log_mel_converter>>(
+        m, "WaveformToLogMelConverter")
+        .def(
+            py::init([](
+                std::int32_t num_mel_bins,
+                std::int32_t num_fft,
+                std::int32_t hop_length,
+                float32 waveform_scale,
+                bool channel_last,
+                bool keep_waveform,
+                std::optional<at::ScalarType> dtype,
+                std::optional<at::Device> device,
+                bool pin_memory)
+            {
+                return std::make_shared<waveform_to_log_mel_converter>(
+                    log_mel_options()
+                        .num_mel_bins(num_mel_bins)
+                        .num_fft(num_fft)
+                        .hop_length(hop_length)
+                        .waveform_scale(waveform_scale)
+                        .channel_last(channel_last)
+                        .keep_waveform(keep_waveform)
+                        .maybe_dtype(dtype)
+                        .maybe_device(device)
+                        .pin_memory(pin_memory));
+            }),
+            py::arg("num_mel_bins") = 80,
+            py::arg("num_fft") = 400,
+            py::arg("hop_length") = 160,
+            py::arg("waveform_scale") = 1.0,
+            py::arg("channel_last") = false,
+            py::arg("keep_waveform") = false,
+            py::arg("dtype") = std::nullopt,
+            py::arg("device") = std::nullopt,
+            py::arg("pin_memory") = false)
+        .def(
+            "__call__",
+            &waveform_to_log_mel_converter::operator(),
+            py::call_guard<py::gil_scoped_release>{});
+
+    map_functors().register_<waveform_to_log_mel_converter>();
+
+    // WaveformToMfccConverter
+    py::class_<waveform_to_mfcc_converter, std::shared_ptr<waveform_to_mfcc_converter>>(
+        m, "WaveformToMfccConverter")
+        .def(
+            py::init([](
+                std::int32_t num_mel_bins,
+                std::int32_t num_ceps,
+                float32 cepstral_lifter,
+                float32 waveform_scale,
+                bool channel_last,
+                bool standardize,
+                bool keep_waveform,
+                std::optional<at::ScalarType> dtype,
+                std::optional<at::Device> device,
+                bool pin_memory)
+            {
+                return std::make_shared<waveform_to_mfcc_converter>(
+                    mfcc_options()
+                        .num_mel_bins(num_mel_bins)
+                        .num_ceps(num_ceps)
+                        .cepstral_lifter(cepstral_lifter)
+                        .waveform_scale(waveform_scale)
+                        .channel_last(channel_last)
+                        .standardize(standardize)
+                        .keep_waveform(keep_waveform)
+                        .maybe_dtype(dtype)
+                        .maybe_device(device)
+                        .pin_memory(pin_memory));
+            }),
+            py::arg("num_mel_bins") = 23,
+            py::arg("num_ceps") = 13,
+            py::arg("cepstral_lifter") = 22.0,
+            py::arg("waveform_scale") = 1.0,
+            py::arg("channel_last") = false,
+            py::arg("standardize") = false,
+            py::arg("keep_waveform") = false,
+            py::arg("dtype") = std::nullopt,
+            py::arg("device") = std::nullopt,
+            py::arg("pin_memory") = false)
+        .def(
+            "__call__",
+            &waveform_to_mfcc_converter::operator(),
+            py::call_guard<py::gil_scoped_release>{});
+
+    map_functors().register_<waveform_to_mfcc_converter>();
+
+    // VoiceActivitySegmenter
+    py::class_<voice_activity_segmenter, std::shared_ptr<voice_activity_segmenter>>(
+        m, "VoiceActivitySegmenter")
+        .def(
+            py::init([](
+                float32 frame_duration,
+                float32 start_threshold,
+                float32 end_threshold,
+                float32 max_zero_crossing_rate,
+                float32 min_silence_duration,
+                float32 min_segment_duration,
+                float32 max_segment_duration,
+                float32 padding_duration,
+                float32 waveform_scale,
+                bool channel_last)
+            {
+                return std::make_shared<voice_activity_segmenter>(
+                    vad_options()
+                        .frame_duration(frame_duration)
+                        .start_threshold(start_threshold)
+                        .end_threshold(end_threshold)
+                        .max_zero_crossing_rate(max_zero_crossing_rate)
+                        .min_silence_duration(min_silence_duration)
+                        .min_segment_duration(min_segment_duration)
+                        .max_segment_duration(max_segment_duration)
+                        .padding_duration(padding_duration)
+                        .waveform_scale(waveform_scale)
+                        .channel_last(channel_last));
+            }),
+            py::arg("frame_duration") = 0.02,
+            py::arg("start_threshold") = -35.0,
+            py::arg("end_threshold") = -45.0,
+            py::arg("max_zero_crossing_rate") = 0.4,
+            py::arg("min_silence_duration") = 0.3,
+            py::arg("min_segment_duration") = 0.25,
+            py::arg("max_segment_duration") = 30.0,
+            py::arg("padding_duration") = 0.1,
+            py::arg("waveform_scale") = 1.0,
+            py::arg("channel_last") = false)
+        .def(
+            "__call__",
+            &voice_activity_segmenter::operator(),
+            py::call_guard<py::gil_scoped_release>{});
 }
 
 }  // namespace fairseq2n
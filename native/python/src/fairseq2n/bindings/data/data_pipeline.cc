@@ -9,11 +9,13 @@
 #include <algorithm>
 #include <cstddef>
 #include <exception>
+#include <filesystem>
 #include <functional>
 #include <iterator>
 #include <memory>
 #include <optional>
 #include <stdexcept>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <variant>
@@ -24,8 +26,13 @@
 #include <fairseq2n/data/collater.h>
 #include <fairseq2n/data/element_mapper.h>
 #include <fairseq2n/data/data.h>
+#include <fairseq2n/data/data_hasher.h>
 #include <fairseq2n/data/data_length_extractor.h>
 #include <fairseq2n/data/data_pipeline.h>
+#include <fairseq2n/data/data_pipeline_async_reader.h>
+#include <fairseq2n/data/data_sink.h>
+#include <fairseq2n/data/file.h>
+#include <fairseq2n/data/file_cache.h>
 #include <fairseq2n/data/file_mapper.h>
 #include <fairseq2n/data/record_reader.h>
 #include <fairseq2n/data/tape.h>
@@ -194,6 +201,238 @@ private:
     data_pipeline *pipeline_;
 };
 
+// Implements `async for` over a data pipeline. The examples are read by a
+// native background thread that signals their completion through a file
+// descriptor; the event loop waits on it via `add_reader()`, so neither the
+// loop nor any other Python thread blocks on the data pipeline.
+class data_pipeline_async_iterator {
+public:
+    explicit
+    data_pipeline_async_iterator(const py::object &pipeline)
+      : reader_{make_reader(pipeline)}
+    {}
+
+    data_pipeline_async_iterator(const data_pipeline_async_iterator &) = delete;
+    data_pipeline_async_iterator &operator=(const data_pipeline_async_iterator &) = delete;
+
+    data_pipeline_async_iterator(data_pipeline_async_iterator &&) noexcept = default;
+    data_pipeline_async_iterator &operator=(data_pipeline_async_iterator &&) noexcept = default;
+
+   ~data_pipeline_async_iterator()
+    {
+        // If `aclose()` was called, the event loop takes care of the rest.
+        if (!reader_ || maybe_close_future_)
+            return;
+
+        remove_reader();
+
+        reader_->close();
+
+        if (reader_->is_stopped())
+            return;
+
+        // If we are destroyed on an event loop (e.g. at the end of an `async
+        // for` that was exited early), let the loop dispose of the reader once
+        // its background thread exits instead of blocking it.
+        try {
+            py::object loop = py::module_::import("asyncio").attr("get_running_loop")();
+
+            watch_until_stopped(loop, py::none());
+
+            return;
+        } catch (const py::error_already_set &) {}
+
+        // Otherwise, wait for the background thread.
+        reader_.reset();
+    }
+
+    // Performs one step of an `__anext__()` awaitable; either returns a future
+    // for the event loop to wait on, or finishes the awaitable by raising
+    // `StopIteration` with the next example or `StopAsyncIteration`.
+    py::object
+    step()
+    {
+        if (maybe_close_future_) {
+            PyErr_SetNone(PyExc_StopAsyncIteration);
+
+            throw py::error_already_set();
+        }
+
+        if (!reader_->is_ready()) {
+            // If the previous wait was abandoned (e.g. cancelled), the read it
+            // requested is still in flight and this call is a no-op.
+            reader_->request_next();
+
+            py::object loop = py::module_::import("asyncio").attr("get_running_loop")();
+
+            maybe_loop_ = loop;
+
+            py::object future = loop.attr("create_future")();
+
+            int fd = reader_->fd();
+
+            auto on_ready = [loop, future, fd]
+            {
+                loop.attr("remove_reader")(fd);
+
+                if (!future.attr("done")().cast<bool>())
+                    future.attr("set_result")(py::none());
+            };
+
+            loop.attr("add_reader")(fd, py::cpp_function{on_ready});
+
+            maybe_wait_future_ = future;
+
+            // Yield the future through its own awaitable protocol so that the
+            // task suspends until it is done.
+            return future.attr("__await__")().attr("__next__")();
+        }
+
+        std::optional<data> maybe_example{};
+
+        try {
+            maybe_example = reader_->take_result();
+        } catch (data_pipeline_error &ex) {
+            last_failed_example_ = std::move(ex.maybe_example());
+
+            throw;
+        }
+
+        // The operation was successful, clear the error state.
+        last_failed_example_ = std::nullopt;
+
+        if (!maybe_example) {
+            PyErr_SetNone(PyExc_StopAsyncIteration);
+
+            throw py::error_already_set();
+        }
+
+        // We explicitly construct the `StopIteration` instance; otherwise, an
+        // example of type `tuple` would be unpacked as its arguments.
+        py::object stop = py::handle{PyExc_StopIteration}(py::cast(*std::move(maybe_example)));
+
+        PyErr_SetObject(PyExc_StopIteration, stop.ptr());
+
+        throw py::error_already_set();
+    }
+
+    // Cancels the read in flight, if any, without waiting for it; returns a
+    // future that completes once the background thread exits. Only then the
+    // data pipeline can be reset and used again.
+    py::object
+    aclose()
+    {
+        if (maybe_close_future_)
+            return maybe_close_future_;
+
+        py::object loop = py::module_::import("asyncio").attr("get_running_loop")();
+
+        py::object future = loop.attr("create_future")();
+
+        remove_reader();
+
+        // Wake up a task that still waits for the next example; it will
+        // receive `StopAsyncIteration`.
+        if (maybe_wait_future_ && !maybe_wait_future_.attr("done")().cast<bool>())
+            maybe_wait_future_.attr("set_result")(py::none());
+
+        maybe_wait_future_ = {};
+
+        reader_->close();
+
+        if (reader_->is_stopped())
+            future.attr("set_result")(py::none());
+        else
+            watch_until_stopped(loop, future);
+
+        maybe_close_future_ = future;
+
+        return future;
+    }
+
+private:
+    // The returned reader keeps `pipeline` alive until its background thread
+    // has exited, no matter who drops the last reference to it.
+    static std::shared_ptr<data_pipeline_async_reader>
+    make_reader(const py::object &pipeline)
+    {
+        auto &p = pipeline.cast<data_pipeline &>();
+
+        auto deleter = [pipeline](data_pipeline_async_reader *reader)
+        {
+            // The background thread might be waiting for GIL to run a Python
+            // callback of the data pipeline.
+            py::gil_scoped_release no_gil{};
+
+            delete reader;
+        };
+
+        return std::shared_ptr<data_pipeline_async_reader>{
+            new data_pipeline_async_reader{p}, std::move(deleter)};
+    }
+
+    // Stops the event loop from watching the file descriptor of `reader_` in
+    // case a wait was abandoned before the read completed.
+    void
+    remove_reader() noexcept
+    {
+        if (!maybe_loop_)
+            return;
+
+        try {
+            if (!maybe_loop_.attr("is_closed")().cast<bool>())
+                maybe_loop_.attr("remove_reader")(reader_->fd());
+        } catch (const py::error_already_set &) {}
+
+        maybe_loop_ = {};
+    }
+
+    // Lets `loop` keep the closed reader (and with it the data pipeline) alive
+    // until its background thread exits, and then completes `future`, unless
+    // it is `None`.
+    void
+    watch_until_stopped(const py::object &loop, const py::object &future)
+    {
+        int fd = reader_->fd();
+
+        auto on_ready = [loop, future, fd, reader = reader_]
+        {
+            if (!reader->is_stopped())
+                return;
+
+            loop.attr("remove_reader")(fd);
+
+            if (!future.is_none() && !future.attr("done")().cast<bool>())
+                future.attr("set_result")(py::none());
+        };
+
+        loop.attr("add_reader")(fd, py::cpp_function{on_ready});
+    }
+
+private:
+    std::shared_ptr<data_pipeline_async_reader> reader_;
+    py::object maybe_loop_{};
+    py::object maybe_wait_future_{};
+    py::object maybe_close_future_{};
+};
+
+class data_pipeline_async_next {
+public:
+    explicit
+    data_pipeline_async_next(data_pipeline_async_iterator &iterator) noexcept
+      : iterator_{&iterator}
+    {}
+
+    py::object
+    next()
+    {
+        return iterator_->step();
+    }
+
+private:
+    data_pipeline_async_iterator *iterator_;
+};
+
 }  // namespace
 }  // namespace detail
 
@@ -217,6 +456,13 @@ def_data_pipeline(py::module_ &data_module)
             },
             py::keep_alive<0, 1>{})
 
+        .def(
+            "__aiter__",
+            [](const py::object &self)
+            {
+                return data_pipeline_async_iterator{self};
+            })
+
         .def(
             "reset",
             &data_pipeline::reset,
@@ -404,6 +650,37 @@ def_data_pipeline(py::module_ &data_module)
             })
         .def("__next__", &data_pipeline_iterator::next);
 
+    py::class_<data_pipeline_async_iterator>(m, "_DataPipelineAsyncIterator")
+        .def(
+            "__aiter__",
+            [](data_pipeline_async_iterator &self) -> data_pipeline_async_iterator &
+            {
+                return self;
+            })
+        .def(
+            "__anext__",
+            [](data_pipeline_async_iterator &self)
+            {
+                return data_pipeline_async_next{self};
+            },
+            py::keep_alive<0, 1>{})
+        .def("aclose", &data_pipeline_async_iterator::aclose);
+
+    py::class_<data_pipeline_async_next>(m, "_DataPipelineAsyncNext")
+        .def(
+            "__await__",
+            [](data_pipeline_async_next &self) -> data_pipeline_async_next &
+            {
+                return self;
+            })
+        .def(
+            "__iter__",
+            [](data_pipeline_async_next &self) -> data_pipeline_async_next &
+            {
+                return self;
+            })
+        .def("__next__", &data_pipeline_async_next::next);
+
     // DataPipelineBuilder
     py::class_<data_pipeline_builder>(m, "DataPipelineBuilder")
         .def(
@@ -535,6 +812,19 @@ def_data_pipeline(py::module_ &data_module)
             },
             py::arg("num_repeats") = std::nullopt,
             py::arg("reset_rng") = false)
+        .def(
+            "restore_order",
+            [](
+                data_pipeline_builder &self,
+                std::size_t max_num_buffered,
+                std::string index_selector) -> data_pipeline_builder &
+            {
+                self = std::move(self).restore_order(max_num_buffered, std::move(index_selector));
+
+                return self;
+            },
+            py::arg("max_num_buffered"),
+            py::arg("index_selector") = "index")
         .def(
             "shard",
             [](
@@ -555,14 +845,16 @@ def_data_pipeline(py::module_ &data_module)
             [](
                 data_pipeline_builder &self,
                 std::size_t shuffle_window,
-                std::optional<std::uint64_t> maybe_seed) -> data_pipeline_builder &
+                std::optional<std::uint64_t> maybe_seed,
+                std::size_t warmup_window) -> data_pipeline_builder &
             {
-                self = std::move(self).shuffle(shuffle_window, maybe_seed);
+                self = std::move(self).shuffle(shuffle_window, maybe_seed, warmup_window);
 
                 return self;
             },
             py::arg("shuffle_window"),
-            py::arg("seed") = std::nullopt)
+            py::arg("seed") = std::nullopt,
+            py::arg("warmup_window") = 0)
         .def(
             "skip",
             [](data_pipeline_builder &self, std::size_t num_examples) -> data_pipeline_builder &
@@ -572,6 +864,51 @@ def_data_pipeline(py::module_ &data_module)
                 return self;
             },
             py::arg("num_examples"))
+        .def(
+            "sort_for_inference",
+            [](
+                data_pipeline_builder &self,
+                std::size_t window_size,
+                std::size_t batch_size,
+                std::optional<std::string> maybe_selector,
+                std::string index_key) -> data_pipeline_builder &
+            {
+                self = std::move(self).sort_for_inference(
+                    window_size,
+                    batch_size,
+                    data_length_extractor{std::move(maybe_selector)},
+                    std::move(index_key));
+
+                return self;
+            },
+            py::arg("window_size"),
+            py::arg("batch_size"),
+            py::arg("selector") = std::nullopt,
+            py::arg("index_key") = "index")
+        .def(
+            "stratified_sample",
+            [](
+                data_pipeline_builder &self,
+                std::string selector,
+                std::size_t reservoir_size,
+                std::optional<std::unordered_map<std::string, float64>> maybe_weights,
+                std::optional<float64> maybe_temperature,
+                std::optional<std::uint64_t> maybe_seed) -> data_pipeline_builder &
+            {
+                self = std::move(self).stratified_sample(
+                    std::move(selector),
+                    reservoir_size,
+                    std::move(maybe_weights),
+                    maybe_temperature,
+                    maybe_seed);
+
+                return self;
+            },
+            py::arg("selector"),
+            py::arg("reservoir_size") = 1000,
+            py::arg("weights") = std::nullopt,
+            py::arg("temperature") = std::nullopt,
+            py::arg("seed") = std::nullopt)
         .def(
             "take",
             [](data_pipeline_builder &self, std::size_t num_examples) -> data_pipeline_builder &
@@ -581,6 +918,22 @@ def_data_pipeline(py::module_ &data_module)
                 return self;
             },
             py::arg("num_examples"))
+        .def(
+            "take_random",
+            [](
+                data_pipeline_builder &self,
+                std::size_t num_examples,
+                std::optional<std::string> maybe_weight_selector,
+                std::optional<std::uint64_t> maybe_seed) -> data_pipeline_builder &
+            {
+                self = std::move(self).take_random(
+                    num_examples, std::move(maybe_weight_selector), maybe_seed);
+
+                return self;
+            },
+            py::arg("num_examples"),
+            py::arg("weight_selector") = std::nullopt,
+            py::arg("seed") = std::nullopt)
         .def(
             "yield_from",
             [](data_pipeline_builder &self, yield_fn fn) -> data_pipeline_builder &
@@ -625,22 +978,79 @@ def_data_pipeline(py::module_ &data_module)
 
     m.def("read_zipped_records", &read_zipped_records, py::arg("path"));
 
+    // DataPipeline Sinks
+    py::enum_<file_compression>(m, "FileCompression")
+        .value("NONE", file_compression::none)
+        .value("GZIP", file_compression::gzip);
+
+    m.def(
+        "write_records",
+        [](
+            data_pipeline &pipeline,
+            const std::filesystem::path &path,
+            file_compression compression,
+            std::optional<std::size_t> maybe_block_size)
+        {
+            auto opts = file_writer_options()
+                .compression(compression).maybe_block_size(maybe_block_size);
+
+            return write_records(pipeline, path, opts);
+        },
+        py::arg("pipeline"),
+        py::arg("path"),
+        py::arg("compression") = file_compression::none,
+        py::arg("block_size")  = std::nullopt,
+        py::call_guard<py::gil_scoped_release>{});
+
+    m.def(
+        "write_tensors",
+        [](
+            data_pipeline &pipeline,
+            const std::filesystem::path &path,
+            const std::optional<std::filesystem::path> &maybe_index_path,
+            file_compression compression,
+            std::optional<std::size_t> maybe_block_size)
+        {
+            auto opts = file_writer_options()
+                .compression(compression).maybe_block_size(maybe_block_size);
+
+            return write_tensors(pipeline, path, maybe_index_path, opts);
+        },
+        py::arg("pipeline"),
+        py::arg("path"),
+        py::arg("index_path")  = std::nullopt,
+        py::arg("compression") = file_compression::none,
+        py::arg("block_size")  = std::nullopt,
+        py::call_guard<py::gil_scoped_release>{});
+
     // Collater
     py::class_<collate_options_override>(m, "CollateOptionsOverride")
         .def(
             py::init([](
                 std::string selector,
                 std::optional<std::int64_t> maybe_pad_value,
-                std::int64_t pad_to_multiple)
+                std::int64_t pad_to_multiple,
+                bool pack,
+                bool padding_mask,
+                bool segment_ids,
+                bool position_ids)
             {
                 return collate_options_override{std::move(selector),
                     collate_options()
                         .maybe_pad_value(maybe_pad_value)
-                        .pad_to_multiple(pad_to_multiple)};
+                        .pad_to_multiple(pad_to_multiple)
+                        .pack(pack)
+                        .padding_mask(padding_mask)
+                        .segment_ids(segment_ids)
+                        .position_ids(position_ids)};
             }),
             py::arg("selector"),
             py::arg("pad_value") = std::nullopt,
-            py::arg("pad_to_multiple") = 1)
+            py::arg("pad_to_multiple") = 1,
+            py::arg("pack") = false,
+            py::arg("padding_mask") = false,
+            py::arg("segment_ids") = false,
+            py::arg("position_ids") = false)
         .def_property_readonly(
             "selector",
             [](const collate_options_override &self)
@@ -658,6 +1068,30 @@ def_data_pipeline(py::module_ &data_module)
             [](const collate_options_override &self)
             {
                 return self.options().pad_to_multiple();
+            })
+        .def_property_readonly(
+            "pack",
+            [](const collate_options_override &self)
+            {
+                return self.options().pack();
+            })
+        .def_property_readonly(
+            "padding_mask",
+            [](const collate_options_override &self)
+            {
+                return self.options().padding_mask();
+            })
+        .def_property_readonly(
+            "segment_ids",
+            [](const collate_options_override &self)
+            {
+                return self.options().segment_ids();
+            })
+        .def_property_readonly(
+            "position_ids",
+            [](const collate_options_override &self)
+            {
+                return self.options().position_ids();
             });
 
     py::class_<collater, std::shared_ptr<collater>>(m, "Collater")
@@ -665,10 +1099,19 @@ def_data_pipeline(py::module_ &data_module)
             py::init([](
                 std::optional<std::int64_t> maybe_pad_value,
                 std::int64_t pad_to_multiple,
-                std::optional<std::vector<collate_options_override>> maybe_opt_overrides)
+                std::optional<std::vector<collate_options_override>> maybe_opt_overrides,
+                bool pack,
+                bool padding_mask,
+                bool segment_ids,
+                bool position_ids)
             {
                 auto opts = collate_options()
-                    .maybe_pad_value(maybe_pad_value).pad_to_multiple(pad_to_multiple);
+                    .maybe_pad_value(maybe_pad_value)
+                    .pad_to_multiple(pad_to_multiple)
+                    .pack(pack)
+                    .padding_mask(padding_mask)
+                    .segment_ids(segment_ids)
+                    .position_ids(position_ids);
 
                 std::vector<collate_options_override> opt_overrides{};
                 if (maybe_opt_overrides)
@@ -678,21 +1121,53 @@ def_data_pipeline(py::module_ &data_module)
             }),
             py::arg("pad_value") = std::nullopt,
             py::arg("pad_to_multiple") = 1,
-            py::arg("overrides") = std::nullopt)
+            py::arg("overrides") = std::nullopt,
+            py::arg("pack") = false,
+            py::arg("padding_mask") = false,
+            py::arg("segment_ids") = false,
+            py::arg("position_ids") = false)
         .def("__call__", &collater::operator(), py::call_guard<py::gil_scoped_release>{});
 
     map_functors().register_<collater>();
 
+    // DataHasher
+    py::class_<data_hasher, std::shared_ptr<data_hasher>>(m, "DataHasher")
+        .def(
+            py::init<std::optional<std::string>, std::optional<std::string>, std::uint64_t>(),
+            py::arg("selector") = std::nullopt,
+            py::arg("key") = std::nullopt,
+            py::arg("seed") = 0)
+        .def("hash", &data_hasher::hash, py::arg("data"), py::call_guard<py::gil_scoped_release>{})
+        .def("__call__", &data_hasher::operator(), py::call_guard<py::gil_scoped_release>{});
+
+    map_functors().register_<data_hasher>();
+
     // FileMapper
     py::class_<file_mapper, std::shared_ptr<file_mapper>>(m, "FileMapper")
         .def(
-            py::init<std::optional<std::filesystem::path>, std::optional<std::size_t>>(),
+            py::init<std::optional<std::filesystem::path>, std::optional<std::size_t>, bool>(),
             py::arg("root_dir") = std::nullopt,
-            py::arg("cached_fd_count") = std::nullopt)
+            py::arg("cached_fd_count") = std::nullopt,
+            py::arg("readahead") = false)
         .def("__call__", &file_mapper::operator(), py::call_guard<py::gil_scoped_release>{});
 
     map_functors().register_<file_mapper>();
 
+    // FileCache
+    py::class_<file_cache, std::shared_ptr<file_cache>>(m, "FileCache")
+        .def(
+            py::init<std::filesystem::path, std::size_t>(),
+            py::arg("cache_dir"),
+            py::arg("max_size"))
+        .def_property_readonly("cache_dir", &file_cache::cache_dir)
+        .def_property_readonly("max_size", &file_cache::max_size)
+        .def_property_readonly("num_hits", &file_cache::num_hits)
+        .def_property_readonly("num_misses", &file_cache::num_misses);
+
+    m.def("get_file_cache", &get_file_cache);
+
+    m.def("set_file_cache", &set_file_cache, py::arg("cache"));
+
     // RecordError
     static py::exception<record_error> py_record_error{m, "RecordError", PyExc_RuntimeError};
 
@@ -29,15 +29,34 @@ def_image(py::module_ &data_module)
         .def(
             py::init([](
                 std::optional<at::Device> maybe_device,
-                bool pin_memory)
+                bool pin_memory,
+                bool random_crop,
+                float32 min_crop_scale,
+                float32 max_crop_scale,
+                float32 min_crop_ratio,
+                float32 max_crop_ratio,
+                std::optional<std::uint64_t> maybe_seed)
             {
                 auto opts = image_decoder_options()
-                    .maybe_device(maybe_device).pin_memory(pin_memory);
+                    .maybe_device(maybe_device)
+                    .pin_memory(pin_memory)
+                    .random_crop(random_crop)
+                    .min_crop_scale(min_crop_scale)
+                    .max_crop_scale(max_crop_scale)
+                    .min_crop_ratio(min_crop_ratio)
+                    .max_crop_ratio(max_crop_ratio)
+                    .maybe_seed(maybe_seed);
 
                 return std::make_shared<image_decoder>(opts);
             }),
             py::arg("device") = std::nullopt,
-            py::arg("pin_memory") = false)
+            py::arg("pin_memory") = false,
+            py::arg("random_crop") = false,
+            py::arg("min_crop_scale") = 0.08,
+            py::arg("max_crop_scale") = 1.0,
+            py::arg("min_crop_ratio") = 3.0 / 4.0,
+            py::arg("max_crop_ratio") = 4.0 / 3.0,
+            py::arg("seed") = std::nullopt)
         .def("__call__", &image_decoder::operator(), py::call_guard<py::gil_scoped_release>{});
 
     map_functors().register_<image_decoder>();
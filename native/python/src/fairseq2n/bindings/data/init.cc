@@ -45,6 +45,8 @@ def_data(py::module_ &base)
     def_data_pipeline(m);
 
     def_text(m);
+
+    def_video(m);
 }
 
 }  // namespace fairseq2n
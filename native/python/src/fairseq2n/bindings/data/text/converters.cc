@@ -7,18 +7,24 @@
 #include "fairseq2n/bindings/module.h"
 
 #include <cstdint>
+#include <filesystem>
 #include <optional>
 #include <stdexcept>
 #include <string_view>
 #include <utility>
 #include <vector>
 
+#include <ATen/Device.h>
 #include <ATen/ScalarType.h>
 
 #include <fairseq2n/data/data_pipeline.h>
+#include <fairseq2n/data/text/regex_filter.h>
+#include <fairseq2n/data/text/regex_replacer.h>
 #include <fairseq2n/data/text/string_splitter.h>
 #include <fairseq2n/data/text/string_to_int_converter.h>
 #include <fairseq2n/data/text/string_to_tensor_converter.h>
+#include <fairseq2n/data/text/text_normalizer.h>
+#include <fairseq2n/data/text/vocab_lookup.h>
 #include <fairseq2n/detail/exception.h>
 
 namespace py = pybind11;
@@ -32,6 +38,24 @@ def_text_converters(py::module_ &text_module)
 {
     py::module_ m = text_module.def_submodule("converters");
 
+    // RegexFilter
+    py::class_<regex_filter, std::shared_ptr<regex_filter>>(m, "RegexFilter")
+        .def(
+            py::init<std::string_view, std::optional<std::string>, bool>(),
+            py::arg("pattern"),
+            py::arg("selector") = std::nullopt,
+            py::arg("exclude") = false)
+        .def("__call__", &regex_filter::operator(), py::call_guard<py::gil_scoped_release>{});
+
+    // RegexReplacer
+    py::class_<regex_replacer, std::shared_ptr<regex_replacer>>(m, "RegexReplacer")
+        .def(
+            py::init<std::string_view, std::string, std::optional<std::string>>(),
+            py::arg("pattern"),
+            py::arg("rewrite"),
+            py::arg("selector") = std::nullopt)
+        .def("__call__", &regex_replacer::operator(), py::call_guard<py::gil_scoped_release>{});
+
     // StrSplitter
     py::class_<string_splitter, std::shared_ptr<string_splitter>>(m, "StrSplitter")
         .def(
@@ -89,9 +113,91 @@ def_text_converters(py::module_ &text_module)
             &string_to_tensor_converter::operator(),
             py::call_guard<py::gil_scoped_release>{});
 
+    // TextNormalizer
+    py::enum_<normalization_form>(m, "NormalizationForm")
+        .value("NFC",  normalization_form::nfc)
+        .value("NFKC", normalization_form::nfkc);
+
+    py::class_<text_normalizer, std::shared_ptr<text_normalizer>>(m, "TextNormalizer")
+        .def(
+            py::init([](normalization_form form, bool case_fold, bool collapse_whitespace)
+            {
+                auto opts = text_normalizer_options()
+                    .form(form).case_fold(case_fold).collapse_whitespace(collapse_whitespace);
+
+                return std::make_shared<text_normalizer>(opts);
+            }),
+            py::arg("form") = normalization_form::nfc,
+            py::arg("case_fold") = false,
+            py::arg("collapse_whitespace") = false)
+        .def(
+            "__call__",
+            &text_normalizer::operator(),
+            py::call_guard<py::gil_scoped_release>{});
+
+    // VocabLookup
+    py::class_<vocab_lookup, std::shared_ptr<vocab_lookup>>(m, "VocabLookup")
+        .def(
+            py::init([](
+                std::filesystem::path path,
+                bool char_level,
+                std::string_view sep,
+                std::optional<std::string> maybe_unk_token,
+                std::optional<std::string> maybe_bos_token,
+                std::optional<std::string> maybe_eos_token,
+                std::optional<std::string> maybe_pad_token,
+                bool add_bos,
+                bool add_eos,
+                std::optional<at::Device> maybe_device,
+                bool pin_memory)
+            {
+                if (sep.size() != 1)
+                    throw_<std::invalid_argument>(
+                        "`sep` must be of length 1, but is of length {} instead.", sep.size());
+
+                auto opts = vocab_lookup_options()
+                    .char_level(char_level)
+                    .separator(sep[0])
+                    .maybe_unk_token(std::move(maybe_unk_token))
+                    .maybe_bos_token(std::move(maybe_bos_token))
+                    .maybe_eos_token(std::move(maybe_eos_token))
+                    .maybe_pad_token(std::move(maybe_pad_token))
+                    .add_bos(add_bos)
+                    .add_eos(add_eos)
+                    .maybe_device(maybe_device)
+                    .pin_memory(pin_memory);
+
+                return std::make_shared<vocab_lookup>(path, std::move(opts));
+            }),
+            py::arg("path"),
+            py::arg("char_level") = false,
+            py::arg("sep")        = ' ',
+            py::arg("unk_token")  = std::nullopt,
+            py::arg("bos_token")  = std::nullopt,
+            py::arg("eos_token")  = std::nullopt,
+            py::arg("pad_token")  = std::nullopt,
+            py::arg("add_bos")    = false,
+            py::arg("add_eos")    = false,
+            py::arg("device")     = std::nullopt,
+            py::arg("pin_memory") = false)
+        .def("__call__", &vocab_lookup::operator(), py::call_guard<py::gil_scoped_release>{})
+        .def("token_to_index", &vocab_lookup::token_to_index, py::arg("token"))
+
+        .def_property_readonly("unk_idx", &vocab_lookup::unk_idx)
+        .def_property_readonly("bos_idx", &vocab_lookup::bos_idx)
+        .def_property_readonly("eos_idx", &vocab_lookup::eos_idx)
+        .def_property_readonly("pad_idx", &vocab_lookup::pad_idx)
+
+        .def_property_readonly("vocabulary_size", &vocab_lookup::vocabulary_size);
+
+    map_functors().register_<regex_replacer>();
     map_functors().register_<string_splitter>();
     map_functors().register_<string_to_int_converter>();
     map_functors().register_<string_to_tensor_converter>();
+    map_functors().register_<text_normalizer>();
+    map_functors().register_<vocab_lookup>();
+
+    predicate_functors().register_<regex_filter>();
 }
 
 }  // namespace fairseq2n
@@ -19,6 +19,8 @@ def_text(py::module_ &data_module)
 
     def_text_reader(m);
 
+    def_text_writer(m);
+
     def_text_converters(m);
 }
 
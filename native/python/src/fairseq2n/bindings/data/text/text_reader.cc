@@ -7,9 +7,12 @@
 #include "fairseq2n/bindings/module.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <optional>
 #include <string>
+#include <utility>
+#include <variant>
 
 #include <fairseq2n/data/data_pipeline.h>
 #include <fairseq2n/data/text/text_reader.h>
@@ -39,8 +42,23 @@ def_text_reader(py::module_ &text_module)
             bool rtrim,
             bool skip_empty,
             bool memory_map,
-            std::optional<std::size_t> maybe_block_size)
+            std::optional<std::size_t> maybe_block_size,
+            std::size_t num_parallel_scans,
+            std::variant<bool, std::filesystem::path> index,
+            bool shuffle,
+            std::optional<std::uint64_t> maybe_seed)
         {
+            std::optional<std::filesystem::path> maybe_index_path{};
+
+            if (auto *index_path = std::get_if<std::filesystem::path>(&index))
+                maybe_index_path = std::move(*index_path);
+            else if (std::get<bool>(index)) {
+                // By default, the index is stored next to the text file.
+                maybe_index_path = path;
+
+                *maybe_index_path += ".idx";
+            }
+
             auto opts = text_options()
                 .maybe_encoding(std::move(maybe_encoding))
                 .line_ending(le)
@@ -48,19 +66,27 @@ def_text_reader(py::module_ &text_module)
                 .rtrim(rtrim)
                 .skip_empty(skip_empty)
                 .memory_map(memory_map)
-                .maybe_block_size(maybe_block_size);
+                .maybe_block_size(maybe_block_size)
+                .num_parallel_scans(num_parallel_scans)
+                .maybe_index_path(std::move(maybe_index_path))
+                .shuffle(shuffle)
+                .maybe_seed(maybe_seed);
 
             return read_text(std::move(path), std::move(key), std::move(opts));
         },
         py::arg("path"),
-        py::arg("key")         = std::nullopt,
-        py::arg("encoding")    = std::nullopt,
-        py::arg("line_ending") = line_ending::infer,
-        py::arg("ltrim")       = false,
-        py::arg("rtrim")       = false,
-        py::arg("skip_empty")  = false,
-        py::arg("memory_map")  = false,
-        py::arg("block_size")  = std::nullopt);
+        py::arg("key")                = std::nullopt,
+        py::arg("encoding")           = std::nullopt,
+        py::arg("line_ending")        = line_ending::infer,
+        py::arg("ltrim")              = false,
+        py::arg("rtrim")              = false,
+        py::arg("skip_empty")         = false,
+        py::arg("memory_map")         = false,
+        py::arg("block_size")         = std::nullopt,
+        py::arg("num_parallel_scans") = 1,
+        py::arg("index")              = false,
+        py::arg("shuffle")            = false,
+        py::arg("seed")               = std::nullopt);
 }
 
 }  // namespace fairseq2n
@@ -0,0 +1,53 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/bindings/module.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include <fairseq2n/data/data_pipeline.h>
+#include <fairseq2n/data/file.h>
+#include <fairseq2n/data/text/text_reader.h>
+#include <fairseq2n/data/text/text_writer.h>
+
+namespace py = pybind11;
+
+namespace fairseq2n {
+
+void
+def_text_writer(py::module_ &text_module)
+{
+    py::module_ m = text_module.def_submodule("text_writer");
+
+    m.def(
+        "write_text",
+        [](
+            data_pipeline &pipeline,
+            const std::filesystem::path &path,
+            std::optional<std::string> maybe_key,
+            line_ending le,
+            file_compression compression,
+            std::optional<std::size_t> maybe_block_size)
+        {
+            auto opts = file_writer_options()
+                .compression(compression).maybe_block_size(maybe_block_size);
+
+            return write_text(pipeline, path, std::move(maybe_key), le, opts);
+        },
+        py::arg("pipeline"),
+        py::arg("path"),
+        py::arg("key")         = std::nullopt,
+        py::arg("line_ending") = line_ending::lf,
+        py::arg("compression") = file_compression::none,
+        py::arg("block_size")  = std::nullopt,
+        py::call_guard<py::gil_scoped_release>{});
+}
+
+}  // namespace fairseq2n
@@ -0,0 +1,55 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/bindings/module.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include <ATen/Device.h>
+
+#include <fairseq2n/data/video/video_decoder.h>
+
+namespace py = pybind11;
+
+namespace fairseq2n {
+
+void
+def_video(py::module_ &data_module)
+{
+    py::module_ m = data_module.def_submodule("video");
+
+    // VideoDecoder
+    py::class_<video_decoder, std::shared_ptr<video_decoder>>(m, "VideoDecoder")
+        .def(
+            py::init([](
+                std::int64_t num_frames,
+                bool random_sampling,
+                std::optional<at::Device> maybe_device,
+                bool pin_memory,
+                std::optional<std::uint64_t> maybe_seed)
+            {
+                auto opts = video_decoder_options()
+                    .num_frames(num_frames)
+                    .random_sampling(random_sampling)
+                    .maybe_device(maybe_device)
+                    .pin_memory(pin_memory)
+                    .maybe_seed(maybe_seed);
+
+                return std::make_shared<video_decoder>(opts);
+            }),
+            py::arg("num_frames") = 8,
+            py::arg("random_sampling") = false,
+            py::arg("device") = std::nullopt,
+            py::arg("pin_memory") = false,
+            py::arg("seed") = std::nullopt)
+        .def("__call__", &video_decoder::operator(), py::call_guard<py::gil_scoped_release>{});
+
+    map_functors().register_<video_decoder>();
+}
+
+}  // namespace fairseq2n
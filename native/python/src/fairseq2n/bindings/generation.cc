@@ -0,0 +1,50 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/bindings/module.h"
+
+#include <memory>
+#include <vector>
+
+#include <ATen/Tensor.h>
+
+#include <fairseq2n/generation/banned_sequence_table.h>
+#include <fairseq2n/generation/ngram_repeat_block.h>
+
+namespace py = pybind11;
+
+namespace fairseq2n {
+
+void
+def_generation(py::module_ &base_module)
+{
+    py::module_ m = base_module.def_submodule("generation");
+
+    m.def(
+        "block_ngram_repeats",
+        &block_ngram_repeats,
+        py::arg("seqs"),
+        py::arg("probs"),
+        py::arg("ngram_size"),
+        py::arg("lprob") = false,
+        py::call_guard<py::gil_scoped_release>{});
+
+    // BannedSequenceTable
+    py::class_<banned_sequence_table, std::shared_ptr<banned_sequence_table>>(
+        m, "BannedSequenceTable")
+
+        .def(py::init<const std::vector<at::Tensor> &>(), py::arg("banned_seqs"))
+
+        .def(
+            "ban",
+            &banned_sequence_table::ban,
+            py::arg("seqs"),
+            py::arg("probs"),
+            py::arg("lprob") = false,
+            py::call_guard<py::gil_scoped_release>{});
+}
+
+}  // namespace fairseq2n
@@ -17,6 +17,8 @@ PYBIND11_MODULE(bindings, m)
 
     def_data(m);
 
+    def_generation(m);
+
     def_memory(m);
 }
 
@@ -15,6 +15,7 @@
 #include "fairseq2n/bindings/type_casters/data.h"
 #include "fairseq2n/bindings/type_casters/immutable_string.h"
 #include "fairseq2n/bindings/type_casters/map_fn.h"
+#include "fairseq2n/bindings/type_casters/predicate_fn.h"
 #include "fairseq2n/bindings/type_casters/py.h"
 #include "fairseq2n/bindings/type_casters/torch.h"
 
@@ -23,6 +24,9 @@ namespace fairseq2n {
 void
 def_audio(pybind11::module_ &data_module);
 
+void
+def_generation(pybind11::module_ &base_module);
+
 void
 def_image(pybind11::module_ &data_module);
 
@@ -47,4 +51,10 @@ def_text_converters(pybind11::module_ &text_module);
 void
 def_text_reader(pybind11::module_ &text_module);
 
+void
+def_text_writer(pybind11::module_ &text_module);
+
+void
+def_video(pybind11::module_ &data_module);
+
 }  // namespace fairseq2n
@@ -0,0 +1,95 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/bindings/type_casters/predicate_fn.h"
+
+#include "fairseq2n/bindings/type_casters/data.h"
+
+namespace py = pybind11;
+
+namespace fairseq2n {
+
+predicate_fn
+predicate_functor_registry::maybe_as_functor(py::handle src)
+{
+    if (auto pos = types_.find(py::type::of(src)); pos != types_.end())
+        return pos->second(src);
+
+    return nullptr;
+}
+
+void
+predicate_functor_registry::register_(py::type &&t, cast_to_predicate_fn &&fn)
+{
+    types_[std::move(t)] = std::move(fn);
+}
+
+predicate_functor_registry &
+predicate_functors() noexcept
+{
+    static predicate_functor_registry registry{};
+
+    return registry;
+}
+
+}  // namespace fairseq2n
+
+using namespace fairseq2n;
+
+namespace pybind11::detail {
+
+bool
+type_caster<predicate_fn>::load(handle src, bool)
+{
+    if (predicate_fn fn = predicate_functors().maybe_as_functor(src); fn != nullptr) {
+        value = std::move(fn);
+
+        return true;
+    }
+
+    // Callable
+    if (isinstance<function>(src)) {
+        class predicate_fn_wrapper {
+        public:
+            explicit
+            predicate_fn_wrapper(function &&fn) noexcept
+              : fn_{std::move(fn)}
+            {}
+
+            predicate_fn_wrapper(const predicate_fn_wrapper &) = default;
+            predicate_fn_wrapper &operator=(const predicate_fn_wrapper &) = default;
+
+            predicate_fn_wrapper(predicate_fn_wrapper &&) = default;
+            predicate_fn_wrapper &operator=(predicate_fn_wrapper &&) = default;
+
+           ~predicate_fn_wrapper()  // NOLINT(bugprone-exception-escape)
+            {
+                gil_scoped_acquire gil{};
+
+                fn_ = {};
+            }
+
+            bool
+            operator()(const data &d)
+            {
+                gil_scoped_acquire gil{};
+
+                return fn_(d).cast<bool>();
+            }
+
+        private:
+            function fn_;
+        };
+
+        value = predicate_fn_wrapper{src.cast<function>()};
+
+        return true;
+    }
+
+    return false;
+}
+
+}  // namespace pybind11::detail
@@ -0,0 +1,99 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+#include <pybind11/pybind11.h>
+
+#include <fairseq2n/data/data_pipeline.h>
+
+namespace fairseq2n {
+
+// Same as `map_functor_registry`, but for C++ functors that are compatible with
+// the `predicate_fn` signature and that can be passed to `filter()`.
+class predicate_functor_registry {
+    using cast_to_predicate_fn = std::function<predicate_fn(pybind11::handle)>;
+
+    struct py_handle_hash {
+        std::size_t
+        operator()(const pybind11::handle &h) const noexcept
+        {
+            return std::hash<void *>{}(h.ptr());
+        }
+    };
+
+public:
+    // Checks if the C++ type of `src` is a registered functor. If yes, returns
+    // `src` as a native callable.
+    predicate_fn
+    maybe_as_functor(pybind11::handle src);
+
+    // Registers `T` as a functor.
+    template <typename T>
+    void
+    register_();
+
+private:
+    void
+    register_(pybind11::type &&t, cast_to_predicate_fn &&fn);
+
+private:
+    std::unordered_map<pybind11::type, cast_to_predicate_fn, py_handle_hash> types_{};
+};
+
+template <typename T>
+void
+predicate_functor_registry::register_()
+{
+    auto fn = [](pybind11::handle src)
+    {
+        return [functor = src.cast<std::shared_ptr<const T>>()](const data &d)
+        {
+            return (*functor)(d);
+        };
+    };
+
+    register_(pybind11::type::of<T>(), std::move(fn));
+}
+
+// The singleton registry instance.
+predicate_functor_registry &
+predicate_functors() noexcept;
+
+}  // namespace fairseq2n
+
+namespace pybind11::detail {
+
+// Similar to `map_fn`, native functors passed to the `filter()` data pipeline
+// operator are called directly in C++ without acquiring GIL.
+template <>
+struct type_caster<fairseq2n::predicate_fn> {
+    PYBIND11_TYPE_CASTER(fairseq2n::predicate_fn, const_name("Callable[[Any], bool]"));
+
+public:
+    bool
+    load(handle src, bool);
+
+    static handle
+    cast(const fairseq2n::predicate_fn &fn, return_value_policy policy, handle)
+    {
+        return cpp_function{fn, policy}.release();
+    }
+
+    static handle
+    cast(fairseq2n::predicate_fn &&fn, return_value_policy policy, handle)
+    {
+        return cpp_function{std::move(fn), policy}.release();
+    }
+};
+
+}  // namespace pybind11::detail
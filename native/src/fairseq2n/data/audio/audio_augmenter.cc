@@ -0,0 +1,269 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/audio/audio_augmenter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+#include <ATen/CPUGeneratorImpl.h>
+#include <ATen/Functions.h>
+#include <ATen/core/TransformationHelper.h>
+
+#include "fairseq2n/fmt.h"
+#include "fairseq2n/span.h"
+#include "fairseq2n/data/file_mapper.h"
+#include "fairseq2n/data/audio/detail/waveform_helpers.h"
+#include "fairseq2n/data/detail/rng.h"
+#include "fairseq2n/data/detail/tensor_helpers.h"
+#include "fairseq2n/detail/exception.h"
+#include "fairseq2n/utils/cast.h"
+
+using namespace fairseq2n::detail;
+
+namespace fairseq2n {
+namespace detail {
+namespace {
+
+std::vector<audio_clip>
+load_clips(const file_mapper &mapper, const std::vector<std::string> &pathnames)
+{
+    std::vector<audio_clip> clips{};
+
+    clips.reserve(pathnames.size());
+
+    for (const std::string &pathname : pathnames) {
+        data output = mapper(pathname);
+
+        clips.emplace_back(pathname, output.as_dict()["data"].as_memory_block());
+    }
+
+    return clips;
+}
+
+}  // namespace
+}  // namespace detail
+
+audio_augmenter::audio_augmenter(
+    const std::vector<std::string> &noise_pathnames,
+    const std::vector<std::string> &rir_pathnames,
+    audio_augmenter_options opts)
+  : opts_{std::move(opts)}
+{
+    if (noise_pathnames.empty() && rir_pathnames.empty())
+        throw_<std::invalid_argument>(
+            "`noise_pathnames` and `rir_pathnames` must not be both empty.");
+
+    if (opts_.noise_probability() < 0.0F || opts_.noise_probability() > 1.0F)
+        throw_<std::invalid_argument>(
+            "`noise_probability` must be greater than or equal to 0 and less than or equal to 1, but is {:G} instead.", opts_.noise_probability());
+
+    if (opts_.reverb_probability() < 0.0F || opts_.reverb_probability() > 1.0F)
+        throw_<std::invalid_argument>(
+            "`reverb_probability` must be greater than or equal to 0 and less than or equal to 1, but is {:G} instead.", opts_.reverb_probability());
+
+    if (opts_.max_snr() < opts_.min_snr())
+        throw_<std::invalid_argument>(
+            "`max_snr` must be greater than or equal to `min_snr` ({:G}), but is {:G} instead.", opts_.min_snr(), opts_.max_snr());
+
+    // The clips share the memory maps of the mapper, which stay alive as long
+    // as the clips do.
+    file_mapper mapper{opts_.maybe_root_dir()};
+
+    noise_clips_ = load_clips(mapper, noise_pathnames);
+
+    rir_clips_ = load_clips(mapper, rir_pathnames);
+
+    std::uint64_t seed = opts_.maybe_seed() ? *opts_.maybe_seed() : pseudo_random();
+
+    generator_ = at::make_generator<at::CPUGeneratorImpl>(seed);
+}
+
+data
+audio_augmenter::operator()(data &&d) const
+{
+    if (!d.is_dict())
+        throw_<std::invalid_argument>(
+            "The input data must be of type `dict` containing a waveform tensor and its sample rate, but is of type `{}` instead.", d.type());
+
+    data_dict &dict = d.as_dict();
+
+    at::Tensor waveform = find_waveform(dict);
+
+    float32 sample_rate = find_sample_rate(dict);
+
+    if (!at::isFloatingType(waveform.scalar_type()))
+        throw_<std::invalid_argument>(
+            "The input waveform must be of a floating-point data type.");
+
+    // `find_waveform()` returns one dimensional waveforms as `(S, 1)`. Note
+    // that `waveform` remains a view of the original tensor, so the operations
+    // below modify it in place.
+    if (dict["waveform"].as_tensor().dim() == 1 || opts_.channel_last())
+        waveform = waveform.transpose(0, 1);
+
+    std::int64_t num_samples = waveform.size(1);
+    if (num_samples == 0)
+        return std::move(d);
+
+    augmentation_plan plan = make_plan(num_samples);
+
+    // Reverberate first; the background noise is not supposed to come from the
+    // same room as the speaker.
+    if (plan.maybe_rir_clip != nullptr) {
+        check_sample_rate(*plan.maybe_rir_clip, sample_rate);
+
+        add_reverb(waveform, *plan.maybe_rir_clip);
+    }
+
+    if (plan.maybe_noise_clip != nullptr) {
+        check_sample_rate(*plan.maybe_noise_clip, sample_rate);
+
+        add_noise(waveform, *plan.maybe_noise_clip, plan.noise_offset, plan.snr);
+    }
+
+    return std::move(d);
+}
+
+audio_augmenter::augmentation_plan
+audio_augmenter::make_plan(std::int64_t num_samples) const
+{
+    // We draw all random numbers for an example in one go so that we hold the
+    // lock only briefly when called from multiple threads.
+    std::lock_guard<std::mutex> generator_lock{generator_.mutex()};
+
+    auto *gen = generator_.get<at::CPUGeneratorImpl>();
+
+    auto random_index = [gen](std::size_t size)
+    {
+        return conditional_cast<std::size_t>(gen->random64()) % size;
+    };
+
+    augmentation_plan plan{};
+
+    if (!rir_clips_.empty()) {
+        float32 sample = at::transformation::uniform_real(gen->random(), 0.0F, 1.0F);
+
+        if (sample < opts_.reverb_probability())
+            plan.maybe_rir_clip = &rir_clips_[random_index(rir_clips_.size())];
+    }
+
+    if (!noise_clips_.empty()) {
+        float32 sample = at::transformation::uniform_real(gen->random(), 0.0F, 1.0F);
+
+        if (sample < opts_.noise_probability()) {
+            const audio_clip &clip = noise_clips_[random_index(noise_clips_.size())];
+
+            if (clip.num_frames() > num_samples) {
+                auto max_offset = static_cast<std::size_t>(clip.num_frames() - num_samples);
+
+                plan.noise_offset = static_cast<std::int64_t>(random_index(max_offset + 1));
+            }
+
+            plan.snr = at::transformation::uniform_real(
+                gen->random(), opts_.min_snr(), opts_.max_snr());
+
+            plan.maybe_noise_clip = &clip;
+        }
+    }
+
+    return plan;
+}
+
+void
+audio_augmenter::add_reverb(at::Tensor &waveform, const audio_clip &rir_clip)
+{
+    at::Tensor rir = rir_clip.decode(0, rir_clip.num_frames());
+
+    span<const float32> rir_data = cast<const float32>(get_raw_storage(rir));
+
+    float64 sum_of_squares = 0.0;
+    for (float32 value : rir_data)
+        sum_of_squares += static_cast<float64>(value) * static_cast<float64>(value);
+
+    if (sum_of_squares == 0.0)
+        return;
+
+    // The strongest reflection is the direct path from the source to the
+    // microphone. We align the output with it so that the reverberant speech
+    // does not lag behind the original one.
+    auto direct_path_pos = std::max_element(rir_data.begin(), rir_data.end(), [](float32 a, float32 b)
+    {
+        return std::abs(a) < std::abs(b);
+    });
+
+    auto direct_path_offset = static_cast<std::int64_t>(direct_path_pos - rir_data.begin());
+
+    // A unit-norm RIR approximately preserves the energy of the waveform.
+    rir = rir.div_(std::sqrt(sum_of_squares)).to(waveform.device());
+
+    std::int64_t num_samples = waveform.size(1);
+
+    // Convolve in the frequency domain; a linear convolution needs the FFT size
+    // to cover the full length of the output.
+    std::int64_t fft_size = num_samples + rir.size(0) - 1;
+
+    at::Tensor spectrum = at::fft_rfft(waveform.to(at::kFloat), fft_size, /*dim=*/-1);
+
+    spectrum.mul_(at::fft_rfft(rir, fft_size, /*dim=*/-1));
+
+    at::Tensor reverberated = at::fft_irfft(spectrum, fft_size, /*dim=*/-1);
+
+    waveform.copy_(reverberated.narrow(-1, direct_path_offset, num_samples));
+}
+
+void
+audio_augmenter::add_noise(
+    at::Tensor &waveform,
+    const audio_clip &noise_clip,
+    std::int64_t noise_offset,
+    float32 snr)
+{
+    std::int64_t num_samples = waveform.size(1);
+
+    at::Tensor noise{};
+
+    if (noise_clip.num_frames() >= num_samples)
+        noise = noise_clip.decode(noise_offset, num_samples);
+    else {
+        // Loop clips that are shorter than the waveform.
+        noise = noise_clip.decode(0, noise_clip.num_frames());
+
+        std::int64_t num_repeats = (num_samples + noise.size(0) - 1) / noise.size(0);
+
+        noise = noise.repeat({num_repeats}).narrow(0, 0, num_samples);
+    }
+
+    auto noise_power = noise.square().mean().item<float64>();
+    if (noise_power == 0.0)
+        return;
+
+    auto signal_power = waveform.to(at::kFloat).square().mean().item<float64>();
+
+    // Scale the noise such that `10 * log10(signal_power / noise_power)` equals
+    // to `snr`.
+    float64 scale = std::sqrt(
+        signal_power / (noise_power * std::pow(10.0, static_cast<float64>(snr) / 10.0)));
+
+    noise = noise.to(waveform.device(), waveform.scalar_type());
+
+    // `noise` gets broadcast over the channels.
+    waveform.add_(noise, scale);
+}
+
+void
+audio_augmenter::check_sample_rate(const audio_clip &clip, float32 sample_rate)
+{
+    if (!are_close(clip.sample_rate(), sample_rate))
+        throw_<std::invalid_argument>(
+            "The sample rate of the audio clip '{}' must match the sample rate of the input waveform ({:G}), but is {:G} instead.", clip.pathname(), sample_rate, clip.sample_rate());
+}
+
+}  // namespace fairseq2n
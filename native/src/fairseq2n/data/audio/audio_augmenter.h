@@ -0,0 +1,206 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ATen/Generator.h>
+#include <ATen/Tensor.h>
+
+#include "fairseq2n/api.h"
+#include "fairseq2n/float.h"
+#include "fairseq2n/data/data.h"
+#include "fairseq2n/data/audio/detail/audio_clip.h"
+
+namespace fairseq2n {
+
+class audio_augmenter_options {
+public:
+    audio_augmenter_options
+    noise_probability(float32 value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.noise_probability_ = value;
+
+        return tmp;
+    }
+
+    float32
+    noise_probability() const noexcept
+    {
+        return noise_probability_;
+    }
+
+    audio_augmenter_options
+    min_snr(float32 value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.min_snr_ = value;
+
+        return tmp;
+    }
+
+    float32
+    min_snr() const noexcept
+    {
+        return min_snr_;
+    }
+
+    audio_augmenter_options
+    max_snr(float32 value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.max_snr_ = value;
+
+        return tmp;
+    }
+
+    float32
+    max_snr() const noexcept
+    {
+        return max_snr_;
+    }
+
+    audio_augmenter_options
+    reverb_probability(float32 value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.reverb_probability_ = value;
+
+        return tmp;
+    }
+
+    float32
+    reverb_probability() const noexcept
+    {
+        return reverb_probability_;
+    }
+
+    audio_augmenter_options
+    channel_last(bool value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.channel_last_ = value;
+
+        return tmp;
+    }
+
+    bool
+    channel_last() const noexcept
+    {
+        return channel_last_;
+    }
+
+    audio_augmenter_options
+    maybe_root_dir(std::optional<std::filesystem::path> value)
+    {
+        auto tmp = *this;
+
+        tmp.maybe_root_dir_ = std::move(value);
+
+        return tmp;
+    }
+
+    const std::optional<std::filesystem::path> &
+    maybe_root_dir() const noexcept
+    {
+        return maybe_root_dir_;
+    }
+
+    audio_augmenter_options
+    maybe_seed(std::optional<std::uint64_t> value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.maybe_seed_ = value;
+
+        return tmp;
+    }
+
+    std::optional<std::uint64_t>
+    maybe_seed() const noexcept
+    {
+        return maybe_seed_;
+    }
+
+private:
+    float32 noise_probability_ = 1.0F;
+    float32 min_snr_ = 5.0F;
+    float32 max_snr_ = 20.0F;
+    float32 reverb_probability_ = 1.0F;
+    bool channel_last_ = false;
+    std::optional<std::filesystem::path> maybe_root_dir_{};
+    std::optional<std::uint64_t> maybe_seed_{};
+};
+
+// Adds background noise at a random signal-to-noise ratio and/or reverberation
+// to the waveform of a `dict` holding a waveform tensor and its sample rate. The
+// waveform is modified in place.
+//
+// The noise and room impulse response (RIR) clips are given as pathnames with
+// optional offset and size specifiers as accepted by `file_mapper`. They are
+// memory mapped once on construction and only the region of a clip that is
+// mixed into a waveform gets decoded. A clip must have the same sample rate as
+// the waveforms it is applied to.
+//
+// The augmenter is safe to use with `map()` with `num_parallel_calls` greater
+// than 1. Note though that, in such case, the order in which the examples draw
+// from the random number generator is not deterministic even if a seed is
+// specified.
+class FAIRSEQ2_API audio_augmenter {
+public:
+    explicit
+    audio_augmenter(
+        const std::vector<std::string> &noise_pathnames,
+        const std::vector<std::string> &rir_pathnames,
+        audio_augmenter_options opts = {});
+
+    data
+    operator()(data &&d) const;
+
+private:
+    struct augmentation_plan {
+        const detail::audio_clip *maybe_noise_clip{};
+        std::int64_t noise_offset{};
+        float32 snr{};
+        const detail::audio_clip *maybe_rir_clip{};
+    };
+
+    augmentation_plan
+    make_plan(std::int64_t num_samples) const;
+
+    static void
+    add_reverb(at::Tensor &waveform, const detail::audio_clip &rir_clip);
+
+    static void
+    add_noise(
+        at::Tensor &waveform,
+        const detail::audio_clip &noise_clip,
+        std::int64_t noise_offset,
+        float32 snr);
+
+    static void
+    check_sample_rate(const detail::audio_clip &clip, float32 sample_rate);
+
+private:
+    std::vector<detail::audio_clip> noise_clips_{};
+    std::vector<detail::audio_clip> rir_clips_{};
+    audio_augmenter_options opts_;
+    mutable at::Generator generator_;
+};
+
+}  // namespace fairseq2n
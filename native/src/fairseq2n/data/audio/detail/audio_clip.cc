@@ -0,0 +1,75 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/audio/detail/audio_clip.h"
+
+#include <stdexcept>
+#include <utility>
+
+#include <ATen/Functions.h>
+
+#include "fairseq2n/span.h"
+#include "fairseq2n/data/audio/detail/sndfile.h"
+#include "fairseq2n/data/detail/tensor_helpers.h"
+#include "fairseq2n/detail/exception.h"
+#include "fairseq2n/utils/cast.h"
+
+namespace fairseq2n::detail {
+namespace {
+
+sndfile
+open_clip(const std::string &pathname, const memory_block &block)
+{
+    try {
+        return sndfile::from_memory(block);
+    } catch (const std::invalid_argument &) {
+        throw_with_nested<std::invalid_argument>(
+            "The audio clip '{}' cannot be decoded. See nested exception for details.", pathname);
+    } catch (const std::runtime_error &) {
+        throw_with_nested<std::invalid_argument>(
+            "The audio clip '{}' cannot be decoded. See nested exception for details.", pathname);
+    }
+}
+
+}  // namespace
+
+audio_clip::audio_clip(std::string pathname, memory_block block)
+  : pathname_{std::move(pathname)}, block_{std::move(block)}
+{
+    sndfile file = open_clip(pathname_, block_);
+
+    num_frames_ = file.num_frames();
+
+    if (num_frames_ == 0)
+        throw_<std::invalid_argument>(
+            "The audio clip '{}' must have at least one frame.", pathname_);
+
+    num_channels_ = file.num_channels();
+
+    sample_rate_ = static_cast<float32>(file.sample_rate());
+}
+
+at::Tensor
+audio_clip::decode(std::int64_t frame_offset, std::int64_t num_frames) const
+{
+    // Opening a clip only parses its header, which is cheap compared to the
+    // decoding itself; this way the clip is safe to use from multiple threads.
+    sndfile file = open_clip(pathname_, block_);
+
+    at::Tensor frames = at::empty({num_frames, num_channels_},
+        at::dtype(at::kFloat).device(at::kCPU));
+
+    span frames_data = cast<float32>(get_raw_mutable_storage(frames));
+
+    file.decode_into(frames_data, frame_offset);
+
+    if (num_channels_ == 1)
+        return frames.squeeze(-1);
+
+    return frames.mean(-1);
+}
+
+}  // namespace fairseq2n::detail
@@ -0,0 +1,59 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <ATen/Tensor.h>
+
+#include "fairseq2n/float.h"
+#include "fairseq2n/memory.h"
+
+namespace fairseq2n::detail {
+
+// Represents an encoded audio clip (e.g. a noise recording or a room impulse
+// response) held in memory, typically a memory map of its file. Only the header
+// of the clip is parsed on construction; its frames are decoded on demand.
+class audio_clip {
+public:
+    explicit
+    audio_clip(std::string pathname, memory_block block);
+
+    // Decodes `num_frames` frames starting at `frame_offset`, mixes them down
+    // to mono, and returns them as a CPU tensor of shape `(num_frames)` in
+    // single precision.
+    at::Tensor
+    decode(std::int64_t frame_offset, std::int64_t num_frames) const;
+
+    const std::string &
+    pathname() const noexcept
+    {
+        return pathname_;
+    }
+
+    std::int64_t
+    num_frames() const noexcept
+    {
+        return num_frames_;
+    }
+
+    float32
+    sample_rate() const noexcept
+    {
+        return sample_rate_;
+    }
+
+private:
+    std::string pathname_;
+    memory_block block_;
+    std::int64_t num_frames_{};
+    std::int64_t num_channels_{};
+    float32 sample_rate_{};
+};
+
+}  // namespace fairseq2n::detail
@@ -151,6 +151,29 @@ sndfile::decode_into(span<std::int16_t> target)
             "`sndfile` has failed to decode the input audio. Please file a bug report.");
 }
 
+void
+sndfile::decode_into(span<float32> target, std::int64_t frame_offset)
+{
+    auto num_frames = static_cast<::sf_count_t>(target.size()) / audio_info_.channels;
+
+    if (frame_offset < 0 || frame_offset + num_frames > audio_info_.frames)
+        throw_<internal_error>(
+            "`sndfile` has been asked to decode a region outside of the input audio. Please file a bug report.");
+
+    if (::sf_seek(handle_, frame_offset, SEEK_SET) == -1) {
+        check_handle();
+
+        throw_<std::runtime_error>(
+            "The input audio does not support random access.");
+    }
+
+    ::sf_count_t num_frames_decoded = ::sf_readf_float(handle_, target.data(), num_frames);
+
+    if (num_frames_decoded != num_frames)
+        throw_<internal_error>(
+            "`sndfile` has failed to decode the input audio. Please file a bug report.");
+}
+
 void
 sndfile::check_handle(::SNDFILE *handle)
 {
@@ -108,6 +108,12 @@ public:
     void
     decode_into(span<std::int32_t> target);
 
+    // Decodes `target.size() / num_channels()` frames starting at
+    // `frame_offset`; unlike the overloads above, only the requested region of
+    // the audio is decoded.
+    void
+    decode_into(span<float32> target, std::int64_t frame_offset);
+
     std::int64_t
     num_frames() const noexcept
     {
@@ -0,0 +1,283 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/audio/detail/voice_activity_data_source.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+#include "fairseq2n/span.h"
+#include "fairseq2n/data/audio/detail/waveform_helpers.h"
+#include "fairseq2n/data/detail/tensor_helpers.h"
+#include "fairseq2n/detail/parallel.h"
+#include "fairseq2n/utils/cast.h"
+
+namespace fairseq2n::detail {
+namespace {
+
+std::int64_t
+to_num_samples(float32 duration, float32 sample_rate) noexcept
+{
+    return static_cast<std::int64_t>(std::lround(static_cast<float64>(duration) * static_cast<float64>(sample_rate)));
+}
+
+}  // namespace
+
+voice_activity_data_source::voice_activity_data_source(
+    data_dict &&dict, float32 sample_rate, const vad_options &opts)
+  : dict_{std::move(dict)}, opts_{opts}
+{
+    waveform_ = find_waveform(dict_);
+
+    is_one_dimensional_ = dict_["waveform"].as_tensor().dim() == 1;
+
+    // `find_waveform()` returns one dimensional waveforms as `(S, 1)`.
+    bool channel_last = is_one_dimensional_ || opts_.channel_last();
+
+    sample_dim_ = channel_last ? 0 : 1;
+
+    num_samples_ = waveform_.size(sample_dim_);
+
+    frame_length_ = std::max(to_num_samples(opts_.frame_duration(), sample_rate), std::int64_t{1});
+
+    auto to_num_frames = [this, sample_rate](float32 duration)
+    {
+        return to_num_samples(duration, sample_rate) / frame_length_;
+    };
+
+    min_silence_frames_ = std::max(to_num_frames(opts_.min_silence_duration()), std::int64_t{1});
+    min_segment_frames_ = to_num_frames(opts_.min_segment_duration());
+    max_segment_frames_ = std::max(to_num_frames(opts_.max_segment_duration()), std::int64_t{2});
+
+    padding_samples_ = to_num_samples(opts_.padding_duration(), sample_rate);
+
+    compute_frame_features(prepare_waveform(dict_, channel_last, opts_.waveform_scale()));
+}
+
+void
+voice_activity_data_source::compute_frame_features(const at::Tensor &waveform)
+{
+    auto num_channels = static_cast<std::size_t>(waveform.size(0));
+
+    auto num_samples = static_cast<std::size_t>(num_samples_);
+
+    auto frame_length = static_cast<std::size_t>(frame_length_);
+
+    std::size_t num_frames = (num_samples + frame_length - 1) / frame_length;
+
+    energies_.resize(num_frames);
+
+    zero_crossing_rates_.resize(num_frames);
+
+    span<const float32> samples = cast<const float32>(get_raw_storage(waveform));
+
+    auto compute_features = [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t frame_nr = begin; frame_nr < end; ++frame_nr) {
+            std::size_t offset = frame_nr * frame_length;
+
+            std::size_t size = std::min(frame_length, num_samples - offset);
+
+            float64 sum_of_squares = 0.0;
+
+            std::size_t num_crossings = 0;
+
+            bool was_negative = false;
+
+            for (std::size_t i = offset; i < offset + size; ++i) {
+                // Mix down to mono.
+                float64 sample = 0.0;
+                for (std::size_t c = 0; c < num_channels; ++c)
+                    sample += static_cast<float64>(samples[c * num_samples + i]);
+
+                sample /= static_cast<float64>(num_channels);
+
+                sum_of_squares += sample * sample;
+
+                bool is_negative = sample < 0.0;
+                if (i > offset && is_negative != was_negative)
+                    num_crossings++;
+
+                was_negative = is_negative;
+            }
+
+            float64 mean_square = sum_of_squares / static_cast<float64>(size);
+
+            // Avoid -inf for digital silence; -100 dB is well below any
+            // sensible threshold.
+            energies_[frame_nr] = static_cast<float32>(10.0 * std::log10(mean_square + 1e-10));
+
+            if (size > 1)
+                zero_crossing_rates_[frame_nr] =
+                    static_cast<float32>(num_crossings) / static_cast<float32>(size - 1);
+            else
+                zero_crossing_rates_[frame_nr] = 0.0F;
+        }
+    };
+
+    parallel_for<std::size_t>(compute_features, num_frames);
+}
+
+std::optional<data>
+voice_activity_data_source::next()
+{
+    auto num_frames = static_cast<std::int64_t>(energies_.size());
+
+    while (frame_nr_ < num_frames) {
+        std::int64_t start_frame = frame_nr_;
+
+        bool is_continuation = is_split_;
+
+        // Unless we continue a segment that we had to split, look for the
+        // beginning of the next one.
+        if (!is_continuation) {
+            while (start_frame < num_frames && !is_start_frame(start_frame))
+                start_frame++;
+
+            if (start_frame == num_frames) {
+                frame_nr_ = num_frames;
+
+                return std::nullopt;
+            }
+        }
+
+        is_split_ = false;
+
+        std::int64_t end_frame = num_frames;
+
+        std::int64_t last_active_frame = start_frame;
+
+        for (std::int64_t f = start_frame + 1; f < num_frames; f++) {
+            if (is_active_frame(f))
+                last_active_frame = f;
+            else if (f - last_active_frame >= min_silence_frames_) {
+                end_frame = last_active_frame + 1;
+
+                break;
+            }
+
+            if (f - start_frame + 1 >= max_segment_frames_) {
+                end_frame = find_quietest_frame(start_frame + max_segment_frames_ / 2, f + 1);
+
+                is_split_ = true;
+
+                break;
+            }
+        }
+
+        if (end_frame == num_frames)
+            end_frame = std::min(last_active_frame + 1, num_frames);
+
+        frame_nr_ = end_frame;
+
+        // The pieces of a split segment are never dropped.
+        if (end_frame - start_frame < min_segment_frames_ && !is_split_ && !is_continuation)
+            continue;
+
+        std::int64_t start_sample = start_frame * frame_length_;
+        std::int64_t end_sample = std::min(end_frame * frame_length_, num_samples_);
+
+        // The pieces of a split segment are contiguous, so we pad only at the
+        // actual boundaries of the segment.
+        if (!is_continuation)
+            start_sample = std::max(start_sample - padding_samples_, prev_end_sample_);
+
+        if (!is_split_)
+            end_sample = std::min(end_sample + padding_samples_, num_samples_);
+
+        prev_end_sample_ = end_sample;
+
+        return make_segment(start_sample, end_sample);
+    }
+
+    return std::nullopt;
+}
+
+void
+voice_activity_data_source::reset(bool)
+{
+    frame_nr_ = 0;
+
+    is_split_ = false;
+
+    prev_end_sample_ = 0;
+}
+
+void
+voice_activity_data_source::record_position(tape &t, bool) const
+{
+    t.record(frame_nr_);
+
+    t.record(is_split_);
+
+    t.record(prev_end_sample_);
+}
+
+void
+voice_activity_data_source::reload_position(tape &t, bool)
+{
+    frame_nr_ = t.read<std::int64_t>();
+
+    is_split_ = t.read<bool>();
+
+    prev_end_sample_ = t.read<std::int64_t>();
+}
+
+bool
+voice_activity_data_source::is_infinite() const noexcept
+{
+    return false;
+}
+
+bool
+voice_activity_data_source::is_start_frame(std::int64_t frame_nr) const noexcept
+{
+    auto idx = static_cast<std::size_t>(frame_nr);
+
+    return energies_[idx] >= opts_.start_threshold() &&
+        zero_crossing_rates_[idx] <= opts_.max_zero_crossing_rate();
+}
+
+bool
+voice_activity_data_source::is_active_frame(std::int64_t frame_nr) const noexcept
+{
+    return energies_[static_cast<std::size_t>(frame_nr)] >= opts_.end_threshold();
+}
+
+std::int64_t
+voice_activity_data_source::find_quietest_frame(std::int64_t begin, std::int64_t end) const noexcept
+{
+    // Search backwards so that, on ties, we keep the pieces as long as
+    // possible.
+    auto first = energies_.rbegin() + static_cast<std::ptrdiff_t>(energies_.size()) - end;
+    auto last  = energies_.rbegin() + static_cast<std::ptrdiff_t>(energies_.size()) - begin;
+
+    return end - 1 - (std::min_element(first, last) - first);
+}
+
+data
+voice_activity_data_source::make_segment(std::int64_t start_sample, std::int64_t end_sample) const
+{
+    data_dict segment = dict_;
+
+    // A view of the original waveform; no copy is made.
+    at::Tensor waveform = waveform_.narrow(sample_dim_, start_sample, end_sample - start_sample);
+
+    // Restore the original rank of one dimensional waveforms.
+    if (is_one_dimensional_)
+        waveform = waveform.squeeze(1 - sample_dim_);
+
+    segment["waveform"] = std::move(waveform);
+
+    segment["start_sample"] = start_sample;
+    segment["end_sample"] = end_sample;
+
+    return segment;
+}
+
+}  // namespace fairseq2n::detail
@@ -0,0 +1,77 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <ATen/Tensor.h>
+
+#include "fairseq2n/float.h"
+#include "fairseq2n/data/data.h"
+#include "fairseq2n/data/data_source.h"
+#include "fairseq2n/data/audio/voice_activity_segmenter.h"
+
+namespace fairseq2n::detail {
+
+class voice_activity_data_source final : public data_source {
+public:
+    explicit
+    voice_activity_data_source(data_dict &&dict, float32 sample_rate, const vad_options &opts);
+
+    std::optional<data>
+    next() override;
+
+    void
+    reset(bool reset_rng) override;
+
+    void
+    record_position(tape &t, bool strict) const override;
+
+    void
+    reload_position(tape &t, bool strict) override;
+
+    bool
+    is_infinite() const noexcept override;
+
+private:
+    void
+    compute_frame_features(const at::Tensor &waveform);
+
+    bool
+    is_start_frame(std::int64_t frame_nr) const noexcept;
+
+    bool
+    is_active_frame(std::int64_t frame_nr) const noexcept;
+
+    std::int64_t
+    find_quietest_frame(std::int64_t begin, std::int64_t end) const noexcept;
+
+    data
+    make_segment(std::int64_t start_sample, std::int64_t end_sample) const;
+
+private:
+    data_dict dict_;
+    at::Tensor waveform_;
+    bool is_one_dimensional_;
+    std::int64_t sample_dim_;
+    std::int64_t num_samples_;
+    vad_options opts_;
+    std::int64_t frame_length_;
+    std::int64_t min_silence_frames_;
+    std::int64_t min_segment_frames_;
+    std::int64_t max_segment_frames_;
+    std::int64_t padding_samples_;
+    std::vector<float32> energies_{};
+    std::vector<float32> zero_crossing_rates_{};
+    std::int64_t frame_nr_ = 0;
+    bool is_split_ = false;
+    std::int64_t prev_end_sample_ = 0;
+};
+
+}  // namespace fairseq2n::detail
@@ -0,0 +1,85 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/audio/detail/waveform_helpers.h"
+
+#include <stdexcept>
+
+#include "fairseq2n/fmt.h"
+#include "fairseq2n/detail/exception.h"
+
+namespace fairseq2n::detail {
+
+at::Tensor
+find_waveform(data_dict &dict)
+{
+    auto pos = dict.find("waveform");
+    if (pos == dict.end())
+        throw_<std::invalid_argument>(
+            "The input dictionary must contain the waveform under a key named `waveform`, but does not contain such key.");
+
+    data &element = pos->second;
+    if (!element.is_tensor())
+        throw_<std::invalid_argument>(
+            "The input waveform must be of type `torch.Tensor`, but is of type `{}` instead.", element.type());
+
+    at::Tensor &waveform = element.as_tensor();
+
+    if (waveform.dim() == 1)
+        return waveform.unsqueeze(-1);
+
+    if (waveform.dim() != 2)
+        throw_<std::invalid_argument>(
+            "The input waveform must be two dimensional, but has {} dimension(s) instead.", waveform.dim());
+
+    return waveform;
+}
+
+float32
+find_sample_rate(const data_dict &dict)
+{
+    auto pos = dict.find("sample_rate");
+    if (pos == dict.end())
+        throw_<std::invalid_argument>(
+            "The input dictionary must contain the waveform sample rate under a key named `sample_rate`, but does not contain such key.");
+
+    const data &element = pos->second;
+    if (!element.is_float() && !element.is_int())
+        throw_<std::invalid_argument>(
+            "The input sample rate must be of type `float` or `int`, but is of type `{}` instead.", element.type());
+
+    float64 fp64_sample_rate{};
+    if (element.is_float())
+        fp64_sample_rate = element.as_float();
+    else
+        fp64_sample_rate = static_cast<float64>(element.as_int());
+
+    float32 sample_rate{};
+    if (!maybe_narrow(fp64_sample_rate, sample_rate))
+        throw_<std::invalid_argument>(
+            "The input sample rate must be representable in single precision (32-bit), but is {:G} instead.", fp64_sample_rate);
+
+    return sample_rate;
+}
+
+at::Tensor
+prepare_waveform(data_dict &dict, bool channel_last, float32 scale)
+{
+    at::Tensor waveform = find_waveform(dict);
+
+    if (channel_last)
+        waveform = waveform.transpose(0, 1);
+
+    waveform = waveform.to(
+        at::kCPU, at::kFloat, /*non_blocking=*/false, /*copy=*/false, at::MemoryFormat::Contiguous);
+
+    if (!are_close(scale, 1.0F))
+        waveform = waveform.multiply(scale);
+
+    return waveform;
+}
+
+}  // namespace fairseq2n::detail
@@ -0,0 +1,30 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <ATen/Tensor.h>
+
+#include "fairseq2n/float.h"
+#include "fairseq2n/data/data.h"
+
+namespace fairseq2n::detail {
+
+// The helpers below are shared by the converters that compute features from a
+// `dict` holding a waveform tensor and its sample rate.
+
+at::Tensor
+find_waveform(data_dict &dict);
+
+float32
+find_sample_rate(const data_dict &dict);
+
+// Returns the waveform in `dict` as a contiguous CPU tensor of shape
+// `(num_channels, num_samples)` in single precision, scaled by `scale`.
+at::Tensor
+prepare_waveform(data_dict &dict, bool channel_last, float32 scale);
+
+}  // namespace fairseq2n::detail
@@ -0,0 +1,64 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/audio/voice_activity_segmenter.h"
+
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "fairseq2n/fmt.h"
+#include "fairseq2n/data/audio/detail/voice_activity_data_source.h"
+#include "fairseq2n/data/audio/detail/waveform_helpers.h"
+#include "fairseq2n/detail/exception.h"
+
+using namespace fairseq2n::detail;
+
+namespace fairseq2n {
+
+voice_activity_segmenter::voice_activity_segmenter(vad_options opts)
+  : opts_{opts}
+{
+    if (opts_.frame_duration() <= 0.0F)
+        throw_<std::invalid_argument>(
+            "`frame_duration` must be greater than 0, but is {:G} instead.", opts_.frame_duration());
+
+    if (opts_.end_threshold() > opts_.start_threshold())
+        throw_<std::invalid_argument>(
+            "`end_threshold` must be less than or equal to `start_threshold` ({:G}), but is {:G} instead.", opts_.start_threshold(), opts_.end_threshold());
+
+    if (opts_.max_segment_duration() < opts_.min_segment_duration())
+        throw_<std::invalid_argument>(
+            "`max_segment_duration` must be greater than or equal to `min_segment_duration` ({:G}), but is {:G} instead.", opts_.min_segment_duration(), opts_.max_segment_duration());
+}
+
+data_pipeline
+voice_activity_segmenter::operator()(const data &d) const
+{
+    if (!d.is_dict())
+        throw_<std::invalid_argument>(
+            "The input data must be of type `dict` containing a waveform tensor and its sample rate, but is of type `{}` instead.", d.type());
+
+    data_dict dict = d.as_dict();
+
+    float32 sample_rate = find_sample_rate(dict);
+    if (sample_rate <= 0.0F)
+        throw_<std::invalid_argument>(
+            "The input sample rate must be greater than 0, but is {:G} instead.", sample_rate);
+
+    // Validate the waveform eagerly; the frame features are computed lazily
+    // when the pipeline is first iterated.
+    find_waveform(dict);
+
+    auto factory = [dict = std::move(dict), sample_rate, opts = opts_]()
+    {
+        return std::make_unique<voice_activity_data_source>(data_dict{dict}, sample_rate, opts);
+    };
+
+    return data_pipeline_builder{std::move(factory)}.and_return();
+}
+
+}  // namespace fairseq2n
@@ -0,0 +1,221 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include "fairseq2n/api.h"
+#include "fairseq2n/float.h"
+#include "fairseq2n/data/data.h"
+#include "fairseq2n/data/data_pipeline.h"
+
+namespace fairseq2n {
+
+// The durations are in seconds and the thresholds in decibels relative to a
+// full-scale (i.e. [-1, 1]) waveform.
+class vad_options {
+public:
+    vad_options
+    frame_duration(float32 value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.frame_duration_ = value;
+
+        return tmp;
+    }
+
+    float32
+    frame_duration() const noexcept
+    {
+        return frame_duration_;
+    }
+
+    vad_options
+    start_threshold(float32 value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.start_threshold_ = value;
+
+        return tmp;
+    }
+
+    float32
+    start_threshold() const noexcept
+    {
+        return start_threshold_;
+    }
+
+    vad_options
+    end_threshold(float32 value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.end_threshold_ = value;
+
+        return tmp;
+    }
+
+    float32
+    end_threshold() const noexcept
+    {
+        return end_threshold_;
+    }
+
+    vad_options
+    max_zero_crossing_rate(float32 value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.max_zero_crossing_rate_ = value;
+
+        return tmp;
+    }
+
+    float32
+    max_zero_crossing_rate() const noexcept
+    {
+        return max_zero_crossing_rate_;
+    }
+
+    vad_options
+    min_silence_duration(float32 value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.min_silence_duration_ = value;
+
+        return tmp;
+    }
+
+    float32
+    min_silence_duration() const noexcept
+    {
+        return min_silence_duration_;
+    }
+
+    vad_options
+    min_segment_duration(float32 value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.min_segment_duration_ = value;
+
+        return tmp;
+    }
+
+    float32
+    min_segment_duration() const noexcept
+    {
+        return min_segment_duration_;
+    }
+
+    vad_options
+    max_segment_duration(float32 value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.max_segment_duration_ = value;
+
+        return tmp;
+    }
+
+    float32
+    max_segment_duration() const noexcept
+    {
+        return max_segment_duration_;
+    }
+
+    vad_options
+    padding_duration(float32 value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.padding_duration_ = value;
+
+        return tmp;
+    }
+
+    float32
+    padding_duration() const noexcept
+    {
+        return padding_duration_;
+    }
+
+    vad_options
+    waveform_scale(float32 value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.waveform_scale_ = value;
+
+        return tmp;
+    }
+
+    float32
+    waveform_scale() const noexcept
+    {
+        return waveform_scale_;
+    }
+
+    vad_options
+    channel_last(bool value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.channel_last_ = value;
+
+        return tmp;
+    }
+
+    bool
+    channel_last() const noexcept
+    {
+        return channel_last_;
+    }
+
+private:
+    float32 frame_duration_ = 0.02F;
+    float32 start_threshold_ = -35.0F;
+    float32 end_threshold_ = -45.0F;
+    float32 max_zero_crossing_rate_ = 0.4F;
+    float32 min_silence_duration_ = 0.3F;
+    float32 min_segment_duration_ = 0.25F;
+    float32 max_segment_duration_ = 30.0F;
+    float32 padding_duration_ = 0.1F;
+    float32 waveform_scale_ = 1.0F;
+    bool channel_last_ = false;
+};
+
+// Splits a waveform into voiced segments using the energy and the zero-crossing
+// rate of fixed-size frames.
+//
+// A segment starts at a frame whose energy is at least `start_threshold` and
+// whose zero-crossing rate is at most `max_zero_crossing_rate`, and ends once
+// the energy stays below `end_threshold` for `min_silence_duration`. Segments
+// shorter than `min_segment_duration` are dropped; segments longer than
+// `max_segment_duration` are split at their quietest frame in the second half.
+// Each segment is padded by `padding_duration` on both sides, without
+// overlapping its predecessor.
+//
+// The input is a `dict` with a waveform and its sample rate. The returned data
+// pipeline lazily yields a copy of that `dict` per segment, where the waveform
+// is replaced by a view of the segment and `start_sample` and `end_sample` hold
+// its offsets in the original waveform. Since its signature matches `yield_fn`,
+// a segmenter can be passed to `data_pipeline_builder::yield_from()`.
+class FAIRSEQ2_API voice_activity_segmenter {
+public:
+    explicit
+    voice_activity_segmenter(vad_options opts = {});
+
+    data_pipeline
+    operator()(const data &d) const;
+
+private:
+    vad_options opts_;
+};
+
+}  // namespace fairseq2n
@@ -17,6 +17,7 @@
 #include "fairseq2n/fmt.h"
 #include "fairseq2n/detail/exception.h"
 #include "fairseq2n/data/audio/detail/kaldi_fbank.h"
+#include "fairseq2n/data/audio/detail/waveform_helpers.h"
 
 using namespace fairseq2n::detail;
 
@@ -54,16 +55,7 @@ waveform_to_fbank_converter::operator()(data &&d) const
                 "The input waveform must have a sample rate of {}, but has a sample rate of {:G} instead.", computer_->sample_rate(), sample_rate);
     }
 
-    at::Tensor waveform = find_waveform(dict);
-
-    if (opts_.channel_last())
-        waveform = waveform.transpose(0, 1);
-
-    waveform = waveform.to(
-        at::kCPU, at::kFloat, /*non_blocking=*/false, /*copy=*/false, at::MemoryFormat::Contiguous);
-
-    if (!are_close(opts_.waveform_scale(), 1.0F))
-        waveform = waveform.multiply(opts_.waveform_scale());
+    at::Tensor waveform = prepare_waveform(dict, opts_.channel_last(), opts_.waveform_scale());
 
     at::Tensor fbank = computer_->compute(waveform, opts_.pin_memory());
 
@@ -94,58 +86,6 @@ waveform_to_fbank_converter::operator()(data &&d) const
     return std::move(d);
 }
 
-at::Tensor
-waveform_to_fbank_converter::find_waveform(data_dict &dict)
-{
-    auto pos = dict.find("waveform");
-    if (pos == dict.end())
-        throw_<std::invalid_argument>(
-            "The input dictionary must contain the waveform under a key named `waveform`, but does not contain such key.");
-
-    data &element = pos->second;
-    if (!element.is_tensor())
-        throw_<std::invalid_argument>(
-            "The input waveform must be of type `torch.Tensor`, but is of type `{}` instead.", element.type());
-
-    at::Tensor &waveform = element.as_tensor();
-
-    if (waveform.dim() == 1)
-        return waveform.unsqueeze(-1);
-
-    if (waveform.dim() != 2)
-        throw_<std::invalid_argument>(
-            "The input waveform must be two dimensional, but has {} dimension(s) instead.", waveform.dim());
-
-    return waveform;
-}
-
-float32
-waveform_to_fbank_converter::find_sample_rate(const data_dict &dict)
-{
-    auto pos = dict.find("sample_rate");
-    if (pos == dict.end())
-        throw_<std::invalid_argument>(
-            "The input dictionary must contain the waveform sample rate under a key named `sample_rate`, but does not contain such key.");
-
-    const data &element = pos->second;
-    if (!element.is_float() && !element.is_int())
-        throw_<std::invalid_argument>(
-            "The input sample rate must be of type `float` or `int`, but is of type `{}` instead.", element.type());
-
-    float64 fp64_sample_rate{};
-    if (element.is_float())
-        fp64_sample_rate = element.as_float();
-    else
-        fp64_sample_rate = static_cast<float64>(element.as_int());
-
-    float32 sample_rate{};
-    if (!maybe_narrow(fp64_sample_rate, sample_rate))
-        throw_<std::invalid_argument>(
-            "The input sample rate must be representable in single precision (32-bit), but is {:G} instead.", fp64_sample_rate);
-
-    return sample_rate;
-}
-
 void
 waveform_to_fbank_converter::init_computer(float32 sample_rate) const
 {
@@ -184,12 +184,6 @@ public:
     operator()(data &&d) const;
 
 private:
-    static at::Tensor
-    find_waveform(data_dict &dict);
-
-    static float32
-    find_sample_rate(const data_dict &dict);
-
     void
     init_computer(float32 sample_rate) const;
 
@@ -0,0 +1,240 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/audio/waveform_to_log_mel_converter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <ATen/Functions.h>
+#include <ATen/Tensor.h>
+
+#include "fairseq2n/fmt.h"
+#include "fairseq2n/span.h"
+#include "fairseq2n/data/audio/detail/waveform_helpers.h"
+#include "fairseq2n/data/detail/tensor_helpers.h"
+#include "fairseq2n/detail/exception.h"
+#include "fairseq2n/utils/cast.h"
+
+using namespace fairseq2n::detail;
+
+namespace fairseq2n {
+namespace detail {
+namespace {
+
+// The mel scale of Slaney's Auditory Toolbox, which is linear below 1 kHz and
+// logarithmic above; this is also the default of librosa.
+constexpr float64 slaney_f_sp = 200.0 / 3.0;
+constexpr float64 slaney_min_log_hz = 1000.0;
+constexpr float64 slaney_min_log_mel = slaney_min_log_hz / slaney_f_sp;
+
+inline float64
+slaney_log_step() noexcept
+{
+    return std::log(6.4) / 27.0;
+}
+
+inline float64
+hz_to_mel(float64 hz) noexcept
+{
+    if (hz < slaney_min_log_hz)
+        return hz / slaney_f_sp;
+
+    return slaney_min_log_mel + std::log(hz / slaney_min_log_hz) / slaney_log_step();
+}
+
+inline float64
+mel_to_hz(float64 mel) noexcept
+{
+    if (mel < slaney_min_log_mel)
+        return mel * slaney_f_sp;
+
+    return slaney_min_log_hz * std::exp(slaney_log_step() * (mel - slaney_min_log_mel));
+}
+
+// Returns the same filters as `librosa.filters.mel(sr, n_fft, n_mels)`, which
+// is what Whisper ships in its `mel_filters.npz`.
+// *Shape:* (num_mel_bins, num_fft / 2 + 1)
+at::Tensor
+make_slaney_mel_filters(float32 sample_rate, std::int32_t num_fft, std::int32_t num_mel_bins)
+{
+    auto num_bins = static_cast<std::size_t>(num_mel_bins);
+
+    std::size_t num_freqs = static_cast<std::size_t>(num_fft) / 2 + 1;
+
+    auto sr = static_cast<float64>(sample_rate);
+
+    // The center frequencies of the filters, plus their two outer edges, evenly
+    // spaced on the mel scale between 0 and the Nyquist frequency.
+    std::vector<float64> mel_freqs(num_bins + 2);
+
+    float64 mel_step = hz_to_mel(sr / 2.0) / static_cast<float64>(num_bins + 1);
+
+    for (std::size_t i = 0; i < mel_freqs.size(); ++i)
+        mel_freqs[i] = mel_to_hz(static_cast<float64>(i) * mel_step);
+
+    at::Tensor filters = at::empty({num_mel_bins, static_cast<std::int64_t>(num_freqs)},
+        at::dtype(at::kFloat).device(at::kCPU));
+
+    span filters_data = cast<float32>(get_raw_mutable_storage(filters));
+
+    for (std::size_t i = 0; i < num_bins; ++i) {
+        float64 lower_width = mel_freqs[i + 1] - mel_freqs[i];
+        float64 upper_width = mel_freqs[i + 2] - mel_freqs[i + 1];
+
+        // Normalize each filter to have a constant energy per band.
+        float64 norm = 2.0 / (mel_freqs[i + 2] - mel_freqs[i]);
+
+        for (std::size_t j = 0; j < num_freqs; ++j) {
+            float64 hz = static_cast<float64>(j) * (sr / static_cast<float64>(num_fft));
+
+            float64 lower = (hz - mel_freqs[i]) / lower_width;
+            float64 upper = (mel_freqs[i + 2] - hz) / upper_width;
+
+            // librosa rounds the weight to single precision before normalizing
+            // it; we do the same to produce bit-identical filters.
+            auto weight = static_cast<float32>(std::max(0.0, std::min(lower, upper)));
+
+            filters_data[i * num_freqs + j] = static_cast<float32>(static_cast<float64>(weight) * norm);
+        }
+    }
+
+    return filters;
+}
+
+}  // namespace
+}  // namespace detail
+
+struct waveform_to_log_mel_converter::filter_bank {
+    float32 sample_rate;
+    at::Tensor mel_filters;
+    at::Tensor window;
+};
+
+waveform_to_log_mel_converter::waveform_to_log_mel_converter(log_mel_options opts)
+  : opts_{opts}
+{
+    if (opts_.num_mel_bins() <= 0)
+        throw_<std::invalid_argument>(
+            "`num_mel_bins` must be greater than 0, but is {} instead.", opts_.num_mel_bins());
+
+    if (opts_.num_fft() <= 0)
+        throw_<std::invalid_argument>(
+            "`num_fft` must be greater than 0, but is {} instead.", opts_.num_fft());
+
+    if (opts_.hop_length() <= 0)
+        throw_<std::invalid_argument>(
+            "`hop_length` must be greater than 0, but is {} instead.", opts_.hop_length());
+}
+
+waveform_to_log_mel_converter::~waveform_to_log_mel_converter() = default;
+
+data
+waveform_to_log_mel_converter::operator()(data &&d) const
+{
+    if (!d.is_dict())
+        throw_<std::invalid_argument>(
+            "The input data must be of type `dict` containing a waveform tensor and its sample rate, but is of type `{}` instead.", d.type());
+
+    data_dict &dict = d.as_dict();
+
+    float32 sample_rate = find_sample_rate(dict);
+    if (filter_bank_ == nullptr) {
+        if (sample_rate <= 0.0F)
+            throw_<std::invalid_argument>(
+                "The input sample rate must be greater than 0, but is {:G} instead.", sample_rate);
+
+        std::lock_guard<std::mutex> init_guard{init_mutex_};
+
+        if (filter_bank_ == nullptr)
+            init_filter_bank(sample_rate);
+    } else {
+        if (!are_close(filter_bank_->sample_rate, sample_rate))
+            throw_<std::invalid_argument>(
+                "The input waveform must have a sample rate of {}, but has a sample rate of {:G} instead.", filter_bank_->sample_rate, sample_rate);
+    }
+
+    at::Tensor waveform = prepare_waveform(dict, opts_.channel_last(), opts_.waveform_scale());
+
+    if (waveform.size(0) != 1)
+        throw_<std::invalid_argument>(
+            "The input waveform must have a single channel, but has {} channels instead.", waveform.size(0));
+
+    // Reflection padding requires more samples than half of the window.
+    if (waveform.size(1) <= opts_.num_fft() / 2)
+        throw_<std::invalid_argument>(
+            "The input waveform must have more than {} samples, but has {} samples instead.", opts_.num_fft() / 2, waveform.size(1));
+
+    at::Tensor stft = at::stft(
+        waveform.squeeze(0),
+        /*n_fft=*/opts_.num_fft(),
+        /*hop_length=*/opts_.hop_length(),
+        /*win_length=*/opts_.num_fft(),
+        /*window=*/filter_bank_->window,
+        /*center=*/true,
+        /*pad_mode=*/"reflect",
+        /*normalized=*/false,
+        /*onesided=*/true,
+        /*return_complex=*/true);
+
+    // Like Whisper, drop the last frame, which is centered past the end of the
+    // waveform.
+    at::Tensor magnitudes = stft.narrow(/*dim=*/-1, /*start=*/0, stft.size(-1) - 1).abs().square();
+
+    // (M, F) @ (F, T) -> (M, T)
+    at::Tensor log_mel = at::matmul(filter_bank_->mel_filters, magnitudes);
+
+    log_mel = log_mel.clamp_min(1e-10).log10();
+
+    log_mel = at::maximum(log_mel, log_mel.max() - 8.0);
+
+    log_mel = log_mel.add(4.0).divide(4.0);
+
+    // (M, T) -> (T, M)
+    log_mel = log_mel.transpose(0, 1);
+
+    // If no device is specified, we fallback to the device of the waveform
+    // instead of the default floating-point type.
+    at::Device device = opts_.maybe_device().value_or(waveform.device());
+
+    at::ScalarType dtype = opts_.maybe_dtype().value_or(at::kFloat);
+
+    log_mel = log_mel.to(
+        device, dtype, /*non_blocking=*/false, /*copy=*/false, at::MemoryFormat::Contiguous);
+
+    if (opts_.pin_memory() && device == at::kCPU)
+        log_mel = log_mel.pin_memory();
+
+    // Ensure that we return the sample rate always in floating-point.
+    dict["sample_rate"] = static_cast<float64>(sample_rate);
+
+    if (!opts_.keep_waveform())
+        dict.erase("waveform");
+
+    dict.emplace("log_mel", std::move(log_mel));
+
+    return std::move(d);
+}
+
+void
+waveform_to_log_mel_converter::init_filter_bank(float32 sample_rate) const
+{
+    auto bank = std::make_unique<filter_bank>();
+
+    bank->sample_rate = sample_rate;
+
+    bank->mel_filters = make_slaney_mel_filters(sample_rate, opts_.num_fft(), opts_.num_mel_bins());
+
+    bank->window = at::hann_window(opts_.num_fft(), /*periodic=*/true, at::dtype(at::kFloat));
+
+    filter_bank_ = std::move(bank);
+}
+
+}  // namespace fairseq2n
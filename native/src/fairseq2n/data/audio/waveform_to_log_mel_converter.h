@@ -0,0 +1,214 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+#include <ATen/Device.h>
+#include <ATen/ScalarType.h>
+
+#include "fairseq2n/api.h"
+#include "fairseq2n/float.h"
+#include "fairseq2n/data/data.h"
+
+namespace fairseq2n {
+
+class log_mel_options {
+public:
+    log_mel_options
+    num_mel_bins(std::int32_t value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.num_mel_bins_ = value;
+
+        return tmp;
+    }
+
+    std::int32_t
+    num_mel_bins() const noexcept
+    {
+        return num_mel_bins_;
+    }
+
+    log_mel_options
+    num_fft(std::int32_t value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.num_fft_ = value;
+
+        return tmp;
+    }
+
+    std::int32_t
+    num_fft() const noexcept
+    {
+        return num_fft_;
+    }
+
+    log_mel_options
+    hop_length(std::int32_t value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.hop_length_ = value;
+
+        return tmp;
+    }
+
+    std::int32_t
+    hop_length() const noexcept
+    {
+        return hop_length_;
+    }
+
+    log_mel_options
+    waveform_scale(float32 value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.waveform_scale_ = value;
+
+        return tmp;
+    }
+
+    float32
+    waveform_scale() const noexcept
+    {
+        return waveform_scale_;
+    }
+
+    log_mel_options
+    channel_last(bool value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.channel_last_ = value;
+
+        return tmp;
+    }
+
+    bool
+    channel_last() const noexcept
+    {
+        return channel_last_;
+    }
+
+    log_mel_options
+    keep_waveform(bool value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.keep_waveform_ = value;
+
+        return tmp;
+    }
+
+    bool
+    keep_waveform() const noexcept
+    {
+        return keep_waveform_;
+    }
+
+    log_mel_options
+    maybe_dtype(std::optional<at::ScalarType> value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.maybe_dtype_ = value;
+
+        return tmp;
+    }
+
+    std::optional<at::ScalarType>
+    maybe_dtype() const noexcept
+    {
+        return maybe_dtype_;
+    }
+
+    log_mel_options
+    maybe_device(std::optional<at::Device> value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.maybe_device_ = value;
+
+        return tmp;
+    }
+
+    std::optional<at::Device>
+    maybe_device() const noexcept
+    {
+        return maybe_device_;
+    }
+
+    log_mel_options
+    pin_memory(bool value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.pin_memory_ = value;
+
+        return tmp;
+    }
+
+    bool
+    pin_memory() const noexcept
+    {
+        return pin_memory_;
+    }
+
+private:
+    std::int32_t num_mel_bins_ = 80;
+    std::int32_t num_fft_ = 400;
+    std::int32_t hop_length_ = 160;
+    float32 waveform_scale_ = 1.0;
+    bool channel_last_ = false;
+    bool keep_waveform_ = false;
+    std::optional<at::ScalarType> maybe_dtype_{};
+    std::optional<at::Device> maybe_device_{};
+    bool pin_memory_ = false;
+};
+
+// Computes the log-mel spectrogram of a waveform the same way as Whisper: the
+// power spectrum of a centered STFT with a periodic Hann window is projected
+// onto Slaney-style mel filters, converted to log10 scale, clamped to 80 dB
+// below its peak, and rescaled to roughly [-1, 1]. The output has the shape
+// `(num_frames, num_mel_bins)` and is stored under the key `log_mel`.
+class FAIRSEQ2_API waveform_to_log_mel_converter {
+public:
+    explicit
+    waveform_to_log_mel_converter(log_mel_options opts = {});
+
+    waveform_to_log_mel_converter(const waveform_to_log_mel_converter &) = delete;
+    waveform_to_log_mel_converter &operator=(const waveform_to_log_mel_converter &) = delete;
+
+    waveform_to_log_mel_converter(waveform_to_log_mel_converter &&other) = delete;
+    waveform_to_log_mel_converter &operator=(waveform_to_log_mel_converter &&other) = delete;
+
+   ~waveform_to_log_mel_converter();
+
+    data
+    operator()(data &&d) const;
+
+private:
+    struct filter_bank;
+
+    void
+    init_filter_bank(float32 sample_rate) const;
+
+private:
+    mutable std::unique_ptr<filter_bank> filter_bank_;
+    mutable std::mutex init_mutex_{};
+    log_mel_options opts_;
+};
+
+}  // namespace fairseq2n
@@ -0,0 +1,168 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/audio/waveform_to_mfcc_converter.h"
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#include <ATen/Functions.h>
+#include <kaldi-native-fbank/csrc/feature-fbank.h>
+
+#include "fairseq2n/fmt.h"
+#include "fairseq2n/span.h"
+#include "fairseq2n/data/audio/detail/kaldi_fbank.h"
+#include "fairseq2n/data/audio/detail/waveform_helpers.h"
+#include "fairseq2n/data/detail/tensor_helpers.h"
+#include "fairseq2n/detail/exception.h"
+#include "fairseq2n/utils/cast.h"
+
+using namespace fairseq2n::detail;
+
+namespace fairseq2n {
+namespace detail {
+namespace {
+
+constexpr float64 pi = 3.14159265358979323846;
+
+// Returns the first `num_ceps` columns of the orthonormal DCT-II matrix of
+// Kaldi's `ComputeDctMatrix()`, with the cepstral lifter folded into them so
+// that a single matrix multiplication produces the final coefficients.
+// *Shape:* (num_mel_bins, num_ceps)
+at::Tensor
+make_liftered_dct_matrix(std::int32_t num_mel_bins, std::int32_t num_ceps, float32 cepstral_lifter)
+{
+    auto num_bins = static_cast<std::size_t>(num_mel_bins);
+    auto num_cols = static_cast<std::size_t>(num_ceps);
+
+    at::Tensor matrix = at::empty({num_mel_bins, num_ceps},
+        at::dtype(at::kFloat).device(at::kCPU));
+
+    span matrix_data = cast<float32>(get_raw_mutable_storage(matrix));
+
+    auto n = static_cast<float64>(num_mel_bins);
+
+    auto q = static_cast<float64>(cepstral_lifter);
+
+    for (std::size_t k = 0; k < num_cols; ++k) {
+        float64 scale = std::sqrt((k == 0 ? 1.0 : 2.0) / n);
+
+        // A lifter of zero means no liftering.
+        if (q != 0.0)
+            scale *= 1.0 + 0.5 * q * std::sin(pi * static_cast<float64>(k) / q);
+
+        for (std::size_t j = 0; j < num_bins; ++j) {
+            float64 value = std::cos(pi / n * (static_cast<float64>(j) + 0.5) * static_cast<float64>(k));
+
+            matrix_data[j * num_cols + k] = static_cast<float32>(scale * value);
+        }
+    }
+
+    return matrix;
+}
+
+}  // namespace
+}  // namespace detail
+
+waveform_to_mfcc_converter::waveform_to_mfcc_converter(mfcc_options opts)
+  : opts_{opts}
+{
+    if (opts_.num_mel_bins() <= 0)
+        throw_<std::invalid_argument>(
+            "`num_mel_bins` must be greater than 0, but is {} instead.", opts_.num_mel_bins());
+
+    if (opts_.num_ceps() <= 0 || opts_.num_ceps() > opts_.num_mel_bins())
+        throw_<std::invalid_argument>(
+            "`num_ceps` must be greater than 0 and less than or equal to `num_mel_bins` ({}), but is {} instead.", opts_.num_mel_bins(), opts_.num_ceps());
+
+    dct_matrix_ = make_liftered_dct_matrix(
+        opts_.num_mel_bins(), opts_.num_ceps(), opts_.cepstral_lifter());
+}
+
+waveform_to_mfcc_converter::~waveform_to_mfcc_converter() = default;
+
+data
+waveform_to_mfcc_converter::operator()(data &&d) const
+{
+    if (!d.is_dict())
+        throw_<std::invalid_argument>(
+            "The input data must be of type `dict` containing a waveform tensor and its sample rate, but is of type `{}` instead.", d.type());
+
+    data_dict &dict = d.as_dict();
+
+    float32 sample_rate = find_sample_rate(dict);
+    if (computer_ == nullptr) {
+        // Any sample rate below 100 causes Kaldi to underflow.
+        if (sample_rate < 100.0F)
+            throw_<std::invalid_argument>(
+                "The input sample rate must be greater than or equal to 100, but is {:G} instead.", sample_rate);
+
+        std::lock_guard<std::mutex> init_guard{init_mutex_};
+
+        if (computer_ == nullptr)
+            init_computer(sample_rate);
+    } else {
+        if (!are_close(computer_->sample_rate(), sample_rate))
+            throw_<std::invalid_argument>(
+                "The input waveform must have a sample rate of {}, but has a sample rate of {:G} instead.", computer_->sample_rate(), sample_rate);
+    }
+
+    at::Tensor waveform = prepare_waveform(dict, opts_.channel_last(), opts_.waveform_scale());
+
+    // The framing, windowing, and mel filter bank are shared with the fbank
+    // converter. (T, M) @ (M, C) -> (T, C)
+    at::Tensor mfcc = at::matmul(computer_->compute(waveform, /*pin_memory=*/false), dct_matrix_);
+
+    if (opts_.standardize()) {
+        at::Tensor stdev{}, mean{};
+
+        std::tie(stdev, mean) = at::std_mean(mfcc, /*dim=*/0);
+
+        mfcc = mfcc.subtract(mean).divide(stdev);
+    }
+
+    // If no device is specified, we fallback to the device of the waveform
+    // instead of the default floating-point type.
+    at::Device device = opts_.maybe_device().value_or(waveform.device());
+
+    at::ScalarType dtype = opts_.maybe_dtype().value_or(at::kFloat);
+
+    mfcc = mfcc.to(device, dtype);
+
+    if (opts_.pin_memory() && device == at::kCPU)
+        mfcc = mfcc.pin_memory();
+
+    // Ensure that we return the sample rate always in floating-point.
+    dict["sample_rate"] = static_cast<float64>(sample_rate);
+
+    if (!opts_.keep_waveform())
+        dict.erase("waveform");
+
+    dict.emplace("mfcc", std::move(mfcc));
+
+    return std::move(d);
+}
+
+void
+waveform_to_mfcc_converter::init_computer(float32 sample_rate) const
+{
+    knf::MelBanksOptions mel_opts{};
+    mel_opts.num_bins = opts_.num_mel_bins();
+
+    knf::FrameExtractionOptions frame_opts{};
+    frame_opts.samp_freq = sample_rate;
+
+    knf::FbankOptions opts{};
+    opts.frame_opts = frame_opts;
+    opts.mel_opts = mel_opts;
+
+    computer_ = std::make_unique<kaldi_fbank_computer>(opts);
+}
+
+}  // namespace fairseq2n
@@ -0,0 +1,238 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+#include <ATen/Device.h>
+#include <ATen/ScalarType.h>
+#include <ATen/Tensor.h>
+
+#include "fairseq2n/api.h"
+#include "fairseq2n/float.h"
+#include "fairseq2n/data/data.h"
+
+namespace fairseq2n {
+
+class mfcc_options {
+public:
+    mfcc_options
+    num_mel_bins(std::int32_t value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.num_mel_bins_ = value;
+
+        return tmp;
+    }
+
+    std::int32_t
+    num_mel_bins() const noexcept
+    {
+        return num_mel_bins_;
+    }
+
+    mfcc_options
+    num_ceps(std::int32_t value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.num_ceps_ = value;
+
+        return tmp;
+    }
+
+    std::int32_t
+    num_ceps() const noexcept
+    {
+        return num_ceps_;
+    }
+
+    mfcc_options
+    cepstral_lifter(float32 value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.cepstral_lifter_ = value;
+
+        return tmp;
+    }
+
+    float32
+    cepstral_lifter() const noexcept
+    {
+        return cepstral_lifter_;
+    }
+
+    mfcc_options
+    waveform_scale(float32 value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.waveform_scale_ = value;
+
+        return tmp;
+    }
+
+    float32
+    waveform_scale() const noexcept
+    {
+        return waveform_scale_;
+    }
+
+    mfcc_options
+    channel_last(bool value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.channel_last_ = value;
+
+        return tmp;
+    }
+
+    bool
+    channel_last() const noexcept
+    {
+        return channel_last_;
+    }
+
+    mfcc_options
+    standardize(bool value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.standardize_ = value;
+
+        return tmp;
+    }
+
+    bool
+    standardize() const noexcept
+    {
+        return standardize_;
+    }
+
+    mfcc_options
+    keep_waveform(bool value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.keep_waveform_ = value;
+
+        return tmp;
+    }
+
+    bool
+    keep_waveform() const noexcept
+    {
+        return keep_waveform_;
+    }
+
+    mfcc_options
+    maybe_dtype(std::optional<at::ScalarType> value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.maybe_dtype_ = value;
+
+        return tmp;
+    }
+
+    std::optional<at::ScalarType>
+    maybe_dtype() const noexcept
+    {
+        return maybe_dtype_;
+    }
+
+    mfcc_options
+    maybe_device(std::optional<at::Device> value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.maybe_device_ = value;
+
+        return tmp;
+    }
+
+    std::optional<at::Device>
+    maybe_device() const noexcept
+    {
+        return maybe_device_;
+    }
+
+    mfcc_options
+    pin_memory(bool value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.pin_memory_ = value;
+
+        return tmp;
+    }
+
+    bool
+    pin_memory() const noexcept
+    {
+        return pin_memory_;
+    }
+
+private:
+    std::int32_t num_mel_bins_ = 23;
+    std::int32_t num_ceps_ = 13;
+    float32 cepstral_lifter_ = 22.0;
+    float32 waveform_scale_ = 1.0;
+    bool channel_last_ = false;
+    bool standardize_ = false;
+    bool keep_waveform_ = false;
+    std::optional<at::ScalarType> maybe_dtype_{};
+    std::optional<at::Device> maybe_device_{};
+    bool pin_memory_ = false;
+};
+
+namespace detail {
+
+class kaldi_fbank_computer;
+
+}
+
+// Computes the Kaldi-compatible MFCCs of a waveform by applying an orthonormal
+// DCT-II and a sinusoidal cepstral lifter to the log-mel filter bank energies
+// of `kaldi_fbank_computer`. Like `torchaudio.compliance.kaldi.mfcc()` with its
+// default options, the zeroth coefficient is not replaced by the log energy.
+// The output has the shape `(num_frames, num_ceps)` and is stored under the key
+// `mfcc`.
+class FAIRSEQ2_API waveform_to_mfcc_converter {
+public:
+    explicit
+    waveform_to_mfcc_converter(mfcc_options opts = {});
+
+    waveform_to_mfcc_converter(const waveform_to_mfcc_converter &) = delete;
+    waveform_to_mfcc_converter &operator=(const waveform_to_mfcc_converter &) = delete;
+
+    waveform_to_mfcc_converter(waveform_to_mfcc_converter &&other) = delete;
+    waveform_to_mfcc_converter &operator=(waveform_to_mfcc_converter &&other) = delete;
+
+   ~waveform_to_mfcc_converter();
+
+    data
+    operator()(data &&d) const;
+
+private:
+    void
+    init_computer(float32 sample_rate) const;
+
+private:
+    mutable std::unique_ptr<detail::kaldi_fbank_computer> computer_;
+    at::Tensor dct_matrix_{};
+    mutable std::mutex init_mutex_{};
+    mfcc_options opts_;
+};
+
+}  // namespace fairseq2n
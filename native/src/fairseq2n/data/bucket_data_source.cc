@@ -22,13 +22,7 @@ bucket_data_source::next()
 
     output.reserve(bucket_size_);
 
-    for (std::size_t i = 0; i < bucket_size_; ++i) {
-        std::optional<data> maybe_example = inner_->next();
-        if (!maybe_example)
-            break;
-
-        output.push_back(*std::move(maybe_example));
-    }
+    inner_->next_n(bucket_size_, output);
 
     if (output.empty())
         return std::nullopt;
@@ -20,6 +20,7 @@
 #include "fairseq2n/fmt.h"
 #include "fairseq2n/span.h"
 #include "fairseq2n/data/data.h"
+#include "fairseq2n/data/detail/tensor_helpers.h"
 #include "fairseq2n/detail/exception.h"
 
 using namespace fairseq2n::detail;
@@ -29,6 +30,7 @@ namespace detail {
 
 class collate_op {
     using bucket_visitor_fn = std::function<void(data &, std::size_t)>;
+    using const_bucket_visitor_fn = std::function<void(const data &, std::size_t)>;
 
 public:
     explicit
@@ -44,10 +46,10 @@ private:
     collate_current_path();
 
     data
-    collate(data_list &list);
+    collate(const data_list &list);
 
     data
-    collate(data_dict &dict);
+    collate(const data_dict &dict);
 
     data
     collate(at::Tensor &tensor);
@@ -58,15 +60,39 @@ private:
     void
     visit_bucket_items(data_type expected_type, const bucket_visitor_fn &visitor);
 
+    void
+    inspect_bucket_items(data_type expected_type, const const_bucket_visitor_fn &visitor) const;
+
     data &
     get_current_element(std::size_t bucket_item_idx);
 
+    const data &
+    get_current_element(std::size_t bucket_item_idx) const;
+
+    void
+    check_element_type(const data &element, data_type expected_type, std::size_t bucket_item_idx) const;
+
     const collate_options &
     get_options_for_current_path() const;
 
-    static data
+    data
     pad_tensors(span<at::Tensor> tensors, std::int64_t pad_value, const collate_options &opts);
 
+    data
+    pack_tensors(span<at::Tensor> tensors, std::int64_t pad_value, const collate_options &opts);
+
+    static at::Tensor
+    pad_to_multiple(const at::Tensor &seqs, std::int64_t pad_value, std::int64_t multiple);
+
+    static void
+    add_sequence_masks(
+        data_dict &output,
+        span<const std::int64_t> seq_lens,
+        std::int64_t batch_size,
+        std::int64_t batch_seq_len,
+        const collate_options &opts,
+        at::Device device);
+
 private:
     const collater *collater_;
     data_list bucket_;
@@ -89,11 +115,14 @@ collate_op::collate_current_path()
     // for the remaining items.
     data &element = get_current_element(/*bucket_item_idx=*/0);
 
+    // Lists and dicts are copy-on-write; only read them here, so that we do not
+    // clone a container that is shared with another example. Their elements
+    // get moved (and, if necessary, cloned) once we reach the leaves.
     if (element.is_list())
-        return collate(element.as_list());
+        return collate(std::as_const(element).as_list());
 
     if (element.is_dict())
-        return collate(element.as_dict());
+        return collate(std::as_const(element).as_dict());
 
     if (element.is_tensor())
         return collate(element.as_tensor());
@@ -103,12 +132,12 @@ collate_op::collate_current_path()
 }
 
 data
-collate_op::collate(data_list &list)
+collate_op::collate(const data_list &list)
 {
     auto expected_dtype = data_type::list;
 
     // Make sure that each bucket item has the same list size.
-    visit_bucket_items(expected_dtype, [this, &list](data &element, std::size_t item_idx)
+    inspect_bucket_items(expected_dtype, [this, &list](const data &element, std::size_t item_idx)
     {
         std::size_t size = element.as_list().size();
         if (path_.empty()) {
@@ -141,12 +170,12 @@ collate_op::collate(data_list &list)
 }
 
 data
-collate_op::collate(data_dict &dict)
+collate_op::collate(const data_dict &dict)
 {
     auto expected_dtype = data_type::dict;
 
     // Make sure that each bucket item has the same dict size.
-    visit_bucket_items(expected_dtype, [this, &dict](data &element, std::size_t item_idx)
+    inspect_bucket_items(expected_dtype, [this, &dict](const data &element, std::size_t item_idx)
     {
         std::size_t size = element.as_dict().size();
         if (path_.empty()) {
@@ -163,7 +192,7 @@ collate_op::collate(data_dict &dict)
     data_dict output{};
 
     // Collate each entry of the dictionary.
-    for (auto &[key, value] : dict) {
+    for (const auto &[key, value] : dict) {
         // Move the path down to the next key in the dict.
         path_.emplace_back(key);
 
@@ -244,15 +273,20 @@ collate_op::visit_bucket_items(data_type expected_type, const bucket_visitor_fn
     for (std::size_t item_idx = 1; item_idx < bucket_.size(); ++item_idx) {
         data &element = get_current_element(item_idx);
 
-        if (path_.empty()) {
-            if (element.type() != expected_type)
-                throw_<std::invalid_argument>(
-                    "The bucket item {} must be of type `{}`, but is of type `{}` instead.", item_idx, expected_type, element.type());
-        } else {
-            if (element.type() != expected_type)
-                throw_<std::invalid_argument>(
-                    "The element at path '{}' in the bucket item {} must be of type `{}`, but is of type `{}` instead.", path_, item_idx, expected_type, element.type());
-        }
+        check_element_type(element, expected_type, item_idx);
+
+        visitor(element, item_idx);
+    }
+}
+
+void
+collate_op::inspect_bucket_items(
+    data_type expected_type, const const_bucket_visitor_fn &visitor) const
+{
+    for (std::size_t item_idx = 1; item_idx < bucket_.size(); ++item_idx) {
+        const data &element = get_current_element(item_idx);
+
+        check_element_type(element, expected_type, item_idx);
 
         visitor(element, item_idx);
     }
@@ -279,6 +313,41 @@ collate_op::get_current_element(std::size_t bucket_item_idx)
     return *element;
 }
 
+const data &
+collate_op::get_current_element(std::size_t bucket_item_idx) const
+{
+    const data &bucket_item = bucket_[bucket_item_idx];
+
+    const data *element = nullptr;
+
+    try {
+        element_selector::visit(bucket_item, path_, [&element](const data &d, element_path_ref)
+        {
+            element = &d;
+        });
+    } catch (const std::invalid_argument &) {
+        throw_<std::invalid_argument>(
+            "The bucket item {} does not have an element at path '{}'.", bucket_item_idx, path_);
+    }
+
+    return *element;
+}
+
+void
+collate_op::check_element_type(
+    const data &element, data_type expected_type, std::size_t bucket_item_idx) const
+{
+    if (path_.empty()) {
+        if (element.type() != expected_type)
+            throw_<std::invalid_argument>(
+                "The bucket item {} must be of type `{}`, but is of type `{}` instead.", bucket_item_idx, expected_type, element.type());
+    } else {
+        if (element.type() != expected_type)
+            throw_<std::invalid_argument>(
+                "The element at path '{}' in the bucket item {} must be of type `{}`, but is of type `{}` instead.", path_, bucket_item_idx, expected_type, element.type());
+    }
+}
+
 const collate_options &
 collate_op::get_options_for_current_path() const
 {
@@ -293,30 +362,18 @@ collate_op::get_options_for_current_path() const
 data
 collate_op::pad_tensors(span<at::Tensor> tensors, std::int64_t pad_value, const collate_options &opts)
 {
-    at::Tensor seqs{};
+    if (opts.pack())
+        return pack_tensors(tensors, pad_value, opts);
 
     // Pad.
     at::Tensor tmp = at::pad_sequence(
         tensors, /*batch_first=*/true, static_cast<float64>(pad_value));
 
-    at::IntArrayRef shape = tmp.sizes();
-
     // Pad to multiple.
-    if (opts.pad_to_multiple() > 1 && shape[1] % opts.pad_to_multiple() > 0) {
-        std::vector<std::int64_t> pad_shape(shape.begin(), shape.end());
-
-        pad_shape[1] = opts.pad_to_multiple() - (shape[1] % opts.pad_to_multiple());
-
-        at::Tensor pad = tmp.new_full(pad_shape, pad_value);
-
-        // PyTorch has trouble with LSan when a tensor is used both as an input
-        // and as an output to `concat`. `tmp` is a workaround for that.
-        seqs = at::concat({tmp, pad}, /*dim=*/1);
-    } else
-        seqs = tmp;
+    at::Tensor seqs = pad_to_multiple(tmp, pad_value, opts.pad_to_multiple());
 
     // Construct sequence length tensor.
-    at::Tensor seq_lens = at::empty({shape[0]}, at::dtype(at::kLong));
+    at::Tensor seq_lens = at::empty({seqs.size(0)}, at::dtype(at::kLong));
 
     bool is_ragged = false;
 
@@ -339,17 +396,155 @@ collate_op::pad_tensors(span<at::Tensor> tensors, std::int64_t pad_value, const
     if (!is_ragged && !tensors.empty() && seq_lens_data[0] != seqs.size(1))
         is_ragged = true;
 
-    seq_lens = seq_lens.to(seqs.device());
+    std::int64_t batch_size = seqs.size(0), batch_seq_len = seqs.size(1);
+
+    at::Device device = seqs.device();
 
     // Pack the sequences and their lengths into a dict.
     data_dict output{{"is_ragged", is_ragged}};
 
     output.emplace("seqs", std::move(seqs));
-    output.emplace("seq_lens", std::move(seq_lens));
+    output.emplace("seq_lens", seq_lens.to(device));
+
+    add_sequence_masks(
+        output, cast<const std::int64_t>(get_raw_storage(seq_lens)), batch_size, batch_seq_len, opts, device);
 
     return output;
 }
 
+data
+collate_op::pack_tensors(span<at::Tensor> tensors, std::int64_t pad_value, const collate_options &opts)
+{
+    at::Tensor tmp{};
+
+    try {
+        tmp = at::concat(tensors);
+    } catch (const c10::Error &) {
+        if (path_.empty()) {
+            throw_with_nested<std::invalid_argument>(
+                "The tensors in the bucket cannot be packed. See nested exception for details.");
+        } else {
+            throw_with_nested<std::invalid_argument>(
+                "The tensors at path '{}' in the bucket cannot be packed. See nested exception for details.", path_);
+        }
+    }
+
+    // (S, *) -> (1, S, *)
+    at::Tensor seqs = pad_to_multiple(tmp.unsqueeze(0), pad_value, opts.pad_to_multiple());
+
+    // Construct the segment length tensor.
+    at::Tensor segment_lens = at::empty({static_cast<std::int64_t>(tensors.size())}, at::dtype(at::kLong));
+
+    auto segment_lens_data = segment_lens.accessor<std::int64_t, 1>();
+
+    std::int64_t i = 0;
+    for (const at::Tensor &t : tensors)
+        segment_lens_data[i++] = t.size(0);
+
+    // A packed batch is a single sequence made of multiple segments; it is
+    // ragged only if it has extra padding due to `pad_to_multiple`.
+    at::Tensor seq_lens = at::full({1}, tmp.size(0), at::dtype(at::kLong));
+
+    bool is_ragged = tmp.size(0) != seqs.size(1);
+
+    std::int64_t batch_seq_len = seqs.size(1);
+
+    at::Device device = seqs.device();
+
+    // Pack the sequence, its length, and the lengths of its segments into a
+    // dict.
+    data_dict output{{"is_ragged", is_ragged}};
+
+    output.emplace("seqs", std::move(seqs));
+    output.emplace("seq_lens", seq_lens.to(device));
+    output.emplace("segment_lens", segment_lens.to(device));
+
+    add_sequence_masks(
+        output, cast<const std::int64_t>(get_raw_storage(segment_lens)), 1, batch_seq_len, opts, device);
+
+    return output;
+}
+
+at::Tensor
+collate_op::pad_to_multiple(const at::Tensor &seqs, std::int64_t pad_value, std::int64_t multiple)
+{
+    at::IntArrayRef shape = seqs.sizes();
+
+    if (multiple <= 1 || shape[1] % multiple == 0)
+        return seqs;
+
+    std::vector<std::int64_t> pad_shape(shape.begin(), shape.end());
+
+    pad_shape[1] = multiple - (shape[1] % multiple);
+
+    at::Tensor pad = seqs.new_full(pad_shape, pad_value);
+
+    // PyTorch has trouble with LSan when a tensor is used both as an input and
+    // as an output to `concat`. Returning a new tensor is a workaround for that.
+    return at::concat({seqs, pad}, /*dim=*/1);
+}
+
+void
+collate_op::add_sequence_masks(
+    data_dict &output,
+    span<const std::int64_t> seq_lens,
+    std::int64_t batch_size,
+    std::int64_t batch_seq_len,
+    const collate_options &opts,
+    at::Device device)
+{
+    if (!opts.padding_mask() && !opts.segment_ids() && !opts.position_ids())
+        return;
+
+    at::Tensor padding_mask = at::zeros({batch_size, batch_seq_len}, at::dtype(at::kBool));
+    at::Tensor segment_ids  = at::full({batch_size, batch_seq_len}, -1, at::dtype(at::kLong));
+    at::Tensor position_ids = at::zeros({batch_size, batch_seq_len}, at::dtype(at::kLong));
+
+    auto padding_mask_data = padding_mask.accessor<bool, 2>();
+    auto segment_ids_data  = segment_ids.accessor<std::int64_t, 2>();
+    auto position_ids_data = position_ids.accessor<std::int64_t, 2>();
+
+    // In a packed batch, the sequences are laid out one after another in a
+    // single row.
+    bool is_packed = opts.pack();
+
+    std::int64_t offset = 0;
+
+    for (std::size_t i = 0; i < seq_lens.size(); ++i) {
+        std::int64_t row = is_packed ? 0 : static_cast<std::int64_t>(i);
+
+        for (std::int64_t j = 0; j < seq_lens[i]; ++j) {
+            padding_mask_data[row][offset + j] = true;
+
+            segment_ids_data[row][offset + j] = static_cast<std::int64_t>(i);
+
+            position_ids_data[row][offset + j] = j;
+        }
+
+        if (is_packed)
+            offset += seq_lens[i];
+    }
+
+    if (opts.padding_mask())
+        output.emplace("padding_mask", padding_mask.to(device));
+
+    if (opts.segment_ids())
+        output.emplace("segment_ids", segment_ids.to(device));
+
+    if (opts.position_ids())
+        output.emplace("position_ids", position_ids.to(device));
+}
+
+namespace {
+
+bool
+requires_pad_value(const collate_options &opts) noexcept
+{
+    return opts.pack() || opts.padding_mask() || opts.segment_ids() || opts.position_ids();
+}
+
+}  // namespace
+
 collater::collater(collate_options opts, std::vector<collate_options_override> opt_overrides)
   : opts_{opts}, opt_overrides_{std::move(opt_overrides)}
 {
@@ -357,10 +552,19 @@ collater::collater(collate_options opts, std::vector<collate_options_override> o
         throw_<std::invalid_argument>(
             "`pad_value` must be set when `pad_to_multiple` is greater than 1.");
 
-    for (collate_options_override &ov : opt_overrides_)
+    if (requires_pad_value(opts_) && !opts_.maybe_pad_value())
+        throw_<std::invalid_argument>(
+            "`pad_value` must be set when `pack`, `padding_mask`, `segment_ids`, or `position_ids` is set.");
+
+    for (collate_options_override &ov : opt_overrides_) {
         if (ov.options().pad_to_multiple() > 1 && !ov.options().maybe_pad_value())
             throw_<std::invalid_argument>(
                 "`pad_value` of the selector '{}' must be set when `pad_to_multiple` is greater than 1.", ov.selector().string_());
+
+        if (requires_pad_value(ov.options()) && !ov.options().maybe_pad_value())
+            throw_<std::invalid_argument>(
+                "`pad_value` of the selector '{}' must be set when `pack`, `padding_mask`, `segment_ids`, or `position_ids` is set.", ov.selector().string_());
+    }
 }
 
 data
@@ -51,9 +51,77 @@ public:
         return pad_to_multiple_;
     }
 
+    collate_options
+    pack(bool value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.pack_ = value;
+
+        return tmp;
+    }
+
+    bool
+    pack() const noexcept
+    {
+        return pack_;
+    }
+
+    collate_options
+    padding_mask(bool value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.padding_mask_ = value;
+
+        return tmp;
+    }
+
+    bool
+    padding_mask() const noexcept
+    {
+        return padding_mask_;
+    }
+
+    collate_options
+    segment_ids(bool value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.segment_ids_ = value;
+
+        return tmp;
+    }
+
+    bool
+    segment_ids() const noexcept
+    {
+        return segment_ids_;
+    }
+
+    collate_options
+    position_ids(bool value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.position_ids_ = value;
+
+        return tmp;
+    }
+
+    bool
+    position_ids() const noexcept
+    {
+        return position_ids_;
+    }
+
 private:
     std::optional<std::int64_t> maybe_pad_value_;
     std::int64_t pad_to_multiple_ = 1;
+    bool pack_ = false;
+    bool padding_mask_ = false;
+    bool segment_ids_ = false;
+    bool position_ids_ = false;
 };
 
 class collate_options_override {
@@ -88,6 +156,15 @@ class collate_op;
 
 }  // namespace detail
 
+// Collates a bucket of examples into a batch. Tensors at a path with a pad
+// value are padded to the length of the longest one (or, if `pack` is set,
+// concatenated into a single row) and returned along with their lengths.
+//
+// If requested, a boolean `padding_mask` that is true at non-pad positions,
+// per-token `segment_ids` holding the index of the example in the bucket (-1 at
+// pad positions), and per-token `position_ids` that start from zero at each
+// example are generated from those lengths as well, so that the model does not
+// have to rebuild them on every forward pass.
 class FAIRSEQ2_API collater {
     friend class detail::collate_op;
 
@@ -23,6 +23,23 @@ count_data_source::next()
     return output;
 }
 
+std::size_t
+count_data_source::next_n(std::size_t num_examples, data_list &output)
+{
+    output.reserve(output.size() + num_examples);
+
+    for (std::size_t i = 0; i < num_examples; ++i) {
+        if (maybe_key_)
+            output.emplace_back(data_dict{{*maybe_key_, counter_}});
+        else
+            output.emplace_back(counter_);
+
+        counter_ += step_;
+    }
+
+    return num_examples;
+}
+
 void
 count_data_source::reset(bool)
 {
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -237,68 +238,68 @@ public:
 
     // list
     data(const std::vector<data> &value)
-      : payload_{value}
+      : payload_{std::make_shared<std::vector<data>>(value)}
     {}
 
-    data(std::vector<data> &&value) noexcept
-      : payload_{std::move(value)}
+    data(std::vector<data> &&value)
+      : payload_{std::make_shared<std::vector<data>>(std::move(value))}
     {}
 
     bool
     is_list() const noexcept
     {
-        return is<std::vector<data>>();
+        return is<std::shared_ptr<std::vector<data>>>();
     }
 
     std::vector<data> &
-    as_list() & noexcept
+    as_list() &
     {
-        return as<std::vector<data>>();
+        return as_unshared<std::vector<data>>();
     }
 
     const std::vector<data> &
     as_list() const & noexcept
     {
-        return as<std::vector<data>>();
+        return *as<std::shared_ptr<std::vector<data>>>();
     }
 
     std::vector<data> &&
-    as_list() && noexcept
+    as_list() &&
     {
-        return move_as<std::vector<data>>();
+        return std::move(as_unshared<std::vector<data>>());
     }
 
     // dict
     data(const flat_hash_map<std::string, data> &value)
-      : payload_{value}
+      : payload_{std::make_shared<flat_hash_map<std::string, data>>(value)}
     {}
 
-    data(flat_hash_map<std::string, data> &&value) noexcept
-      : payload_{std::move(value)}
+    data(flat_hash_map<std::string, data> &&value)
+      : payload_{std::make_shared<flat_hash_map<std::string, data>>(std::move(value))}
     {}
 
     bool
     is_dict() const noexcept
     {
-        return is<flat_hash_map<std::string, data>>();
+        return is<std::shared_ptr<flat_hash_map<std::string, data>>>();
     }
 
     flat_hash_map<std::string, data> &
-    as_dict() & noexcept
+    as_dict() &
     {
-        return as<flat_hash_map<std::string, data>>();
+        return as_unshared<flat_hash_map<std::string, data>>();
     }
 
     const flat_hash_map<std::string, data> &
     as_dict() const & noexcept
     {
-        return as<flat_hash_map<std::string, data>>();
+        return *as<std::shared_ptr<flat_hash_map<std::string, data>>>();
     }
 
     flat_hash_map<std::string, data> &&
-    as_dict() && noexcept
+    as_dict() &&
     {
-        return move_as<flat_hash_map<std::string, data>>();
+        return std::move(as_unshared<flat_hash_map<std::string, data>>());
     }
 
     // py_object
@@ -363,7 +364,34 @@ private:
         return std::move(as<T>());
     }
 
+    // Returns the container stored in `payload_`, cloning it first if it is
+    // shared with another `data` instance. Note that the clone is shallow; the
+    // nested containers remain shared until they get accessed for writing.
+    //
+    // Copies of this instance might be released on other threads (e.g. by the
+    // workers of `prefetch()` or `map()`). A use count that drops to one while
+    // we check it is fine; the acquire fence below orders the last reads of
+    // those copies before our writes. However, this instance must not be
+    // copied by another thread while it is being accessed for writing.
+    template <typename T>
+    T &
+    as_unshared()
+    {
+        auto &storage = as<std::shared_ptr<T>>();
+
+        if (storage.use_count() > 1)
+            storage = std::make_shared<T>(std::as_const(*storage));
+        else
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+        return *storage;
+    }
+
 private:
+    // Lists and dicts are copy-on-write; copying a `data` instance holding one
+    // of them is O(1) regardless of how deeply nested it is. A reference
+    // returned by a non-const `as_list()` or `as_dict()` call must therefore
+    // not be used to write to the container after the instance gets copied.
     std::variant<
         bool,
         std::int64_t,
@@ -371,11 +399,17 @@ private:
         immutable_string,
         at::Tensor,
         memory_block,
-        std::vector<data>,
-        flat_hash_map<std::string, data>,
+        std::shared_ptr<std::vector<data>>,
+        std::shared_ptr<flat_hash_map<std::string, data>>,
         py_object> payload_{};
 };
 
+// `data` instances are stored by value in lists, buckets, and shuffle buffers,
+// so their size directly affects the memory traffic of the data pipeline. Any
+// alternative larger than a `memory_block` should be stored behind a pointer.
+static_assert(sizeof(data) <= sizeof(memory_block) + sizeof(void *),
+    "`data` must not be larger than a `memory_block` plus its type tag.");
+
 using data_list = std::vector<data>;
 
 using data_dict = flat_hash_map<std::string, data>;
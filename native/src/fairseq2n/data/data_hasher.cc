@@ -0,0 +1,222 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/data_hasher.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include <ATen/Tensor.h>
+
+#include "fairseq2n/fmt.h"
+#include "fairseq2n/memory.h"
+#include "fairseq2n/data/detail/hash.h"
+#include "fairseq2n/detail/exception.h"
+
+using namespace fairseq2n::detail;
+
+namespace fairseq2n {
+namespace detail {
+namespace {
+
+// Mixed into the hash of each element so that values of different types with
+// the same byte representation (e.g. `1` and `True`) do not collide. The values
+// are part of the hash format and must not be changed.
+enum class hash_tag : std::uint64_t {
+    bool_ = 1,
+    int_,
+    float_,
+    string,
+    tensor,
+    memory_block,
+    list,
+    dict,
+};
+
+inline std::uint64_t
+hash_header(std::uint64_t seed, hash_tag tag) noexcept
+{
+    return hash_combine(seed, static_cast<std::uint64_t>(tag));
+}
+
+inline std::uint64_t
+hash_word(std::uint64_t seed, hash_tag tag, std::uint64_t word) noexcept
+{
+    return xxh64_avalanche(hash_combine(hash_header(seed, tag), word));
+}
+
+inline std::uint64_t
+hash_bytes(std::uint64_t seed, hash_tag tag, memory_span bytes) noexcept
+{
+    return xxh64(bytes, hash_header(seed, tag));
+}
+
+inline memory_span
+as_bytes(const immutable_string &s) noexcept
+{
+    return {reinterpret_cast<const std::byte *>(s.data()), s.size()};
+}
+
+std::uint64_t
+hash_float(std::uint64_t seed, float64 value) noexcept
+{
+    // Make sure that all zeros and all NaNs have the same hash.
+    if (std::fpclassify(value) == FP_ZERO)
+        value = 0.0;
+    else if (std::isnan(value))
+        value = std::numeric_limits<float64>::quiet_NaN();
+
+    std::uint64_t word{};
+
+    std::memcpy(&word, &value, sizeof(word));
+
+    return hash_word(seed, hash_tag::float_, word);
+}
+
+std::uint64_t
+hash_tensor(std::uint64_t seed, const at::Tensor &tensor)
+{
+    std::uint64_t h = hash_header(seed, hash_tag::tensor);
+
+    h = hash_combine(h, static_cast<std::uint64_t>(tensor.scalar_type()));
+
+    h = hash_combine(h, static_cast<std::uint64_t>(tensor.dim()));
+
+    for (std::int64_t size : tensor.sizes())
+        h = hash_combine(h, static_cast<std::uint64_t>(size));
+
+    // We hash the logical content of the tensor; its device and memory layout
+    // do not affect the hash.
+    at::Tensor t = tensor.cpu().contiguous();
+
+    return xxh64(memory_span{static_cast<const std::byte *>(t.data_ptr()), t.nbytes()}, h);
+}
+
+std::uint64_t
+hash_value(std::uint64_t seed, const data &d)
+{
+    switch (d.type()) {
+    case data_type::bool_:
+        return hash_word(seed, hash_tag::bool_, d.as_bool() ? 1 : 0);
+
+    case data_type::int_:
+        return hash_word(seed, hash_tag::int_, static_cast<std::uint64_t>(d.as_int()));
+
+    case data_type::float_:
+        return hash_float(seed, d.as_float());
+
+    case data_type::string:
+        return hash_bytes(seed, hash_tag::string, as_bytes(d.as_string()));
+
+    case data_type::tensor:
+        return hash_tensor(seed, d.as_tensor());
+
+    case data_type::memory_block:
+        return hash_bytes(seed, hash_tag::memory_block, d.as_memory_block());
+
+    case data_type::list: {
+        const data_list &list = d.as_list();
+
+        std::uint64_t h = hash_header(seed, hash_tag::list);
+
+        for (const data &element : list)
+            h = hash_combine(h, hash_value(seed, element));
+
+        return xxh64_avalanche(hash_combine(h, list.size()));
+    }
+
+    case data_type::dict: {
+        const data_dict &dict = d.as_dict();
+
+        // The entries are combined with a commutative operation so that the
+        // hash does not depend on the insertion order of the keys.
+        std::uint64_t entries = 0;
+
+        for (auto &[key, value] : dict) {
+            std::uint64_t key_hash = xxh64(
+                memory_span{reinterpret_cast<const std::byte *>(key.data()), key.size()}, seed);
+
+            entries += xxh64_avalanche(hash_combine(key_hash, hash_value(seed, value)));
+        }
+
+        std::uint64_t h = hash_combine(hash_header(seed, hash_tag::dict), entries);
+
+        return xxh64_avalanche(hash_combine(h, dict.size()));
+    }
+
+    case data_type::pyobj:
+        throw_<std::invalid_argument>(
+            "The input data must not contain Python objects since they cannot be hashed in a stable manner.");
+    };
+
+    throw_<std::invalid_argument>("The input data has an invalid data type.");
+}
+
+}  // namespace
+}  // namespace detail
+
+data_hasher::data_hasher(
+    std::optional<std::string> maybe_selector,
+    std::optional<std::string> maybe_key,
+    std::uint64_t seed)
+  : maybe_key_{std::move(maybe_key)}, seed_{seed}
+{
+    if (maybe_selector)
+        maybe_selector_ = element_selector{*std::move(maybe_selector)};
+}
+
+std::uint64_t
+data_hasher::hash(const data &d) const
+{
+    if (!maybe_selector_)
+        return hash_element(d);
+
+    // If we have a selector, we hash the selected elements as if they were a
+    // list in the order they appear in the selector.
+    std::uint64_t h = hash_header(seed_, hash_tag::list);
+
+    std::size_t num_elements = 0;
+
+    maybe_selector_->visit(d, [this, &h, &num_elements](const data &element, element_path_ref)
+    {
+        h = hash_combine(h, hash_element(element));
+
+        num_elements++;
+    });
+
+    return xxh64_avalanche(hash_combine(h, num_elements));
+}
+
+data
+data_hasher::operator()(data &&d) const
+{
+    // `data` has no unsigned integer type; we return the hash as its two's
+    // complement signed representation.
+    auto h = static_cast<std::int64_t>(hash(d));
+
+    if (!maybe_key_)
+        return h;
+
+    if (!d.is_dict())
+        throw_<std::invalid_argument>(
+            "The input data must be of type `dict` when `key` is specified, but is of type `{}` instead.", d.type());
+
+    d.as_dict()[*maybe_key_] = h;
+
+    return std::move(d);
+}
+
+std::uint64_t
+data_hasher::hash_element(const data &d) const
+{
+    return hash_value(seed_, d);
+}
+
+}  // namespace fairseq2n
@@ -0,0 +1,46 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "fairseq2n/api.h"
+#include "fairseq2n/data/data.h"
+#include "fairseq2n/data/element_selector.h"
+
+namespace fairseq2n {
+
+// Computes a stable 64-bit content hash of `data` instances. Two instances have
+// the same hash if they hold the same values, regardless of the process, the
+// machine, or the insertion order of their dict entries.
+class FAIRSEQ2_API data_hasher {
+public:
+    explicit
+    data_hasher(
+        std::optional<std::string> maybe_selector = {},
+        std::optional<std::string> maybe_key = {},
+        std::uint64_t seed = 0);
+
+    std::uint64_t
+    hash(const data &d) const;
+
+    data
+    operator()(data &&d) const;
+
+private:
+    std::uint64_t
+    hash_element(const data &d) const;
+
+private:
+    std::optional<element_selector> maybe_selector_{};
+    std::optional<std::string> maybe_key_;
+    std::uint64_t seed_;
+};
+
+}  // namespace fairseq2n
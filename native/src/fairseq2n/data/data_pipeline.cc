@@ -19,21 +19,27 @@
 #include "fairseq2n/data/constant_data_source.h"
 #include "fairseq2n/data/count_data_source.h"
 #include "fairseq2n/data/detail/file_system.h"
+#include "fairseq2n/data/element_selector.h"
 #include "fairseq2n/data/filter_data_source.h"
 #include "fairseq2n/data/list_data_source.h"
 #include "fairseq2n/data/map_data_source.h"
 #include "fairseq2n/data/prefetch_data_source.h"
 #include "fairseq2n/data/repeat_data_source.h"
+#include "fairseq2n/data/restore_order_data_source.h"
 #include "fairseq2n/data/round_robin_data_source.h"
 #include "fairseq2n/data/sample_data_source.h"
 #include "fairseq2n/data/shard_data_source.h"
 #include "fairseq2n/data/shuffle_data_source.h"
 #include "fairseq2n/data/skip_data_source.h"
+#include "fairseq2n/data/sort_for_inference_data_source.h"
+#include "fairseq2n/data/stratified_sample_data_source.h"
 #include "fairseq2n/data/take_data_source.h"
+#include "fairseq2n/data/take_random_data_source.h"
 #include "fairseq2n/data/tape.h"
 #include "fairseq2n/data/yield_from_data_source.h"
 #include "fairseq2n/data/zip_data_source.h"
 #include "fairseq2n/data/zip_file_data_source.h"
+#include "fairseq2n/detail/cancellation.h"
 #include "fairseq2n/detail/exception.h"
 
 using namespace fairseq2n::detail;
@@ -70,6 +76,10 @@ data_pipeline::next()
 
                 throw;
             }
+        } catch (const operation_cancelled &) {
+            // A cancellation is always followed by a reset or a teardown, so
+            // it does not break the pipeline.
+            throw;
         } catch (const std::exception &) {
             is_broken_ = true;
 
@@ -441,6 +451,24 @@ data_pipeline_builder::repeat(std::optional<std::size_t> num_repeats, bool reset
     return std::move(*this);
 }
 
+data_pipeline_builder
+data_pipeline_builder::restore_order(std::size_t max_num_buffered, std::string index_selector) &&
+{
+    if (max_num_buffered == 0)
+        throw_<std::invalid_argument>(
+            "`max_num_buffered` must be greater than zero.");
+
+    element_selector selector{std::move(index_selector)};
+
+    factory_ = [=, inner = std::move(factory_)]
+    {
+        return std::make_unique<restore_order_data_source>(
+            inner(), element_selector{selector}, max_num_buffered);
+    };
+
+    return std::move(*this);
+}
+
 data_pipeline_builder
 data_pipeline_builder::shard(std::size_t shard_idx, std::size_t num_shards, bool allow_uneven) &&
 {
@@ -461,11 +489,15 @@ data_pipeline_builder::shard(std::size_t shard_idx, std::size_t num_shards, bool
 }
 
 data_pipeline_builder
-data_pipeline_builder::shuffle(std::size_t shuffle_window, std::optional<std::uint64_t> maybe_seed) &&
+data_pipeline_builder::shuffle(
+    std::size_t shuffle_window,
+    std::optional<std::uint64_t> maybe_seed,
+    std::size_t warmup_window) &&
 {
     factory_ = [=, inner = std::move(factory_)]
     {
-        return std::make_unique<shuffle_data_source>(inner(), shuffle_window, maybe_seed);
+        return std::make_unique<shuffle_data_source>(
+            inner(), shuffle_window, maybe_seed, warmup_window);
     };
 
     return std::move(*this);
@@ -482,6 +514,93 @@ data_pipeline_builder::skip(std::size_t num_examples) &&
     return std::move(*this);
 }
 
+data_pipeline_builder
+data_pipeline_builder::sort_for_inference(
+    std::size_t window_size,
+    std::size_t batch_size,
+    data_length_fn fn,
+    std::string index_key) &&
+{
+    if (window_size == 0)
+        throw_<std::invalid_argument>(
+            "`window_size` must be greater than zero.");
+
+    if (batch_size == 0)
+        throw_<std::invalid_argument>(
+            "`batch_size` must be greater than zero.");
+
+    factory_ = [
+        =,
+        fn = std::move(fn),
+        index_key = std::move(index_key),
+        inner = std::move(factory_)]() mutable
+    {
+        return std::make_unique<sort_for_inference_data_source>(
+            inner(), window_size, batch_size, std::move(fn), std::move(index_key));
+    };
+
+    return std::move(*this);
+}
+
+data_pipeline_builder
+data_pipeline_builder::stratified_sample(
+    std::string class_selector,
+    std::size_t reservoir_size,
+    std::optional<std::unordered_map<std::string, float64>> maybe_weights,
+    std::optional<float64> maybe_temperature,
+    std::optional<std::uint64_t> maybe_seed) &&
+{
+    if (reservoir_size == 0)
+        throw_<std::invalid_argument>(
+            "`reservoir_size` must be greater than zero.");
+
+    if (maybe_weights && maybe_temperature)
+        throw_<std::invalid_argument>(
+            "`weights` and `temperature` must not be specified at the same time.");
+
+    if (maybe_weights) {
+        bool has_positive_weight = false;
+
+        for (auto &[cls, weight] : *maybe_weights) {
+            if (weight < 0.0)
+                throw_<std::invalid_argument>(
+                    "The `weights` must be greater than or equal to 0.0, but the weight of the class '{}' is {} instead.", cls, weight);
+
+            if (!std::isfinite(weight))
+                throw_<std::invalid_argument>(
+                    "The `weights` must be finite, but the weight of the class '{}' is infinite or NaN instead.", cls);
+
+            if (weight > 0.0)
+                has_positive_weight = true;
+        }
+
+        if (!has_positive_weight)
+            throw_<std::invalid_argument>(
+                "`weights` must contain at least one class with a weight greater than 0.0.");
+    }
+
+    if (maybe_temperature && !(*maybe_temperature > 0.0 && std::isfinite(*maybe_temperature)))
+        throw_<std::invalid_argument>(
+            "`temperature` must be a finite number greater than 0.0, but is {} instead.", *maybe_temperature);
+
+    element_selector selector{std::move(class_selector)};
+
+    factory_ = [=, inner = std::move(factory_)]
+    {
+        auto weights_copy = maybe_weights;
+
+        return std::make_unique<stratified_sample_data_source>(
+            inner(),
+            element_selector{selector},
+            reservoir_size,
+            std::move(weights_copy),
+            maybe_temperature,
+            maybe_seed);
+    };
+
+    return std::move(*this);
+}
+
 data_pipeline_builder
 data_pipeline_builder::take(std::size_t num_examples) &&
 {
@@ -493,6 +612,27 @@ data_pipeline_builder::take(std::size_t num_examples) &&
     return std::move(*this);
 }
 
+data_pipeline_builder
+data_pipeline_builder::take_random(
+    std::size_t num_examples,
+    std::optional<std::string> maybe_weight_selector,
+    std::optional<std::uint64_t> maybe_seed) &&
+{
+    std::optional<element_selector> maybe_selector{};
+    if (maybe_weight_selector)
+        maybe_selector = element_selector{*std::move(maybe_weight_selector)};
+
+    factory_ = [=, inner = std::move(factory_)]
+    {
+        auto selector_copy = maybe_selector;
+
+        return std::make_unique<take_random_data_source>(
+            inner(), num_examples, std::move(selector_copy), maybe_seed);
+    };
+
+    return std::move(*this);
+}
+
 data_pipeline_builder
 data_pipeline_builder::yield_from(yield_fn fn) &&
 {
@@ -14,10 +14,12 @@
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "fairseq2n/api.h"
+#include "fairseq2n/float.h"
 #include "fairseq2n/data/data.h"
 #include "fairseq2n/data/data_source.h"
 #include "fairseq2n/data/tape.h"
@@ -153,18 +155,45 @@ public:
     data_pipeline_builder
     repeat(std::optional<std::size_t> num_repeats = std::nullopt, bool reset_rng = false) &&;
 
+    data_pipeline_builder
+    restore_order(std::size_t max_num_buffered, std::string index_selector = "index") &&;
+
     data_pipeline_builder
     shard(std::size_t shard_idx, std::size_t num_shards, bool allow_uneven = false) &&;
 
     data_pipeline_builder
-    shuffle(std::size_t shuffle_window, std::optional<std::uint64_t> maybe_seed = {}) &&;
+    shuffle(
+        std::size_t shuffle_window,
+        std::optional<std::uint64_t> maybe_seed = {},
+        std::size_t warmup_window = 0) &&;
 
     data_pipeline_builder
     skip(std::size_t num_examples) &&;
 
+    data_pipeline_builder
+    sort_for_inference(
+        std::size_t window_size,
+        std::size_t batch_size,
+        data_length_fn fn,
+        std::string index_key = "index") &&;
+
+    data_pipeline_builder
+    stratified_sample(
+        std::string class_selector,
+        std::size_t reservoir_size,
+        std::optional<std::unordered_map<std::string, float64>> maybe_weights = {},
+        std::optional<float64> maybe_temperature = {},
+        std::optional<std::uint64_t> maybe_seed = {}) &&;
+
     data_pipeline_builder
     take(std::size_t num_examples) &&;
 
+    data_pipeline_builder
+    take_random(
+        std::size_t num_examples,
+        std::optional<std::string> maybe_weight_selector = {},
+        std::optional<std::uint64_t> maybe_seed = {}) &&;
+
     data_pipeline_builder
     yield_from(yield_fn fn) &&;
 
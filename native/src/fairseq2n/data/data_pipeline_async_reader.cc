@@ -0,0 +1,249 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/data_pipeline_async_reader.h"
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+#include "fairseq2n/data/data_pipeline.h"
+#include "fairseq2n/data/detail/thread.h"
+#include "fairseq2n/detail/error.h"
+#include "fairseq2n/detail/exception.h"
+
+using namespace fairseq2n::detail;
+
+namespace fairseq2n {
+
+data_pipeline_async_reader::data_pipeline_async_reader(data_pipeline &pipeline)
+  : pipeline_{&pipeline}, cancellation_token_{cancellation_token::make()}
+{
+#ifdef __linux__
+    read_fd_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (read_fd_ == invalid_fd)
+        throw_system_error(last_error(),
+            "The completion event of the asynchronous data pipeline reader cannot be created");
+#else
+    std::array<int, 2> fds{};
+    if (::pipe(fds.data()) == -1)
+        throw_system_error(last_error(),
+            "The completion event of the asynchronous data pipeline reader cannot be created");
+
+    read_fd_ = fds[0];
+    write_fd_ = fds[1];
+
+    for (int fd : fds) {
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    }
+#endif
+}
+
+data_pipeline_async_reader::~data_pipeline_async_reader()
+{
+    close();
+
+    if (thread_.joinable())
+        thread_.join();
+}
+
+void
+data_pipeline_async_reader::request_next()
+{
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        if (is_closed_)
+            throw_<std::runtime_error>(
+                "The asynchronous data pipeline reader has already been closed.");
+
+        if (state_ != read_state::idle)
+            return;
+
+        state_ = read_state::reading;
+
+        // We start the background thread on the first read, so that merely
+        // creating a reader costs nothing.
+        if (!thread_.joinable())
+            thread_ = start_thread(&data_pipeline_async_reader::run, this);
+    }
+
+    condition_.notify_one();
+}
+
+bool
+data_pipeline_async_reader::is_ready() const
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    return state_ == read_state::done;
+}
+
+std::optional<data>
+data_pipeline_async_reader::take_result()
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    if (state_ != read_state::done)
+        throw_<std::runtime_error>(
+            "The asynchronous data pipeline reader has no completed read.");
+
+    drain();
+
+    state_ = read_state::idle;
+
+    if (exception_ptr_)
+        std::rethrow_exception(std::exchange(exception_ptr_, nullptr));
+
+    return std::exchange(maybe_example_, std::nullopt);
+}
+
+void
+data_pipeline_async_reader::close() noexcept
+{
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        if (is_closed_)
+            return;
+
+        is_closed_ = true;
+
+        // From now on, the descriptor only signals the exit of the background
+        // thread.
+        if (state_ == read_state::done) {
+            drain();
+
+            maybe_example_ = std::nullopt;
+
+            exception_ptr_ = nullptr;
+
+            state_ = read_state::idle;
+        }
+
+        if (!thread_.joinable())
+            is_stopped_ = true;
+    }
+
+    // Let the read in flight, if any, stop at its next cancellation point.
+    cancellation_token_.cancel();
+
+    condition_.notify_one();
+}
+
+bool
+data_pipeline_async_reader::is_stopped() const
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    return is_stopped_;
+}
+
+void
+data_pipeline_async_reader::run() noexcept
+{
+    cancellation_scope scope{cancellation_token_};
+
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    while (true) {
+        condition_.wait(lock, [this]
+        {
+            return state_ == read_state::reading || is_closed_;
+        });
+
+        if (is_closed_)
+            break;
+
+        lock.unlock();
+
+        std::optional<data> maybe_example{};
+
+        std::exception_ptr exception_ptr{};
+
+        try {
+            maybe_example = pipeline_->next();
+        } catch (...) {
+            exception_ptr = std::current_exception();
+        }
+
+        lock.lock();
+
+        // Nobody is interested in the result anymore.
+        if (is_closed_) {
+            lock.unlock();
+
+            // Destroying the result might call back into Python (e.g. to drop
+            // a reference to a Python object), which must not happen while we
+            // hold the lock.
+            maybe_example = std::nullopt;
+
+            exception_ptr = nullptr;
+
+            lock.lock();
+
+            break;
+        }
+
+        maybe_example_ = std::move(maybe_example);
+
+        exception_ptr_ = std::move(exception_ptr);
+
+        state_ = read_state::done;
+
+        notify();
+    }
+
+    is_stopped_ = true;
+
+    notify();
+}
+
+void
+data_pipeline_async_reader::notify() noexcept
+{
+#ifdef __linux__
+    std::uint64_t value = 1;
+
+    if (::write(read_fd_.get(), &value, sizeof(value)) == -1) {
+        // The counter cannot overflow since we drain it on every read.
+    }
+#else
+    char value = 1;
+
+    if (::write(write_fd_.get(), &value, sizeof(value)) == -1) {
+        // The pipe cannot fill up since we drain it on every read.
+    }
+#endif
+}
+
+void
+data_pipeline_async_reader::drain() noexcept
+{
+#ifdef __linux__
+    std::uint64_t value{};
+
+    if (::read(read_fd_.get(), &value, sizeof(value)) == -1) {
+        // Nothing to drain.
+    }
+#else
+    std::array<char, 64> buffer{};
+
+    while (::read(read_fd_.get(), buffer.data(), buffer.size()) > 0);
+#endif
+}
+
+}  // namespace fairseq2n
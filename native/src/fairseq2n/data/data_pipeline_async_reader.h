@@ -0,0 +1,111 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "fairseq2n/api.h"
+#include "fairseq2n/data/data.h"
+#include "fairseq2n/data/detail/file.h"
+#include "fairseq2n/detail/cancellation.h"
+
+namespace fairseq2n {
+
+class data_pipeline;
+
+// Reads the examples of a data pipeline on a background thread and signals the
+// completion of each read through a file descriptor, so that an event loop
+// (e.g. asyncio) can wait for the next example without blocking.
+//
+// Only one read is in flight at a time; a read that is requested while another
+// is in flight or whose result has not been taken yet is a no-op. Therefore,
+// abandoning a wait (e.g. due to a timeout) does not lose any example; the
+// pending result is returned by the next `take_result()` call.
+//
+// Closing the reader does not block; the background thread exits once the
+// read in flight, if any, returns, and signals it through the same descriptor.
+// The data pipeline must outlive the background thread.
+class FAIRSEQ2_API data_pipeline_async_reader {
+    enum class read_state { idle, reading, done };
+
+public:
+    explicit
+    data_pipeline_async_reader(data_pipeline &pipeline);
+
+    data_pipeline_async_reader(const data_pipeline_async_reader &) = delete;
+    data_pipeline_async_reader &operator=(const data_pipeline_async_reader &) = delete;
+
+    data_pipeline_async_reader(data_pipeline_async_reader &&) = delete;
+    data_pipeline_async_reader &operator=(data_pipeline_async_reader &&) = delete;
+
+    // Closes the reader and waits for the background thread to exit. To avoid
+    // blocking, call `close()` and wait for `is_stopped()` beforehand.
+   ~data_pipeline_async_reader();
+
+    // Starts reading the next example unless a read is already in flight or
+    // its result has not been taken yet.
+    void
+    request_next();
+
+    bool
+    is_ready() const;
+
+    // Returns the result of the completed read, or rethrows its error. Must
+    // only be called when `is_ready()` returns `true`.
+    std::optional<data>
+    take_result();
+
+    // Cancels the read in flight, if any, and asks the background thread to
+    // exit without waiting for it. The result of a completed read that has not
+    // been taken yet is discarded.
+    void
+    close() noexcept;
+
+    // Returns `true` if the reader is closed and its background thread has
+    // exited (or was never started). Only then the data pipeline can be used
+    // (e.g. reset) again.
+    bool
+    is_stopped() const;
+
+    // Returns a file descriptor that becomes readable once a read completes,
+    // or, after `close()`, once the background thread exits.
+    int
+    fd() const noexcept
+    {
+        return read_fd_.get();
+    }
+
+private:
+    void
+    run() noexcept;
+
+    void
+    notify() noexcept;
+
+    void
+    drain() noexcept;
+
+private:
+    data_pipeline *pipeline_;
+    detail::file_desc read_fd_{};
+    detail::file_desc write_fd_{};
+    std::thread thread_{};
+    mutable std::mutex mutex_{};
+    std::condition_variable condition_{};
+    read_state state_ = read_state::idle;
+    bool is_closed_ = false;
+    bool is_stopped_ = false;
+    std::optional<data> maybe_example_{};
+    std::exception_ptr exception_ptr_{};
+    detail::cancellation_token cancellation_token_;
+};
+
+}  // namespace fairseq2n
@@ -0,0 +1,189 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/data_sink.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+
+#include <ATen/Tensor.h>
+
+#include "fairseq2n/exception.h"
+#include "fairseq2n/fmt.h"
+#include "fairseq2n/memory.h"
+#include "fairseq2n/data/file_writer.h"
+#include "fairseq2n/data/immutable_string.h"
+#include "fairseq2n/detail/exception.h"
+
+using namespace fairseq2n::detail;
+
+namespace fairseq2n {
+namespace detail {
+namespace {
+
+void
+write_le64(file_writer &writer, std::uint64_t value)
+{
+    std::array<std::byte, 8> bytes{};
+
+    for (std::size_t i = 0; i < bytes.size(); ++i)
+        bytes[i] = static_cast<std::byte>(value >> (8 * i));
+
+    writer.write(memory_span{bytes.data(), bytes.size()});
+}
+
+// The data type codes stored in the tensor index. Never renumber them; only
+// append new ones.
+std::optional<std::uint64_t>
+get_dtype_code(at::ScalarType t) noexcept
+{
+    switch (t) {
+    case at::ScalarType::Bool:
+        return 0;
+    case at::ScalarType::Byte:
+        return 1;
+    case at::ScalarType::Char:
+        return 2;
+    case at::ScalarType::Short:
+        return 3;
+    case at::ScalarType::Int:
+        return 4;
+    case at::ScalarType::Long:
+        return 5;
+    case at::ScalarType::Half:
+        return 6;
+    case at::ScalarType::BFloat16:
+        return 7;
+    case at::ScalarType::Float:
+        return 8;
+    case at::ScalarType::Double:
+        return 9;
+    default:
+        return std::nullopt;
+    }
+}
+
+void
+write_index_entry(
+    file_writer &index_writer, std::size_t tensor_idx, const at::Tensor &tensor, std::uint64_t offset)
+{
+    std::optional<std::uint64_t> maybe_dtype_code = get_dtype_code(tensor.scalar_type());
+    if (!maybe_dtype_code)
+        throw_<not_supported_error>(
+            "The tensor {} in the pipeline has a data type that cannot be recorded in the index. Only boolean, integral, and floating-point types are supported.", tensor_idx);
+
+    write_le64(index_writer, offset);
+
+    write_le64(index_writer, *maybe_dtype_code);
+
+    write_le64(index_writer, static_cast<std::uint64_t>(tensor.dim()));
+
+    for (std::int64_t size : tensor.sizes())
+        write_le64(index_writer, static_cast<std::uint64_t>(size));
+}
+
+}  // namespace
+}  // namespace detail
+
+std::size_t
+write_records(
+    data_pipeline &pipeline,
+    const std::filesystem::path &path,
+    const file_writer_options &opts)
+{
+    file_writer writer{path, opts};
+
+    std::size_t num_records = 0;
+
+    while (std::optional<data> maybe_example = pipeline.next()) {
+        const data &example = *maybe_example;
+
+        memory_span record{};
+
+        if (example.is_memory_block())
+            record = example.as_memory_block();
+        else if (example.is_string()) {
+            const immutable_string &s = example.as_string();
+
+            record = memory_span{reinterpret_cast<const std::byte *>(s.data()), s.size()};
+        } else
+            throw_<std::invalid_argument>(
+                "The example {} in the pipeline must be of type `memory_block` or `string`, but is of type `{}` instead.", num_records, example.type());
+
+        write_le64(writer, record.size());
+
+        writer.write(record);
+
+        num_records++;
+    }
+
+    writer.commit();
+
+    return num_records;
+}
+
+std::size_t
+write_tensors(
+    data_pipeline &pipeline,
+    const std::filesystem::path &path,
+    const std::optional<std::filesystem::path> &maybe_index_path,
+    const file_writer_options &opts)
+{
+    file_writer writer{path, opts};
+
+    // The index is meant for random access; we never compress it.
+    std::unique_ptr<file_writer> index_writer{};
+    if (maybe_index_path)
+        index_writer = std::make_unique<file_writer>(
+            *maybe_index_path, file_writer_options().maybe_block_size(opts.maybe_block_size()));
+
+    std::optional<at::ScalarType> maybe_dtype{};
+
+    std::size_t num_tensors = 0;
+
+    std::uint64_t offset = 0;
+
+    while (std::optional<data> maybe_example = pipeline.next()) {
+        const data &example = *maybe_example;
+
+        if (!example.is_tensor())
+            throw_<std::invalid_argument>(
+                "The example {} in the pipeline must be of type `torch.Tensor`, but is of type `{}` instead.", num_tensors, example.type());
+
+        const at::Tensor &tensor = example.as_tensor();
+
+        if (!maybe_dtype)
+            maybe_dtype = tensor.scalar_type();
+        else if (tensor.scalar_type() != *maybe_dtype)
+            throw_<std::invalid_argument>(
+                "The tensor {} in the pipeline must have the same data type as the first tensor.", num_tensors);
+
+        at::Tensor t = tensor.cpu().contiguous();
+
+        writer.write(memory_span{static_cast<const std::byte *>(t.data_ptr()), t.nbytes()});
+
+        if (index_writer)
+            write_index_entry(*index_writer, num_tensors, t, offset);
+
+        offset += static_cast<std::uint64_t>(t.numel());
+
+        num_tensors++;
+    }
+
+    // Commit the data file first; an index must never refer to a data file
+    // that does not exist (yet).
+    writer.commit();
+
+    if (index_writer)
+        index_writer->commit();
+
+    return num_tensors;
+}
+
+}  // namespace fairseq2n
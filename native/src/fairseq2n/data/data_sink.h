@@ -0,0 +1,42 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+
+#include "fairseq2n/api.h"
+#include "fairseq2n/data/data_pipeline.h"
+#include "fairseq2n/data/file.h"
+
+namespace fairseq2n {
+
+// Drains `pipeline` and writes each of its examples, which must be memory
+// blocks or strings, to `path` as a record made of its size as a 64-bit
+// little-endian integer followed by its bytes. Returns the number of records.
+FAIRSEQ2_API std::size_t
+write_records(
+    data_pipeline &pipeline,
+    const std::filesystem::path &path,
+    const file_writer_options &opts = {});
+
+// Drains `pipeline` and writes the elements of each of its examples, which must
+// be tensors of the same data type, back to back to `path` in row-major order.
+// If `maybe_index_path` is specified, also writes an entry per tensor to that
+// path made of its element offset, its data type code, its number of
+// dimensions, and its size in each dimension, all as 64-bit little-endian
+// integers. The data file is committed before the index. Returns the number of
+// tensors.
+FAIRSEQ2_API std::size_t
+write_tensors(
+    data_pipeline &pipeline,
+    const std::filesystem::path &path,
+    const std::optional<std::filesystem::path> &maybe_index_path = {},
+    const file_writer_options &opts = {});
+
+}  // namespace fairseq2n
@@ -6,8 +6,26 @@
 
 #include "fairseq2n/data/data_source.h"
 
+#include <utility>
+
 namespace fairseq2n {
 
 data_source::~data_source() = default;
 
+std::size_t
+data_source::next_n(std::size_t num_examples, data_list &output)
+{
+    std::size_t i = 0;
+
+    for (; i < num_examples; ++i) {
+        std::optional<data> maybe_example = next();
+        if (!maybe_example)
+            break;
+
+        output.push_back(*std::move(maybe_example));
+    }
+
+    return i;
+}
+
 }
@@ -31,6 +31,13 @@ public:
     virtual std::optional<data>
     next() = 0;
 
+    // Appends up to `num_examples` examples to `output` and returns the number
+    // of appended examples; a return value less than `num_examples` indicates
+    // the end of data. The default implementation calls `next()` repeatedly;
+    // data sources that can move their examples in bulk should override it.
+    virtual std::size_t
+    next_n(std::size_t num_examples, data_list &output);
+
     virtual void
     reset(bool reset_rng) = 0;
 
@@ -6,10 +6,12 @@
 
 #include "fairseq2n/data/detail/file.h"
 
+#include <cstdint>
 #include <system_error>
 
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #include "fairseq2n/memory.h"
 #include "fairseq2n/detail/error.h"
@@ -48,4 +50,29 @@ memory_map_file(const file_desc &fd, const std::filesystem::path &path)
     return memory_block{static_cast<std::byte *>(addr), size, nullptr, mmap_deallocate};
 }
 
+void
+hint_will_need_memory(const memory_block &block) noexcept
+{
+#ifdef __linux__
+    if (block.empty())
+        return;
+
+    // `block` might be a slice of a memory map, but `madvise()` expects a page
+    // aligned address.
+    auto page_size = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+
+    auto addr = reinterpret_cast<std::uintptr_t>(block.data());
+
+    std::uintptr_t aligned_addr = addr & ~(page_size - 1);
+
+    // This is only a hint; if the kernel rejects it, the pages are still read
+    // on demand, so we deliberately ignore the result.
+    // NOLINTNEXTLINE(performance-no-int-to-ptr)
+    (void) ::madvise(
+        reinterpret_cast<void *>(aligned_addr), block.size() + (addr - aligned_addr), MADV_WILLNEED);
+#else
+    (void) block;
+#endif
+}
+
 }  // namespace fairseq2n::detail
@@ -87,4 +87,10 @@ operator!=(const file_desc &lhs, const file_desc &rhs) noexcept
 memory_block
 memory_map_file(const file_desc &fd, const std::filesystem::path &path);
 
+// Asks the kernel to start reading the pages of `block` in the background, so
+// that the calling thread does not block on page faults when it (or a thread
+// further down the pipeline) accesses them later.
+void
+hint_will_need_memory(const memory_block &block) noexcept;
+
 }
@@ -0,0 +1,138 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "fairseq2n/memory.h"
+
+namespace fairseq2n::detail {
+
+// The functions in this file implement the 64-bit variant of xxHash. Unlike
+// `std::hash`, their output is fully specified and is therefore stable across
+// processes, machines, and library versions.
+
+inline constexpr std::uint64_t xxh_prime64_1 = 0x9E3779B185EBCA87ULL;
+inline constexpr std::uint64_t xxh_prime64_2 = 0xC2B2AE3D27D4EB4FULL;
+inline constexpr std::uint64_t xxh_prime64_3 = 0x165667B19E3779F9ULL;
+inline constexpr std::uint64_t xxh_prime64_4 = 0x85EBCA77C2B2AE63ULL;
+inline constexpr std::uint64_t xxh_prime64_5 = 0x27D4EB2F165667C5ULL;
+
+inline constexpr std::uint64_t
+rotl64(std::uint64_t x, int r) noexcept
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+// Reads `T` in little-endian byte order regardless of the host byte order.
+template <typename T>
+inline T
+read_le(const std::byte *ptr) noexcept
+{
+    T value = 0;
+
+    for (std::size_t i = 0; i < sizeof(T); i++)
+        value |= static_cast<T>(std::to_integer<T>(ptr[i]) << (8 * i));
+
+    return value;
+}
+
+inline constexpr std::uint64_t
+xxh64_round(std::uint64_t acc, std::uint64_t input) noexcept
+{
+    acc += input * xxh_prime64_2;
+
+    return rotl64(acc, 31) * xxh_prime64_1;
+}
+
+inline constexpr std::uint64_t
+xxh64_merge_round(std::uint64_t acc, std::uint64_t val) noexcept
+{
+    acc ^= xxh64_round(0, val);
+
+    return acc * xxh_prime64_1 + xxh_prime64_4;
+}
+
+inline constexpr std::uint64_t
+xxh64_avalanche(std::uint64_t h) noexcept
+{
+    h ^= h >> 33;
+    h *= xxh_prime64_2;
+    h ^= h >> 29;
+    h *= xxh_prime64_3;
+    h ^= h >> 32;
+
+    return h;
+}
+
+inline std::uint64_t
+xxh64(memory_span bytes, std::uint64_t seed = 0) noexcept
+{
+    const std::byte *ptr = bytes.data();
+    const std::byte *end = ptr + bytes.size();
+
+    std::uint64_t h{};
+
+    if (bytes.size() >= 32) {
+        std::uint64_t v1 = seed + xxh_prime64_1 + xxh_prime64_2;
+        std::uint64_t v2 = seed + xxh_prime64_2;
+        std::uint64_t v3 = seed;
+        std::uint64_t v4 = seed - xxh_prime64_1;
+
+        for (; end - ptr >= 32; ptr += 32) {
+            v1 = xxh64_round(v1, read_le<std::uint64_t>(ptr));
+            v2 = xxh64_round(v2, read_le<std::uint64_t>(ptr + 8));
+            v3 = xxh64_round(v3, read_le<std::uint64_t>(ptr + 16));
+            v4 = xxh64_round(v4, read_le<std::uint64_t>(ptr + 24));
+        }
+
+        h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+
+        h = xxh64_merge_round(h, v1);
+        h = xxh64_merge_round(h, v2);
+        h = xxh64_merge_round(h, v3);
+        h = xxh64_merge_round(h, v4);
+    } else
+        h = seed + xxh_prime64_5;
+
+    h += static_cast<std::uint64_t>(bytes.size());
+
+    for (; end - ptr >= 8; ptr += 8) {
+        h ^= xxh64_round(0, read_le<std::uint64_t>(ptr));
+
+        h = rotl64(h, 27) * xxh_prime64_1 + xxh_prime64_4;
+    }
+
+    if (end - ptr >= 4) {
+        h ^= static_cast<std::uint64_t>(read_le<std::uint32_t>(ptr)) * xxh_prime64_1;
+
+        h = rotl64(h, 23) * xxh_prime64_2 + xxh_prime64_3;
+
+        ptr += 4;
+    }
+
+    for (; ptr < end; ++ptr) {
+        h ^= std::to_integer<std::uint64_t>(*ptr) * xxh_prime64_5;
+
+        h = rotl64(h, 11) * xxh_prime64_1;
+    }
+
+    return xxh64_avalanche(h);
+}
+
+// Mixes `value` into the running hash `h`. This is the same step that xxHash
+// uses to consume 8-byte words and is sensitive to the order of its calls.
+inline constexpr std::uint64_t
+hash_combine(std::uint64_t h, std::uint64_t value) noexcept
+{
+    h ^= xxh64_round(0, value);
+
+    return rotl64(h, 27) * xxh_prime64_1 + xxh_prime64_4;
+}
+
+}  // namespace fairseq2n::detail
@@ -13,6 +13,7 @@
 #include <sys/mman.h>
 
 #include "fairseq2n/data/byte_stream.h"
+#include "fairseq2n/data/file_cache.h"
 #include "fairseq2n/data/file_stream.h"
 #include "fairseq2n/data/memory_stream.h"
 #include "fairseq2n/data/detail/file.h"
@@ -29,6 +30,18 @@ namespace {
 file_desc
 do_open_file(const std::filesystem::path &path)
 {
+    if (std::shared_ptr<file_cache> cache = get_file_cache(); cache) {
+        std::filesystem::path local_path = cache->get_local_path(path);
+        if (local_path != path) {
+            file_desc fd = ::open(local_path.c_str(), O_RDONLY | O_CLOEXEC);
+
+            // The entry might have been evicted by another process since it
+            // was looked up; in that case, fall back to the original file.
+            if (fd != invalid_fd)
+                return fd;
+        }
+    }
+
     file_desc fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
     if (fd != invalid_fd)
         return fd;
@@ -96,6 +96,46 @@ text_file_options(std::optional<std::string> maybe_text_encoding = {}) noexcept
     return file_options().mode(file_mode::text).maybe_text_encoding(std::move(maybe_text_encoding));
 }
 
+enum class file_compression {
+    none,
+    gzip
+};
+
+class file_writer_options {
+public:
+    file_writer_options
+    compression(file_compression value) && noexcept
+    {
+        compression_ = value;
+
+        return std::move(*this);
+    }
+
+    file_compression
+    compression() const noexcept
+    {
+        return compression_;
+    }
+
+    file_writer_options
+    maybe_block_size(std::optional<std::size_t> value) && noexcept
+    {
+        maybe_block_size_ = value;
+
+        return std::move(*this);
+    }
+
+    std::optional<std::size_t>
+    maybe_block_size() const noexcept
+    {
+        return maybe_block_size_;
+    }
+
+private:
+    file_compression compression_ = file_compression::none;
+    std::optional<std::size_t> maybe_block_size_{};
+};
+
 FAIRSEQ2_API std::unique_ptr<byte_stream>
 open_file(const std::filesystem::path &path, const file_options &opts = {});
 
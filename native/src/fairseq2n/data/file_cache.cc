@@ -0,0 +1,369 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/file_cache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+#include "fairseq2n/memory.h"
+#include "fairseq2n/data/detail/file.h"
+#include "fairseq2n/data/detail/hash.h"
+#include "fairseq2n/detail/error.h"
+#include "fairseq2n/detail/exception.h"
+
+using namespace fairseq2n::detail;
+
+namespace fairseq2n {
+namespace detail {
+namespace {
+
+constexpr std::string_view tmp_suffix = ".cache-tmp";
+
+// Temporary files older than this are considered orphaned by a process that
+// crashed while populating the cache.
+constexpr auto max_tmp_file_age = std::chrono::hours{1};
+
+constexpr std::size_t entry_hash_size = 16;
+
+bool
+is_digit(char c) noexcept
+{
+    return c >= '0' && c <= '9';
+}
+
+bool
+is_lower_hex_digit(char c) noexcept
+{
+    return is_digit(c) || (c >= 'a' && c <= 'f');
+}
+
+// Checks whether `name` is of the form returned by `make_entry_name()` (i.e.
+// 16 lowercase hex digits followed by an optional extension). The cache never
+// touches any other file in `cache_dir`.
+bool
+is_entry_name(std::string_view name) noexcept
+{
+    if (name.size() < entry_hash_size)
+        return false;
+
+    std::string_view hash = name.substr(0, entry_hash_size);
+
+    if (!std::all_of(hash.begin(), hash.end(), is_lower_hex_digit))
+        return false;
+
+    std::string_view ext = name.substr(entry_hash_size);
+
+    return ext.empty() || (ext.front() == '.' && ext.find('.', 1) == std::string_view::npos);
+}
+
+// Strips a `.<number>` suffix from `name`; returns `false` if it has none.
+bool
+strip_number_suffix(std::string_view &name) noexcept
+{
+    std::size_t pos = name.rfind('.');
+    if (pos == std::string_view::npos)
+        return false;
+
+    std::string_view number = name.substr(pos + 1);
+
+    if (number.empty() || !std::all_of(number.begin(), number.end(), is_digit))
+        return false;
+
+    name = name.substr(0, pos);
+
+    return true;
+}
+
+// Checks whether `name` is of the form `<entry>.<pid>.<n>.cache-tmp` used by
+// `file_cache::populate()`.
+bool
+is_tmp_name(std::string_view name) noexcept
+{
+    if (name.size() <= tmp_suffix.size())
+        return false;
+
+    if (name.substr(name.size() - tmp_suffix.size()) != tmp_suffix)
+        return false;
+
+    name.remove_suffix(tmp_suffix.size());
+
+    // Strip the counter and the process id.
+    if (!strip_number_suffix(name) || !strip_number_suffix(name))
+        return false;
+
+    return is_entry_name(name);
+}
+
+// Derives the name of the cache entry of `path` from its absolute pathname,
+// size, and modification time; an entry of a modified file is never reused
+// and eventually gets evicted.
+std::string
+make_entry_name(const std::filesystem::path &path, const struct ::stat &buf)
+{
+    const std::string &pathname = path.native();
+
+    memory_span bytes{reinterpret_cast<const std::byte *>(pathname.data()), pathname.size()};
+
+    std::uint64_t h = xxh64(bytes);
+
+    h = hash_combine(h, static_cast<std::uint64_t>(buf.st_size));
+
+#ifdef __linux__
+    const struct ::timespec &mtime = buf.st_mtim;
+#else
+    const struct ::timespec &mtime = buf.st_mtimespec;
+#endif
+
+    h = hash_combine(h, static_cast<std::uint64_t>(mtime.tv_sec));
+    h = hash_combine(h, static_cast<std::uint64_t>(mtime.tv_nsec));
+
+    // Keep the extension to make the entries easier to inspect.
+    return fmt::format("{:016x}{}", h, path.extension().string());
+}
+
+struct cache_entry {
+    std::filesystem::path path;
+    std::size_t size;
+    std::filesystem::file_time_type last_use_time;
+};
+
+// Collects the entries in `cache_dir`, removes orphaned temporary files along
+// the way, and returns the total size of the entries.
+std::size_t
+scan_cache_dir(const std::filesystem::path &cache_dir, std::vector<cache_entry> &entries)
+{
+    std::size_t total_size = 0;
+
+    auto now = std::filesystem::file_time_type::clock::now();
+
+    std::error_code err{};
+
+    std::filesystem::directory_iterator iter{cache_dir, err}, end{};
+
+    for (; !err && iter != end; iter.increment(err)) {
+        std::error_code entry_err{};
+
+        const std::filesystem::path &entry_path = iter->path();
+
+        std::string name = entry_path.filename().string();
+
+        bool is_tmp = is_tmp_name(name);
+
+        // Leave files that do not belong to the cache alone, even if they
+        // live in `cache_dir`.
+        if (!is_tmp && !is_entry_name(name))
+            continue;
+
+        auto last_write_time = std::filesystem::last_write_time(entry_path, entry_err);
+        if (entry_err)
+            continue;
+
+        std::size_t entry_size = std::filesystem::file_size(entry_path, entry_err);
+        if (entry_err)
+            continue;
+
+        if (is_tmp) {
+            if (now - last_write_time > max_tmp_file_age)
+                ::unlink(entry_path.c_str());
+
+            continue;
+        }
+
+        entries.push_back(cache_entry{entry_path, entry_size, last_write_time});
+
+        total_size += entry_size;
+    }
+
+    return total_size;
+}
+
+// Flushes the contents of `path` to the disk.
+bool
+sync_file(const std::filesystem::path &path) noexcept
+{
+    file_desc fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == invalid_fd)
+        return false;
+
+    return ::fsync(fd.get()) == 0;
+}
+
+std::mutex file_cache_mutex{};
+
+std::shared_ptr<file_cache> global_file_cache{};
+
+}  // namespace
+}  // namespace detail
+
+file_cache::file_cache(std::filesystem::path cache_dir, std::size_t max_size)
+  : max_size_{max_size}
+{
+    std::error_code err{};
+
+    std::filesystem::create_directories(cache_dir, err);
+    if (err)
+        throw_system_error(err,
+            "The file cache directory '{}' cannot be created", cache_dir.string());
+
+    cache_dir_ = std::filesystem::absolute(cache_dir, err);
+    if (err)
+        throw_system_error(err,
+            "The file cache directory '{}' cannot be resolved", cache_dir.string());
+
+    std::vector<cache_entry> entries{};
+
+    total_size_ = scan_cache_dir(cache_dir_, entries);
+}
+
+std::filesystem::path
+file_cache::get_local_path(const std::filesystem::path &path)
+{
+    std::error_code err{};
+
+    std::filesystem::path abs_path = std::filesystem::absolute(path, err);
+    if (err)
+        return path;
+
+    // Let the caller report the error if `path` is not a regular file.
+    struct ::stat buf{};
+    if (::stat(abs_path.c_str(), &buf) == -1 || !S_ISREG(buf.st_mode))
+        return path;
+
+    if (abs_path.parent_path() == cache_dir_)
+        return path;
+
+    std::filesystem::path local_path = cache_dir_ / make_entry_name(abs_path, buf);
+
+    // Touching the entry serves both as an existence check and as the LRU
+    // timestamp used for eviction.
+    if (::utimensat(AT_FDCWD, local_path.c_str(), nullptr, 0) == 0) {
+        num_hits_++;
+
+        return local_path;
+    }
+
+    num_misses_++;
+
+    auto size = static_cast<std::size_t>(buf.st_size);
+    if (size > max_size_)
+        return path;
+
+    if (!populate(abs_path, local_path, size))
+        return path;
+
+    return local_path;
+}
+
+bool
+file_cache::populate(
+    const std::filesystem::path &path, const std::filesystem::path &local_path, std::size_t size)
+{
+    reserve(size);
+
+    // We copy to a temporary file first and atomically rename it so that
+    // concurrent readers (e.g. other processes) never see a partial copy. If
+    // several processes miss the same file at the same time, each makes its
+    // own copy and the last rename wins.
+    std::filesystem::path tmp_path = local_path;
+
+    tmp_path += fmt::format(".{}.{}{}", ::getpid(), num_tmp_files_++, tmp_suffix);
+
+    std::error_code err{};
+
+    std::filesystem::copy_file(
+        path, tmp_path, std::filesystem::copy_options::overwrite_existing, err);
+    // Without the sync, a crash right after the rename might leave an empty
+    // or truncated entry that would be served as a hit.
+    if (err || !sync_file(tmp_path) || ::rename(tmp_path.c_str(), local_path.c_str()) == -1) {
+        ::unlink(tmp_path.c_str());
+
+        release(size);
+
+        return false;
+    }
+
+    return true;
+}
+
+void
+file_cache::reserve(std::size_t size)
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+
+    // `total_size_` is seeded by a scan and then only tracks the entries that
+    // we add ourselves. Scanning the directory on every miss would make each
+    // miss linear in the number of entries; instead we rescan only once we
+    // appear to be over budget, which also picks up the entries added and
+    // evicted by other processes in the meantime.
+    if (total_size_ + size <= max_size_) {
+        total_size_ += size;
+
+        return;
+    }
+
+    std::vector<cache_entry> entries{};
+
+    total_size_ = scan_cache_dir(cache_dir_, entries);
+
+    if (total_size_ + size > max_size_) {
+        std::sort(entries.begin(), entries.end(), [](const cache_entry &a, const cache_entry &b)
+        {
+            return a.last_use_time < b.last_use_time;
+        });
+
+        // Unlinking an entry that is still open (or memory mapped) is safe;
+        // its readers keep their view of the file until they close it.
+        for (const cache_entry &entry : entries) {
+            if (::unlink(entry.path.c_str()) == 0)
+                total_size_ -= std::min(total_size_, entry.size);
+
+            if (total_size_ + size <= max_size_)
+                break;
+        }
+    }
+
+    total_size_ += size;
+}
+
+void
+file_cache::release(std::size_t size)
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+
+    total_size_ -= std::min(total_size_, size);
+}
+
+void
+set_file_cache(std::shared_ptr<file_cache> cache)
+{
+    std::lock_guard<std::mutex> lock{file_cache_mutex};
+
+    global_file_cache = std::move(cache);
+}
+
+std::shared_ptr<file_cache>
+get_file_cache()
+{
+    std::lock_guard<std::mutex> lock{file_cache_mutex};
+
+    return global_file_cache;
+}
+
+}  // namespace fairseq2n
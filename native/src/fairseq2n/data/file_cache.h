@@ -0,0 +1,95 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+
+#include "fairseq2n/api.h"
+
+namespace fairseq2n {
+
+// Keeps local copies of files that live on slow (e.g. network) storage.
+//
+// A file is copied as a whole to `cache_dir` the first time it is opened and
+// is served from there afterwards, as long as its size and modification time
+// do not change. Once the total size of the cached files would exceed
+// `max_size` bytes, the least-recently-used ones are evicted. Copies are
+// written to a temporary file and renamed into place, so several processes
+// (e.g. data loader workers or ranks on the same host) can safely share the
+// same `cache_dir`; in that case `max_size` is enforced approximately since
+// each process only rescans `cache_dir` once its own running total exceeds
+// `max_size`. Files in `cache_dir` that were not created by the cache are left
+// alone.
+class FAIRSEQ2_API file_cache {
+public:
+    explicit
+    file_cache(std::filesystem::path cache_dir, std::size_t max_size);
+
+    // Returns the path of the local copy of `path`, copying it to the cache if
+    // necessary. If `path` cannot be cached (e.g. it is larger than `max_size`
+    // or the copy fails), returns `path` itself.
+    std::filesystem::path
+    get_local_path(const std::filesystem::path &path);
+
+    const std::filesystem::path &
+    cache_dir() const noexcept
+    {
+        return cache_dir_;
+    }
+
+    std::size_t
+    max_size() const noexcept
+    {
+        return max_size_;
+    }
+
+    std::size_t
+    num_hits() const noexcept
+    {
+        return num_hits_;
+    }
+
+    std::size_t
+    num_misses() const noexcept
+    {
+        return num_misses_;
+    }
+
+private:
+    bool
+    populate(const std::filesystem::path &path, const std::filesystem::path &local_path, std::size_t size);
+
+    void
+    reserve(std::size_t size);
+
+    void
+    release(std::size_t size);
+
+private:
+    std::filesystem::path cache_dir_;
+    std::size_t max_size_;
+    std::atomic<std::size_t> num_hits_{};
+    std::atomic<std::size_t> num_misses_{};
+    std::atomic<std::size_t> num_tmp_files_{};
+    std::mutex mutex_{};
+    std::size_t total_size_{};
+};
+
+// Sets the cache used by `open_file()`, `memory_map_file()`, and all readers
+// built on top of them. If `nullptr`, files are read from their original
+// location.
+FAIRSEQ2_API void
+set_file_cache(std::shared_ptr<file_cache> cache);
+
+FAIRSEQ2_API std::shared_ptr<file_cache>
+get_file_cache();
+
+}  // namespace fairseq2n
@@ -15,6 +15,7 @@
 #include "fairseq2n/utils/string.h"
 #include "fairseq2n/data/immutable_string.h"
 #include "fairseq2n/data/file.h"
+#include "fairseq2n/data/detail/file.h"
 #include "fairseq2n/detail/exception.h"
 
 using namespace fairseq2n::detail;
@@ -23,8 +24,10 @@ namespace fairseq2n {
 
 file_mapper::file_mapper(
     std::optional<std::filesystem::path> maybe_root_dir,
-    std::optional<std::size_t> maybe_cached_fd_count) noexcept
-  : cache_{/*capacity=*/maybe_cached_fd_count.value_or(default_cached_fd_count)}
+    std::optional<std::size_t> maybe_cached_fd_count,
+    bool readahead) noexcept
+  : readahead_{readahead},
+    cache_{/*capacity=*/maybe_cached_fd_count.value_or(default_cached_fd_count)}
 {
     if (maybe_root_dir)
         root_dir_ = *std::move(maybe_root_dir);
@@ -86,8 +89,15 @@ file_mapper::operator()(data &&d) const
 
     memory_block block = get_memory_map(parts[0]);
 
-    auto pack_output = [&d](memory_block &&blk)
+    auto pack_output = [this, &d](memory_block &&blk)
     {
+        // Hint the kernel to start reading the data before it is first
+        // accessed (typically by a decoder in a subsequent `map()`). This is a
+        // readahead hint only; the accesses still block on whatever pages have
+        // not been read by then.
+        if (readahead_)
+            hint_will_need_memory(blk);
+
         data_dict output{};
 
         output.emplace("path", std::move(d));
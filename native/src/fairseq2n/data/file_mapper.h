@@ -28,7 +28,8 @@ public:
     explicit
     file_mapper(
         std::optional<std::filesystem::path> maybe_root_dir = {},
-        std::optional<std::size_t> maybe_cached_fd_count = {}) noexcept;
+        std::optional<std::size_t> maybe_cached_fd_count = {},
+        bool readahead = false) noexcept;
 
     data
     operator()(data &&d) const;
@@ -39,6 +40,7 @@ private:
 
 private:
     std::filesystem::path root_dir_{};
+    bool readahead_;
     mutable std::mutex cache_mutex_{};
     mutable detail::lru_cache<memory_block> cache_;
 };
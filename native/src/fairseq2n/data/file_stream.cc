@@ -12,6 +12,7 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+#include "fairseq2n/detail/cancellation.h"
 #include "fairseq2n/detail/error.h"
 #include "fairseq2n/detail/exception.h"
 
@@ -45,6 +46,11 @@ file_stream::read_chunk()
     writable_memory_span remaining_space = chunk;
 
     while (!remaining_space.empty()) {
+        // A chunk can take several reads to fill (e.g. on a pipe or a network
+        // file system); stop early if nobody is waiting for it anymore. Note
+        // that a `fill_chunk()` call that is already blocked is not abandoned.
+        throw_if_cancelled();
+
         std::size_t num_bytes_read = fill_chunk(remaining_space);
         if (num_bytes_read == 0) {
             is_eod_ = true;
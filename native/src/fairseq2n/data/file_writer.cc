@@ -0,0 +1,420 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/file_writer.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <zip/src/miniz.h>
+
+#include "fairseq2n/fmt.h"
+#include "fairseq2n/data/byte_stream.h"
+#include "fairseq2n/data/detail/thread.h"
+#include "fairseq2n/detail/error.h"
+#include "fairseq2n/detail/exception.h"
+
+namespace fairseq2n::detail {
+
+// Produces a gzip member (RFC 1952) using the raw deflate encoder of miniz,
+// which we already ship as part of the zip library.
+class gzip_deflater {
+public:
+    explicit
+    gzip_deflater(std::size_t out_size)
+      : out_(out_size)
+    {
+        int result = mz_deflateInit2(
+            &stream_, MZ_DEFAULT_LEVEL, MZ_DEFLATED, -MZ_DEFAULT_WINDOW_BITS, 9, MZ_DEFAULT_STRATEGY);
+        if (result != MZ_OK)
+            throw_<std::runtime_error>(
+                "The gzip compressor cannot be initialized. Error code: {}", result);
+    }
+
+    gzip_deflater(const gzip_deflater &) = delete;
+    gzip_deflater &operator=(const gzip_deflater &) = delete;
+
+    gzip_deflater(gzip_deflater &&) = delete;
+    gzip_deflater &operator=(gzip_deflater &&) = delete;
+
+   ~gzip_deflater()
+    {
+        mz_deflateEnd(&stream_);
+    }
+
+    template <typename Func>
+    void
+    deflate(memory_span input, bool finish, Func &&write_fn)
+    {
+        if (!is_header_written_) {
+            // Magic number, deflate method, no flags, no mtime, no extra
+            // flags, and unknown OS.
+            static constexpr std::array<std::uint8_t, 10> header{
+                0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff};
+
+            write_fn(memory_span{reinterpret_cast<const std::byte *>(header.data()), header.size()});
+
+            is_header_written_ = true;
+        }
+
+        // Note that `mz_crc32()` returns the initial value for a null pointer.
+        if (!input.empty())
+            crc_ = mz_crc32(
+                crc_, reinterpret_cast<const unsigned char *>(input.data()), input.size());
+
+        input_size_ += input.size();
+
+        // `avail_in` is 32-bit; feed large inputs in pieces.
+        constexpr std::size_t max_piece_size = 0x4000'0000;  // 1 GiB
+
+        do {
+            std::size_t piece_size = std::min(input.size(), max_piece_size);
+
+            bool is_last_piece = piece_size == input.size();
+
+            deflate_piece(input.first(piece_size), finish && is_last_piece, write_fn);
+
+            input = input.subspan(piece_size);
+        } while (!input.empty());
+
+        if (finish) {
+            std::array<std::byte, 8> trailer{};
+
+            write_le32(trailer.data(), static_cast<std::uint32_t>(crc_));
+            write_le32(trailer.data() + 4, static_cast<std::uint32_t>(input_size_));
+
+            write_fn(memory_span{trailer.data(), trailer.size()});
+        }
+    }
+
+private:
+    template <typename Func>
+    void
+    deflate_piece(memory_span input, bool finish, Func &&write_fn)
+    {
+        stream_.next_in = reinterpret_cast<const unsigned char *>(input.data());
+        stream_.avail_in = static_cast<unsigned int>(input.size());
+
+        int flush = finish ? MZ_FINISH : MZ_NO_FLUSH;
+
+        while (true) {
+            stream_.next_out = reinterpret_cast<unsigned char *>(out_.data());
+            stream_.avail_out = static_cast<unsigned int>(out_.size());
+
+            int result = mz_deflate(&stream_, flush);
+            if (result != MZ_OK && result != MZ_STREAM_END && result != MZ_BUF_ERROR)
+                throw_<std::runtime_error>(
+                    "The data cannot be compressed. Error code: {}", result);
+
+            std::size_t num_bytes = out_.size() - stream_.avail_out;
+            if (num_bytes > 0)
+                write_fn(memory_span{out_.data(), num_bytes});
+
+            if (finish) {
+                if (result == MZ_STREAM_END)
+                    break;
+            } else if (stream_.avail_in == 0 && stream_.avail_out != 0)
+                break;
+        }
+    }
+
+    static void
+    write_le32(std::byte *ptr, std::uint32_t value) noexcept
+    {
+        for (std::size_t i = 0; i < 4; ++i)
+            ptr[i] = static_cast<std::byte>(value >> (8 * i));
+    }
+
+private:
+    mz_stream stream_{};
+    std::vector<std::byte> out_;
+    bool is_header_written_ = false;
+    mz_ulong crc_ = MZ_CRC32_INIT;
+    std::uint64_t input_size_ = 0;
+};
+
+namespace {
+
+file_desc
+create_file(const std::filesystem::path &path, std::filesystem::path &tmp_path)
+{
+    // Several processes, possibly on different hosts sharing the directory,
+    // might write the same path; let `mkostemp()` pick a unique name.
+    std::string tmp_name = path.string() + ".tmp.XXXXXX";
+
+    file_desc fd = ::mkostemp(tmp_name.data(), O_CLOEXEC);
+    if (fd != invalid_fd) {
+        tmp_path = tmp_name;
+
+        // `mkostemp()` creates the file with mode 0600.
+        if (::fchmod(fd.get(), 0644) == -1) {
+            std::error_code err = last_error();
+
+            ::unlink(tmp_name.c_str());
+
+            throw_system_error(err,
+                "'{}' cannot be created", path.string());
+        }
+
+        return fd;
+    }
+
+    std::error_code err = last_error();
+
+    if (err == std::errc::no_such_file_or_directory)
+        throw_<byte_stream_error>(
+            "The parent directory of '{}' does not exist.", path.string());
+
+    if (err == std::errc::permission_denied)
+        throw_<byte_stream_error>(
+            "The permission to write '{}' has been denied.", path.string());
+
+    throw_system_error(err,
+        "'{}' cannot be created", path.string());
+}
+
+}  // namespace
+
+file_writer::file_writer(std::filesystem::path path, const file_writer_options &opts)
+  : path_{std::move(path)}
+{
+    block_size_ = opts.maybe_block_size().value_or(0x0010'0000);  // 1 MiB
+    if (block_size_ == 0)
+        throw_<std::invalid_argument>("`block_size` must be greater than zero.");
+
+    // We write to a temporary file first and atomically rename it on commit so
+    // that readers never see a partial file.
+    fd_ = create_file(path_, tmp_path_);
+
+    if (opts.compression() == file_compression::gzip)
+        deflater_ = std::make_unique<gzip_deflater>(block_size_);
+
+    buffer_ = allocate_memory(block_size_);
+}
+
+file_writer::~file_writer()
+{
+    if (!is_committed_) {
+        std::unique_lock<std::mutex> queue_lock{queue_mutex_};
+
+        // The file will be discarded anyways; do not wait for the pending
+        // blocks to be written.
+        queue_.clear();
+    }
+
+    stop_write_thread();
+
+    if (is_committed_)
+        return;
+
+    fd_ = file_desc{};
+
+    ::unlink(tmp_path_.c_str());
+}
+
+void
+file_writer::write(memory_span bytes)
+{
+    while (!bytes.empty()) {
+        std::size_t num_bytes = std::min(bytes.size(), block_size_ - buffer_size_);
+
+        std::memcpy(buffer_.data() + buffer_size_, bytes.data(), num_bytes);
+
+        buffer_size_ += num_bytes;
+
+        if (buffer_size_ == block_size_)
+            flush_buffer();
+
+        bytes = bytes.subspan(num_bytes);
+    }
+}
+
+void
+file_writer::commit()
+{
+    if (is_committed_)
+        return;
+
+    flush_buffer();
+
+    stop_write_thread();
+
+    check_if_faulted();
+
+    if (deflater_)
+        write_block({}, /*is_last=*/true);
+
+    // Make sure the data reaches the disk before the rename; otherwise a crash
+    // might leave an empty or truncated file under the final name.
+    if (::fsync(fd_.get()) == -1)
+        throw_system_error(last_error(),
+            "'{}' cannot be written", path_.string());
+
+    fd_ = file_desc{};
+
+    if (::rename(tmp_path_.c_str(), path_.c_str()) == -1)
+        throw_system_error(last_error(),
+            "'{}' cannot be created", path_.string());
+
+    is_committed_ = true;
+}
+
+void
+file_writer::flush_buffer()
+{
+    if (buffer_size_ == 0)
+        return;
+
+    ensure_write_thread_running();
+
+    {
+        std::unique_lock<std::mutex> queue_lock{queue_mutex_};
+
+        // Keep at most two blocks in flight; this bounds the memory usage when
+        // the disk is slower than the pipeline.
+        fill_queue_condition_.wait(queue_lock, [this]
+        {
+            return exception_ptr_ || queue_.size() < 2;
+        });
+
+        if (exception_ptr_)
+            std::rethrow_exception(exception_ptr_);
+
+        queue_.push_back(buffer_.share_first(buffer_size_));
+    }
+
+    write_queue_condition_.notify_one();
+
+    buffer_ = allocate_memory(block_size_);
+
+    buffer_size_ = 0;
+}
+
+void
+file_writer::ensure_write_thread_running()
+{
+    if (write_thread_.joinable())
+        return;
+
+    write_thread_ = start_thread(&file_writer::write_blocks, this);
+}
+
+void
+file_writer::write_blocks()
+{
+    while (true) {
+        memory_block block{};
+
+        {
+            std::unique_lock<std::mutex> queue_lock{queue_mutex_};
+
+            write_queue_condition_.wait(queue_lock, [this]
+            {
+                return should_finish_ || !queue_.empty();
+            });
+
+            if (queue_.empty())
+                return;
+
+            block = queue_.front();
+        }
+
+        try {
+            write_block(block, /*is_last=*/false);
+        } catch (const std::exception &) {
+            {
+                std::unique_lock<std::mutex> queue_lock{queue_mutex_};
+
+                exception_ptr_ = std::current_exception();
+
+                queue_.clear();
+            }
+
+            fill_queue_condition_.notify_one();
+
+            return;
+        }
+
+        {
+            std::unique_lock<std::mutex> queue_lock{queue_mutex_};
+
+            // The queue might have been cleared in the meantime by the
+            // destructor.
+            if (!queue_.empty())
+                queue_.pop_front();
+        }
+
+        fill_queue_condition_.notify_one();
+    }
+}
+
+void
+file_writer::write_block(memory_span block, bool is_last)
+{
+    if (deflater_)
+        deflater_->deflate(block, is_last, [this](memory_span bytes)
+        {
+            write_all(bytes);
+        });
+    else
+        write_all(block);
+}
+
+void
+file_writer::write_all(memory_span bytes)
+{
+    while (!bytes.empty()) {
+        ::ssize_t num_bytes_written = ::write(fd_.get(), bytes.data(), bytes.size());
+        if (num_bytes_written == -1) {
+            if (errno == EINTR)
+                continue;
+
+            throw_system_error(last_error(),
+                "'{}' cannot be written", path_.string());
+        }
+
+        bytes = bytes.subspan(static_cast<std::size_t>(num_bytes_written));
+    }
+}
+
+void
+file_writer::stop_write_thread() noexcept
+{
+    if (!write_thread_.joinable())
+        return;
+
+    {
+        std::unique_lock<std::mutex> queue_lock{queue_mutex_};
+
+        should_finish_ = true;
+    }
+
+    write_queue_condition_.notify_one();
+
+    write_thread_.join();
+
+    should_finish_ = false;
+}
+
+void
+file_writer::check_if_faulted()
+{
+    if (exception_ptr_)
+        std::rethrow_exception(exception_ptr_);
+}
+
+}  // namespace fairseq2n::detail
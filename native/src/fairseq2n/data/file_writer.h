@@ -0,0 +1,97 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "fairseq2n/memory.h"
+#include "fairseq2n/data/file.h"
+#include "fairseq2n/data/detail/file.h"
+
+namespace fairseq2n::detail {
+
+class gzip_deflater;
+
+// Writes a file through a buffer that is handed off to a background thread
+// once full, so that the caller never blocks on compression or disk I/O unless
+// it outpaces them. The output goes to a temporary file next to `path` which is
+// atomically renamed to `path` by `commit()`; if the writer is destroyed before
+// that, the temporary file is removed.
+class file_writer {
+public:
+    explicit
+    file_writer(std::filesystem::path path, const file_writer_options &opts = {});
+
+    file_writer(const file_writer &) = delete;
+    file_writer &operator=(const file_writer &) = delete;
+
+    file_writer(file_writer &&) = delete;
+    file_writer &operator=(file_writer &&) = delete;
+
+   ~file_writer();
+
+    void
+    write(memory_span bytes);
+
+    void
+    commit();
+
+    const std::filesystem::path &
+    path() const noexcept
+    {
+        return path_;
+    }
+
+private:
+    void
+    flush_buffer();
+
+    void
+    ensure_write_thread_running();
+
+    void
+    write_blocks();
+
+    void
+    write_block(memory_span block, bool is_last);
+
+    void
+    write_all(memory_span bytes);
+
+    void
+    stop_write_thread() noexcept;
+
+    void
+    check_if_faulted();
+
+private:
+    std::filesystem::path path_;
+    std::filesystem::path tmp_path_;
+    file_desc fd_;
+    std::size_t block_size_;
+    std::unique_ptr<gzip_deflater> deflater_{};
+    writable_memory_block buffer_{};
+    std::size_t buffer_size_ = 0;
+    std::thread write_thread_{};
+    std::mutex queue_mutex_{};
+    std::condition_variable write_queue_condition_{};
+    std::condition_variable fill_queue_condition_{};
+    std::deque<memory_block> queue_{};
+    bool should_finish_ = false;
+    bool is_committed_ = false;
+    std::exception_ptr exception_ptr_{};
+};
+
+}  // namespace fairseq2n::detail
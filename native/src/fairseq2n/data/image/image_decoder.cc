@@ -7,12 +7,19 @@
 #include "fairseq2n/data/image/image_decoder.h"
 
 #ifdef FAIRSEQ2N_SUPPORT_IMAGE
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <exception>
+#include <mutex>
 #include <stdexcept>
+#include <vector>
 
+#include <ATen/CPUGeneratorImpl.h>
 #include <ATen/Functions.h>
 #include <ATen/Tensor.h>
+#include <ATen/core/TransformationHelper.h>
 #include <csetjmp>
 #include <png.h>
 #include <jpeglib.h>
@@ -23,6 +30,7 @@
 #include "fairseq2n/memory.h"
 #include "fairseq2n/data/image/detail/png_read_struct.h"
 #include "fairseq2n/data/image/detail/jpeg_decompress_struct.h"
+#include "fairseq2n/data/detail/rng.h"
 #include "fairseq2n/data/detail/tensor_helpers.h"
 #include "fairseq2n/detail/exception.h"
 
@@ -32,7 +40,29 @@ namespace fairseq2n {
 
 image_decoder::image_decoder(image_decoder_options opts)
   : opts_{opts}
-{}
+{
+    if (opts_.random_crop()) {
+        if (opts_.min_crop_scale() <= 0.0F)
+            throw_<std::invalid_argument>(
+                "`min_crop_scale` must be greater than 0, but is {:G} instead.", opts_.min_crop_scale());
+
+        if (opts_.max_crop_scale() < opts_.min_crop_scale() || opts_.max_crop_scale() > 1.0F)
+            throw_<std::invalid_argument>(
+                "`max_crop_scale` must be greater than or equal to `min_crop_scale` ({:G}) and less than or equal to 1, but is {:G} instead.", opts_.min_crop_scale(), opts_.max_crop_scale());
+
+        if (opts_.min_crop_ratio() <= 0.0F)
+            throw_<std::invalid_argument>(
+                "`min_crop_ratio` must be greater than 0, but is {:G} instead.", opts_.min_crop_ratio());
+
+        if (opts_.max_crop_ratio() < opts_.min_crop_ratio())
+            throw_<std::invalid_argument>(
+                "`max_crop_ratio` must be greater than or equal to `min_crop_ratio` ({:G}), but is {:G} instead.", opts_.min_crop_ratio(), opts_.max_crop_ratio());
+    }
+
+    std::uint64_t seed = opts_.maybe_seed() ? *opts_.maybe_seed() : pseudo_random();
+
+    generator_ = at::make_generator<at::CPUGeneratorImpl>(seed);
+}
 
 bool
 image_decoder::is_little_endian() {
@@ -43,34 +73,49 @@ image_decoder::is_little_endian() {
 data
 image_decoder::operator()(data &&d) const
 {
-    if (!d.is_memory_block())
+    std::optional<crop_box> maybe_box{};
+
+    const memory_block *block_ptr = nullptr;
+
+    if (d.is_memory_block())
+        block_ptr = &d.as_memory_block();
+    else if (d.is_dict()) {
+        const data_dict &dict = d.as_dict();
+
+        auto pos = dict.find("data");
+        if (pos == dict.end() || !pos->second.is_memory_block())
+            throw_<std::invalid_argument>(
+                "The input dictionary must contain the image under a key named `data` of type `memory_block`, but does not contain such key.");
+
+        block_ptr = &pos->second.as_memory_block();
+
+        maybe_box = maybe_find_crop_box(dict);
+    } else
         throw_<std::invalid_argument>(
-            "The input data must be of type `memory_block`, but is of type `{}` instead.", d.type());
+            "The input data must be of type `memory_block` or `dict`, but is of type `{}` instead.", d.type());
 
-    const memory_block &block = d.as_memory_block();
+    const memory_block &block = *block_ptr;
     if (block.empty())
         throw_<std::invalid_argument>(
             "The input memory block has zero length and cannot be decoded.");
 
     auto data_ptr = block.data();
 
-    data output{};
-
     const std::array<uint8_t, 3> jpeg_signature = {255, 216, 255};
     const std::array<uint8_t, 4> png_signature = {137, 80, 78, 71};
 
-    if(std::memcmp(jpeg_signature.data(), data_ptr, jpeg_signature.size()) == 0)
-        return decode_jpeg(block);
+    if(block.size() >= jpeg_signature.size() && std::memcmp(jpeg_signature.data(), data_ptr, jpeg_signature.size()) == 0)
+        return decode_jpeg(block, maybe_box);
 
-    if(std::memcmp(png_signature.data(), data_ptr, png_signature.size()) == 0)
-        return decode_png(block);
+    if(block.size() >= png_signature.size() && std::memcmp(png_signature.data(), data_ptr, png_signature.size()) == 0)
+        return decode_png(block, maybe_box);
 
     throw_<std::invalid_argument>(
         "Unsupported image file. Only jpeg and png are currently supported.");
 }
 
 data
-image_decoder::decode_png(const memory_block &block) const
+image_decoder::decode_png(const memory_block &block, const std::optional<crop_box> &maybe_input_box) const
 {
     png_read pngReadStruct;
     png_structp png_ptr = pngReadStruct.getPngPtr();
@@ -126,19 +171,54 @@ image_decoder::decode_png(const memory_block &block) const
     if (is_little_endian()) {
       png_set_swap(png_ptr);
     }
+
+    // Unpack 1, 2, and 4-bit pixels into separate bytes so that each pixel,
+    // and therefore each crop offset, spans a whole number of bytes.
+    if (bit_depth < 8)
+        png_set_packing(png_ptr);
+
+    // Update `info_ptr` so that `png_get_rowbytes()` reflects the transforms.
+    png_read_update_info(png_ptr, info_ptr);
+
     int channels = png_get_channels(png_ptr, info_ptr);
 
+    std::optional<crop_box> maybe_box = resolve_crop_box(maybe_input_box, height, width);
+
+    crop_box box = maybe_box.value_or(crop_box{0, 0, height, width});
+
     at::ScalarType dtype = bit_depth <= 8 ? at::kByte : at::kShort;
-    at::Tensor image = at::empty({height, width, channels}, at::dtype(dtype).device(at::kCPU).pinned_memory(opts_.pin_memory()));
+    at::Tensor image = at::empty({box.height, box.width, channels}, at::dtype(dtype).device(at::kCPU).pinned_memory(opts_.pin_memory()));
 
     size_t rowbytes = png_get_rowbytes(png_ptr, info_ptr);
     writable_memory_span image_bits = get_raw_mutable_storage(image);
     auto image_data = reinterpret_cast<png_bytep>(image_bits.data());
 
-    // Read image data into tensor
-    for (png_uint_32 i = 0; i < height; ++i) {
-        png_read_row(png_ptr, image_data, nullptr);
-        image_data += rowbytes;
+    if (!maybe_box) {
+        // Read image data into tensor
+        for (png_uint_32 i = 0; i < height; ++i) {
+            png_read_row(png_ptr, image_data, nullptr);
+            image_data += rowbytes;
+        }
+    } else {
+        std::size_t pixel_size = static_cast<std::size_t>(channels) * image.element_size();
+
+        std::size_t crop_offset = static_cast<std::size_t>(box.left) * pixel_size;
+        std::size_t crop_size   = static_cast<std::size_t>(box.width) * pixel_size;
+
+        std::vector<png_byte> row(rowbytes);
+
+        // PNG rows cannot be skipped, but we can stop reading after the last
+        // row of the crop box.
+        for (std::int64_t i = 0; i < box.top + box.height; ++i) {
+            png_read_row(png_ptr, row.data(), nullptr);
+
+            if (i < box.top)
+                continue;
+
+            std::memcpy(image_data, row.data() + crop_offset, crop_size);
+
+            image_data += crop_size;
+        }
     }
 
     at::Device device = opts_.maybe_device().value_or(at::kCPU);
@@ -148,28 +228,35 @@ image_decoder::decode_png(const memory_block &block) const
     // Pack png data and format as output
     data_dict output{
         {"bit_depth", static_cast<float32>(bit_depth)}, {"color_type", static_cast<float32>(color_type)}, 
-        {"channels", static_cast<float32>(channels)}, {"height", static_cast<float32>(height)}, 
-        {"width", static_cast<float32>(width)}};
+        {"channels", static_cast<float32>(channels)}, {"height", static_cast<float32>(box.height)}, 
+        {"width", static_cast<float32>(box.width)}};
 
     output.emplace("image", std::move(image));
 
+    if (maybe_box)
+        output.emplace("crop_box", data_list{box.top, box.left, box.height, box.width});
+
     return output;
 }
 
 data
-image_decoder::decode_jpeg(const memory_block &block) const 
+image_decoder::decode_jpeg(const memory_block &block, const std::optional<crop_box> &maybe_input_box) const
 {
-    jpeg_decompress jpegDecompressStruct;
-    jpeg_decompress_struct cinfo = jpegDecompressStruct.get();
-
-    auto data_ptr = block.data();
-    auto data_len = block.size();
-
     struct custom_error_mgr {
         struct jpeg_error_mgr pub;	// Public fields
         jmp_buf setjmp_buffer;	// Return to caller 
     };
+    // Must outlive `jpegDecompressStruct` which references it.
     struct custom_error_mgr jerr = {};
+
+    jpeg_decompress jpegDecompressStruct;
+    // Note that this must be a reference; `jpeg_decompress` releases the
+    // memory allocated by libjpeg only for its own instance.
+    jpeg_decompress_struct &cinfo = jpegDecompressStruct.get();
+
+    auto data_ptr = block.data();
+    auto data_len = block.size();
+
     using error_ptr = struct custom_error_mgr *;
     cinfo.err = jpeg_std_error(&jerr.pub);
     // error_exit is called by libjpeg when a fatal error occurs
@@ -194,23 +281,69 @@ image_decoder::decode_jpeg(const memory_block &block) const
     jpeg_read_header(&cinfo, TRUE);
     jpeg_start_decompress(&cinfo);
 
-    auto width = cinfo.output_width;
-    auto height = cinfo.output_height;
     auto channels = cinfo.output_components;
-    auto row_size = width * static_cast<unsigned int>(channels);
     int bit_depth = cinfo.data_precision;
 
+    std::optional<crop_box> maybe_box = resolve_crop_box(
+        maybe_input_box, cinfo.output_height, cinfo.output_width);
+
+    crop_box box = maybe_box.value_or(crop_box{0, 0, cinfo.output_height, cinfo.output_width});
+
+    auto row_size = static_cast<std::size_t>(box.width) * static_cast<std::size_t>(channels);
+
     at::ScalarType dtype = bit_depth <= 8 ? at::kByte : at::kShort;
-    at::Tensor image = at::empty({height, width, channels}, at::dtype(dtype).device(at::kCPU).pinned_memory(opts_.pin_memory()));
+    at::Tensor image = at::empty({box.height, box.width, channels}, at::dtype(dtype).device(at::kCPU).pinned_memory(opts_.pin_memory()));
     writable_memory_span image_bits = get_raw_mutable_storage(image);
     auto image_data = reinterpret_cast<uint8_t*>(image_bits.data());
 
-    // Read image into tensor
-    while (cinfo.output_scanline < cinfo.output_height) {
-        jpeg_read_scanlines(&cinfo, &image_data, 1);
-        image_data += row_size;
+    if (!maybe_box) {
+        // Read image into tensor
+        while (cinfo.output_scanline < cinfo.output_height) {
+            jpeg_read_scanlines(&cinfo, &image_data, 1);
+            image_data += row_size;
+        }
+        jpeg_finish_decompress(&cinfo);
+    } else {
+        // With fancy upsampling, libjpeg replicates the edge pixels of the
+        // decoded region instead of reading its neighbors; we therefore pad the
+        // region by one pixel on the left and by an iMCU on the right so that
+        // the crop matches the corresponding region of a full decode.
+        std::int64_t imcu_width = cinfo.max_h_samp_factor * cinfo.min_DCT_scaled_size;
+
+        std::int64_t region_begin = std::max(box.left - 1, std::int64_t{0});
+        std::int64_t region_end   = std::min(box.left + box.width + imcu_width, static_cast<std::int64_t>(cinfo.output_width));
+
+        auto x_offset = static_cast<JDIMENSION>(region_begin);
+        auto crop_width = static_cast<JDIMENSION>(region_end - region_begin);
+
+        // Decode only the iMCU columns overlapping the region. Note that
+        // `jpeg_crop_scanline()` might widen the region to the left to align it
+        // with an iMCU boundary; `output_width` is set to the widened width.
+        jpeg_crop_scanline(&cinfo, &x_offset, &crop_width);
+
+        auto crop_offset = static_cast<std::size_t>(box.left - x_offset) * static_cast<std::size_t>(channels);
+
+        // The rows above the crop box are entropy decoded, but neither
+        // dequantized nor upsampled.
+        if (box.top > 0)
+            jpeg_skip_scanlines(&cinfo, static_cast<JDIMENSION>(box.top));
+
+        // Allocated from the image pool of libjpeg, so it also gets released
+        // if decoding fails.
+        JSAMPARRAY row = (*cinfo.mem->alloc_sarray)(
+            reinterpret_cast<j_common_ptr>(&cinfo), JPOOL_IMAGE, cinfo.output_width * static_cast<JDIMENSION>(channels), 1);
+
+        for (std::int64_t i = 0; i < box.height; ++i) {
+            jpeg_read_scanlines(&cinfo, row, 1);
+
+            std::memcpy(image_data, row[0] + crop_offset, row_size);
+
+            image_data += row_size;
+        }
+
+        // We do not need the rows below the crop box.
+        jpeg_abort_decompress(&cinfo);
     }
-    jpeg_finish_decompress(&cinfo);
 
     at::Device device = opts_.maybe_device().value_or(at::kCPU);
     if (device != at::kCPU)
@@ -218,14 +351,129 @@ image_decoder::decode_jpeg(const memory_block &block) const
 
     // Pack jpeg data and format as output.
     data_dict output{
-        {{"channels", static_cast<float32>(channels)}, {"height", static_cast<float32>(height)}, 
-        {"width", static_cast<float32>(width)}, {"bit_depth", static_cast<float32>(bit_depth)}}};
+        {{"channels", static_cast<float32>(channels)}, {"height", static_cast<float32>(box.height)}, 
+        {"width", static_cast<float32>(box.width)}, {"bit_depth", static_cast<float32>(bit_depth)}}};
+
+    if (maybe_box)
+        output.emplace("crop_box", data_list{box.top, box.left, box.height, box.width});
 
     output.emplace("image", std::move(image));
 
     return output;
 }
 
+std::optional<image_decoder::crop_box>
+image_decoder::maybe_find_crop_box(const data_dict &dict)
+{
+    auto pos = dict.find("crop_box");
+    if (pos == dict.end())
+        return std::nullopt;
+
+    const data &element = pos->second;
+
+    auto is_valid = [&element]
+    {
+        if (!element.is_list())
+            return false;
+
+        const data_list &values = element.as_list();
+
+        return values.size() == 4 && std::all_of(values.begin(), values.end(), [](const data &value)
+        {
+            return value.is_int();
+        });
+    };
+
+    if (!is_valid())
+        throw_<std::invalid_argument>(
+            "The crop box must be a list of four integers `[top, left, height, width]`, but is of type `{}` instead.", element.type());
+
+    const data_list &values = element.as_list();
+
+    return crop_box{
+        values[0].as_int(), values[1].as_int(), values[2].as_int(), values[3].as_int()};
+}
+
+std::optional<image_decoder::crop_box>
+image_decoder::resolve_crop_box(
+    const std::optional<crop_box> &maybe_box, std::int64_t height, std::int64_t width) const
+{
+    if (!maybe_box) {
+        if (opts_.random_crop())
+            return sample_crop_box(height, width);
+
+        return std::nullopt;
+    }
+
+    const crop_box &box = *maybe_box;
+
+    if (box.top < 0 || box.left < 0 || box.height <= 0 || box.width <= 0 ||
+        box.top + box.height > height || box.left + box.width > width)
+        throw_<std::invalid_argument>(
+            "The crop box `[{}, {}, {}, {}]` must be non-empty and must lie within the image of height {} and width {}.", box.top, box.left, box.height, box.width, height, width);
+
+    return box;
+}
+
+image_decoder::crop_box
+image_decoder::sample_crop_box(std::int64_t height, std::int64_t width) const
+{
+    auto area = static_cast<float64>(height) * static_cast<float64>(width);
+
+    float64 log_min_ratio = std::log(static_cast<float64>(opts_.min_crop_ratio()));
+    float64 log_max_ratio = std::log(static_cast<float64>(opts_.max_crop_ratio()));
+
+    {
+        std::lock_guard<std::mutex> generator_lock{generator_.mutex()};
+
+        auto *gen = generator_.get<at::CPUGeneratorImpl>();
+
+        auto random_offset = [gen](std::int64_t max_offset)
+        {
+            std::uint64_t r = gen->random64() % static_cast<std::uint64_t>(max_offset + 1);
+
+            return static_cast<std::int64_t>(r);
+        };
+
+        // Follows `torchvision.transforms.RandomResizedCrop.get_params()`.
+        for (int attempt = 0; attempt < 10; ++attempt) {
+            float64 target_area = area * at::transformation::uniform_real(
+                gen->random64(), static_cast<float64>(opts_.min_crop_scale()), static_cast<float64>(opts_.max_crop_scale()));
+
+            float64 ratio = std::exp(at::transformation::uniform_real(
+                gen->random64(), log_min_ratio, log_max_ratio));
+
+            auto crop_width  = static_cast<std::int64_t>(std::round(std::sqrt(target_area * ratio)));
+            auto crop_height = static_cast<std::int64_t>(std::round(std::sqrt(target_area / ratio)));
+
+            if (crop_width > 0 && crop_width <= width && crop_height > 0 && crop_height <= height) {
+                std::int64_t top  = random_offset(height - crop_height);
+                std::int64_t left = random_offset(width - crop_width);
+
+                return crop_box{top, left, crop_height, crop_width};
+            }
+        }
+    }
+
+    // Fall back to a center crop with the closest valid aspect ratio.
+    auto image_ratio = static_cast<float64>(width) / static_cast<float64>(height);
+
+    std::int64_t crop_height = height;
+    std::int64_t crop_width  = width;
+
+    if (image_ratio < static_cast<float64>(opts_.min_crop_ratio()))
+        crop_height = static_cast<std::int64_t>(
+            std::round(static_cast<float64>(width) / static_cast<float64>(opts_.min_crop_ratio())));
+    else if (image_ratio > static_cast<float64>(opts_.max_crop_ratio()))
+        crop_width = static_cast<std::int64_t>(
+            std::round(static_cast<float64>(height) * static_cast<float64>(opts_.max_crop_ratio())));
+
+    crop_height = std::clamp(crop_height, std::int64_t{1}, height);
+    crop_width  = std::clamp(crop_width,  std::int64_t{1}, width);
+
+    return crop_box{(height - crop_height) / 2, (width - crop_width) / 2, crop_height, crop_width};
+}
+
 }; // namespace fairseq2n
 
 #else
@@ -6,12 +6,15 @@
 
 #pragma once
 
+#include <cstdint>
 #include <optional>
 
 #include "fairseq2n/api.h"
+#include "fairseq2n/float.h"
 #include "fairseq2n/data/data.h"
 
 #include <ATen/Device.h>
+#include <ATen/Generator.h>
 #include <ATen/ScalarType.h>
 
 namespace fairseq2n {
@@ -50,11 +53,125 @@ public:
         return pin_memory_;
     }
 
+    image_decoder_options
+    random_crop(bool value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.random_crop_ = value;
+
+        return tmp;
+    }
+
+    bool
+    random_crop() const noexcept
+    {
+        return random_crop_;
+    }
+
+    image_decoder_options
+    min_crop_scale(float32 value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.min_crop_scale_ = value;
+
+        return tmp;
+    }
+
+    float32
+    min_crop_scale() const noexcept
+    {
+        return min_crop_scale_;
+    }
+
+    image_decoder_options
+    max_crop_scale(float32 value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.max_crop_scale_ = value;
+
+        return tmp;
+    }
+
+    float32
+    max_crop_scale() const noexcept
+    {
+        return max_crop_scale_;
+    }
+
+    image_decoder_options
+    min_crop_ratio(float32 value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.min_crop_ratio_ = value;
+
+        return tmp;
+    }
+
+    float32
+    min_crop_ratio() const noexcept
+    {
+        return min_crop_ratio_;
+    }
+
+    image_decoder_options
+    max_crop_ratio(float32 value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.max_crop_ratio_ = value;
+
+        return tmp;
+    }
+
+    float32
+    max_crop_ratio() const noexcept
+    {
+        return max_crop_ratio_;
+    }
+
+    image_decoder_options
+    maybe_seed(std::optional<std::uint64_t> value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.maybe_seed_ = value;
+
+        return tmp;
+    }
+
+    std::optional<std::uint64_t>
+    maybe_seed() const noexcept
+    {
+        return maybe_seed_;
+    }
+
 private:
     std::optional<at::Device> maybe_device_{};
     bool pin_memory_ = false;
+    bool random_crop_ = false;
+    float32 min_crop_scale_ = 0.08F;
+    float32 max_crop_scale_ = 1.0F;
+    float32 min_crop_ratio_ = 3.0F / 4.0F;
+    float32 max_crop_ratio_ = 4.0F / 3.0F;
+    std::optional<std::uint64_t> maybe_seed_{};
 };
 
+// Decodes a JPEG or PNG image given as a `memory_block`, or as a `dict` holding
+// the `memory_block` under the key `data` (e.g. the output of `file_mapper`).
+//
+// Optionally, only a region of the image gets decoded. The region is either
+// specified by the input `dict` under the key `crop_box` as a list of `[top,
+// left, height, width]`, or, if `random_crop` is set, sampled from the image
+// dimensions in the same way as torchvision's `RandomResizedCrop` (i.e. with an
+// area and an aspect ratio drawn uniformly from the specified scale and log
+// ratio ranges). Note that the crop is not resized. JPEG images are decoded
+// only for the MCUs overlapping the region, which makes small crops of large
+// images much cheaper than a full decode.
+
 class FAIRSEQ2_API image_decoder {
 public:
     explicit
@@ -64,16 +181,35 @@ public:
     operator()(data &&d) const;
 
 private:
-    image_decoder_options opts_;
+    struct crop_box {
+        std::int64_t top{};
+        std::int64_t left{};
+        std::int64_t height{};
+        std::int64_t width{};
+    };
 
     static bool
     is_little_endian();
 
     data
-    decode_png(const memory_block &block) const;
+    decode_png(const memory_block &block, const std::optional<crop_box> &maybe_box) const;
 
     data
-    decode_jpeg(const memory_block &block) const;
+    decode_jpeg(const memory_block &block, const std::optional<crop_box> &maybe_box) const;
+
+    static std::optional<crop_box>
+    maybe_find_crop_box(const data_dict &dict);
+
+    std::optional<crop_box>
+    resolve_crop_box(
+        const std::optional<crop_box> &maybe_box, std::int64_t height, std::int64_t width) const;
+
+    crop_box
+    sample_crop_box(std::int64_t height, std::int64_t width) const;
+
+private:
+    image_decoder_options opts_;
+    mutable at::Generator generator_;
 };
 
 }  // namespace fairseq2n
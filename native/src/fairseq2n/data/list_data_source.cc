@@ -6,6 +6,8 @@
 
 #include "fairseq2n/data/list_data_source.h"
 
+#include <algorithm>
+
 #include <cstddef>
 
 namespace fairseq2n::detail {
@@ -19,6 +21,22 @@ list_data_source::next()
     return *pos_++;
 }
 
+std::size_t
+list_data_source::next_n(std::size_t num_examples, data_list &output)
+{
+    auto num_remaining = static_cast<std::size_t>(list_.end() - pos_);
+
+    std::size_t n = std::min(num_examples, num_remaining);
+
+    auto end = pos_ + static_cast<std::ptrdiff_t>(n);
+
+    output.insert(output.end(), pos_, end);
+
+    pos_ = end;
+
+    return n;
+}
+
 void
 list_data_source::reset(bool)
 {
@@ -10,6 +10,7 @@
 
 #include "fairseq2n/data/data_pipeline.h"
 #include "fairseq2n/data/detail/exception.h"
+#include "fairseq2n/detail/cancellation.h"
 #include "fairseq2n/detail/parallel.h"
 
 namespace fairseq2n::detail {
@@ -99,22 +100,28 @@ map_data_source::fill_buffer()
 {
     buffer_.clear();
 
-    for (std::size_t i = 0; i < num_parallel_calls_; i++) {
-        std::optional<data> maybe_example = inner_->next();
-        if (!maybe_example)
-            break;
+    data_list examples{};
 
-        buffer_.push_back(std::move(maybe_example));
-    }
+    examples.reserve(num_parallel_calls_);
+
+    inner_->next_n(num_parallel_calls_, examples);
+
+    for (data &example : examples)
+        buffer_.emplace_back(std::move(example));
 
     if (buffer_.empty())
         return false;
 
-    // Apply the processor to all buffered examples.
+    // Apply the processor to all buffered examples. If the output is no longer
+    // needed (e.g. the prefetch thread we run on is being stopped), abandon the
+    // remaining examples.
     auto apply_function = [this](std::size_t begin, std::size_t end)
     {
-        for (auto i = begin; i < end; ++i)
+        for (auto i = begin; i < end; ++i) {
+            throw_if_cancelled();
+
             buffer_[i] = invoke_function(*std::move(buffer_[i]), i);
+        }
     };
 
     // Avoid threading overhead if we have just one example.
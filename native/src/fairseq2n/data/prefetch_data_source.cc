@@ -6,15 +6,18 @@
 
 #include "fairseq2n/data/prefetch_data_source.h"
 
+#include <algorithm>
 #include <exception>
+#include <iterator>
 
 #include "fairseq2n/data/detail/thread.h"
+#include "fairseq2n/detail/cancellation.h"
 
 namespace fairseq2n::detail {
 
 prefetch_data_source::~prefetch_data_source()
 {
-    stop_prefetch_thread();
+    cancel_prefetch_thread();
 }
 
 std::optional<data>
@@ -41,6 +44,11 @@ prefetch_data_source::next()
             if (state_ == prefetch_state::faulted)
                 std::rethrow_exception(exception_ptr_);
 
+            // This can only happen if we are ourselves running on a prefetch
+            // thread that is being cancelled.
+            if (state_ == prefetch_state::cancelled)
+                throw operation_cancelled{};
+
             std::swap(next_queue_, fill_queue_);
         }
 
@@ -60,7 +68,9 @@ prefetch_data_source::next()
 void
 prefetch_data_source::reset(bool reset_rng)
 {
-    stop_prefetch_thread();
+    // The prefetched examples get discarded anyway, so there is no point in
+    // waiting for the in-flight ones.
+    cancel_prefetch_thread();
 
     if (state_ == prefetch_state::faulted)
         std::rethrow_exception(exception_ptr_);
@@ -95,7 +105,7 @@ prefetch_data_source::record_position(tape &t, bool strict) const
 void
 prefetch_data_source::reload_position(tape &t, bool strict)
 {
-    stop_prefetch_thread();
+    cancel_prefetch_thread();
 
     if (state_ == prefetch_state::faulted)
         std::rethrow_exception(exception_ptr_);
@@ -133,16 +143,31 @@ prefetch_data_source::ensure_prefetch_thread_running()
 
     state_ = prefetch_state::running;
 
+    // If we are running on another prefetch thread, inherit its token so that
+    // cancelling it cancels us as well.
+    cancellation_token_ = cancellation_token::make(current_cancellation_token());
+
     prefetch_thread_ = start_thread(&prefetch_data_source::prefetch, this);
 }
 
 void
 prefetch_data_source::prefetch()
 {
+    // Make the token visible to the upstream operators running on this thread
+    // (e.g. `map()`), so that they can abandon their work once cancelled.
+    cancellation_scope scope{cancellation_token_};
+
+    // We start by reading one example at a time, and read in larger chunks as
+    // the fill queue grows. This way we avoid per-example locking for cheap
+    // examples without delaying the first examples of the reader.
+    std::size_t chunk_size = 1;
+
     while (state_ == prefetch_state::running) {
-        std::optional<data> maybe_example{};
+        data_list examples{};
+
+        std::size_t num_examples_read = 0;
         try {
-            maybe_example = inner_->next();
+            num_examples_read = inner_->next_n(chunk_size, examples);
         } catch (const std::exception &) {
             exception_ptr_ = std::current_exception();
         }
@@ -155,16 +180,32 @@ prefetch_data_source::prefetch()
                 return should_stop_prefetch_ || fill_queue_.size() < num_examples_;
             });
 
-            if (exception_ptr_) {
-                state_ = prefetch_state::faulted;
-            } else if (!maybe_example) {
-                state_ = prefetch_state::eod;
-            } else {
-                fill_queue_.push_back(*std::move(maybe_example));
+            // The output of a cancelled call is discarded, even if it has
+            // failed.
+            if (cancellation_token_.is_cancelled()) {
+                exception_ptr_ = nullptr;
 
-                if (should_stop_prefetch_)
+                state_ = prefetch_state::cancelled;
+            } else {
+                fill_queue_.insert(
+                    fill_queue_.end(),
+                    std::make_move_iterator(examples.begin()),
+                    std::make_move_iterator(examples.end()));
+
+                if (exception_ptr_)
+                    state_ = prefetch_state::faulted;
+                else if (num_examples_read < chunk_size)
+                    state_ = prefetch_state::eod;
+                else if (should_stop_prefetch_)
                     state_ = prefetch_state::not_running;
             }
+
+            std::size_t queue_size = fill_queue_.size();
+
+            if (queue_size < num_examples_)
+                chunk_size = std::clamp(queue_size, std::size_t{1}, num_examples_ - queue_size);
+            else
+                chunk_size = 1;
         }
 
         read_queue_condition_.notify_one();
@@ -190,4 +231,15 @@ prefetch_data_source::stop_prefetch_thread() const noexcept
     should_stop_prefetch_ = false;
 }
 
+void
+prefetch_data_source::cancel_prefetch_thread() noexcept
+{
+    if (!prefetch_thread_.joinable())
+        return;
+
+    cancellation_token_.cancel();
+
+    stop_prefetch_thread();
+}
+
 }  // namespace fairseq2n::detail
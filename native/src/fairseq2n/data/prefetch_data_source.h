@@ -16,11 +16,12 @@
 #include <utility>
 
 #include "fairseq2n/data/data_source.h"
+#include "fairseq2n/detail/cancellation.h"
 
 namespace fairseq2n::detail {
 
 class prefetch_data_source final : public data_source {
-    enum class prefetch_state { not_running, running, eod, faulted };
+    enum class prefetch_state { not_running, running, eod, faulted, cancelled };
 
 public:
     explicit
@@ -61,11 +62,15 @@ private:
     void
     stop_prefetch_thread() const noexcept;
 
+    void
+    cancel_prefetch_thread() noexcept;
+
 private:
     std::unique_ptr<data_source> inner_;
     std::size_t num_examples_;
     prefetch_state state_ = prefetch_state::not_running;
     mutable std::thread prefetch_thread_{};
+    cancellation_token cancellation_token_{};
     mutable bool should_stop_prefetch_ = false;
     mutable std::mutex queue_mutex_{};
     mutable std::condition_variable fill_queue_condition_{};
@@ -0,0 +1,241 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/restore_order_data_source.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include "fairseq2n/fmt.h"
+#include "fairseq2n/data/detail/exception.h"
+#include "fairseq2n/detail/exception.h"
+
+namespace fairseq2n::detail {
+
+std::optional<data>
+restore_order_data_source::next()
+{
+    while (true) {
+        if (!buffer_.empty()) {
+            auto pos = buffer_.begin();
+
+            if (pos->first == next_index_) {
+                data output = std::move(pos->second);
+
+                buffer_.erase(pos);
+
+                next_index_++;
+
+                return output;
+            }
+
+            // If the buffer is full, we assume that the examples up to the
+            // smallest buffered index were dropped upstream (e.g. filtered or
+            // skipped due to an error) and move on.
+            if (buffer_.size() >= max_num_buffered_) {
+                skip_to(pos->first);
+
+                continue;
+            }
+        }
+
+        std::optional<data> maybe_example = inner_->next();
+        if (!maybe_example) {
+            if (buffer_.empty())
+                return std::nullopt;
+
+            // Likewise, the remaining gaps can never be filled.
+            skip_to(buffer_.begin()->first);
+
+            continue;
+        }
+
+        data &example = *maybe_example;
+
+        // A list is treated as a batch of examples (e.g. the output of
+        // `sort_for_inference()`), and its elements are reordered individually.
+        if (example.is_list()) {
+            for (data &element : example.as_list())
+                buffer_example(std::move(element));
+        } else
+            buffer_example(std::move(example));
+    }
+}
+
+void
+restore_order_data_source::buffer_example(data &&example)
+{
+    std::int64_t index = get_index(example);
+
+    if (index < next_index_) {
+        if (is_skipped(index))
+            throw_data_pipeline_error(std::move(example), /*recoverable=*/true,
+                "The example with the original index {} has arrived after its position was skipped. `max_num_buffered` ({}) must be greater than or equal to the number of examples by which the upstream data pipeline reorders its output.", index, max_num_buffered_);
+
+        if (index < min_tracked_index_)
+            throw_data_pipeline_error(std::move(example), /*recoverable=*/true,
+                "The example with the original index {} is either a duplicate or has arrived after its position was skipped.", index);
+    }
+
+    if (index < next_index_ || buffer_.find(index) != buffer_.end())
+        throw_data_pipeline_error(std::move(example), /*recoverable=*/true,
+            "The original index of each example must be unique, but the index {} has already been seen.", index);
+
+    buffer_.emplace(index, std::move(example));
+}
+
+void
+restore_order_data_source::skip_to(std::int64_t index)
+{
+    if (index > next_index_) {
+        skipped_ranges_.emplace(next_index_, index);
+
+        // Keep the history bounded; older indices are reported as either
+        // duplicate or late.
+        if (skipped_ranges_.size() > max_num_buffered_) {
+            auto pos = skipped_ranges_.begin();
+
+            min_tracked_index_ = pos->second;
+
+            skipped_ranges_.erase(pos);
+        }
+    }
+
+    next_index_ = index;
+}
+
+bool
+restore_order_data_source::is_skipped(std::int64_t index) const
+{
+    auto pos = skipped_ranges_.upper_bound(index);
+    if (pos == skipped_ranges_.begin())
+        return false;
+
+    --pos;
+
+    return index < pos->second;
+}
+
+std::int64_t
+restore_order_data_source::get_index(const data &example) const
+{
+    std::int64_t index = 0;
+
+    try {
+        index_selector_.visit(example, [&index](const data &element, element_path_ref path)
+        {
+            if (!element.is_int())
+                throw_<std::invalid_argument>(
+                    "The element at '{}' in the input data must be of type `int`, but is of type `{}` instead.", path, element.type());
+
+            index = element.as_int();
+        });
+    } catch (const std::invalid_argument &) {
+        throw_data_pipeline_error_with_nested(example, /*recoverable=*/true,
+            "The original index of the input data cannot be determined.");
+    }
+
+    return index;
+}
+
+void
+restore_order_data_source::reset(bool reset_rng)
+{
+    buffer_.clear();
+
+    next_index_ = 0;
+
+    skipped_ranges_.clear();
+
+    min_tracked_index_ = 0;
+
+    inner_->reset(reset_rng);
+}
+
+void
+restore_order_data_source::record_position(tape &t, bool strict) const
+{
+    if (strict) {
+        std::vector<std::int64_t> indices{};
+        data_list examples{};
+
+        indices.reserve(buffer_.size());
+        examples.reserve(buffer_.size());
+
+        for (auto &[index, example] : buffer_) {
+            indices.push_back(index);
+
+            examples.push_back(example);
+        }
+
+        t.record(indices);
+
+        t.record(examples);
+
+        std::vector<std::int64_t> range_begins{};
+        std::vector<std::int64_t> range_ends{};
+
+        range_begins.reserve(skipped_ranges_.size());
+        range_ends.reserve(skipped_ranges_.size());
+
+        for (auto [begin, end] : skipped_ranges_) {
+            range_begins.push_back(begin);
+
+            range_ends.push_back(end);
+        }
+
+        t.record(range_begins);
+
+        t.record(range_ends);
+
+        t.record(min_tracked_index_);
+    }
+
+    t.record(next_index_);
+
+    inner_->record_position(t, strict);
+}
+
+void
+restore_order_data_source::reload_position(tape &t, bool strict)
+{
+    buffer_.clear();
+
+    skipped_ranges_.clear();
+
+    min_tracked_index_ = 0;
+
+    if (strict) {
+        auto indices = t.read<std::vector<std::int64_t>>();
+
+        auto examples = t.read<data_list>();
+
+        for (std::size_t i = 0; i < std::min(indices.size(), examples.size()); ++i)
+            buffer_.emplace(indices[i], std::move(examples[i]));
+
+        auto range_begins = t.read<std::vector<std::int64_t>>();
+
+        auto range_ends = t.read<std::vector<std::int64_t>>();
+
+        for (std::size_t i = 0; i < std::min(range_begins.size(), range_ends.size()); ++i)
+            skipped_ranges_.emplace(range_begins[i], range_ends[i]);
+
+        min_tracked_index_ = t.read<std::int64_t>();
+    }
+
+    next_index_ = t.read<std::int64_t>();
+
+    inner_->reload_position(t, strict);
+}
+
+bool
+restore_order_data_source::is_infinite() const noexcept
+{
+    return inner_->is_infinite();
+}
+
+}  // namespace fairseq2n::detail
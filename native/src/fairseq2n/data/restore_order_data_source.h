@@ -0,0 +1,73 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include "fairseq2n/data/data_source.h"
+#include "fairseq2n/data/element_selector.h"
+
+namespace fairseq2n::detail {
+
+class restore_order_data_source final : public data_source {
+public:
+    explicit
+    restore_order_data_source(
+        std::unique_ptr<data_source> &&inner,
+        element_selector &&index_selector,
+        std::size_t max_num_buffered) noexcept
+      : inner_{std::move(inner)},
+        index_selector_{std::move(index_selector)},
+        max_num_buffered_{max_num_buffered}
+    {}
+
+    std::optional<data>
+    next() override;
+
+    void
+    reset(bool reset_rng) override;
+
+    void
+    record_position(tape &t, bool strict) const override;
+
+    void
+    reload_position(tape &t, bool strict) override;
+
+    bool
+    is_infinite() const noexcept override;
+
+private:
+    void
+    buffer_example(data &&example);
+
+    void
+    skip_to(std::int64_t index);
+
+    bool
+    is_skipped(std::int64_t index) const;
+
+    std::int64_t
+    get_index(const data &example) const;
+
+private:
+    std::unique_ptr<data_source> inner_;
+    element_selector index_selector_;
+    std::size_t max_num_buffered_;
+    std::map<std::int64_t, data> buffer_{};
+    std::int64_t next_index_ = 0;
+    // The most recent ranges of indices that were skipped because they did not
+    // arrive in time; used to tell late examples apart from duplicates.
+    std::map<std::int64_t, std::int64_t> skipped_ranges_{};
+    std::int64_t min_tracked_index_ = 0;
+};
+
+}  // namespace fairseq2n::detail
@@ -21,7 +21,8 @@ namespace fairseq2n::detail {
 shuffle_data_source::shuffle_data_source(
     std::unique_ptr<data_source> &&inner,
     std::size_t shuffle_window,
-    std::optional<std::uint64_t> maybe_seed)
+    std::optional<std::uint64_t> maybe_seed,
+    std::size_t warmup_window)
   : inner_{std::move(inner)}
 {
     if (shuffle_window == 0)
@@ -29,6 +30,13 @@ shuffle_data_source::shuffle_data_source(
     else
         shuffle_window_ = shuffle_window;
 
+    // A warm-up window that is not smaller than the shuffle window has no
+    // effect.
+    if (warmup_window >= shuffle_window_)
+        warmup_window_ = 0;
+    else
+        warmup_window_ = warmup_window;
+
     seed_ = maybe_seed ? *maybe_seed : pseudo_random();
 
     generator_ = at::make_generator<at::CPUGeneratorImpl>(seed_);
@@ -45,10 +53,17 @@ shuffle_data_source::next()
         // errors.
         buffer_.reserve(std::min(shuffle_window_, max_pre_alloc_size_));
 
-        for (std::size_t i = 0; i < shuffle_window_; i++) {
+        // In warm-up mode, we start emitting as soon as the warm-up window is
+        // filled and grow it to the full shuffle window as we go.
+        std::size_t window = warmup_window_ == 0 ? shuffle_window_ : warmup_window_;
+
+        for (std::size_t i = 0; i < window; i++) {
             std::optional<data> maybe_example = inner_->next();
-            if (!maybe_example)
+            if (!maybe_example) {
+                is_eod_ = true;
+
                 break;
+            }
 
             buffer_.push_back(*std::move(maybe_example));
         }
@@ -57,8 +72,15 @@ shuffle_data_source::next()
         buffer_end_ = buffer_.end();
 
         fill_buffer_ = false;
+
+        // If `inner_` is exhausted before the warm-up window is filled, there
+        // is nothing left to grow into.
+        warming_up_ = warmup_window_ != 0 && buffer_.size() == warmup_window_;
     }
 
+    if (warming_up_)
+        return next_warmup();
+
     if (buffer_pos_ == buffer_end_)
         return std::nullopt;
 
@@ -75,10 +97,18 @@ shuffle_data_source::next()
     // If we have not reached the end of `inner_`, fill the position of the
     // moved example with a new example.
     if (buffer_end_ == buffer_.end()) {
-        std::optional<data> maybe_example = inner_->next();
+        std::optional<data> maybe_example{};
+
+        // `inner_` might have already been exhausted while filling the buffer
+        // or during warm-up; in that case, do not read from it again.
+        if (!is_eod_)
+            maybe_example = inner_->next();
+
         if (maybe_example) {
             buffered_example = *std::move(maybe_example);
         } else {
+            is_eod_ = true;
+
             // Mark this position, so that once we cycle back to it, we can
             // stop.
             buffer_end_ = buffer_pos_;
@@ -101,6 +131,10 @@ shuffle_data_source::reset(bool reset_rng)
 
     fill_buffer_ = true;
 
+    warming_up_ = false;
+
+    is_eod_ = false;
+
     if (reset_rng)
         generator_.set_current_seed(seed_);
 
@@ -117,6 +151,10 @@ shuffle_data_source::record_position(tape &t, bool strict) const
         t.record(buffer_end_ - buffer_.begin());
 
         t.record(fill_buffer_);
+
+        t.record(warming_up_);
+
+        t.record(is_eod_);
     }
 
     t.record(seed_);
@@ -136,6 +174,10 @@ shuffle_data_source::reload_position(tape &t, bool strict)
         buffer_end_ = buffer_.begin() + t.read<std::ptrdiff_t>();
 
         fill_buffer_ = t.read<bool>();
+
+        warming_up_ = t.read<bool>();
+
+        is_eod_ = t.read<bool>();
     } else {
         buffer_.clear();
 
@@ -143,6 +185,10 @@ shuffle_data_source::reload_position(tape &t, bool strict)
         buffer_end_ = buffer_.end();
 
         fill_buffer_ = true;
+
+        warming_up_ = false;
+
+        is_eod_ = false;
     }
 
     seed_ = t.read<std::uint64_t>();
@@ -158,6 +204,47 @@ shuffle_data_source::is_infinite() const noexcept
     return inner_->is_infinite();
 }
 
+std::optional<data>
+shuffle_data_source::next_warmup()
+{
+    auto *gen = generator_.get<at::CPUGeneratorImpl>();
+
+    // While warming up, the window is still growing, so instead of shuffling
+    // per buffer we sample a random position per call.
+    std::size_t idx = conditional_cast<std::size_t>(gen->random64()) % buffer_.size();
+
+    data output = std::move(buffer_[idx]);
+
+    std::optional<data> maybe_example = inner_->next();
+    if (maybe_example) {
+        buffer_[idx] = *std::move(maybe_example);
+
+        // Grow the window by one example per emitted example.
+        maybe_example = inner_->next();
+        if (maybe_example)
+            buffer_.push_back(*std::move(maybe_example));
+    } else {
+        if (idx != buffer_.size() - 1)
+            buffer_[idx] = std::move(buffer_.back());
+
+        buffer_.pop_back();
+    }
+
+    if (!maybe_example)
+        is_eod_ = true;
+
+    // Once the window reaches its full size, or `inner_` is exhausted, switch
+    // to regular shuffling; `next()` handles the end of `inner_` in that mode.
+    if (!maybe_example || buffer_.size() == shuffle_window_)
+        warming_up_ = false;
+
+    // `push_back()` might have reallocated the buffer.
+    buffer_pos_ = buffer_.begin();
+    buffer_end_ = buffer_.end();
+
+    return output;
+}
+
 void
 shuffle_data_source::shuffle()
 {
@@ -25,7 +25,8 @@ public:
     shuffle_data_source(
         std::unique_ptr<data_source> &&inner,
         std::size_t shuffle_window,
-        std::optional<std::uint64_t> maybe_seed);
+        std::optional<std::uint64_t> maybe_seed,
+        std::size_t warmup_window = 0);
 
     std::optional<data>
     next() override;
@@ -43,6 +44,9 @@ public:
     is_infinite() const noexcept override;
 
 private:
+    std::optional<data>
+    next_warmup();
+
     void
     shuffle();
 
@@ -52,7 +56,10 @@ private:
     data_list::iterator buffer_pos_ = buffer_.begin();
     data_list::iterator buffer_end_ = buffer_.end();
     std::size_t shuffle_window_;
+    std::size_t warmup_window_;
     bool fill_buffer_ = true;
+    bool warming_up_ = false;
+    bool is_eod_ = false;
     std::uint64_t seed_;
     at::Generator generator_;
 };
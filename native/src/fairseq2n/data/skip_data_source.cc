@@ -14,17 +14,31 @@ skip_data_source::next()
     if (num_examples_ == 0)
         return inner_->next();
 
-    if (!skip_) {
-        for (std::size_t i = 0; i < num_examples_; i++)
-            if (!inner_->next())
-                break;
-
-        skip_ = true;
-    }
+    if (!skip_)
+        skip();
 
     return inner_->next();
 }
 
+std::size_t
+skip_data_source::next_n(std::size_t num_examples, data_list &output)
+{
+    if (!skip_)
+        skip();
+
+    return inner_->next_n(num_examples, output);
+}
+
+void
+skip_data_source::skip()
+{
+    for (std::size_t i = 0; i < num_examples_; i++)
+        if (!inner_->next())
+            break;
+
+    skip_ = true;
+}
+
 void
 skip_data_source::reset(bool reset_rng)
 {
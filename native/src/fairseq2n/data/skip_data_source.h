@@ -24,6 +24,9 @@ public:
     std::optional<data>
     next() override;
 
+    std::size_t
+    next_n(std::size_t num_examples, data_list &output) override;
+
     void
     reset(bool reset_rng) override;
 
@@ -36,6 +39,10 @@ public:
     bool
     is_infinite() const noexcept override;
 
+private:
+    void
+    skip();
+
 private:
     std::unique_ptr<data_source> inner_;
     std::size_t num_examples_;
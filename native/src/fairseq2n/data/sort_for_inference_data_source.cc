@@ -0,0 +1,187 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/sort_for_inference_data_source.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+#include "fairseq2n/data/detail/exception.h"
+
+namespace fairseq2n::detail {
+
+sort_for_inference_data_source::sort_for_inference_data_source(
+    std::unique_ptr<data_source> &&inner,
+    std::size_t window_size,
+    std::size_t batch_size,
+    data_length_fn &&fn,
+    std::string index_key)
+  : inner_{std::move(inner)},
+    window_size_{window_size},
+    batch_size_{batch_size},
+    data_length_fn_{std::move(fn)},
+    index_key_{std::move(index_key)}
+{
+    window_lens_.reserve(window_size_);
+
+    window_.reserve(window_size_);
+}
+
+std::optional<data>
+sort_for_inference_data_source::next()
+{
+    if (batch_idx_ == batches_.size()) {
+        if (!fill_window())
+            return std::nullopt;
+
+        batch_window();
+    }
+
+    return std::exchange(batches_[batch_idx_++], {});
+}
+
+bool
+sort_for_inference_data_source::fill_window()
+{
+    // Note that `window_` persists across calls; if an example fails below, we
+    // resume filling the same window on the next call.
+    while (window_.size() < window_size_) {
+        std::optional<data> maybe_example = inner_->next();
+        if (!maybe_example)
+            break;
+
+        data &example = *maybe_example;
+
+        if (!example.is_dict())
+            throw_data_pipeline_error(std::move(maybe_example), /*recoverable=*/true,
+                "The input data must be of type `dict` to hold its original index, but is of type `{}` instead.", example.type());
+
+        std::size_t data_len{};
+        try {
+            data_len = data_length_fn_(example);
+        } catch (const std::invalid_argument &) {
+            throw_data_pipeline_error_with_nested(std::move(maybe_example), /*recoverable=*/true,
+                "The length of the input data cannot be determined.");
+        }
+
+        // The indices are only assigned to the examples that make it into the
+        // window, so they are contiguous even if some examples get skipped.
+        example.as_dict().insert_or_assign(index_key_, next_index_++);
+
+        window_lens_.push_back(data_len);
+
+        window_.push_back(std::move(example));
+    }
+
+    return !window_.empty();
+}
+
+void
+sort_for_inference_data_source::batch_window()
+{
+    std::vector<std::size_t> order(window_.size());
+
+    std::iota(order.begin(), order.end(), 0);
+
+    // Longest examples come first, so that out-of-memory errors, if any, are
+    // hit right at the beginning of the window. The sort is stable to keep the
+    // batches deterministic.
+    std::stable_sort(
+        order.begin(), order.end(), [this](std::size_t lhs, std::size_t rhs)
+        {
+            return window_lens_[lhs] > window_lens_[rhs];
+        });
+
+    batches_.clear();
+
+    batches_.reserve((order.size() + batch_size_ - 1) / batch_size_);
+
+    for (std::size_t i = 0; i < order.size(); i += batch_size_) {
+        std::size_t batch_end = std::min(i + batch_size_, order.size());
+
+        data_list &batch = batches_.emplace_back();
+
+        batch.reserve(batch_end - i);
+
+        for (std::size_t j = i; j < batch_end; ++j)
+            batch.push_back(std::move(window_[order[j]]));
+    }
+
+    batch_idx_ = 0;
+
+    window_lens_.clear();
+
+    window_.clear();
+}
+
+void
+sort_for_inference_data_source::reset(bool reset_rng)
+{
+    window_lens_.clear();
+
+    window_.clear();
+
+    batches_.clear();
+
+    batch_idx_ = 0;
+
+    next_index_ = 0;
+
+    inner_->reset(reset_rng);
+}
+
+void
+sort_for_inference_data_source::record_position(tape &t, bool strict) const
+{
+    if (strict) {
+        t.record(window_lens_);
+
+        t.record(window_);
+
+        t.record(batches_);
+
+        t.record(batch_idx_);
+    }
+
+    t.record(next_index_);
+
+    inner_->record_position(t, strict);
+}
+
+void
+sort_for_inference_data_source::reload_position(tape &t, bool strict)
+{
+    if (strict) {
+        window_lens_ = t.read<std::vector<std::size_t>>();
+
+        window_ = t.read<data_list>();
+
+        batches_ = t.read<std::vector<data_list>>();
+
+        batch_idx_ = t.read<std::size_t>();
+    } else {
+        window_lens_.clear();
+
+        window_.clear();
+
+        batches_.clear();
+
+        batch_idx_ = 0;
+    }
+
+    next_index_ = t.read<std::int64_t>();
+
+    inner_->reload_position(t, strict);
+}
+
+bool
+sort_for_inference_data_source::is_infinite() const noexcept
+{
+    return inner_->is_infinite();
+}
+
+}  // namespace fairseq2n::detail
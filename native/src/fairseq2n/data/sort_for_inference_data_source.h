@@ -0,0 +1,67 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "fairseq2n/data/data_pipeline.h"
+#include "fairseq2n/data/data_source.h"
+
+namespace fairseq2n::detail {
+
+class sort_for_inference_data_source final : public data_source {
+public:
+    explicit
+    sort_for_inference_data_source(
+        std::unique_ptr<data_source> &&inner,
+        std::size_t window_size,
+        std::size_t batch_size,
+        data_length_fn &&fn,
+        std::string index_key);
+
+    std::optional<data>
+    next() override;
+
+    void
+    reset(bool reset_rng) override;
+
+    void
+    record_position(tape &t, bool strict) const override;
+
+    void
+    reload_position(tape &t, bool strict) override;
+
+    bool
+    is_infinite() const noexcept override;
+
+private:
+    bool
+    fill_window();
+
+    void
+    batch_window();
+
+private:
+    std::unique_ptr<data_source> inner_;
+    std::size_t window_size_;
+    std::size_t batch_size_;
+    data_length_fn data_length_fn_;
+    std::string index_key_;
+    std::vector<std::size_t> window_lens_{};
+    data_list window_{};
+    std::vector<data_list> batches_{};
+    std::size_t batch_idx_ = 0;
+    std::int64_t next_index_ = 0;
+};
+
+}  // namespace fairseq2n::detail
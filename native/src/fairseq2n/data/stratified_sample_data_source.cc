@@ -0,0 +1,304 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/stratified_sample_data_source.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include <ATen/CPUGeneratorImpl.h>
+#include <ATen/Context.h>
+#include <ATen/core/TransformationHelper.h>
+
+#include "fairseq2n/fmt.h"
+#include "fairseq2n/data/immutable_string.h"
+#include "fairseq2n/data/detail/exception.h"
+#include "fairseq2n/data/detail/rng.h"
+#include "fairseq2n/detail/exception.h"
+#include "fairseq2n/utils/cast.h"
+
+namespace fairseq2n::detail {
+
+stratified_sample_data_source::stratified_sample_data_source(
+    std::unique_ptr<data_source> &&inner,
+    element_selector &&class_selector,
+    std::size_t reservoir_size,
+    std::optional<std::unordered_map<std::string, float64>> &&maybe_weights,
+    std::optional<float64> maybe_temperature,
+    std::optional<std::uint64_t> maybe_seed)
+  : inner_{std::move(inner)},
+    class_selector_{std::move(class_selector)},
+    reservoir_size_{reservoir_size},
+    maybe_weights_{std::move(maybe_weights)},
+    maybe_temperature_{maybe_temperature}
+{
+    seed_ = maybe_seed ? *maybe_seed : pseudo_random();
+
+    generator_ = at::make_generator<at::CPUGeneratorImpl>(seed_);
+}
+
+std::optional<data>
+stratified_sample_data_source::next()
+{
+    while (true) {
+        std::optional<std::size_t> maybe_class_idx = random_class_index();
+        if (!maybe_class_idx) {
+            // If no class can be sampled yet, we have to discover more classes.
+            if (!read_example())
+                return std::nullopt;
+
+            continue;
+        }
+
+        std::size_t class_idx = *maybe_class_idx;
+
+        // Refill the reservoir of the sampled class if it is empty; all other
+        // examples read in the meantime go into their own reservoirs. Note that
+        // we deliberately index `reservoirs_` in the loop since a newly seen
+        // class can reallocate it.
+        while (reservoirs_[class_idx].empty())
+            if (!read_example())
+                break;
+
+        data_list &reservoir = reservoirs_[class_idx];
+
+        // We have reached the end of `inner_` and the class is exhausted; sample
+        // again among the remaining ones.
+        if (reservoir.empty())
+            continue;
+
+        std::size_t idx = random_index(reservoir.size());
+
+        data output = std::move(reservoir[idx]);
+
+        if (idx != reservoir.size() - 1)
+            reservoir[idx] = std::move(reservoir.back());
+
+        reservoir.pop_back();
+
+        return output;
+    }
+}
+
+void
+stratified_sample_data_source::reset(bool reset_rng)
+{
+    classes_.clear();
+
+    class_idxs_.clear();
+
+    reservoirs_.clear();
+
+    num_seen_.clear();
+
+    is_eod_ = false;
+
+    if (reset_rng)
+        generator_.set_current_seed(seed_);
+
+    inner_->reset(reset_rng);
+}
+
+void
+stratified_sample_data_source::record_position(tape &t, bool strict) const
+{
+    if (strict) {
+        t.record(classes_);
+
+        t.record(reservoirs_);
+
+        t.record(num_seen_);
+
+        t.record(is_eod_);
+    }
+
+    t.record(seed_);
+
+    t.record(generator_.get_state());
+
+    inner_->record_position(t, strict);
+}
+
+void
+stratified_sample_data_source::reload_position(tape &t, bool strict)
+{
+    classes_.clear();
+
+    class_idxs_.clear();
+
+    if (strict) {
+        for (immutable_string &cls : t.read<std::vector<immutable_string>>()) {
+            class_idxs_.emplace(cls.to_string(), classes_.size());
+
+            classes_.push_back(cls.to_string());
+        }
+
+        reservoirs_ = t.read<std::vector<data_list>>();
+
+        num_seen_ = t.read<std::vector<std::int64_t>>();
+
+        is_eod_ = t.read<bool>();
+
+        if (reservoirs_.size() != classes_.size() || num_seen_.size() != classes_.size())
+            throw_<std::invalid_argument>(
+                "The tape is corrupt. The state of the data pipeline cannot be restored.");
+    } else {
+        reservoirs_.clear();
+
+        num_seen_.clear();
+
+        is_eod_ = false;
+    }
+
+    seed_ = t.read<std::uint64_t>();
+
+    generator_.set_state(t.read<at::Tensor>());
+
+    inner_->reload_position(t, strict);
+}
+
+bool
+stratified_sample_data_source::is_infinite() const noexcept
+{
+    return inner_->is_infinite();
+}
+
+std::optional<std::size_t>
+stratified_sample_data_source::random_class_index()
+{
+    float64 total_weight = 0.0;
+
+    for (std::size_t i = 0; i < classes_.size(); ++i)
+        total_weight += class_weight(i);
+
+    if (total_weight <= 0.0)
+        return std::nullopt;
+
+    auto *gen = generator_.get<at::CPUGeneratorImpl>();
+
+    float64 sample = at::transformation::uniform_real(gen->random64(), 0.0, total_weight);
+
+    std::optional<std::size_t> maybe_class_idx{};
+
+    for (std::size_t i = 0; i < classes_.size(); ++i) {
+        float64 weight = class_weight(i);
+        if (weight <= 0.0)
+            continue;
+
+        maybe_class_idx = i;
+
+        if (sample < weight)
+            break;
+
+        sample -= weight;
+    }
+
+    return maybe_class_idx;
+}
+
+float64
+stratified_sample_data_source::class_weight(std::size_t class_idx) const
+{
+    // Once we reach the end of `inner_`, a class with an empty reservoir is
+    // exhausted.
+    if (is_eod_ && reservoirs_[class_idx].empty())
+        return 0.0;
+
+    if (maybe_weights_) {
+        auto pos = maybe_weights_->find(classes_[class_idx]);
+        if (pos == maybe_weights_->end())
+            return 0.0;
+
+        return pos->second;
+    }
+
+    if (maybe_temperature_)
+        return std::pow(static_cast<float64>(num_seen_[class_idx]), 1.0 / *maybe_temperature_);
+
+    return 1.0;
+}
+
+bool
+stratified_sample_data_source::read_example()
+{
+    if (is_eod_)
+        return false;
+
+    std::optional<data> maybe_example = inner_->next();
+    if (!maybe_example) {
+        is_eod_ = true;
+
+        return false;
+    }
+
+    std::string cls = get_class(*maybe_example);
+
+    // If the target distribution is explicit, drop the classes that would
+    // never be sampled instead of buffering them.
+    if (maybe_weights_) {
+        auto pos = maybe_weights_->find(cls);
+        if (pos == maybe_weights_->end() || pos->second <= 0.0)
+            return true;
+    }
+
+    auto [class_pos, is_new_class] = class_idxs_.emplace(cls, classes_.size());
+    if (is_new_class) {
+        classes_.push_back(std::move(cls));
+
+        reservoirs_.emplace_back().reserve(reservoir_size_);
+
+        num_seen_.push_back(0);
+    }
+
+    std::size_t class_idx = class_pos->second;
+
+    data_list &reservoir = reservoirs_[class_idx];
+
+    auto num_seen = static_cast<std::size_t>(++num_seen_[class_idx]);
+
+    // Vanilla reservoir sampling (i.e. Algorithm R) once the reservoir is full.
+    if (reservoir.size() < reservoir_size_)
+        reservoir.push_back(*std::move(maybe_example));
+    else if (std::size_t idx = random_index(num_seen); idx < reservoir_size_)
+        reservoir[idx] = *std::move(maybe_example);
+
+    return true;
+}
+
+std::string
+stratified_sample_data_source::get_class(const data &example) const
+{
+    std::string output{};
+
+    try {
+        class_selector_.visit(example, [&output](const data &element, element_path_ref path)
+        {
+            if (element.is_string())
+                output = element.as_string().to_string();
+            else if (element.is_int())
+                output = fmt::to_string(element.as_int());
+            else
+                throw_<std::invalid_argument>(
+                    "The element at '{}' in the input data must be of type `string` or `int` to be used as a class, but is of type `{}` instead.", path, element.type());
+        });
+    } catch (const std::invalid_argument &) {
+        throw_data_pipeline_error_with_nested(example, /*recoverable=*/true,
+            "The class of the input data cannot be determined.");
+    }
+
+    return output;
+}
+
+std::size_t
+stratified_sample_data_source::random_index(std::size_t size)
+{
+    auto *gen = generator_.get<at::CPUGeneratorImpl>();
+
+    return conditional_cast<std::size_t>(gen->random64()) % size;
+}
+
+}  // namespace fairseq2n::detail
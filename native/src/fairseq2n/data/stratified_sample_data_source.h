@@ -0,0 +1,82 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ATen/Generator.h>
+
+#include "fairseq2n/float.h"
+#include "fairseq2n/data/data_source.h"
+#include "fairseq2n/data/element_selector.h"
+
+namespace fairseq2n::detail {
+
+class stratified_sample_data_source final : public data_source {
+public:
+    explicit
+    stratified_sample_data_source(
+        std::unique_ptr<data_source> &&inner,
+        element_selector &&class_selector,
+        std::size_t reservoir_size,
+        std::optional<std::unordered_map<std::string, float64>> &&maybe_weights,
+        std::optional<float64> maybe_temperature,
+        std::optional<std::uint64_t> maybe_seed);
+
+    std::optional<data>
+    next() override;
+
+    void
+    reset(bool reset_rng) override;
+
+    void
+    record_position(tape &t, bool strict) const override;
+
+    void
+    reload_position(tape &t, bool strict) override;
+
+    bool
+    is_infinite() const noexcept override;
+
+private:
+    std::optional<std::size_t>
+    random_class_index();
+
+    float64
+    class_weight(std::size_t class_idx) const;
+
+    bool
+    read_example();
+
+    std::string
+    get_class(const data &example) const;
+
+    std::size_t
+    random_index(std::size_t size);
+
+private:
+    std::unique_ptr<data_source> inner_;
+    element_selector class_selector_;
+    std::size_t reservoir_size_;
+    std::optional<std::unordered_map<std::string, float64>> maybe_weights_;
+    std::optional<float64> maybe_temperature_;
+    std::vector<std::string> classes_{};
+    std::unordered_map<std::string, std::size_t> class_idxs_{};
+    std::vector<data_list> reservoirs_{};
+    std::vector<std::int64_t> num_seen_{};
+    bool is_eod_ = false;
+    std::uint64_t seed_;
+    at::Generator generator_;
+};
+
+}  // namespace fairseq2n::detail
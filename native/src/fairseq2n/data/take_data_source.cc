@@ -6,6 +6,8 @@
 
 #include "fairseq2n/data/take_data_source.h"
 
+#include <algorithm>
+
 namespace fairseq2n::detail {
 
 std::optional<data>
@@ -21,6 +23,17 @@ take_data_source::next()
     return maybe_example;
 }
 
+std::size_t
+take_data_source::next_n(std::size_t num_examples, data_list &output)
+{
+    std::size_t n = inner_->next_n(
+        std::min(num_examples, num_examples_ - num_examples_read_), output);
+
+    num_examples_read_ += n;
+
+    return n;
+}
+
 void
 take_data_source::reset(bool reset_rng)
 {
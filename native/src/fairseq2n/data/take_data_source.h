@@ -24,6 +24,9 @@ public:
     std::optional<data>
     next() override;
 
+    std::size_t
+    next_n(std::size_t num_examples, data_list &output) override;
+
     void
     reset(bool reset_rng) override;
 
@@ -0,0 +1,389 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/take_random_data_source.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+#include <ATen/CPUGeneratorImpl.h>
+#include <ATen/Context.h>
+#include <ATen/core/TransformationHelper.h>
+
+#include "fairseq2n/data/detail/exception.h"
+#include "fairseq2n/data/detail/rng.h"
+#include "fairseq2n/detail/exception.h"
+#include "fairseq2n/utils/cast.h"
+
+namespace fairseq2n::detail {
+
+take_random_data_source::take_random_data_source(
+    std::unique_ptr<data_source> &&inner,
+    std::size_t num_examples,
+    std::optional<element_selector> &&maybe_weight_selector,
+    std::optional<std::uint64_t> maybe_seed)
+  : inner_{std::move(inner)},
+    num_examples_{num_examples},
+    maybe_weight_selector_{std::move(maybe_weight_selector)}
+{
+    seed_ = maybe_seed ? *maybe_seed : pseudo_random();
+
+    generator_ = at::make_generator<at::CPUGeneratorImpl>(seed_);
+}
+
+std::optional<data>
+take_random_data_source::next()
+{
+    if (fill_reservoir_) {
+        if (inner_->is_infinite())
+            throw_data_pipeline_error(std::nullopt, /*recoverable=*/false,
+                "A random sample cannot be taken from an infinite data pipeline.");
+
+        fill_reservoir();
+    }
+
+    if (reservoir_pos_ == reservoir_.size())
+        return std::nullopt;
+
+    return std::move(reservoir_[reservoir_pos_++]);
+}
+
+void
+take_random_data_source::reset(bool reset_rng)
+{
+    reservoir_.clear();
+
+    reservoir_pos_ = 0;
+
+    fill_reservoir_ = true;
+
+    if (reset_rng)
+        generator_.set_current_seed(seed_);
+
+    inner_->reset(reset_rng);
+}
+
+void
+take_random_data_source::record_position(tape &t, bool strict) const
+{
+    if (strict) {
+        t.record(reservoir_);
+
+        t.record(reservoir_pos_);
+
+        t.record(fill_reservoir_);
+    }
+
+    t.record(seed_);
+
+    t.record(generator_.get_state());
+
+    inner_->record_position(t, strict);
+}
+
+void
+take_random_data_source::reload_position(tape &t, bool strict)
+{
+    if (strict) {
+        reservoir_ = t.read<data_list>();
+
+        reservoir_pos_ = t.read<std::size_t>();
+
+        fill_reservoir_ = t.read<bool>();
+
+        if (reservoir_pos_ > reservoir_.size())
+            throw_<std::invalid_argument>(
+                "The tape is corrupt. The state of the data pipeline cannot be restored.");
+    } else {
+        reservoir_.clear();
+
+        reservoir_pos_ = 0;
+
+        fill_reservoir_ = true;
+    }
+
+    seed_ = t.read<std::uint64_t>();
+
+    generator_.set_state(t.read<at::Tensor>());
+
+    inner_->reload_position(t, strict);
+}
+
+bool
+take_random_data_source::is_infinite() const noexcept
+{
+    return false;
+}
+
+void
+take_random_data_source::fill_reservoir()
+{
+    reservoir_.clear();
+
+    // We have an upper limit on the reserved buffer size to avoid OOM errors.
+    reservoir_.reserve(std::min(num_examples_, max_pre_alloc_size_));
+
+    // The position of each sampled example in `inner_`.
+    std::vector<std::int64_t> stream_idxs{};
+
+    if (maybe_weight_selector_)
+        fill_reservoir_weighted(stream_idxs);
+    else
+        fill_reservoir_unweighted(stream_idxs);
+
+    // Return the sampled examples in the order they were read from `inner_`
+    // so that the sample does not depend on the slot each one landed in.
+    std::vector<std::size_t> order(reservoir_.size());
+
+    std::iota(order.begin(), order.end(), std::size_t{0});
+
+    std::sort(order.begin(), order.end(), [&stream_idxs](std::size_t a, std::size_t b)
+    {
+        return stream_idxs[a] < stream_idxs[b];
+    });
+
+    data_list output{};
+
+    output.reserve(order.size());
+
+    for (std::size_t idx : order)
+        output.push_back(std::move(reservoir_[idx]));
+
+    reservoir_ = std::move(output);
+
+    reservoir_pos_ = 0;
+
+    fill_reservoir_ = false;
+}
+
+void
+take_random_data_source::fill_reservoir_unweighted(std::vector<std::int64_t> &stream_idxs)
+{
+    if (num_examples_ == 0)
+        return;
+
+    std::int64_t stream_idx = 0;
+
+    while (reservoir_.size() < num_examples_) {
+        std::optional<data> maybe_example = inner_->next();
+        if (!maybe_example)
+            return;
+
+        reservoir_.push_back(*std::move(maybe_example));
+
+        stream_idxs.push_back(stream_idx++);
+    }
+
+    auto k = static_cast<float64>(num_examples_);
+
+    // Li's Algorithm L. Instead of drawing a random number per example, we
+    // draw the number of examples to skip before the next replacement from a
+    // geometric distribution; skipped examples cost a single read each. We
+    // keep `W` in log space since it quickly approaches zero.
+    float64 log_w = random_log_unit() / k;
+
+    while (true) {
+        float64 num_skip = std::floor(random_log_unit() / std::log1p(-std::exp(log_w)));
+
+        // `num_skip` can be arbitrarily large once `W` is close to zero.
+        std::size_t n = std::numeric_limits<std::size_t>::max();
+        if (num_skip < static_cast<float64>(n))
+            n = static_cast<std::size_t>(num_skip);
+
+        if (!skip_inner(n))
+            return;
+
+        stream_idx += static_cast<std::int64_t>(n);
+
+        std::optional<data> maybe_example = inner_->next();
+        if (!maybe_example)
+            return;
+
+        std::size_t idx = random_index(num_examples_);
+
+        reservoir_[idx] = *std::move(maybe_example);
+
+        stream_idxs[idx] = stream_idx++;
+
+        log_w += random_log_unit() / k;
+    }
+}
+
+void
+take_random_data_source::fill_reservoir_weighted(std::vector<std::int64_t> &stream_idxs)
+{
+    if (num_examples_ == 0)
+        return;
+
+    struct entry {
+        float64 log_key;
+        std::int64_t stream_idx;
+        data example;
+    };
+
+    // Keep the entry with the smallest key at the front.
+    auto key_greater = [](const entry &a, const entry &b)
+    {
+        return a.log_key > b.log_key;
+    };
+
+    std::vector<entry> heap{};
+
+    heap.reserve(std::min(num_examples_, max_pre_alloc_size_));
+
+    auto finish = [this, &heap, &stream_idxs]
+    {
+        for (entry &e : heap) {
+            reservoir_.push_back(std::move(e.example));
+
+            stream_idxs.push_back(e.stream_idx);
+        }
+    };
+
+    std::int64_t stream_idx = -1;
+
+    // Efraimidis and Spirakis' A-ExpJ. Each example is assigned the key
+    // `u^(1/w)` and the examples with the `k` largest keys form the sample.
+    // As in Algorithm L, we draw the total weight to skip before the next
+    // replacement instead of a key per example. Keys are kept in log space.
+    while (heap.size() < num_examples_) {
+        std::optional<data> maybe_example = inner_->next();
+        if (!maybe_example) {
+            finish();
+
+            return;
+        }
+
+        stream_idx++;
+
+        float64 weight = get_weight(*maybe_example);
+        if (weight == 0.0)
+            continue;
+
+        heap.push_back(entry{random_log_unit() / weight, stream_idx, *std::move(maybe_example)});
+
+        std::push_heap(heap.begin(), heap.end(), key_greater);
+    }
+
+    while (true) {
+        float64 log_t = heap.front().log_key;
+
+        float64 skip_weight = random_log_unit() / log_t;
+
+        float64 weight{};
+
+        std::optional<data> maybe_example{};
+
+        for (float64 weight_sum = 0.0; weight_sum < skip_weight;) {
+            maybe_example = inner_->next();
+            if (!maybe_example) {
+                finish();
+
+                return;
+            }
+
+            stream_idx++;
+
+            weight = get_weight(*maybe_example);
+
+            weight_sum += weight;
+        }
+
+        auto *gen = generator_.get<at::CPUGeneratorImpl>();
+
+        // The new key is drawn from `[T^w, 1)`, where `T` is the smallest key
+        // in the reservoir, so that it is guaranteed to replace it.
+        float64 min_key = std::exp(log_t * weight);
+
+        float64 key = at::transformation::uniform_real(gen->random64(), min_key, 1.0);
+
+        key = std::max(key, std::numeric_limits<float64>::min());
+
+        std::pop_heap(heap.begin(), heap.end(), key_greater);
+
+        heap.back() = entry{std::log(key) / weight, stream_idx, *std::move(maybe_example)};
+
+        std::push_heap(heap.begin(), heap.end(), key_greater);
+    }
+}
+
+bool
+take_random_data_source::skip_inner(std::size_t num_examples)
+{
+    data_list discarded{};
+
+    // Read in bounded chunks so that sources with a batched `next_n()` can
+    // skip cheaply without us holding on to too many examples.
+    while (num_examples > 0) {
+        std::size_t chunk_size = std::min(num_examples, skip_chunk_size_);
+
+        discarded.clear();
+
+        if (inner_->next_n(chunk_size, discarded) < chunk_size)
+            return false;
+
+        num_examples -= chunk_size;
+    }
+
+    return true;
+}
+
+float64
+take_random_data_source::get_weight(const data &example) const
+{
+    float64 weight{};
+
+    try {
+        maybe_weight_selector_->visit(example, [&weight](const data &element, element_path_ref path)
+        {
+            if (element.is_float())
+                weight = element.as_float();
+            else if (element.is_int())
+                weight = static_cast<float64>(element.as_int());
+            else
+                throw_<std::invalid_argument>(
+                    "The element at '{}' in the input data must be of type `float` or `int` to be used as a weight, but is of type `{}` instead.", path, element.type());
+
+            if (weight < 0.0 || !std::isfinite(weight))
+                throw_<std::invalid_argument>(
+                    "The element at '{}' in the input data must be a finite number greater than or equal to 0.0 to be used as a weight, but is {} instead.", path, weight);
+        });
+    } catch (const std::invalid_argument &) {
+        // The reservoir is filled in a single call; we cannot resume it after
+        // a failure, so the error is not recoverable.
+        throw_data_pipeline_error_with_nested(example, /*recoverable=*/false,
+            "The weight of the input data cannot be determined.");
+    }
+
+    return weight;
+}
+
+float64
+take_random_data_source::random_log_unit()
+{
+    auto *gen = generator_.get<at::CPUGeneratorImpl>();
+
+    // Draw from `(0, 1)` so that the logarithm is finite and negative.
+    float64 value{};
+    do {
+        value = at::transformation::uniform_real(gen->random64(), 0.0, 1.0);
+    } while (value == 0.0);
+
+    return std::log(value);
+}
+
+std::size_t
+take_random_data_source::random_index(std::size_t size)
+{
+    auto *gen = generator_.get<at::CPUGeneratorImpl>();
+
+    return conditional_cast<std::size_t>(gen->random64()) % size;
+}
+
+}  // namespace fairseq2n::detail
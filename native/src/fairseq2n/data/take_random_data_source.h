@@ -0,0 +1,84 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <ATen/Generator.h>
+
+#include "fairseq2n/float.h"
+#include "fairseq2n/data/data_source.h"
+#include "fairseq2n/data/element_selector.h"
+
+namespace fairseq2n::detail {
+
+class take_random_data_source final : public data_source {
+    static constexpr std::size_t max_pre_alloc_size_ = 100'000;
+    static constexpr std::size_t skip_chunk_size_ = 64;
+
+public:
+    explicit
+    take_random_data_source(
+        std::unique_ptr<data_source> &&inner,
+        std::size_t num_examples,
+        std::optional<element_selector> &&maybe_weight_selector,
+        std::optional<std::uint64_t> maybe_seed);
+
+    std::optional<data>
+    next() override;
+
+    void
+    reset(bool reset_rng) override;
+
+    void
+    record_position(tape &t, bool strict) const override;
+
+    void
+    reload_position(tape &t, bool strict) override;
+
+    bool
+    is_infinite() const noexcept override;
+
+private:
+    void
+    fill_reservoir();
+
+    void
+    fill_reservoir_unweighted(std::vector<std::int64_t> &stream_idxs);
+
+    void
+    fill_reservoir_weighted(std::vector<std::int64_t> &stream_idxs);
+
+    bool
+    skip_inner(std::size_t num_examples);
+
+    float64
+    get_weight(const data &example) const;
+
+    float64
+    random_log_unit();
+
+    std::size_t
+    random_index(std::size_t size);
+
+private:
+    std::unique_ptr<data_source> inner_;
+    std::size_t num_examples_;
+    std::optional<element_selector> maybe_weight_selector_;
+    data_list reservoir_{};
+    std::size_t reservoir_pos_ = 0;
+    bool fill_reservoir_ = true;
+    std::uint64_t seed_;
+    at::Generator generator_;
+};
+
+}  // namespace fairseq2n::detail
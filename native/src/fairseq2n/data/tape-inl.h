@@ -9,6 +9,7 @@
 #include <cstdint>
 #include <optional>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "fairseq2n/float.h"
@@ -114,10 +115,10 @@ tape::read()
             return d.as_memory_block();
     } else if constexpr (std::is_same_v<T, data_list>) {
         if (d.is_list())
-            return d.as_list();
+            return std::move(d).as_list();
     } else if constexpr (std::is_same_v<T, data_dict>) {
         if (d.is_dict())
-            return d.as_dict();
+            return std::move(d).as_dict();
     } else if constexpr (std::is_same_v<T, py_object>) {
         if (d.is_py())
             return d.as_py();
@@ -0,0 +1,91 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/text/detail/line_scan.h"
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+
+namespace fairseq2n::detail {
+namespace {
+
+// Returns the end offset of the first line that ends in `[pos, size)`.
+inline std::optional<std::size_t>
+find_line_end(span<const char> chars, std::size_t pos, line_ending le) noexcept
+{
+    const char *first = chars.data();
+    const char *last = first + chars.size();
+
+    for (const char *ptr = first + pos; ptr < last;) {
+        const void *lf = std::memchr(ptr, '\n', static_cast<std::size_t>(last - ptr));
+        if (lf == nullptr)
+            break;
+
+        ptr = static_cast<const char *>(lf) + 1;
+
+        // In CRLF mode, a line feed without a preceding carriage return does
+        // not end a line.
+        if (le == line_ending::crlf && (ptr - first < 2 || ptr[-2] != '\r'))
+            continue;
+
+        return static_cast<std::size_t>(ptr - first);
+    }
+
+    return std::nullopt;
+}
+
+}  // namespace
+
+line_ending
+infer_line_ending(span<const char> chars) noexcept
+{
+    const void *lf = std::memchr(chars.data(), '\n', chars.size());
+    if (lf == nullptr)
+        return line_ending::lf;
+
+    auto pos = static_cast<const char *>(lf);
+
+    if (pos > chars.data() && pos[-1] == '\r')
+        return line_ending::crlf;
+
+    return line_ending::lf;
+}
+
+void
+scan_line_ends(
+    span<const char> chars,
+    line_ending le,
+    std::uint64_t base,
+    std::vector<std::uint64_t> &line_ends)
+{
+    std::optional<std::size_t> maybe_end{};
+
+    for (std::size_t pos = 0; (maybe_end = find_line_end(chars, pos, le)); pos = *maybe_end)
+        line_ends.push_back(base + *maybe_end);
+}
+
+std::size_t
+find_line_start(span<const char> chars, std::size_t pos, line_ending le) noexcept
+{
+    if (pos == 0)
+        return 0;
+
+    if (pos >= chars.size())
+        return chars.size();
+
+    // A line starts at `pos` if the preceding line ends right before it. In
+    // CRLF mode, the terminator might start one byte before `pos`.
+    std::size_t search_pos = le == line_ending::crlf ? std::max(pos, std::size_t{2}) - 2 : pos - 1;
+
+    std::optional<std::size_t> maybe_end = find_line_end(chars, search_pos, le);
+    while (maybe_end && *maybe_end < pos)
+        maybe_end = find_line_end(chars, *maybe_end, le);
+
+    return maybe_end.value_or(chars.size());
+}
+
+}  // namespace fairseq2n::detail
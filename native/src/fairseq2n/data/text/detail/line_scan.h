@@ -0,0 +1,37 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "fairseq2n/span.h"
+#include "fairseq2n/data/text/text_reader.h"
+
+namespace fairseq2n::detail {
+
+// Infers the line ending of `chars` from its first line feed. Defaults to LF if
+// `chars` has no line feed.
+line_ending
+infer_line_ending(span<const char> chars) noexcept;
+
+// Appends the end offsets of the lines in `chars`, shifted by `base`, to
+// `line_ends`. A partial last line is not included.
+void
+scan_line_ends(
+    span<const char> chars,
+    line_ending le,
+    std::uint64_t base,
+    std::vector<std::uint64_t> &line_ends);
+
+// Returns the offset of the first line start in `chars` that is at or after
+// `pos`, or the size of `chars` if there is none.
+std::size_t
+find_line_start(span<const char> chars, std::size_t pos, line_ending le) noexcept;
+
+}  // namespace fairseq2n::detail
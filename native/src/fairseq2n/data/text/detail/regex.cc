@@ -0,0 +1,33 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/text/detail/regex.h"
+
+#include <stdexcept>
+
+#include "fairseq2n/fmt.h"
+#include "fairseq2n/detail/exception.h"
+
+namespace fairseq2n::detail {
+
+std::shared_ptr<const re2::RE2>
+compile_regex(std::string_view pattern)
+{
+    re2::RE2::Options opts{};
+
+    // We report errors via exceptions; do not log them to stderr.
+    opts.set_log_errors(false);
+
+    auto regex = std::make_shared<const re2::RE2>(pattern, opts);
+
+    if (!regex->ok())
+        throw_<std::invalid_argument>(
+            "`pattern` must be a valid regular expression, but is '{}' instead. {}", pattern, regex->error());
+
+    return regex;
+}
+
+}  // namespace fairseq2n::detail
@@ -0,0 +1,19 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <memory>
+#include <string_view>
+
+#include <re2/re2.h>
+
+namespace fairseq2n::detail {
+
+std::shared_ptr<const re2::RE2>
+compile_regex(std::string_view pattern);
+
+}  // namespace fairseq2n::detail
@@ -7,29 +7,55 @@
 #include "fairseq2n/data/text/detail/utf.h"
 
 #include <cstdint>
+#include <cstring>
 
 #include "fairseq2n/span.h"
 #include "fairseq2n/detail/exception.h"
 
 namespace fairseq2n::detail {
 
+bool
+is_ascii(std::string_view s) noexcept
+{
+    constexpr std::uint64_t high_bits = 0x8080808080808080ULL;
+
+    const char *ptr = s.data();
+    const char *end = ptr + s.size();
+
+    // Accumulate the high bits of all bytes and test them once per block so
+    // that the loop has no data-dependent branches and can be vectorized.
+    for (; end - ptr >= 32; ptr += 32) {
+        std::uint64_t words[4]{};
+
+        std::memcpy(words, ptr, sizeof(words));
+
+        if (((words[0] | words[1] | words[2] | words[3]) & high_bits) != 0)
+            return false;
+    }
+
+    for (; end - ptr >= 8; ptr += 8) {
+        std::uint64_t word{};
+
+        std::memcpy(&word, ptr, sizeof(word));
+
+        if ((word & high_bits) != 0)
+            return false;
+    }
+
+    for (; ptr < end; ++ptr)
+        if ((static_cast<unsigned char>(*ptr) & 0x80) != 0)
+            return false;
+
+    return true;
+}
+
 std::size_t
 compute_code_point_length(std::string_view s)
 {
     std::size_t len = 0;
 
     for (auto pos = s.begin(); pos < s.end();) {
-        std::size_t size = 0;
-
-        auto lead = static_cast<std::uint8_t>(*pos);
-             if ((lead & 0x80) == 0x00)
-            size = 1;
-        else if ((lead & 0xe0) == 0xc0)
-            size = 2;
-        else if ((lead & 0xf0) == 0xe0)
-            size = 3;
-        else if ((lead & 0xf8) == 0xf0)
-            size = 4;
+        std::size_t size = get_code_point_size(*pos);
 
         if (size == 0 || static_cast<std::size_t>(s.end() - pos) < size)
             throw_<std::invalid_argument>("`s` has an invalid UTF-8 code point.");
@@ -14,6 +14,30 @@
 
 namespace fairseq2n::detail {
 
+// Checks whether `s` consists of only ASCII characters. The bulk of `s` is
+// scanned in 32-byte blocks, each tested with a single branch.
+bool
+is_ascii(std::string_view s) noexcept;
+
+// Returns the size in bytes of the UTF-8 code point that starts with `lead`, or
+// zero if `lead` is not a valid lead byte.
+inline std::size_t
+get_code_point_size(char lead) noexcept
+{
+    auto b = static_cast<unsigned char>(lead);
+
+    if ((b & 0x80) == 0x00)
+        return 1;
+    if ((b & 0xe0) == 0xc0)
+        return 2;
+    if ((b & 0xf0) == 0xe0)
+        return 3;
+    if ((b & 0xf8) == 0xf0)
+        return 4;
+
+    return 0;
+}
+
 std::size_t
 compute_code_point_length(std::string_view s);
 
@@ -0,0 +1,89 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/text/detail/vocab_table.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "fairseq2n/memory.h"
+#include "fairseq2n/data/detail/hash.h"
+#include "fairseq2n/utils/cast.h"
+
+namespace fairseq2n::detail {
+namespace {
+
+constexpr std::int64_t empty_slot_idx = -1;
+
+constexpr std::size_t min_capacity = 16;
+
+}  // namespace
+
+bool
+vocab_table::try_add(immutable_string token)
+{
+    if (maybe_find(token))
+        return false;
+
+    // Keep the load factor at or below 1/2 so that probe sequences stay short.
+    if (slots_.size() < 2 * (tokens_.size() + 1))
+        rehash(std::max(min_capacity, 2 * slots_.size()));
+
+    insert_slot(hash(token), conditional_cast<std::int64_t>(tokens_.size()));
+
+    tokens_.push_back(std::move(token));
+
+    return true;
+}
+
+std::optional<std::int64_t>
+vocab_table::maybe_find(std::string_view token) const noexcept
+{
+    if (slots_.empty())
+        return std::nullopt;
+
+    std::uint64_t h = hash(token);
+
+    for (std::uint64_t pos = h & mask_;; pos = (pos + 1) & mask_) {
+        const slot &s = slots_[pos];
+
+        if (s.idx == empty_slot_idx)
+            return std::nullopt;
+
+        if (s.hash == h && std::string_view{tokens_[static_cast<std::size_t>(s.idx)]} == token)
+            return s.idx;
+    }
+}
+
+std::uint64_t
+vocab_table::hash(std::string_view token) noexcept
+{
+    return xxh64(memory_span{reinterpret_cast<const std::byte *>(token.data()), token.size()});
+}
+
+void
+vocab_table::rehash(std::size_t capacity)
+{
+    slots_.assign(capacity, slot{0, empty_slot_idx});
+
+    mask_ = capacity - 1;
+
+    for (std::size_t i = 0; i < tokens_.size(); ++i)
+        insert_slot(hash(tokens_[i]), conditional_cast<std::int64_t>(i));
+}
+
+void
+vocab_table::insert_slot(std::uint64_t h, std::int64_t idx) noexcept
+{
+    std::uint64_t pos = h & mask_;
+
+    while (slots_[pos].idx != empty_slot_idx)
+        pos = (pos + 1) & mask_;
+
+    slots_[pos] = slot{h, idx};
+}
+
+}  // namespace fairseq2n::detail
@@ -0,0 +1,65 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "fairseq2n/data/immutable_string.h"
+
+namespace fairseq2n::detail {
+
+// Maps tokens to their indices using an open-addressing hash table with linear
+// probing. The table stores the full hash of each token next to its index so
+// that most probes are resolved without touching the token bytes.
+class vocab_table {
+public:
+    // Adds `token` with the index `size()`. Returns `false` if `token` is
+    // already in the table.
+    bool
+    try_add(immutable_string token);
+
+    std::optional<std::int64_t>
+    maybe_find(std::string_view token) const noexcept;
+
+    const immutable_string &
+    token(std::size_t idx) const noexcept
+    {
+        return tokens_[idx];
+    }
+
+    std::size_t
+    size() const noexcept
+    {
+        return tokens_.size();
+    }
+
+private:
+    struct slot {
+        std::uint64_t hash;
+        std::int64_t idx;
+    };
+
+    static std::uint64_t
+    hash(std::string_view token) noexcept;
+
+    void
+    rehash(std::size_t capacity);
+
+    void
+    insert_slot(std::uint64_t h, std::int64_t idx) noexcept;
+
+private:
+    std::vector<immutable_string> tokens_{};
+    std::vector<slot> slots_{};
+    std::uint64_t mask_{};
+};
+
+}  // namespace fairseq2n::detail
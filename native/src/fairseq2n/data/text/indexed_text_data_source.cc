@@ -0,0 +1,213 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/text/indexed_text_data_source.h"
+
+#include <algorithm>
+#include <exception>
+#include <numeric>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include <ATen/CPUGeneratorImpl.h>
+#include <ATen/Context.h>
+
+#include "fairseq2n/fmt.h"
+#include "fairseq2n/data/byte_stream.h"
+#include "fairseq2n/data/data_pipeline.h"
+#include "fairseq2n/data/file.h"
+#include "fairseq2n/data/immutable_string.h"
+#include "fairseq2n/data/record_reader.h"
+#include "fairseq2n/data/detail/rng.h"
+#include "fairseq2n/data/text/detail/utf.h"
+#include "fairseq2n/detail/exception.h"
+#include "fairseq2n/utils/cast.h"
+#include "fairseq2n/utils/string.h"
+
+namespace fairseq2n::detail {
+
+indexed_text_data_source::indexed_text_data_source(
+    std::filesystem::path &&path, std::optional<std::string> &&maybe_key, text_options &&opts)
+  : path_{std::move(path)}, maybe_key_{std::move(maybe_key)}, opts_{std::move(opts)}
+{
+    seed_ = opts_.maybe_seed() ? *opts_.maybe_seed() : pseudo_random();
+
+    generator_ = at::make_generator<at::CPUGeneratorImpl>(seed_);
+
+    try {
+        load_index();
+    } catch (const std::exception &) {
+        handle_error();
+    }
+}
+
+std::optional<data>
+indexed_text_data_source::next()
+{
+    if (!epoch_started_)
+        start_epoch();
+
+    memory_block line{};
+
+    while (line_pos_ < maybe_index_->num_lines()) {
+        std::size_t line_idx = opts_.shuffle() ? line_order_[line_pos_] : line_pos_;
+
+        line_pos_++;
+
+        auto [first, last] = maybe_index_->line_range(line_idx);
+
+        line = text_.share_slice(first, last - first);
+
+        if (!opts_.skip_empty() || !is_empty(line))
+            break;
+
+        line = {};
+    }
+
+    if (line.empty())
+        return std::nullopt;
+
+    immutable_string output{std::move(line)};
+
+    if (opts_.ltrim())
+        output = ltrim(output);
+
+    if (opts_.rtrim())
+        output = rtrim(output);
+
+    if (maybe_key_)
+        return data_dict{{*maybe_key_, std::move(output)}};
+
+    return output;
+}
+
+void
+indexed_text_data_source::reset(bool reset_rng)
+{
+    line_pos_ = 0;
+
+    epoch_started_ = false;
+
+    if (reset_rng)
+        generator_.set_current_seed(seed_);
+}
+
+void
+indexed_text_data_source::record_position(tape &t, bool) const
+{
+    t.record(line_pos_);
+
+    t.record(epoch_started_);
+
+    if (opts_.shuffle()) {
+        t.record(seed_);
+
+        // Instead of the permutation itself, we record the generator state it
+        // was made from, which lets us regenerate it on reload.
+        if (epoch_started_)
+            t.record(epoch_rng_state_);
+        else
+            t.record(generator_.get_state());
+    }
+}
+
+void
+indexed_text_data_source::reload_position(tape &t, bool)
+{
+    line_pos_ = t.read<std::size_t>();
+
+    bool epoch_started = t.read<bool>();
+
+    if (opts_.shuffle()) {
+        seed_ = t.read<std::uint64_t>();
+
+        generator_.set_state(t.read<at::Tensor>());
+    }
+
+    epoch_started_ = false;
+
+    if (epoch_started)
+        start_epoch();
+}
+
+bool
+indexed_text_data_source::is_infinite() const noexcept
+{
+    return false;
+}
+
+void
+indexed_text_data_source::load_index()
+{
+    text_ = fairseq2n::memory_map_file(path_);
+
+    std::string encoding = infer_bom_encoding(text_.share_first(std::min(text_.size(), std::size_t{4})));
+    if (encoding != "UTF-8")
+        throw_<byte_stream_error>(
+            "'{}' must be UTF-8 encoded to be read with a line index, but is {} encoded instead.", path_.string(), encoding);
+
+    maybe_index_ = text_line_index::load_or_build(
+        path_, text_, *opts_.maybe_index_path(), opts_.line_ending());
+}
+
+void
+indexed_text_data_source::start_epoch()
+{
+    epoch_started_ = true;
+
+    if (!opts_.shuffle())
+        return;
+
+    epoch_rng_state_ = generator_.get_state();
+
+    line_order_.resize(maybe_index_->num_lines());
+
+    std::iota(line_order_.begin(), line_order_.end(), std::size_t{0});
+
+    auto *gen = generator_.get<at::CPUGeneratorImpl>();
+
+    // Vanilla Fisher and Yates'.
+    for (std::size_t s = line_order_.size(); s > 1; s--) {
+        std::uint64_t r = gen->random64();
+
+        std::size_t idx = conditional_cast<std::size_t>(r) % s;
+        if (idx != s - 1)
+            std::swap(line_order_[s - 1], line_order_[idx]);
+    }
+}
+
+bool
+indexed_text_data_source::is_empty(memory_span line) const noexcept
+{
+    if (maybe_index_->actual_line_ending() == line_ending::crlf)
+        return line.size() == 2;
+
+    return line.size() == 1;
+}
+
+void
+indexed_text_data_source::handle_error()
+{
+    try {
+        throw;
+    } catch (const byte_stream_error &) {
+        throw_read_failure();
+    } catch (const record_error &) {
+        throw_read_failure();
+    } catch (const std::system_error &) {
+        throw_read_failure();
+    }
+}
+
+inline void
+indexed_text_data_source::throw_read_failure()
+{
+    throw_with_nested<data_pipeline_error>(
+        "The data pipeline cannot read from '{}'. See nested exception for details.", path_.string());
+}
+
+}  // namespace fairseq2n::detail
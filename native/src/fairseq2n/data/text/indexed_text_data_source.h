@@ -0,0 +1,80 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <ATen/Generator.h>
+#include <ATen/Tensor.h>
+
+#include "fairseq2n/memory.h"
+#include "fairseq2n/data/data_source.h"
+#include "fairseq2n/data/text/text_line_index.h"
+#include "fairseq2n/data/text/text_reader.h"
+
+namespace fairseq2n::detail {
+
+// Reads the lines of a memory mapped text file through a `text_line_index`.
+// Unlike `text_data_source`, it can read the lines in an arbitrary order and
+// reload its position in constant time.
+class indexed_text_data_source final : public data_source {
+public:
+    explicit
+    indexed_text_data_source(
+        std::filesystem::path &&path, std::optional<std::string> &&maybe_key, text_options &&opts);
+
+    std::optional<data>
+    next() override;
+
+    void
+    reset(bool reset_rng) override;
+
+    void
+    record_position(tape &t, bool strict) const override;
+
+    void
+    reload_position(tape &t, bool strict) override;
+
+    bool
+    is_infinite() const noexcept override;
+
+private:
+    void
+    load_index();
+
+    void
+    start_epoch();
+
+    bool
+    is_empty(memory_span line) const noexcept;
+
+    [[noreturn]] void
+    handle_error();
+
+    [[noreturn]] void
+    throw_read_failure();
+
+private:
+    std::filesystem::path path_;
+    std::optional<std::string> maybe_key_;
+    text_options opts_;
+    memory_block text_{};
+    std::optional<text_line_index> maybe_index_{};
+    std::vector<std::size_t> line_order_{};
+    std::size_t line_pos_ = 0;
+    bool epoch_started_ = false;
+    std::uint64_t seed_;
+    at::Generator generator_;
+    at::Tensor epoch_rng_state_{};
+};
+
+}  // namespace fairseq2n::detail
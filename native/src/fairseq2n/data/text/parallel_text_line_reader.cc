@@ -0,0 +1,113 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/text/parallel_text_line_reader.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+#include "fairseq2n/fmt.h"
+#include "fairseq2n/data/record_reader.h"
+#include "fairseq2n/data/text/detail/line_scan.h"
+#include "fairseq2n/detail/exception.h"
+#include "fairseq2n/detail/parallel.h"
+
+namespace fairseq2n::detail {
+
+parallel_text_line_reader::parallel_text_line_reader(
+    memory_block text, line_ending le, std::size_t num_parallel_scans, std::size_t range_size)
+  : text_{std::move(text)},
+    line_ending_{le},
+    num_parallel_scans_{num_parallel_scans},
+    range_size_{range_size},
+    range_line_ends_(num_parallel_scans)
+{
+    if (line_ending_ == line_ending::infer)
+        line_ending_ = infer_line_ending(text_.cast<const char>());
+}
+
+memory_block
+parallel_text_line_reader::next()
+{
+    if (line_idx_ == line_ends_.size())
+        if (!load_next_batch())
+            return {};
+
+    std::uint64_t line_end = line_ends_[line_idx_++];
+
+    memory_block line = text_.share_slice(line_start_, line_end - line_start_);
+
+    line_start_ = line_end;
+
+    return line;
+}
+
+void
+parallel_text_line_reader::reset() noexcept
+{
+    batch_end_ = 0;
+
+    line_ends_.clear();
+
+    line_idx_ = 0;
+
+    line_start_ = 0;
+}
+
+bool
+parallel_text_line_reader::load_next_batch()
+{
+    auto chars = text_.cast<const char>();
+
+    std::size_t batch_start = batch_end_;
+
+    if (batch_start == chars.size())
+        return false;
+
+    // Split the batch into byte ranges that start at line boundaries. A range
+    // can be empty if a single line spans over multiple ranges.
+    std::vector<std::size_t> bounds(num_parallel_scans_ + 1, batch_start);
+
+    for (std::size_t i = 1; i <= num_parallel_scans_; i++) {
+        std::size_t pos = std::max(batch_start + i * range_size_, bounds[i - 1]);
+
+        bounds[i] = find_line_start(chars, pos, line_ending_);
+    }
+
+    auto scan_ranges = [this, &chars, &bounds](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; i++) {
+            std::vector<std::uint64_t> &line_ends = range_line_ends_[i];
+
+            line_ends.clear();
+
+            scan_line_ends(
+                chars.subspan(bounds[i], bounds[i + 1] - bounds[i]), line_ending_, bounds[i], line_ends);
+        }
+    };
+
+    parallel_for<std::size_t>(scan_ranges, num_parallel_scans_);
+
+    line_ends_.clear();
+
+    for (const std::vector<std::uint64_t> &line_ends : range_line_ends_)
+        line_ends_.insert(line_ends_.end(), line_ends.begin(), line_ends.end());
+
+    // Only the last range of the file can end with a partial line. Like
+    // `text_line_reader`, we report it once all preceding lines are read.
+    if (line_ends_.empty())
+        throw_<record_error>(
+            "The stream ends with a partial record of {} byte(s).", fmt::group_digits(chars.size() - batch_start));
+
+    line_idx_ = 0;
+
+    batch_end_ = line_ends_.back();
+
+    return true;
+}
+
+}  // namespace fairseq2n::detail
@@ -0,0 +1,56 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "fairseq2n/memory.h"
+#include "fairseq2n/data/text/text_reader.h"
+
+namespace fairseq2n::detail {
+
+// Reads the lines of a memory mapped UTF-8 text file. The file is processed in
+// batches, each of which is split into `num_parallel_scans` byte ranges aligned
+// to line boundaries that are scanned in parallel. The lines are returned in
+// their original order.
+class parallel_text_line_reader {
+public:
+    explicit
+    parallel_text_line_reader(
+        memory_block text, line_ending le, std::size_t num_parallel_scans, std::size_t range_size);
+
+    memory_block
+    next();
+
+    void
+    reset() noexcept;
+
+    line_ending
+    actual_line_ending() const noexcept
+    {
+        return line_ending_;
+    }
+
+private:
+    bool
+    load_next_batch();
+
+private:
+    memory_block text_;
+    line_ending line_ending_;
+    std::size_t num_parallel_scans_;
+    std::size_t range_size_;
+    std::size_t batch_end_ = 0;
+    std::vector<std::vector<std::uint64_t>> range_line_ends_;
+    std::vector<std::uint64_t> line_ends_{};
+    std::size_t line_idx_ = 0;
+    std::uint64_t line_start_ = 0;
+};
+
+}  // namespace fairseq2n::detail
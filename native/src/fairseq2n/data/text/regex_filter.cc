@@ -0,0 +1,92 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/text/regex_filter.h"
+
+#ifdef FAIRSEQ2N_SUPPORT_REGEX
+#include <stdexcept>
+#include <utility>
+
+#include "fairseq2n/fmt.h"
+#include "fairseq2n/data/data.h"
+#include "fairseq2n/data/text/detail/regex.h"
+#include "fairseq2n/detail/exception.h"
+
+using namespace fairseq2n::detail;
+
+namespace fairseq2n {
+
+regex_filter::regex_filter(
+    std::string_view pattern, std::optional<std::string> maybe_selector, bool exclude)
+  : regex_{compile_regex(pattern)}, exclude_{exclude}
+{
+    if (maybe_selector)
+        maybe_selector_ = element_selector{*std::move(maybe_selector)};
+}
+
+bool
+regex_filter::operator()(const data &d) const
+{
+    return matches(d) != exclude_;
+}
+
+bool
+regex_filter::matches(const data &d) const
+{
+    auto match = [this](const data &element, element_path_ref path = {})
+    {
+        if (!element.is_string()) {
+            if (maybe_selector_)
+                throw_<std::invalid_argument>(
+                    "The element at '{}' in the input data must be of type `string`, but is of type `{}` instead.", path, element.type());
+            else
+                throw_<std::invalid_argument>(
+                    "The input data must be of type `string`, but is of type `{}` instead.", element.type());
+        }
+
+        std::string_view s = element.as_string();
+
+        return re2::RE2::PartialMatch(s, *regex_);
+    };
+
+    if (!maybe_selector_)
+        return match(d);
+
+    // An example matches if any of its selected elements matches.
+    bool matched = false;
+
+    maybe_selector_->visit(d, [&matched, &match](const data &element, element_path_ref path)
+    {
+        if (!matched)
+            matched = match(element, path);
+    });
+
+    return matched;
+}
+
+}  // namespace fairseq2n
+
+#else
+
+#include "fairseq2n/exception.h"
+#include "fairseq2n/detail/exception.h"
+
+namespace fairseq2n {
+
+regex_filter::regex_filter(std::string_view, std::optional<std::string>, bool exclude)
+  : exclude_{exclude}
+{}
+
+bool
+regex_filter::operator()(const data &) const
+{
+    detail::throw_<not_supported_error>(
+        "fairseq2n is not built with regex support.");
+}
+
+}  // namespace fairseq2n
+
+#endif
@@ -0,0 +1,50 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "fairseq2n/api.h"
+#include "fairseq2n/data/element_selector.h"
+
+namespace re2 {
+
+class RE2;
+
+}  // namespace re2
+
+namespace fairseq2n {
+
+class data;
+
+// Keeps the examples whose strings match a regular expression, or drops them if
+// `exclude` is set. Patterns use the RE2 syntax and are matched in linear time.
+class FAIRSEQ2_API regex_filter final {
+public:
+    explicit
+    regex_filter(
+        std::string_view pattern,
+        std::optional<std::string> maybe_selector = {},
+        bool exclude = false);
+
+    bool
+    operator()(const data &d) const;
+
+private:
+    bool
+    matches(const data &d) const;
+
+private:
+    std::shared_ptr<const re2::RE2> regex_;
+    std::optional<element_selector> maybe_selector_{};
+    bool exclude_;
+};
+
+}  // namespace fairseq2n
@@ -0,0 +1,99 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/text/regex_replacer.h"
+
+#ifdef FAIRSEQ2N_SUPPORT_REGEX
+#include <stdexcept>
+#include <utility>
+
+#include "fairseq2n/fmt.h"
+#include "fairseq2n/data/text/detail/regex.h"
+#include "fairseq2n/detail/exception.h"
+
+using namespace fairseq2n::detail;
+
+namespace fairseq2n {
+
+regex_replacer::regex_replacer(
+    std::string_view pattern, std::string rewrite, std::optional<std::string> maybe_selector)
+  : regex_{compile_regex(pattern)}, rewrite_{std::move(rewrite)}
+{
+    std::string error{};
+
+    if (!regex_->CheckRewriteString(rewrite_, &error))
+        throw_<std::invalid_argument>(
+            "`rewrite` must be a valid rewrite string for `pattern`, but is '{}' instead. {}", rewrite_, error);
+
+    if (maybe_selector)
+        maybe_selector_ = element_selector{*std::move(maybe_selector)};
+}
+
+data
+regex_replacer::operator()(data &&d) const
+{
+    if (!maybe_selector_)
+        return replace(std::move(d));
+
+    maybe_selector_->visit(d, [this](data &element, element_path_ref path)
+    {
+        element = replace(std::move(element), path);
+    });
+
+    return std::move(d);
+}
+
+data
+regex_replacer::replace(data &&d, element_path_ref path) const
+{
+    if (!d.is_string()) {
+        if (maybe_selector_)
+            throw_<std::invalid_argument>(
+                "The element at '{}' in the input data must be of type `string`, but is of type `{}` instead.", path, d.type());
+        else
+            throw_<std::invalid_argument>(
+                "The input data must be of type `string`, but is of type `{}` instead.", d.type());
+    }
+
+    std::string_view s = d.as_string();
+
+    // Most strings in a typical cleaning pass have no match; avoid copying them.
+    if (!re2::RE2::PartialMatch(s, *regex_))
+        return std::move(d);
+
+    std::string output{s};
+
+    re2::RE2::GlobalReplace(&output, *regex_, rewrite_);
+
+    return output;
+}
+
+}  // namespace fairseq2n
+
+#else
+
+#include <utility>
+
+#include "fairseq2n/exception.h"
+#include "fairseq2n/detail/exception.h"
+
+namespace fairseq2n {
+
+regex_replacer::regex_replacer(
+    std::string_view, std::string rewrite, std::optional<std::string>)
+  : rewrite_{std::move(rewrite)}
+{}
+
+data
+regex_replacer::operator()(data &&) const
+{
+    detail::throw_<not_supported_error>(
+        "fairseq2n is not built with regex support.");
+}
+
+}  // namespace fairseq2n
+
+#endif
@@ -0,0 +1,52 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "fairseq2n/api.h"
+#include "fairseq2n/data/data.h"
+#include "fairseq2n/data/element_selector.h"
+
+namespace re2 {
+
+class RE2;
+
+}  // namespace re2
+
+namespace fairseq2n {
+
+// Replaces all non-overlapping matches of a regular expression in strings with
+// `rewrite`, which can refer to capturing groups as `\1` to `\9` and to the
+// whole match as `\0`. If `maybe_selector` is specified, the replacement is
+// applied to each selected string of the input data. Strings with no match are
+// returned as is.
+class FAIRSEQ2_API regex_replacer final {
+public:
+    explicit
+    regex_replacer(
+        std::string_view pattern,
+        std::string rewrite,
+        std::optional<std::string> maybe_selector = {});
+
+    data
+    operator()(data &&d) const;
+
+private:
+    data
+    replace(data &&d, element_path_ref path = {}) const;
+
+private:
+    std::shared_ptr<const re2::RE2> regex_;
+    std::string rewrite_;
+    std::optional<element_selector> maybe_selector_{};
+};
+
+}  // namespace fairseq2n
@@ -9,14 +9,17 @@
 #include <algorithm>
 #include <cstddef>
 #include <exception>
+#include <string>
 #include <system_error>
 #include <utility>
 
 #include "fairseq2n/exception.h"
+#include "fairseq2n/fmt.h"
 #include "fairseq2n/data/byte_stream.h"
 #include "fairseq2n/data/data_pipeline.h"
 #include "fairseq2n/data/file.h"
 #include "fairseq2n/data/immutable_string.h"
+#include "fairseq2n/data/text/detail/utf.h"
 #include "fairseq2n/detail/exception.h"
 #include "fairseq2n/utils/string.h"
 
@@ -27,7 +30,7 @@ text_data_source::text_data_source(
   : path_{std::move(path)}, maybe_key_{std::move(maybe_key)}, opts_{std::move(opts)}
 {
     try {
-        line_reader_ = make_text_line_reader();
+        make_line_reader();
     } catch (const std::exception &) {
         handle_error();
     }
@@ -65,7 +68,10 @@ void
 text_data_source::reset(bool)
 {
     try {
-        line_reader_->reset();
+        if (parallel_line_reader_)
+            parallel_line_reader_->reset();
+        else
+            line_reader_->reset();
     } catch (const std::exception &) {
         handle_error();
     }
@@ -96,11 +102,31 @@ text_data_source::is_infinite() const noexcept
     return false;
 }
 
-std::unique_ptr<text_line_reader>
-text_data_source::make_text_line_reader()
+void
+text_data_source::make_line_reader()
 {
     constexpr std::size_t min_chunk_size = 0x0400; // 1 KiB
 
+    if (opts_.num_parallel_scans() > 1) {
+        memory_block text = memory_map_file(path_, /*hint_sequential=*/true);
+
+        std::string encoding = infer_bom_encoding(text.share_first(std::min(text.size(), std::size_t{4})));
+        if (encoding != "UTF-8")
+            throw_<byte_stream_error>(
+                "'{}' must be UTF-8 encoded to be scanned in parallel, but is {} encoded instead.", path_.string(), encoding);
+
+        // Each thread scans a range of this size per batch.
+        std::size_t range_size = opts_.maybe_block_size().value_or(0x0100'0000); // 16 MiB
+
+        parallel_line_reader_ = std::make_unique<parallel_text_line_reader>(
+            std::move(text),
+            opts_.line_ending(),
+            opts_.num_parallel_scans(),
+            std::max(range_size, min_chunk_size));
+
+        return;
+    }
+
     std::size_t chunk_size = opts_.maybe_block_size().value_or(0x0800'0000); // 128 MiB
 
     auto opts = text_file_options(opts_.maybe_encoding())
@@ -108,7 +134,7 @@ text_data_source::make_text_line_reader()
 
     std::unique_ptr<byte_stream> stream = open_file(path_, opts);
 
-    return std::make_unique<text_line_reader>(std::move(stream), opts_.line_ending());
+    line_reader_ = std::make_unique<text_line_reader>(std::move(stream), opts_.line_ending());
 }
 
 memory_block
@@ -116,7 +142,15 @@ text_data_source::read_next_line()
 {
     memory_block line{};
 
-    while (!(line = line_reader_->next()).empty())
+    auto next_line = [this]
+    {
+        if (parallel_line_reader_)
+            return parallel_line_reader_->next();
+
+        return line_reader_->next();
+    };
+
+    while (!(line = next_line()).empty())
         if (!opts_.skip_empty() || !is_empty(line))
             break;
 
@@ -128,7 +162,13 @@ text_data_source::read_next_line()
 bool
 text_data_source::is_empty(memory_span line) const
 {
-    switch (line_reader_->actual_line_ending()) {
+    line_ending le{};
+    if (parallel_line_reader_)
+        le = parallel_line_reader_->actual_line_ending();
+    else
+        le = line_reader_->actual_line_ending();
+
+    switch (le) {
     case line_ending::lf:
         return line.size() == 1;
     case line_ending::crlf:
@@ -16,6 +16,7 @@
 #include "fairseq2n/memory.h"
 #include "fairseq2n/span.h"
 #include "fairseq2n/data/data_source.h"
+#include "fairseq2n/data/text/parallel_text_line_reader.h"
 #include "fairseq2n/data/text/text_line_reader.h"
 #include "fairseq2n/data/text/text_reader.h"
 
@@ -43,8 +44,8 @@ public:
     is_infinite() const noexcept override;
 
 private:
-    std::unique_ptr<text_line_reader>
-    make_text_line_reader();
+    void
+    make_line_reader();
 
     memory_block
     read_next_line();
@@ -62,7 +63,8 @@ private:
     std::filesystem::path path_;
     std::optional<std::string> maybe_key_;
     text_options opts_;
-    std::unique_ptr<text_line_reader> line_reader_;
+    std::unique_ptr<text_line_reader> line_reader_{};
+    std::unique_ptr<parallel_text_line_reader> parallel_line_reader_{};
     std::size_t num_lines_read_ = 0;
 };
 
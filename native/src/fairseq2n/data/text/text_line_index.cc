@@ -0,0 +1,225 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/text/text_line_index.h"
+
+#include <cstring>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "fairseq2n/fmt.h"
+#include "fairseq2n/data/file.h"
+#include "fairseq2n/data/record_reader.h"
+#include "fairseq2n/data/detail/file.h"
+#include "fairseq2n/data/text/detail/line_scan.h"
+#include "fairseq2n/detail/error.h"
+#include "fairseq2n/detail/exception.h"
+
+namespace fairseq2n::detail {
+namespace {
+
+// "FS2TLIDX" in little-endian byte order. An index written on a host with a
+// different byte order has a mismatching magic and gets rebuilt.
+constexpr std::uint64_t index_magic = 0x5844494C54325346;
+
+constexpr std::uint32_t index_version = 1;
+
+// The index file consists of this header followed by `num_lines + 1` line
+// offsets, the last of which is the size of the text file.
+struct index_header {
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t line_ending;
+    std::uint64_t text_size;
+    std::int64_t text_mtime;
+    std::uint64_t num_lines;
+};
+
+static_assert(sizeof(index_header) % sizeof(std::uint64_t) == 0);
+
+index_header
+make_header(const std::filesystem::path &text_path, memory_span text)
+{
+    std::error_code err{};
+
+    auto mtime = std::filesystem::last_write_time(text_path, err);
+    if (err)
+        throw_system_error(err,
+            "The modification time of '{}' cannot be determined", text_path.string());
+
+    index_header header{};
+
+    header.magic = index_magic;
+    header.version = index_version;
+    header.text_size = text.size();
+    header.text_mtime = mtime.time_since_epoch().count();
+
+    return header;
+}
+
+std::optional<memory_block>
+maybe_load_index(const std::filesystem::path &index_path, const index_header &expected, line_ending le)
+{
+    std::error_code err{};
+
+    if (!std::filesystem::exists(index_path, err))
+        return std::nullopt;
+
+    memory_block block = fairseq2n::memory_map_file(index_path);
+
+    if (block.size() < sizeof(index_header))
+        return std::nullopt;
+
+    index_header header{};
+
+    std::memcpy(&header, block.data(), sizeof(index_header));
+
+    if (header.magic != index_magic || header.version != index_version)
+        return std::nullopt;
+
+    // Check whether the index is stale.
+    if (header.text_size != expected.text_size || header.text_mtime != expected.text_mtime)
+        return std::nullopt;
+
+    if (le != line_ending::infer && header.line_ending != static_cast<std::uint32_t>(le))
+        return std::nullopt;
+
+    if (block.size() != sizeof(index_header) + (header.num_lines + 1) * sizeof(std::uint64_t))
+        return std::nullopt;
+
+    return block;
+}
+
+std::vector<std::uint64_t>
+compute_line_offsets(span<const char> chars, line_ending le)
+{
+    std::vector<std::uint64_t> offsets{0};
+
+    scan_line_ends(chars, le, 0, offsets);
+
+    // Like `text_line_reader`, we do not allow a partial last line.
+    if (offsets.back() != chars.size())
+        throw_<record_error>(
+            "The stream ends with a partial record of {} byte(s).", fmt::group_digits(chars.size() - offsets.back()));
+
+    return offsets;
+}
+
+void
+write_all(const file_desc &fd, memory_span bytes, const std::filesystem::path &path)
+{
+    while (!bytes.empty()) {
+        ::ssize_t num_bytes_written = ::write(fd.get(), bytes.data(), bytes.size());
+        if (num_bytes_written == -1) {
+            if (errno == EINTR)
+                continue;
+
+            throw_system_error(last_error(),
+                "The line index '{}' cannot be written", path.string());
+        }
+
+        bytes = bytes.subspan(static_cast<std::size_t>(num_bytes_written));
+    }
+}
+
+void
+save_index(const std::filesystem::path &index_path, memory_span index)
+{
+    // We write to a temporary file first and atomically rename it so that
+    // concurrent readers (e.g. other ranks) never see a partial index. Since
+    // the index directory might be shared by several hosts, the temporary file
+    // name is picked by `mkostemp()` rather than derived from our pid.
+    std::string tmp_name = index_path.string() + ".tmp.XXXXXX";
+
+    {
+        file_desc fd = ::mkostemp(tmp_name.data(), O_CLOEXEC);
+        if (fd == invalid_fd)
+            throw_system_error(last_error(),
+                "The line index '{}' cannot be created", index_path.string());
+
+        try {
+            // `mkostemp()` creates the file with mode 0600.
+            if (::fchmod(fd.get(), 0644) == -1)
+                throw_system_error(last_error(),
+                    "The line index '{}' cannot be created", tmp_name);
+
+            write_all(fd, index, tmp_name);
+        } catch (const std::system_error &) {
+            ::unlink(tmp_name.c_str());
+
+            throw;
+        }
+    }
+
+    if (::rename(tmp_name.c_str(), index_path.c_str()) == -1) {
+        std::error_code err = last_error();
+
+        ::unlink(tmp_name.c_str());
+
+        throw_system_error(err,
+            "The line index '{}' cannot be created", index_path.string());
+    }
+}
+
+}  // namespace
+
+text_line_index
+text_line_index::load_or_build(
+    const std::filesystem::path &text_path,
+    memory_span text,
+    const std::filesystem::path &index_path,
+    line_ending le)
+{
+    index_header header = make_header(text_path, text);
+
+    std::optional<memory_block> maybe_block = maybe_load_index(index_path, header, le);
+    if (maybe_block) {
+        std::memcpy(&header, maybe_block->data(), sizeof(index_header));
+
+        return text_line_index{*std::move(maybe_block), static_cast<line_ending>(header.line_ending)};
+    }
+
+    auto chars = cast<const char>(text);
+
+    if (le == line_ending::infer)
+        le = infer_line_ending(chars);
+
+    std::vector<std::uint64_t> offsets = compute_line_offsets(chars, le);
+
+    header.line_ending = static_cast<std::uint32_t>(le);
+    header.num_lines = offsets.size() - 1;
+
+    std::size_t offsets_size = offsets.size() * sizeof(std::uint64_t);
+
+    writable_memory_block block = allocate_memory(sizeof(index_header) + offsets_size);
+
+    std::memcpy(block.data(), &header, sizeof(index_header));
+
+    std::memcpy(block.data() + sizeof(index_header), offsets.data(), offsets_size);
+
+    try {
+        save_index(index_path, block);
+    } catch (const std::system_error &) {
+        // The index is just a cache; if we cannot save it (e.g. due to a
+        // read-only file system), we use the in-memory copy.
+    }
+
+    return text_line_index{std::move(block), le};
+}
+
+text_line_index::text_line_index(memory_block block, line_ending le) noexcept
+  : block_{std::move(block)}, line_ending_{le}
+{
+    offsets_ = block_.share_slice(sizeof(index_header)).cast<const std::uint64_t>();
+}
+
+}  // namespace fairseq2n::detail
@@ -0,0 +1,62 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <utility>
+
+#include "fairseq2n/memory.h"
+#include "fairseq2n/span.h"
+#include "fairseq2n/data/text/text_reader.h"
+
+namespace fairseq2n::detail {
+
+// Holds the byte offsets of the lines of a text file. The index is stored in a
+// sidecar file that is built on first use and memory mapped afterwards. It gets
+// rebuilt if the size or the modification time of the text file changes.
+class text_line_index {
+public:
+    static text_line_index
+    load_or_build(
+        const std::filesystem::path &text_path,
+        memory_span text,
+        const std::filesystem::path &index_path,
+        line_ending le);
+
+    // Returns the byte range `[first, last)` of the specified line including
+    // its line ending.
+    std::pair<std::size_t, std::size_t>
+    line_range(std::size_t line_idx) const noexcept
+    {
+        return {offsets_[line_idx], offsets_[line_idx + 1]};
+    }
+
+    std::size_t
+    num_lines() const noexcept
+    {
+        return offsets_.size() - 1;
+    }
+
+    line_ending
+    actual_line_ending() const noexcept
+    {
+        return line_ending_;
+    }
+
+private:
+    explicit
+    text_line_index(memory_block block, line_ending le) noexcept;
+
+private:
+    memory_block block_;
+    span<const std::uint64_t> offsets_;
+    line_ending line_ending_;
+};
+
+}  // namespace fairseq2n::detail
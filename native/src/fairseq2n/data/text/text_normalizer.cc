@@ -0,0 +1,247 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/text/text_normalizer.h"
+
+#ifdef FAIRSEQ2N_SUPPORT_TEXT_NORMALIZATION
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+#include <unicode/normalizer2.h>
+#include <unicode/stringpiece.h>
+#include <unicode/uchar.h>
+#include <unicode/unistr.h>
+#include <unicode/utypes.h>
+
+#include "fairseq2n/fmt.h"
+#include "fairseq2n/data/text/detail/utf.h"
+#include "fairseq2n/detail/exception.h"
+
+using namespace fairseq2n::detail;
+
+namespace fairseq2n {
+namespace detail {
+namespace {
+
+// The ASCII characters that have the Unicode White_Space property.
+inline bool
+is_ascii_space(char c) noexcept
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+inline bool
+is_ascii_upper(char c) noexcept
+{
+    return c >= 'A' && c <= 'Z';
+}
+
+const icu::Normalizer2 &
+get_normalizer(normalization_form form)
+{
+    UErrorCode err = U_ZERO_ERROR;
+
+    const icu::Normalizer2 *normalizer{};
+
+    switch (form) {
+    case normalization_form::nfc:
+        normalizer = icu::Normalizer2::getNFCInstance(err);
+        break;
+    case normalization_form::nfkc:
+        normalizer = icu::Normalizer2::getNFKCInstance(err);
+        break;
+    }
+
+    if (U_FAILURE(err) || normalizer == nullptr)
+        throw_<std::runtime_error>(
+            "The ICU normalizer cannot be initialized. ICU Error: {}", u_errorName(err));
+
+    return *normalizer;
+}
+
+}  // namespace
+}  // namespace detail
+
+text_normalizer::text_normalizer(text_normalizer_options opts)
+  : opts_{opts}
+{
+    // Fail early if the ICU data is not available.
+    get_normalizer(opts_.form());
+}
+
+data
+text_normalizer::operator()(data &&d) const
+{
+    if (!d.is_string())
+        throw_<std::invalid_argument>(
+            "The input data must be of type `string`, but is of type `{}` instead.", d.type());
+
+    return normalize(d.as_string());
+}
+
+immutable_string
+text_normalizer::normalize(const immutable_string &s) const
+{
+    std::string_view v = s;
+
+    // ASCII strings are already in all normalization forms, so at most we have
+    // to case fold and collapse their whitespace.
+    if (is_ascii(v)) {
+        if (is_normalized_ascii(v))
+            return s;
+
+        return normalize_ascii(v);
+    }
+
+    return normalize_unicode(v);
+}
+
+bool
+text_normalizer::is_normalized_ascii(std::string_view s) const noexcept
+{
+    bool case_fold = opts_.case_fold();
+
+    bool collapse_whitespace = opts_.collapse_whitespace();
+
+    if (!case_fold && !collapse_whitespace)
+        return true;
+
+    // Leading whitespace is not allowed when collapsing.
+    bool prev_space = true;
+
+    for (char c : s) {
+        if (case_fold && is_ascii_upper(c))
+            return false;
+
+        if (collapse_whitespace) {
+            if (is_ascii_space(c)) {
+                if (c != ' ' || prev_space)
+                    return false;
+
+                prev_space = true;
+            } else
+                prev_space = false;
+        }
+    }
+
+    // Neither is trailing whitespace.
+    return !collapse_whitespace || s.empty() || !prev_space;
+}
+
+std::string
+text_normalizer::normalize_ascii(std::string_view s) const
+{
+    std::string output{};
+
+    output.reserve(s.size());
+
+    bool pending_space = false;
+
+    for (char c : s) {
+        if (opts_.collapse_whitespace() && is_ascii_space(c)) {
+            pending_space = !output.empty();
+
+            continue;
+        }
+
+        if (pending_space) {
+            output.push_back(' ');
+
+            pending_space = false;
+        }
+
+        if (opts_.case_fold() && is_ascii_upper(c))
+            c = static_cast<char>(c - 'A' + 'a');
+
+        output.push_back(c);
+    }
+
+    return output;
+}
+
+std::string
+text_normalizer::normalize_unicode(std::string_view s) const
+{
+    // Ill-formed UTF-8 sequences are replaced with U+FFFD.
+    icu::UnicodeString input = icu::UnicodeString::fromUTF8(
+        icu::StringPiece{s.data(), static_cast<std::int32_t>(s.size())});
+
+    if (opts_.case_fold())
+        input.foldCase(U_FOLD_CASE_DEFAULT);
+
+    UErrorCode err = U_ZERO_ERROR;
+
+    // Case folding does not preserve normalization, therefore we normalize
+    // after folding.
+    icu::UnicodeString normalized = get_normalizer(opts_.form()).normalize(input, err);
+    if (U_FAILURE(err))
+        throw_<std::runtime_error>(
+            "The string cannot be normalized. ICU Error: {}", u_errorName(err));
+
+    if (opts_.collapse_whitespace()) {
+        icu::UnicodeString collapsed{};
+
+        bool pending_space = false;
+
+        for (std::int32_t i = 0; i < normalized.length(); i = normalized.moveIndex32(i, 1)) {
+            UChar32 c = normalized.char32At(i);
+
+            if (u_isUWhiteSpace(c) != 0) {
+                pending_space = !collapsed.isEmpty();
+
+                continue;
+            }
+
+            if (pending_space) {
+                collapsed.append(static_cast<char16_t>(u' '));
+
+                pending_space = false;
+            }
+
+            collapsed.append(c);
+        }
+
+        normalized = std::move(collapsed);
+    }
+
+    std::string output{};
+
+    normalized.toUTF8String(output);
+
+    return output;
+}
+
+}  // namespace fairseq2n
+
+#else
+
+#include "fairseq2n/exception.h"
+#include "fairseq2n/detail/exception.h"
+
+namespace fairseq2n {
+
+text_normalizer::text_normalizer(text_normalizer_options opts)
+  : opts_{opts}
+{}
+
+data
+text_normalizer::operator()(data &&) const
+{
+    detail::throw_<not_supported_error>(
+        "fairseq2n is not built with Unicode text normalization support.");
+}
+
+immutable_string
+text_normalizer::normalize(const immutable_string &) const
+{
+    detail::throw_<not_supported_error>(
+        "fairseq2n is not built with Unicode text normalization support.");
+}
+
+}  // namespace fairseq2n
+
+#endif
@@ -0,0 +1,107 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "fairseq2n/api.h"
+#include "fairseq2n/data/data.h"
+#include "fairseq2n/data/immutable_string.h"
+
+namespace fairseq2n {
+
+enum class normalization_form { nfc, nfkc };
+
+class text_normalizer_options {
+public:
+    text_normalizer_options
+    form(normalization_form value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.form_ = value;
+
+        return tmp;
+    }
+
+    normalization_form
+    form() const noexcept
+    {
+        return form_;
+    }
+
+    text_normalizer_options
+    case_fold(bool value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.case_fold_ = value;
+
+        return tmp;
+    }
+
+    bool
+    case_fold() const noexcept
+    {
+        return case_fold_;
+    }
+
+    // Replaces each whitespace run with a single space. Note that leading and
+    // trailing whitespace is removed entirely rather than collapsed.
+    text_normalizer_options
+    collapse_whitespace(bool value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.collapse_whitespace_ = value;
+
+        return tmp;
+    }
+
+    bool
+    collapse_whitespace() const noexcept
+    {
+        return collapse_whitespace_;
+    }
+
+private:
+    normalization_form form_ = normalization_form::nfc;
+    bool case_fold_ = false;
+    bool collapse_whitespace_ = false;
+};
+
+// Normalizes UTF-8 strings to the specified Unicode normalization form, and
+// optionally case folds them and collapses their whitespace runs into a single
+// space (which also trims leading and trailing whitespace). Pure ASCII strings
+// that need no change are returned as is without any allocation.
+class FAIRSEQ2_API text_normalizer final {
+public:
+    explicit
+    text_normalizer(text_normalizer_options opts = {});
+
+    data
+    operator()(data &&d) const;
+
+    immutable_string
+    normalize(const immutable_string &s) const;
+
+private:
+    bool
+    is_normalized_ascii(std::string_view s) const noexcept;
+
+    std::string
+    normalize_ascii(std::string_view s) const;
+
+    std::string
+    normalize_unicode(std::string_view s) const;
+
+private:
+    text_normalizer_options opts_;
+};
+
+}  // namespace fairseq2n
@@ -7,9 +7,12 @@
 #include "fairseq2n/data/text/text_reader.h"
 
 #include <memory>
+#include <stdexcept>
 
 #include "fairseq2n/data/data_pipeline.h"
+#include "fairseq2n/data/text/indexed_text_data_source.h"
 #include "fairseq2n/data/text/text_data_source.h"
+#include "fairseq2n/detail/exception.h"
 
 using namespace fairseq2n::detail;
 
@@ -18,6 +21,39 @@ namespace fairseq2n {
 data_pipeline_builder
 read_text(std::filesystem::path path, std::optional<std::string> maybe_key, text_options opts)
 {
+    if (opts.num_parallel_scans() == 0)
+        throw_<std::invalid_argument>(
+            "`num_parallel_scans` must be greater than zero.");
+
+    const std::optional<std::string> &maybe_encoding = opts.maybe_encoding();
+
+    bool is_utf8 = !maybe_encoding || *maybe_encoding == "UTF-8" || *maybe_encoding == "utf-8";
+
+    if (opts.num_parallel_scans() > 1 && !is_utf8)
+        throw_<std::invalid_argument>(
+            "The encoding must be UTF-8 when `num_parallel_scans` is greater than one, but is {} instead.", *maybe_encoding);
+
+    if (opts.maybe_index_path()) {
+        if (!is_utf8)
+            throw_<std::invalid_argument>(
+                "The encoding must be UTF-8 when a line index is specified, but is {} instead.", *maybe_encoding);
+
+        auto factory = [
+            path = std::move(path),
+            maybe_key = std::move(maybe_key),
+            opts = std::move(opts)]() mutable
+        {
+            return std::make_unique<indexed_text_data_source>(
+                std::move(path), std::move(maybe_key), std::move(opts));
+        };
+
+        return data_pipeline_builder{std::move(factory)};
+    }
+
+    if (opts.shuffle())
+        throw_<std::invalid_argument>(
+            "A line index must be specified when the lines are to be shuffled.");
+
     auto factory = [
         path = std::move(path),
         maybe_key = std::move(maybe_key),
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <optional>
 #include <string>
@@ -122,6 +123,67 @@ public:
         return maybe_block_size_;
     }
 
+    // If greater than one, memory maps the file and scans it for line endings
+    // using the specified number of threads.
+    text_options
+    num_parallel_scans(std::size_t value) && noexcept
+    {
+        num_parallel_scans_ = value;
+
+        return std::move(*this);
+    }
+
+    std::size_t
+    num_parallel_scans() const noexcept
+    {
+        return num_parallel_scans_;
+    }
+
+    // If set, reads the lines through a sidecar line index stored at the
+    // specified path, which is built if it does not exist or is stale.
+    text_options
+    maybe_index_path(std::optional<std::filesystem::path> value) && noexcept
+    {
+        maybe_index_path_ = std::move(value);
+
+        return std::move(*this);
+    }
+
+    const std::optional<std::filesystem::path> &
+    maybe_index_path() const noexcept
+    {
+        return maybe_index_path_;
+    }
+
+    // Reads the lines in a random order. Requires a line index.
+    text_options
+    shuffle(bool value) && noexcept
+    {
+        shuffle_ = value;
+
+        return std::move(*this);
+    }
+
+    bool
+    shuffle() const noexcept
+    {
+        return shuffle_;
+    }
+
+    text_options
+    maybe_seed(std::optional<std::uint64_t> value) && noexcept
+    {
+        maybe_seed_ = value;
+
+        return std::move(*this);
+    }
+
+    std::optional<std::uint64_t>
+    maybe_seed() const noexcept
+    {
+        return maybe_seed_;
+    }
+
 private:
     std::optional<std::string> maybe_encoding_{};
     fairseq2n::line_ending line_ending_{};
@@ -130,6 +192,10 @@ private:
     bool skip_empty_ = false;
     bool memory_map_ = false;
     std::optional<std::size_t> maybe_block_size_{};
+    std::size_t num_parallel_scans_ = 1;
+    std::optional<std::filesystem::path> maybe_index_path_{};
+    bool shuffle_ = false;
+    std::optional<std::uint64_t> maybe_seed_{};
 };
 
 class data_pipeline_builder;
@@ -0,0 +1,78 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/text/text_writer.h"
+
+#include <stdexcept>
+#include <string_view>
+
+#include "fairseq2n/fmt.h"
+#include "fairseq2n/memory.h"
+#include "fairseq2n/data/file_writer.h"
+#include "fairseq2n/data/immutable_string.h"
+#include "fairseq2n/detail/exception.h"
+
+using namespace fairseq2n::detail;
+
+namespace fairseq2n {
+
+std::size_t
+write_text(
+    data_pipeline &pipeline,
+    const std::filesystem::path &path,
+    std::optional<std::string> maybe_key,
+    line_ending le,
+    const file_writer_options &opts)
+{
+    if (le == line_ending::infer)
+        throw_<std::invalid_argument>(
+            "`line_ending` must be `LF` or `CRLF` when writing text.");
+
+    std::string_view newline = le == line_ending::crlf ? "\r\n" : "\n";
+
+    auto as_bytes = [](std::string_view s)
+    {
+        return memory_span{reinterpret_cast<const std::byte *>(s.data()), s.size()};
+    };
+
+    file_writer writer{path, opts};
+
+    std::size_t num_lines = 0;
+
+    while (std::optional<data> maybe_example = pipeline.next()) {
+        const data *line = &*maybe_example;
+
+        if (maybe_key) {
+            if (!line->is_dict())
+                throw_<std::invalid_argument>(
+                    "The example {} in the pipeline must be of type `dict` when `key` is specified, but is of type `{}` instead.", num_lines, line->type());
+
+            const data_dict &dict = line->as_dict();
+
+            auto pos = dict.find(*maybe_key);
+            if (pos == dict.end())
+                throw_<std::invalid_argument>(
+                    "The example {} in the pipeline does not have an element named '{}'.", num_lines, *maybe_key);
+
+            line = &pos->second;
+        }
+
+        if (!line->is_string())
+            throw_<std::invalid_argument>(
+                "The example {} in the pipeline must be of type `string`, but is of type `{}` instead.", num_lines, line->type());
+
+        writer.write(as_bytes(line->as_string()));
+        writer.write(as_bytes(newline));
+
+        num_lines++;
+    }
+
+    writer.commit();
+
+    return num_lines;
+}
+
+}  // namespace fairseq2n
@@ -0,0 +1,32 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+#include "fairseq2n/api.h"
+#include "fairseq2n/data/data_pipeline.h"
+#include "fairseq2n/data/file.h"
+#include "fairseq2n/data/text/text_reader.h"
+
+namespace fairseq2n {
+
+// Drains `pipeline` and writes each of its examples, which must be strings, as
+// a line to `path`. If `maybe_key` is specified, the examples must be dicts and
+// the string at `maybe_key` is written instead. Returns the number of lines.
+FAIRSEQ2_API std::size_t
+write_text(
+    data_pipeline &pipeline,
+    const std::filesystem::path &path,
+    std::optional<std::string> maybe_key = {},
+    line_ending le = line_ending::lf,
+    const file_writer_options &opts = {});
+
+}  // namespace fairseq2n
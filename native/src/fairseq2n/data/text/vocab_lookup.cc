@@ -0,0 +1,252 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/text/vocab_lookup.h"
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include <ATen/Functions.h>
+
+#include "fairseq2n/fmt.h"
+#include "fairseq2n/memory.h"
+#include "fairseq2n/span.h"
+#include "fairseq2n/data/file.h"
+#include "fairseq2n/data/immutable_string.h"
+#include "fairseq2n/data/detail/tensor_helpers.h"
+#include "fairseq2n/data/text/detail/utf.h"
+#include "fairseq2n/detail/exception.h"
+#include "fairseq2n/utils/cast.h"
+
+using namespace fairseq2n::detail;
+
+namespace fairseq2n {
+namespace detail {
+namespace {
+
+constexpr std::string_view utf8_bom = "\xef\xbb\xbf";
+
+vocab_table
+load_vocab_table(const std::filesystem::path &path)
+{
+    memory_block block = memory_map_file(path);
+
+    span<const char> chars = block.cast<const char>();
+
+    std::string_view text{chars.data(), chars.size()};
+
+    std::size_t pos = 0;
+
+    if (text.substr(0, utf8_bom.size()) == utf8_bom)
+        pos = utf8_bom.size();
+
+    vocab_table table{};
+
+    for (std::size_t line_nr = 1; pos < text.size(); line_nr++) {
+        std::size_t line_end = text.find('\n', pos);
+        if (line_end == std::string_view::npos)
+            line_end = text.size();
+
+        std::size_t next_pos = line_end + 1;
+
+        if (line_end > pos && text[line_end - 1] == '\r')
+            line_end--;
+
+        std::size_t token_end = text.substr(0, line_end).find('\t', pos);
+        if (token_end == std::string_view::npos)
+            token_end = line_end;
+
+        if (token_end == pos)
+            throw_<std::runtime_error>(
+                "The vocabulary file '{}' has an empty token at line {}.", path.string(), line_nr);
+
+        // The tokens are slices of the memory-mapped file; no copy is made.
+        immutable_string token{block.share_slice(pos, token_end - pos)};
+
+        if (!table.try_add(token))
+            throw_<std::runtime_error>(
+                "The vocabulary file '{}' has a duplicate token '{}' at line {}.", path.string(), token, line_nr);
+
+        pos = next_pos;
+    }
+
+    return table;
+}
+
+}  // namespace
+}  // namespace detail
+
+vocab_lookup::vocab_lookup(const std::filesystem::path &path, vocab_lookup_options opts)
+  : opts_{std::move(opts)}, table_{load_vocab_table(path)}
+{
+    maybe_unk_idx_ = resolve_special_token(opts_.maybe_unk_token(), "unk_token");
+    maybe_bos_idx_ = resolve_special_token(opts_.maybe_bos_token(), "bos_token");
+    maybe_eos_idx_ = resolve_special_token(opts_.maybe_eos_token(), "eos_token");
+    maybe_pad_idx_ = resolve_special_token(opts_.maybe_pad_token(), "pad_token");
+
+    if (opts_.add_bos() && !maybe_bos_idx_)
+        throw_<std::invalid_argument>("`bos_token` must be specified when `add_bos` is set.");
+
+    if (opts_.add_eos() && !maybe_eos_idx_)
+        throw_<std::invalid_argument>("`eos_token` must be specified when `add_eos` is set.");
+}
+
+data
+vocab_lookup::operator()(data &&d) const
+{
+    if (d.is_string())
+        return encode(d.as_string());
+
+    if (d.is_list())
+        return encode(std::as_const(d).as_list());
+
+    throw_<std::invalid_argument>(
+        "The input data must be of type `string` or `list`, but is of type `{}` instead.", d.type());
+}
+
+template <typename Func>
+void
+vocab_lookup::for_each_token(std::string_view text, Func &&f) const
+{
+    if (opts_.char_level()) {
+        for (std::size_t pos = 0; pos < text.size();) {
+            std::size_t size = get_code_point_size(text[pos]);
+
+            if (size == 0 || text.size() - pos < size)
+                throw_<std::invalid_argument>(
+                    "The input string has an invalid UTF-8 code point at byte offset {}.", pos);
+
+            f(text.substr(pos, size));
+
+            pos += size;
+        }
+    } else {
+        // Consecutive separators are treated as one, and leading and trailing
+        // separators are ignored.
+        for (std::size_t pos = 0; pos < text.size();) {
+            std::size_t token_end = text.find(opts_.separator(), pos);
+            if (token_end == std::string_view::npos)
+                token_end = text.size();
+
+            if (token_end > pos)
+                f(text.substr(pos, token_end - pos));
+
+            pos = token_end + 1;
+        }
+    }
+}
+
+at::Tensor
+vocab_lookup::encode(std::string_view text) const
+{
+    std::size_t num_tokens = 0;
+
+    for_each_token(text, [&num_tokens](std::string_view)
+    {
+        num_tokens++;
+    });
+
+    at::Tensor tensor = make_tensor(num_tokens);
+
+    span tensor_data = cast<std::int64_t>(get_raw_mutable_storage(tensor));
+
+    std::size_t i = opts_.add_bos() ? 1 : 0;
+
+    for_each_token(text, [this, &tensor_data, &i](std::string_view token)
+    {
+        tensor_data[i++] = lookup(token);
+    });
+
+    return finalize_tensor(std::move(tensor));
+}
+
+at::Tensor
+vocab_lookup::encode(const data_list &tokens) const
+{
+    for (std::size_t i = 0; i < tokens.size(); ++i)
+        if (!tokens[i].is_string())
+            throw_<std::invalid_argument>(
+                "The element at index {} in the input data must be of type `string`, but is of type `{}` instead.", i, tokens[i].type());
+
+    at::Tensor tensor = make_tensor(tokens.size());
+
+    span tensor_data = cast<std::int64_t>(get_raw_mutable_storage(tensor));
+
+    std::size_t i = opts_.add_bos() ? 1 : 0;
+
+    for (const data &token : tokens)
+        tensor_data[i++] = lookup(token.as_string());
+
+    return finalize_tensor(std::move(tensor));
+}
+
+std::optional<std::int64_t>
+vocab_lookup::resolve_special_token(
+    const std::optional<std::string> &maybe_token, std::string_view name) const
+{
+    if (!maybe_token)
+        return std::nullopt;
+
+    std::optional<std::int64_t> maybe_idx = table_.maybe_find(*maybe_token);
+    if (!maybe_idx)
+        throw_<std::invalid_argument>(
+            "`{}` must be a token in the vocabulary, but is '{}' instead.", name, *maybe_token);
+
+    return maybe_idx;
+}
+
+std::int64_t
+vocab_lookup::lookup(std::string_view token) const
+{
+    std::optional<std::int64_t> maybe_idx = table_.maybe_find(token);
+    if (maybe_idx)
+        return *maybe_idx;
+
+    if (maybe_unk_idx_)
+        return *maybe_unk_idx_;
+
+    throw_<std::invalid_argument>(
+        "The token '{}' is not in the vocabulary and `unk_token` is not specified.", token);
+}
+
+at::Tensor
+vocab_lookup::make_tensor(std::size_t num_tokens) const
+{
+    std::size_t seq_len = num_tokens;
+
+    if (opts_.add_bos())
+        seq_len++;
+
+    if (opts_.add_eos())
+        seq_len++;
+
+    at::Tensor tensor = at::empty({static_cast<std::int64_t>(seq_len)},
+        at::dtype(at::kLong).device(at::kCPU).pinned_memory(opts_.pin_memory()));
+
+    span tensor_data = cast<std::int64_t>(get_raw_mutable_storage(tensor));
+
+    if (opts_.add_bos())
+        tensor_data[0] = *maybe_bos_idx_;
+
+    if (opts_.add_eos())
+        tensor_data[seq_len - 1] = *maybe_eos_idx_;
+
+    return tensor;
+}
+
+at::Tensor
+vocab_lookup::finalize_tensor(at::Tensor &&tensor) const
+{
+    at::Device device = opts_.maybe_device().value_or(at::kCPU);
+    if (device != at::kCPU)
+        return tensor.to(device);
+
+    return std::move(tensor);
+}
+
+}  // namespace fairseq2n
@@ -0,0 +1,262 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <ATen/Device.h>
+#include <ATen/Tensor.h>
+
+#include "fairseq2n/api.h"
+#include "fairseq2n/data/data.h"
+#include "fairseq2n/data/text/detail/vocab_table.h"
+
+namespace fairseq2n {
+
+class vocab_lookup_options {
+public:
+    vocab_lookup_options
+    char_level(bool value) && noexcept
+    {
+        char_level_ = value;
+
+        return std::move(*this);
+    }
+
+    bool
+    char_level() const noexcept
+    {
+        return char_level_;
+    }
+
+    vocab_lookup_options
+    separator(char value) && noexcept
+    {
+        separator_ = value;
+
+        return std::move(*this);
+    }
+
+    char
+    separator() const noexcept
+    {
+        return separator_;
+    }
+
+    vocab_lookup_options
+    maybe_unk_token(std::optional<std::string> value) && noexcept
+    {
+        maybe_unk_token_ = std::move(value);
+
+        return std::move(*this);
+    }
+
+    const std::optional<std::string> &
+    maybe_unk_token() const noexcept
+    {
+        return maybe_unk_token_;
+    }
+
+    vocab_lookup_options
+    maybe_bos_token(std::optional<std::string> value) && noexcept
+    {
+        maybe_bos_token_ = std::move(value);
+
+        return std::move(*this);
+    }
+
+    const std::optional<std::string> &
+    maybe_bos_token() const noexcept
+    {
+        return maybe_bos_token_;
+    }
+
+    vocab_lookup_options
+    maybe_eos_token(std::optional<std::string> value) && noexcept
+    {
+        maybe_eos_token_ = std::move(value);
+
+        return std::move(*this);
+    }
+
+    const std::optional<std::string> &
+    maybe_eos_token() const noexcept
+    {
+        return maybe_eos_token_;
+    }
+
+    vocab_lookup_options
+    maybe_pad_token(std::optional<std::string> value) && noexcept
+    {
+        maybe_pad_token_ = std::move(value);
+
+        return std::move(*this);
+    }
+
+    const std::optional<std::string> &
+    maybe_pad_token() const noexcept
+    {
+        return maybe_pad_token_;
+    }
+
+    vocab_lookup_options
+    add_bos(bool value) && noexcept
+    {
+        add_bos_ = value;
+
+        return std::move(*this);
+    }
+
+    bool
+    add_bos() const noexcept
+    {
+        return add_bos_;
+    }
+
+    vocab_lookup_options
+    add_eos(bool value) && noexcept
+    {
+        add_eos_ = value;
+
+        return std::move(*this);
+    }
+
+    bool
+    add_eos() const noexcept
+    {
+        return add_eos_;
+    }
+
+    vocab_lookup_options
+    maybe_device(std::optional<at::Device> value) && noexcept
+    {
+        maybe_device_ = value;
+
+        return std::move(*this);
+    }
+
+    std::optional<at::Device>
+    maybe_device() const noexcept
+    {
+        return maybe_device_;
+    }
+
+    vocab_lookup_options
+    pin_memory(bool value) && noexcept
+    {
+        pin_memory_ = value;
+
+        return std::move(*this);
+    }
+
+    bool
+    pin_memory() const noexcept
+    {
+        return pin_memory_;
+    }
+
+private:
+    bool char_level_ = false;
+    char separator_ = ' ';
+    std::optional<std::string> maybe_unk_token_{};
+    std::optional<std::string> maybe_bos_token_{};
+    std::optional<std::string> maybe_eos_token_{};
+    std::optional<std::string> maybe_pad_token_{};
+    bool add_bos_ = false;
+    bool add_eos_ = false;
+    std::optional<at::Device> maybe_device_{};
+    bool pin_memory_ = false;
+};
+
+// Maps the words or the UTF-8 code points of a string, or the strings of a
+// list, to their indices in a vocabulary file and returns them as a tensor.
+//
+// The vocabulary file has one token per line; the index of a token is its
+// zero-based line number. Anything after the first tab character of a line
+// (e.g. a token frequency) is ignored.
+class FAIRSEQ2_API vocab_lookup final {
+public:
+    explicit
+    vocab_lookup(const std::filesystem::path &path, vocab_lookup_options opts = {});
+
+    data
+    operator()(data &&d) const;
+
+    at::Tensor
+    encode(std::string_view text) const;
+
+    at::Tensor
+    encode(const data_list &tokens) const;
+
+    std::optional<std::int64_t>
+    token_to_index(std::string_view token) const noexcept
+    {
+        return table_.maybe_find(token);
+    }
+
+    std::size_t
+    vocabulary_size() const noexcept
+    {
+        return table_.size();
+    }
+
+    std::optional<std::int64_t>
+    unk_idx() const noexcept
+    {
+        return maybe_unk_idx_;
+    }
+
+    std::optional<std::int64_t>
+    bos_idx() const noexcept
+    {
+        return maybe_bos_idx_;
+    }
+
+    std::optional<std::int64_t>
+    eos_idx() const noexcept
+    {
+        return maybe_eos_idx_;
+    }
+
+    std::optional<std::int64_t>
+    pad_idx() const noexcept
+    {
+        return maybe_pad_idx_;
+    }
+
+private:
+    std::optional<std::int64_t>
+    resolve_special_token(const std::optional<std::string> &maybe_token, std::string_view name) const;
+
+    std::int64_t
+    lookup(std::string_view token) const;
+
+    template <typename Func>
+    void
+    for_each_token(std::string_view text, Func &&f) const;
+
+    at::Tensor
+    make_tensor(std::size_t num_tokens) const;
+
+    at::Tensor
+    finalize_tensor(at::Tensor &&tensor) const;
+
+private:
+    vocab_lookup_options opts_;
+    detail::vocab_table table_{};
+    std::optional<std::int64_t> maybe_unk_idx_{};
+    std::optional<std::int64_t> maybe_bos_idx_{};
+    std::optional<std::int64_t> maybe_eos_idx_{};
+    std::optional<std::int64_t> maybe_pad_idx_{};
+};
+
+}  // namespace fairseq2n
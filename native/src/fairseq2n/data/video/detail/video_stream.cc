@@ -0,0 +1,468 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/video/detail/video_stream.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+extern "C" {
+#include <libavutil/error.h>
+#include <libavutil/mem.h>
+#include <libavutil/pixfmt.h>
+}
+
+#include "fairseq2n/exception.h"
+#include "fairseq2n/fmt.h"
+#include "fairseq2n/detail/exception.h"
+
+namespace fairseq2n::detail {
+
+int
+avio_file::read(std::uint8_t *ptr, int count) noexcept
+{
+    std::int64_t num_bytes = std::min(size() - current_pos_, static_cast<std::int64_t>(count));
+    if (num_bytes <= 0)
+        return AVERROR_EOF;
+
+    std::memcpy(ptr, block_.data() + current_pos_, static_cast<std::size_t>(num_bytes));
+
+    current_pos_ += num_bytes;
+
+    return static_cast<int>(num_bytes);
+}
+
+std::int64_t
+avio_file::seek(std::int64_t offset, int whence) noexcept
+{
+    switch (whence & ~AVSEEK_FORCE) {
+    case AVSEEK_SIZE:
+        return size();
+    case SEEK_SET:
+        current_pos_ = offset;
+        break;
+    case SEEK_CUR:
+        current_pos_ += offset;
+        break;
+    case SEEK_END:
+        current_pos_ = size() + offset;
+        break;
+    default:
+        return AVERROR(EINVAL);
+    }
+
+    current_pos_ = std::max(std::min(size(), current_pos_), std::int64_t{});
+
+    return current_pos_;
+}
+
+void
+av_deleter::operator()(::AVIOContext *ptr) const noexcept
+{
+    // The I/O buffer might have been reallocated by libavformat; therefore, we
+    // free the one held by the context, not the one we originally allocated.
+    ::av_freep(&ptr->buffer);
+
+    ::avio_context_free(&ptr);
+}
+
+void
+av_deleter::operator()(::AVFormatContext *ptr) const noexcept
+{
+    ::avformat_close_input(&ptr);
+}
+
+void
+av_deleter::operator()(::AVCodecContext *ptr) const noexcept
+{
+    ::avcodec_free_context(&ptr);
+}
+
+void
+av_deleter::operator()(::AVFrame *ptr) const noexcept
+{
+    ::av_frame_free(&ptr);
+}
+
+void
+av_deleter::operator()(::AVPacket *ptr) const noexcept
+{
+    ::av_packet_free(&ptr);
+}
+
+void
+av_deleter::operator()(::SwsContext *ptr) const noexcept
+{
+    ::sws_freeContext(ptr);
+}
+
+namespace {
+
+int
+avio_read(void *opaque, std::uint8_t *ptr, int count)
+{
+    return static_cast<avio_file *>(opaque)->read(ptr, count);
+}
+
+std::int64_t
+avio_seek(void *opaque, std::int64_t offset, int whence)
+{
+    return static_cast<avio_file *>(opaque)->seek(offset, whence);
+}
+
+std::string
+av_error_string(int err)
+{
+    std::array<char, AV_ERROR_MAX_STRING_SIZE> buffer{};
+
+    if (::av_strerror(err, buffer.data(), buffer.size()) < 0)
+        return fmt::format("Unknown FFmpeg error code {}", err);
+
+    return buffer.data();
+}
+
+template <typename T>
+T *
+check_alloc(T *ptr)
+{
+    if (ptr == nullptr)
+        throw std::bad_alloc{};
+
+    return ptr;
+}
+
+const ::AVIndexEntry *
+find_keyframe(::AVStream *stream, std::int64_t pts)
+{
+#if LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(58, 78, 100)
+    return ::avformat_index_get_entry_from_timestamp(stream, pts, AVSEEK_FLAG_BACKWARD);
+#else
+    int idx = ::av_index_search_timestamp(stream, pts, AVSEEK_FLAG_BACKWARD);
+    if (idx < 0)
+        return nullptr;
+
+    return &stream->index_entries[idx];
+#endif
+}
+
+}  // namespace
+
+video_stream::video_stream(memory_block block)
+  : file_{std::make_unique<avio_file>(std::move(block))}
+{
+    constexpr int io_buffer_size = 0x1'0000;  // 64 KiB
+
+    auto *io_buffer = check_alloc(static_cast<std::uint8_t *>(::av_malloc(io_buffer_size)));
+
+    io_ctx_.reset(::avio_alloc_context(
+        io_buffer, io_buffer_size, /*write_flag=*/0, file_.get(), &avio_read, nullptr, &avio_seek));
+    if (io_ctx_ == nullptr) {
+        ::av_free(io_buffer);
+
+        throw std::bad_alloc{};
+    }
+
+    ::AVFormatContext *fmt_ctx = check_alloc(::avformat_alloc_context());
+
+    fmt_ctx->pb = io_ctx_.get();
+
+    // Note that `avformat_open_input()` frees the context on failure.
+    int err = ::avformat_open_input(&fmt_ctx, nullptr, nullptr, nullptr);
+    if (err < 0)
+        throw_<std::invalid_argument>(
+            "The input video cannot be opened: {}.", av_error_string(err));
+
+    fmt_ctx_.reset(fmt_ctx);
+
+    err = ::avformat_find_stream_info(fmt_ctx, nullptr);
+    if (err < 0)
+        throw_<std::invalid_argument>(
+            "The stream information of the input video cannot be read: {}.", av_error_string(err));
+
+    int stream_idx = ::av_find_best_stream(
+        fmt_ctx, ::AVMEDIA_TYPE_VIDEO, /*wanted_stream_nb=*/-1, /*related_stream=*/-1, nullptr, 0);
+    if (stream_idx < 0)
+        throw_<std::invalid_argument>(
+            "The input does not contain a video stream.");
+
+    stream_ = fmt_ctx->streams[stream_idx];
+
+    // Let the demuxer skip the packets of all other streams.
+    for (unsigned i = 0; i < fmt_ctx->nb_streams; ++i)
+        if (fmt_ctx->streams[i] != stream_)
+            fmt_ctx->streams[i]->discard = ::AVDISCARD_ALL;
+
+    const ::AVCodec *codec = ::avcodec_find_decoder(stream_->codecpar->codec_id);
+    if (codec == nullptr)
+        throw_<std::runtime_error>(
+            "The codec '{}' of the input video is not supported.", ::avcodec_get_name(stream_->codecpar->codec_id));
+
+    codec_ctx_.reset(check_alloc(::avcodec_alloc_context3(codec)));
+
+    err = ::avcodec_parameters_to_context(codec_ctx_.get(), stream_->codecpar);
+    if (err < 0)
+        throw_<std::invalid_argument>(
+            "The codec parameters of the input video cannot be read: {}.", av_error_string(err));
+
+    // Video decoding is meant to be parallelized across videos using
+    // `map(num_parallel_calls)`; frame threading would only oversubscribe the
+    // CPU and increase the latency of a seek.
+    codec_ctx_->thread_count = 1;
+
+    codec_ctx_->pkt_timebase = stream_->time_base;
+
+    err = ::avcodec_open2(codec_ctx_.get(), codec, nullptr);
+    if (err < 0)
+        throw_<std::runtime_error>(
+            "The decoder of the input video cannot be opened: {}.", av_error_string(err));
+
+    if (codec_ctx_->width <= 0 || codec_ctx_->height <= 0)
+        throw_<std::invalid_argument>(
+            "The frame size of the input video cannot be determined.");
+
+    start_pts_ = stream_->start_time != AV_NOPTS_VALUE ? stream_->start_time : 0;
+
+    if (stream_->duration != AV_NOPTS_VALUE && stream_->duration > 0)
+        duration_ = to_seconds(start_pts_ + stream_->duration);
+    else if (fmt_ctx->duration != AV_NOPTS_VALUE && fmt_ctx->duration > 0)
+        duration_ = static_cast<float64>(fmt_ctx->duration) / AV_TIME_BASE;
+    else
+        throw_<std::invalid_argument>(
+            "The duration of the input video cannot be determined.");
+
+    ::AVRational rate = ::av_guess_frame_rate(fmt_ctx, stream_, nullptr);
+    if (rate.num > 0 && rate.den > 0)
+        frame_rate_ = ::av_q2d(rate);
+
+    frame_.reset(check_alloc(::av_frame_alloc()));
+
+    prev_frame_.reset(check_alloc(::av_frame_alloc()));
+
+    packet_.reset(check_alloc(::av_packet_alloc()));
+}
+
+void
+video_stream::decode_into(
+    span<const float64> timestamps,
+    writable_memory_span target,
+    span<float64> frame_timestamps)
+{
+    std::size_t num_frames = timestamps.size();
+    if (num_frames == 0)
+        return;
+
+    auto frame_size = static_cast<std::size_t>(height() * width() * 3);
+
+    if (target.size() < num_frames * frame_size || frame_timestamps.size() < num_frames)
+        throw_<internal_error>(
+            "`video_stream` has been asked to decode into a buffer that is too small. Please file a bug report.");
+
+    std::size_t frame_idx = 0;
+
+    auto emit_frame = [&](const ::AVFrame &frame, std::int64_t pts)
+    {
+        auto *ptr = reinterpret_cast<std::uint8_t *>(target.data() + frame_idx * frame_size);
+
+        convert_frame(frame, ptr);
+
+        frame_timestamps[frame_idx++] = to_seconds(pts);
+    };
+
+    bool has_prev_frame = false;
+
+    std::int64_t prev_pts = std::numeric_limits<std::int64_t>::min();
+
+    maybe_seek(to_pts(timestamps[0]), prev_pts);
+
+    while (frame_idx < num_frames) {
+        if (!receive_frame())
+            break;
+
+        std::int64_t pts = frame_->best_effort_timestamp;
+        if (pts == AV_NOPTS_VALUE)
+            pts = has_prev_frame ? prev_pts + 1 : start_pts_;
+
+        // A frame is presented until the next one; therefore, the frame shown
+        // at a timestamp is the one preceding the first frame after it.
+        while (frame_idx < num_frames && pts > to_pts(timestamps[frame_idx])) {
+            if (has_prev_frame)
+                emit_frame(*prev_frame_, prev_pts);
+            else
+                emit_frame(*frame_, pts);
+        }
+
+        if (frame_idx == num_frames)
+            break;
+
+        ::av_frame_unref(prev_frame_.get());
+
+        ::av_frame_move_ref(prev_frame_.get(), frame_.get());
+
+        has_prev_frame = true;
+
+        prev_pts = pts;
+
+        if (maybe_seek(to_pts(timestamps[frame_idx]), prev_pts))
+            has_prev_frame = false;
+    }
+
+    if (frame_idx == num_frames)
+        return;
+
+    // The remaining timestamps lie past the last frame of the stream.
+    if (!has_prev_frame)
+        throw_<std::invalid_argument>(
+            "The input video does not contain any decodable frame at or after {:.3f} seconds.", timestamps[frame_idx]);
+
+    while (frame_idx < num_frames)
+        emit_frame(*prev_frame_, prev_pts);
+}
+
+bool
+video_stream::maybe_seek(std::int64_t pts, std::int64_t last_decoded_pts)
+{
+    const ::AVIndexEntry *keyframe = find_keyframe(stream_, pts);
+
+    if (keyframe != nullptr) {
+        // If the keyframe comes before the last decoded frame, decoding forward
+        // is cheaper than seeking back.
+        if (keyframe->timestamp <= last_decoded_pts)
+            return false;
+    } else {
+        // Some demuxers (e.g. Matroska) build their index lazily on the first
+        // seek; without an index we decode sequentially afterwards.
+        if (last_decoded_pts != std::numeric_limits<std::int64_t>::min())
+            return false;
+    }
+
+    // If seeking fails, we can still decode sequentially.
+    if (::av_seek_frame(fmt_ctx_.get(), stream_->index, pts, AVSEEK_FLAG_BACKWARD) < 0)
+        return false;
+
+    ::avcodec_flush_buffers(codec_ctx_.get());
+
+    return true;
+}
+
+bool
+video_stream::receive_frame()
+{
+    while (true) {
+        int err = ::avcodec_receive_frame(codec_ctx_.get(), frame_.get());
+        if (err == 0)
+            return true;
+
+        if (err == AVERROR_EOF)
+            return false;
+
+        if (err != AVERROR(EAGAIN))
+            throw_<std::invalid_argument>(
+                "The input video cannot be decoded: {}.", av_error_string(err));
+
+        // The decoder needs more input.
+        while (true) {
+            err = ::av_read_frame(fmt_ctx_.get(), packet_.get());
+            if (err == AVERROR_EOF) {
+                // Enter draining mode to flush the frames buffered by the
+                // decoder.
+                err = ::avcodec_send_packet(codec_ctx_.get(), nullptr);
+                if (err < 0 && err != AVERROR_EOF)
+                    throw_<std::invalid_argument>(
+                        "The input video cannot be decoded: {}.", av_error_string(err));
+
+                break;
+            }
+
+            if (err < 0)
+                throw_<std::invalid_argument>(
+                    "The input video cannot be read: {}.", av_error_string(err));
+
+            if (packet_->stream_index != stream_->index) {
+                ::av_packet_unref(packet_.get());
+
+                continue;
+            }
+
+            err = ::avcodec_send_packet(codec_ctx_.get(), packet_.get());
+
+            ::av_packet_unref(packet_.get());
+
+            // Skip corrupt packets like most players do.
+            if (err == AVERROR_INVALIDDATA)
+                continue;
+
+            if (err < 0)
+                throw_<std::invalid_argument>(
+                    "The input video cannot be decoded: {}.", av_error_string(err));
+
+            break;
+        }
+    }
+}
+
+void
+video_stream::convert_frame(const ::AVFrame &frame, std::uint8_t *target)
+{
+    auto height = static_cast<int>(this->height());
+    auto width  = static_cast<int>(this->width());
+
+    // Note that `sws_getCachedContext()` frees the passed context if it cannot
+    // be reused.
+    sws_ctx_.reset(::sws_getCachedContext(
+        sws_ctx_.release(),
+        frame.width,
+        frame.height,
+        static_cast<::AVPixelFormat>(frame.format),
+        width,
+        height,
+        ::AV_PIX_FMT_RGB24,
+        SWS_BILINEAR,
+        nullptr,
+        nullptr,
+        nullptr));
+
+    if (sws_ctx_ == nullptr)
+        throw_<std::runtime_error>(
+            "The frames of the input video cannot be converted to RGB.");
+
+    std::array<std::uint8_t *, 4> target_planes{target};
+
+    std::array<int, 4> target_strides{width * 3};
+
+    ::sws_scale(
+        sws_ctx_.get(),
+        frame.data,
+        frame.linesize,
+        0,
+        frame.height,
+        target_planes.data(),
+        target_strides.data());
+}
+
+float64
+video_stream::to_seconds(std::int64_t pts) const noexcept
+{
+    return static_cast<float64>(pts - start_pts_) * ::av_q2d(stream_->time_base);
+}
+
+std::int64_t
+video_stream::to_pts(float64 seconds) const noexcept
+{
+    float64 pts = seconds / ::av_q2d(stream_->time_base);
+
+    // Tolerate rounding errors for timestamps that fall exactly on a frame.
+    return start_pts_ + static_cast<std::int64_t>(std::floor(pts + 1e-6));
+}
+
+}  // namespace fairseq2n::detail
@@ -0,0 +1,152 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavformat/avio.h>
+#include <libavutil/frame.h>
+#include <libswscale/swscale.h>
+}
+
+#include "fairseq2n/float.h"
+#include "fairseq2n/memory.h"
+#include "fairseq2n/span.h"
+
+namespace fairseq2n::detail {
+
+// Wraps `memory_block` as a "virtual" file to use with libavformat.
+class avio_file {
+public:
+    explicit
+    avio_file(memory_block &&block) noexcept
+      : block_{std::move(block)}
+    {}
+
+    int
+    read(std::uint8_t *ptr, int count) noexcept;
+
+    std::int64_t
+    seek(std::int64_t offset, int whence) noexcept;
+
+    std::int64_t
+    size() const noexcept
+    {
+        return static_cast<std::int64_t>(block_.size());
+    }
+
+private:
+    memory_block block_;
+    std::int64_t current_pos_{};
+};
+
+struct av_deleter {
+    void
+    operator()(::AVIOContext *ptr) const noexcept;
+
+    void
+    operator()(::AVFormatContext *ptr) const noexcept;
+
+    void
+    operator()(::AVCodecContext *ptr) const noexcept;
+
+    void
+    operator()(::AVFrame *ptr) const noexcept;
+
+    void
+    operator()(::AVPacket *ptr) const noexcept;
+
+    void
+    operator()(::SwsContext *ptr) const noexcept;
+};
+
+template <typename T>
+using av_ptr = std::unique_ptr<T, av_deleter>;
+
+// Represents the best video stream of a container held in a `memory_block`.
+class video_stream {
+public:
+    explicit
+    video_stream(memory_block block);
+
+    // Decodes the frames presented at `timestamps`, given in seconds relative
+    // to the start of the stream in ascending order, as RGB24 into `target`
+    // which must have room for `timestamps.size()` frames of `height()` x
+    // `width()` pixels. The presentation timestamps of the decoded frames are
+    // written to `frame_timestamps`.
+    //
+    // Rather than decoding the stream from its beginning, the decoder seeks to
+    // the keyframe preceding a timestamp whenever that keyframe lies after the
+    // last decoded frame; containers without a seek index are decoded
+    // sequentially.
+    void
+    decode_into(
+        span<const float64> timestamps,
+        writable_memory_span target,
+        span<float64> frame_timestamps);
+
+    float64
+    duration() const noexcept
+    {
+        return duration_;
+    }
+
+    float64
+    frame_rate() const noexcept
+    {
+        return frame_rate_;
+    }
+
+    std::int64_t
+    height() const noexcept
+    {
+        return codec_ctx_->height;
+    }
+
+    std::int64_t
+    width() const noexcept
+    {
+        return codec_ctx_->width;
+    }
+
+private:
+    bool
+    maybe_seek(std::int64_t pts, std::int64_t last_decoded_pts);
+
+    bool
+    receive_frame();
+
+    void
+    convert_frame(const ::AVFrame &frame, std::uint8_t *target);
+
+    float64
+    to_seconds(std::int64_t pts) const noexcept;
+
+    std::int64_t
+    to_pts(float64 seconds) const noexcept;
+
+private:
+    std::unique_ptr<avio_file> file_;
+    av_ptr<::AVIOContext> io_ctx_{};
+    av_ptr<::AVFormatContext> fmt_ctx_{};
+    av_ptr<::AVCodecContext> codec_ctx_{};
+    av_ptr<::SwsContext> sws_ctx_{};
+    av_ptr<::AVFrame> frame_{};
+    av_ptr<::AVFrame> prev_frame_{};
+    av_ptr<::AVPacket> packet_{};
+    ::AVStream *stream_{};
+    std::int64_t start_pts_{};
+    float64 duration_{};
+    float64 frame_rate_{};
+};
+
+}  // namespace fairseq2n::detail
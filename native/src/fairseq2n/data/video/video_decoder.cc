@@ -0,0 +1,148 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/data/video/video_decoder.h"
+
+#ifdef FAIRSEQ2N_SUPPORT_VIDEO
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+
+#include <ATen/CPUGeneratorImpl.h>
+#include <ATen/Functions.h>
+#include <ATen/Tensor.h>
+#include <ATen/core/TransformationHelper.h>
+
+#include "fairseq2n/exception.h"
+#include "fairseq2n/fmt.h"
+#include "fairseq2n/memory.h"
+#include "fairseq2n/span.h"
+#include "fairseq2n/data/detail/rng.h"
+#include "fairseq2n/data/detail/tensor_helpers.h"
+#include "fairseq2n/data/video/detail/video_stream.h"
+#include "fairseq2n/detail/exception.h"
+
+using namespace fairseq2n::detail;
+
+namespace fairseq2n {
+
+video_decoder::video_decoder(video_decoder_options opts)
+  : opts_{opts}
+{
+    if (opts_.num_frames() <= 0)
+        throw_<std::invalid_argument>(
+            "`num_frames` must be greater than zero, but is {} instead.", opts_.num_frames());
+
+    std::uint64_t seed = opts_.maybe_seed() ? *opts_.maybe_seed() : pseudo_random();
+
+    generator_ = at::make_generator<at::CPUGeneratorImpl>(seed);
+}
+
+data
+video_decoder::operator()(data &&d) const
+{
+    if (!d.is_memory_block())
+        throw_<std::invalid_argument>(
+            "The input data must be of type `memory_block`, but is of type `{}` instead.", d.type());
+
+    const memory_block &block = d.as_memory_block();
+    if (block.empty())
+        throw_<std::invalid_argument>(
+            "The input memory block has zero length and cannot be decoded as video.");
+
+    try {
+        video_stream stream{block};
+
+        std::vector<float64> timestamps = sample_timestamps(stream.duration());
+
+        std::int64_t num_frames = opts_.num_frames();
+
+        at::Tensor video = at::empty({num_frames, stream.height(), stream.width(), 3},
+            at::dtype(at::kByte).device(at::kCPU).pinned_memory(opts_.pin_memory()));
+
+        at::Tensor frame_timestamps = at::empty({num_frames}, at::dtype(at::kDouble).device(at::kCPU));
+
+        stream.decode_into(
+            timestamps, get_raw_mutable_storage(video), cast<float64>(get_raw_mutable_storage(frame_timestamps)));
+
+        at::Device device = opts_.maybe_device().value_or(at::kCPU);
+        if (device != at::kCPU)
+            video = video.to(device);
+
+        data_dict output{
+            {"frame_rate", stream.frame_rate()}, {"duration", stream.duration()}};
+
+        output.emplace("video", std::move(video));
+
+        output.emplace("timestamps", std::move(frame_timestamps));
+
+        return output;
+    } catch (const std::invalid_argument &) {
+        throw_with_nested<std::invalid_argument>(
+            "The input video cannot be decoded. See nested exception for details.");
+    } catch (const std::runtime_error &) {
+        throw_with_nested<std::invalid_argument>(
+            "The input video cannot be decoded. See nested exception for details.");
+    }
+}
+
+std::vector<float64>
+video_decoder::sample_timestamps(float64 duration) const
+{
+    auto num_frames = static_cast<std::size_t>(opts_.num_frames());
+
+    float64 segment_duration = duration / static_cast<float64>(num_frames);
+
+    std::vector<float64> timestamps(num_frames);
+
+    if (opts_.random_sampling()) {
+        std::lock_guard<std::mutex> generator_lock{generator_.mutex()};
+
+        auto *gen = generator_.get<at::CPUGeneratorImpl>();
+
+        for (std::size_t i = 0; i < num_frames; ++i) {
+            float64 offset = at::transformation::uniform_real(gen->random64(), 0.0, 1.0);
+
+            timestamps[i] = (static_cast<float64>(i) + offset) * segment_duration;
+        }
+    } else {
+        for (std::size_t i = 0; i < num_frames; ++i)
+            timestamps[i] = (static_cast<float64>(i) + 0.5) * segment_duration;
+    }
+
+    return timestamps;
+}
+
+}  // namespace fairseq2n
+
+#else
+
+#include "fairseq2n/exception.h"
+#include "fairseq2n/detail/exception.h"
+
+namespace fairseq2n {
+
+video_decoder::video_decoder(video_decoder_options opts)
+  : opts_{opts}
+{}
+
+data
+video_decoder::operator()(data &&) const
+{
+    detail::throw_<not_supported_error>(
+        "fairseq2n is not built with video decoding support.");
+}
+
+std::vector<float64>
+video_decoder::sample_timestamps(float64) const
+{
+    return {};
+}
+
+}  // namespace fairseq2n
+
+#endif
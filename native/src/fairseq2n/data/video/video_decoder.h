@@ -0,0 +1,142 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <ATen/Device.h>
+#include <ATen/Generator.h>
+
+#include "fairseq2n/api.h"
+#include "fairseq2n/float.h"
+#include "fairseq2n/data/data.h"
+
+namespace fairseq2n {
+
+class video_decoder_options {
+public:
+    video_decoder_options
+    num_frames(std::int64_t value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.num_frames_ = value;
+
+        return tmp;
+    }
+
+    std::int64_t
+    num_frames() const noexcept
+    {
+        return num_frames_;
+    }
+
+    video_decoder_options
+    random_sampling(bool value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.random_sampling_ = value;
+
+        return tmp;
+    }
+
+    bool
+    random_sampling() const noexcept
+    {
+        return random_sampling_;
+    }
+
+    video_decoder_options
+    maybe_device(std::optional<at::Device> value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.maybe_device_ = value;
+
+        return tmp;
+    }
+
+    std::optional<at::Device>
+    maybe_device() const noexcept
+    {
+        return maybe_device_;
+    }
+
+    video_decoder_options
+    pin_memory(bool value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.pin_memory_ = value;
+
+        return tmp;
+    }
+
+    bool
+    pin_memory() const noexcept
+    {
+        return pin_memory_;
+    }
+
+    video_decoder_options
+    maybe_seed(std::optional<std::uint64_t> value) noexcept
+    {
+        auto tmp = *this;
+
+        tmp.maybe_seed_ = value;
+
+        return tmp;
+    }
+
+    std::optional<std::uint64_t>
+    maybe_seed() const noexcept
+    {
+        return maybe_seed_;
+    }
+
+private:
+    std::int64_t num_frames_ = 8;
+    bool random_sampling_ = false;
+    std::optional<at::Device> maybe_device_{};
+    bool pin_memory_ = false;
+    std::optional<std::uint64_t> maybe_seed_{};
+};
+
+// Decodes `num_frames` frames of the video given as a `memory_block` (e.g. the
+// `data` field of the output of `file_mapper`) into a `[T, H, W, C]` RGB tensor
+// of type `uint8`.
+//
+// The duration of the video is split into `num_frames` segments of equal length
+// and a frame is picked from each segment; either from its middle, or, if
+// `random_sampling` is set, from a uniformly random position (i.e. the sampling
+// strategy of Temporal Segment Networks). Only the frames needed to reach the
+// sampled timestamps get decoded; the decoder seeks to the keyframe preceding
+// a timestamp whenever it is cheaper than decoding forward.
+//
+// The decoder is safe to use with `map()` with `num_parallel_calls` greater
+// than 1; each call uses a single decoding thread.
+class FAIRSEQ2_API video_decoder {
+public:
+    explicit
+    video_decoder(video_decoder_options opts = {});
+
+    data
+    operator()(data &&d) const;
+
+private:
+    std::vector<float64>
+    sample_timestamps(float64 duration) const;
+
+private:
+    video_decoder_options opts_;
+    mutable at::Generator generator_;
+};
+
+}  // namespace fairseq2n
@@ -0,0 +1,58 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/detail/cancellation.h"
+
+#include <utility>
+
+namespace fairseq2n::detail {
+namespace {
+
+thread_local cancellation_token current_token{};
+
+}  // namespace
+
+const char *
+operation_cancelled::what() const noexcept
+{
+    return "The operation has been cancelled.";
+}
+
+cancellation_token
+cancellation_token::make(const cancellation_token &parent)
+{
+    cancellation_token token{};
+
+    token.state_ = std::make_shared<state>();
+
+    token.state_->parent = parent.state_;
+
+    return token;
+}
+
+cancellation_token
+current_cancellation_token() noexcept
+{
+    return current_token;
+}
+
+cancellation_scope::cancellation_scope(cancellation_token token) noexcept
+  : previous_token_{std::exchange(current_token, std::move(token))}
+{}
+
+cancellation_scope::~cancellation_scope()
+{
+    current_token = std::move(previous_token_);
+}
+
+void
+throw_if_cancelled()
+{
+    if (current_token.is_cancelled())
+        throw operation_cancelled{};
+}
+
+}  // namespace fairseq2n::detail
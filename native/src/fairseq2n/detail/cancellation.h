@@ -0,0 +1,85 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <atomic>
+#include <exception>
+#include <memory>
+
+namespace fairseq2n::detail {
+
+// Thrown by a producer that noticed that its output is no longer needed.
+class operation_cancelled final : public std::exception {
+public:
+    const char *
+    what() const noexcept override;
+};
+
+// Signals the in-flight work of a data pipeline (e.g. the examples being read
+// by a prefetch thread) that its output is no longer needed. A default
+// constructed token is never cancelled.
+class cancellation_token {
+    struct state {
+        std::atomic<bool> cancelled{false};
+        std::shared_ptr<const state> parent{};
+    };
+
+public:
+    cancellation_token() noexcept = default;
+
+    // Returns a new token that is also cancelled when `parent` is cancelled.
+    static cancellation_token
+    make(const cancellation_token &parent = {});
+
+    void
+    cancel() noexcept
+    {
+        if (state_)
+            state_->cancelled.store(true, std::memory_order_relaxed);
+    }
+
+    bool
+    is_cancelled() const noexcept
+    {
+        for (const state *s = state_.get(); s != nullptr; s = s->parent.get())
+            if (s->cancelled.load(std::memory_order_relaxed))
+                return true;
+
+        return false;
+    }
+
+private:
+    std::shared_ptr<state> state_{};
+};
+
+// Returns the token of the calling thread.
+cancellation_token
+current_cancellation_token() noexcept;
+
+// Makes `token` the token of the calling thread for the lifetime of the scope.
+class cancellation_scope {
+public:
+    explicit
+    cancellation_scope(cancellation_token token) noexcept;
+
+    cancellation_scope(const cancellation_scope &) = delete;
+    cancellation_scope &operator=(const cancellation_scope &) = delete;
+
+    cancellation_scope(cancellation_scope &&) = delete;
+    cancellation_scope &operator=(cancellation_scope &&) = delete;
+
+   ~cancellation_scope();
+
+private:
+    cancellation_token previous_token_;
+};
+
+// Throws `operation_cancelled` if the token of the calling thread is cancelled.
+void
+throw_if_cancelled();
+
+}  // namespace fairseq2n::detail
@@ -12,6 +12,8 @@
 #include <oneapi/tbb.h>
 #endif
 
+#include "fairseq2n/detail/cancellation.h"
+
 namespace fairseq2n::detail {
 
 template<typename T>
@@ -19,11 +21,20 @@ void
 parallel_for(const std::function<void(T begin, T end)> &fn, T begin, T end)
 {
 #ifdef FAIRSEQ2N_USE_TBB
+    // The worker threads do not share the cancellation token of the calling
+    // thread, so we pass it explicitly. Once the token is cancelled, the ranges
+    // that have not been started yet are skipped.
+    cancellation_token token = current_cancellation_token();
+
     tbb::blocked_range<T> range{begin, end};
 
     tbb::parallel_for(
-        range, [&fn](const tbb::blocked_range<T> &r)
+        range, [&fn, &token](const tbb::blocked_range<T> &r)
         {
+            cancellation_scope scope{token};
+
+            throw_if_cancelled();
+
             fn(r.begin(), r.end());
         });
 #else
@@ -0,0 +1,170 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/generation/banned_sequence_table.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#include <ATen/Dispatch.h>
+
+#include "fairseq2n/fmt.h"
+#include "fairseq2n/detail/exception.h"
+#include "fairseq2n/detail/parallel.h"
+#include "fairseq2n/generation/detail/step_helpers.h"
+
+using namespace fairseq2n::detail;
+
+namespace fairseq2n {
+
+banned_sequence_table::banned_sequence_table(const std::vector<at::Tensor> &banned_seqs)
+  : num_seqs_{banned_seqs.size()}
+{
+    for (std::size_t i = 0; i < banned_seqs.size(); ++i) {
+        const at::Tensor &seq = banned_seqs[i];
+
+        if (seq.dim() != 1)
+            throw_<std::invalid_argument>(
+                "`banned_seqs[{}]` must be one dimensional, but has {} dimension(s) instead.", i, seq.dim());
+
+        std::int64_t seq_len = seq.size(0);
+        if (seq_len == 0)
+            throw_<std::invalid_argument>(
+                "`banned_seqs[{}]` must not be empty.", i);
+
+        at::Tensor cpu_seq = seq.to(at::kCPU).to(at::kLong);
+
+        auto seq_data = cpu_seq.accessor<std::int64_t, 1>();
+
+        std::int64_t token = seq_data[seq_len - 1];
+
+        if (seq_len == 1) {
+            unconditional_tokens_.push_back(token);
+
+            continue;
+        }
+
+        auto prefix_len = static_cast<std::size_t>(seq_len - 1);
+
+        std::size_t prefix_offset = prefix_tokens_.size();
+
+        for (std::int64_t j = 0; j < seq_len - 1; j++)
+            prefix_tokens_.push_back(seq_data[j]);
+
+        // Hash the prefix backwards, the same way `ban_in_row()` hashes the
+        // suffixes of the generated sequence.
+        std::uint64_t prefix_hash = 0;
+
+        for (std::size_t j = prefix_len; j > 0; --j)
+            prefix_hash = hash_combine(prefix_hash, hash_token(prefix_tokens_[prefix_offset + j - 1]));
+
+        entries_.push_back(entry{prefix_hash, prefix_offset, prefix_len, token});
+
+        if (has_prefix_len_.size() <= prefix_len)
+            has_prefix_len_.resize(prefix_len + 1);
+
+        has_prefix_len_[prefix_len] = true;
+    }
+
+    std::sort(entries_.begin(), entries_.end(), [](const entry &lhs, const entry &rhs)
+    {
+        return lhs.prefix_hash < rhs.prefix_hash;
+    });
+}
+
+void
+banned_sequence_table::ban(const at::Tensor &seqs, const at::Tensor &probs, bool lprob) const
+{
+    check_step_tensors(seqs, probs);
+
+    if (empty())
+        return;
+
+    strided_rows<const std::int64_t> seqs_rows{seqs};
+
+    AT_DISPATCH_FLOATING_TYPES_AND2(at::kHalf, at::kBFloat16, probs.scalar_type(), "ban", [&]
+    {
+        strided_rows<scalar_t> probs_rows{probs};
+
+        auto ban_value = static_cast<scalar_t>(lprob ? -std::numeric_limits<float>::infinity() : 0.0F);
+
+        parallel_for<std::int64_t>([&](std::int64_t begin, std::int64_t end)
+        {
+            for (std::int64_t row = begin; row < end; row++)
+                ban_in_row(seqs_rows, probs_rows, row, ban_value);
+        }, seqs.size(0));
+    });
+}
+
+template <typename T>
+void
+banned_sequence_table::ban_in_row(
+    const strided_rows<const std::int64_t> &seqs,
+    const strided_rows<T> &probs,
+    std::int64_t row,
+    T ban_value) const
+{
+    std::int64_t vocab_size = probs.num_cols();
+
+    auto ban = [&](std::int64_t token)
+    {
+        check_token_in_range(token, vocab_size);
+
+        probs(row, token) = ban_value;
+    };
+
+    for (std::int64_t token : unconditional_tokens_)
+        ban(token);
+
+    std::int64_t seq_len = seqs.num_cols();
+
+    // A prefix longer than the generated sequence can never match.
+    auto max_prefix_len = std::min(
+        static_cast<std::int64_t>(has_prefix_len_.size()) - 1, seq_len);
+
+    std::uint64_t suffix_hash = 0;
+
+    // Extend the suffix of the generated sequence one token at a time and look
+    // up the banned sequences whose prefix has the same length and hash.
+    for (std::int64_t suffix_len = 1; suffix_len <= max_prefix_len; suffix_len++) {
+        suffix_hash = hash_combine(suffix_hash, hash_token(seqs(row, seq_len - suffix_len)));
+
+        auto len = static_cast<std::size_t>(suffix_len);
+
+        if (!has_prefix_len_[len])
+            continue;
+
+        auto [first, last] = std::equal_range(
+            entries_.begin(), entries_.end(), entry{suffix_hash, 0, 0, 0},
+            [](const entry &lhs, const entry &rhs)
+            {
+                return lhs.prefix_hash < rhs.prefix_hash;
+            });
+
+        for (auto pos = first; pos < last; ++pos) {
+            if (pos->prefix_len != len)
+                continue;
+
+            bool is_match = true;
+
+            for (std::size_t j = 0; j < len; j++) {
+                std::int64_t token = seqs(row, seq_len - suffix_len + static_cast<std::int64_t>(j));
+
+                if (token != prefix_tokens_[pos->prefix_offset + j]) {
+                    is_match = false;
+
+                    break;
+                }
+            }
+
+            if (is_match)
+                ban(pos->token);
+        }
+    }
+}
+
+}  // namespace fairseq2n
@@ -0,0 +1,81 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <ATen/Tensor.h>
+
+#include "fairseq2n/api.h"
+
+namespace fairseq2n {
+namespace detail {
+
+template <typename T>
+class strided_rows;
+
+}  // namespace detail
+
+// Holds a set of banned token sequences and bans in the next-step
+// probabilities the last token of every banned sequence whose preceding tokens
+// match the end of the sequence generated so far.
+//
+// The prefixes of the banned sequences are indexed by the hash of their tokens,
+// so the cost of a step grows with the length of the longest banned sequence
+// rather than with the number of banned sequences.
+class FAIRSEQ2_API banned_sequence_table final {
+public:
+    explicit
+    banned_sequence_table(const std::vector<at::Tensor> &banned_seqs);
+
+    // Bans the matching tokens in `probs` by setting them to negative infinity
+    // if `lprob` is `true`, and to zero otherwise. Both tensors must be on the
+    // CPU; the rows are processed in parallel.
+    void
+    ban(const at::Tensor &seqs, const at::Tensor &probs, bool lprob) const;
+
+    bool
+    empty() const noexcept
+    {
+        return num_seqs_ == 0;
+    }
+
+private:
+    template <typename T>
+    void
+    ban_in_row(
+        const detail::strided_rows<const std::int64_t> &seqs,
+        const detail::strided_rows<T> &probs,
+        std::int64_t row,
+        T ban_value) const;
+
+private:
+    struct entry {
+        std::uint64_t prefix_hash;
+        std::size_t prefix_offset;
+        std::size_t prefix_len;
+        std::int64_t token;
+    };
+
+    std::size_t num_seqs_ = 0;
+
+    // The last tokens of the banned sequences of length one; banned at every step.
+    std::vector<std::int64_t> unconditional_tokens_{};
+
+    // The entries of the longer banned sequences sorted by their prefix hash.
+    std::vector<entry> entries_{};
+
+    // The concatenated prefixes of the entries, used to resolve hash hits.
+    std::vector<std::int64_t> prefix_tokens_{};
+
+    // `has_prefix_len_[n]` is `true` if any prefix has length `n`.
+    std::vector<bool> has_prefix_len_{};
+};
+
+}  // namespace fairseq2n
@@ -0,0 +1,98 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#include <ATen/Tensor.h>
+
+#include "fairseq2n/data/detail/hash.h"
+#include "fairseq2n/detail/exception.h"
+
+namespace fairseq2n::detail {
+
+// A row-major view of a two dimensional CPU tensor that honors its strides so
+// that slices such as `seqs[:, :step]` do not have to be copied.
+template <typename T>
+class strided_rows {
+public:
+    explicit
+    strided_rows(const at::Tensor &tensor)
+      : data_{tensor.data_ptr<std::remove_const_t<T>>()},
+        num_rows_{tensor.size(0)},
+        num_cols_{tensor.size(1)},
+        row_stride_{tensor.stride(0)},
+        col_stride_{tensor.stride(1)}
+    {}
+
+    T &
+    operator()(std::int64_t row, std::int64_t col) const noexcept
+    {
+        return data_[row * row_stride_ + col * col_stride_];
+    }
+
+    std::int64_t
+    num_rows() const noexcept
+    {
+        return num_rows_;
+    }
+
+    std::int64_t
+    num_cols() const noexcept
+    {
+        return num_cols_;
+    }
+
+private:
+    T *data_;
+    std::int64_t num_rows_;
+    std::int64_t num_cols_;
+    std::int64_t row_stride_;
+    std::int64_t col_stride_;
+};
+
+inline std::uint64_t
+hash_token(std::int64_t token) noexcept
+{
+    return xxh64_round(0, static_cast<std::uint64_t>(token));
+}
+
+inline void
+check_step_tensors(const at::Tensor &seqs, const at::Tensor &probs)
+{
+    if (seqs.dim() != 2)
+        throw_<std::invalid_argument>(
+            "`seqs` must be two dimensional, but has {} dimension(s) instead.", seqs.dim());
+
+    if (probs.dim() != 2)
+        throw_<std::invalid_argument>(
+            "`probs` must be two dimensional, but has {} dimension(s) instead.", probs.dim());
+
+    if (seqs.size(0) != probs.size(0))
+        throw_<std::invalid_argument>(
+            "`seqs` and `probs` must have the same batch size, but have {} and {} instead.", seqs.size(0), probs.size(0));
+
+    if (seqs.scalar_type() != at::kLong)
+        throw_<std::invalid_argument>(
+            "`seqs` must be of type `torch.int64`.");
+
+    if (!seqs.is_cpu() || !probs.is_cpu())
+        throw_<std::invalid_argument>(
+            "`seqs` and `probs` must be on the CPU.");
+}
+
+inline void
+check_token_in_range(std::int64_t token, std::int64_t vocab_size)
+{
+    if (token < 0 || token >= vocab_size)
+        throw_<std::invalid_argument>(
+            "The token {} is out of range for a vocabulary of size {}.", token, vocab_size);
+}
+
+}  // namespace fairseq2n::detail
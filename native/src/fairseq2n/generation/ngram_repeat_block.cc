@@ -0,0 +1,135 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "fairseq2n/generation/ngram_repeat_block.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+#include <ATen/Dispatch.h>
+
+#include "fairseq2n/fmt.h"
+#include "fairseq2n/detail/exception.h"
+#include "fairseq2n/detail/parallel.h"
+#include "fairseq2n/generation/detail/step_helpers.h"
+
+using namespace fairseq2n::detail;
+
+namespace fairseq2n {
+namespace detail {
+namespace {
+
+// The multiplier of the polynomial rolling hash. Any odd constant works since
+// the arithmetic is modulo 2^64.
+constexpr std::uint64_t rolling_base = xxh_prime64_1;
+
+template <typename T>
+void
+block_ngram_repeats_in_row(
+    const strided_rows<const std::int64_t> &seqs,
+    const strided_rows<T> &probs,
+    std::int64_t row,
+    std::int64_t ngram_size,
+    T ban_value)
+{
+    std::int64_t seq_len = seqs.num_cols();
+
+    std::int64_t vocab_size = probs.num_cols();
+
+    auto ban = [&](std::int64_t token)
+    {
+        check_token_in_range(token, vocab_size);
+
+        probs(row, token) = ban_value;
+    };
+
+    // This is an edge case where we do not allow any of the previous tokens.
+    if (ngram_size == 1) {
+        for (std::int64_t i = 0; i < seq_len; i++)
+            ban(seqs(row, i));
+
+        return;
+    }
+
+    std::int64_t prefix_len = ngram_size - 1;
+
+    // The prefix of the next n-gram is the last `ngram_size - 1` tokens.
+    std::int64_t prefix_pos = seq_len - prefix_len;
+
+    auto matches_prefix = [&](std::int64_t pos)
+    {
+        for (std::int64_t k = 0; k < prefix_len; k++)
+            if (seqs(row, pos + k) != seqs(row, prefix_pos + k))
+                return false;
+
+        return true;
+    };
+
+    // `rolling_base` raised to the power of `prefix_len - 1`, used to remove
+    // the leading token from the window hash.
+    std::uint64_t lead_factor = 1;
+
+    std::uint64_t prefix_hash = 0;
+
+    std::uint64_t window_hash = 0;
+
+    for (std::int64_t k = 0; k < prefix_len; k++) {
+        if (k > 0)
+            lead_factor *= rolling_base;
+
+        prefix_hash = prefix_hash * rolling_base + hash_token(seqs(row, prefix_pos + k));
+        window_hash = window_hash * rolling_base + hash_token(seqs(row, k));
+    }
+
+    // Compare the window starting at every earlier position against the prefix
+    // in O(1) and fall back to a token-by-token comparison only on a hash hit.
+    for (std::int64_t pos = 0; pos < prefix_pos; pos++) {
+        if (pos > 0) {
+            window_hash -= hash_token(seqs(row, pos - 1)) * lead_factor;
+
+            window_hash = window_hash * rolling_base + hash_token(seqs(row, pos + prefix_len - 1));
+        }
+
+        if (window_hash == prefix_hash && matches_prefix(pos))
+            ban(seqs(row, pos + prefix_len));
+    }
+}
+
+}  // namespace
+}  // namespace detail
+
+void
+block_ngram_repeats(
+    const at::Tensor &seqs, const at::Tensor &probs, std::int64_t ngram_size, bool lprob)
+{
+    if (ngram_size <= 0)
+        throw_<std::invalid_argument>(
+            "`ngram_size` must be greater than 0, but is {} instead.", ngram_size);
+
+    check_step_tensors(seqs, probs);
+
+    if (ngram_size > seqs.size(1))
+        return;
+
+    strided_rows<const std::int64_t> seqs_rows{seqs};
+
+    AT_DISPATCH_FLOATING_TYPES_AND2(at::kHalf, at::kBFloat16, probs.scalar_type(), "block_ngram_repeats", [&]
+    {
+        strided_rows<scalar_t> probs_rows{probs};
+
+        auto ban_value = static_cast<scalar_t>(lprob ? -std::numeric_limits<float>::infinity() : 0.0F);
+
+        parallel_for<std::int64_t>([&](std::int64_t begin, std::int64_t end)
+        {
+            for (std::int64_t row = begin; row < end; row++)
+                block_ngram_repeats_in_row(seqs_rows, probs_rows, row, ngram_size, ban_value);
+        }, seqs.size(0));
+    });
+}
+
+}  // namespace fairseq2n
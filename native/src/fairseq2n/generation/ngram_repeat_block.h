@@ -0,0 +1,26 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <cstdint>
+
+#include <ATen/Tensor.h>
+
+#include "fairseq2n/api.h"
+
+namespace fairseq2n {
+
+// Bans in `probs` every token that would complete an n-gram of size
+// `ngram_size` that already occurs in the corresponding row of `seqs`. Banned
+// tokens are set to negative infinity if `lprob` is `true`, and to zero
+// otherwise. Both tensors must be on the CPU; the rows are processed in
+// parallel.
+FAIRSEQ2_API void
+block_ngram_repeats(
+    const at::Tensor &seqs, const at::Tensor &probs, std::int64_t ngram_size, bool lprob);
+
+}  // namespace fairseq2n
@@ -6,8 +6,8 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstddef>
-#include <memory>
 #include <string>
 #include <type_traits>
 #include <utility>
@@ -22,7 +22,9 @@ namespace fairseq2n {
 // the underlying memory.
 using memory_deallocator = void (*)(const void *addr, std::size_t size, void *ctx) noexcept;
 
-// Used internally by `memory_block` to manage the lifetime of the memory.
+// Used internally by `memory_block` to manage the lifetime of the memory. The
+// reference count is kept intrusively, so that a `memory_block` needs a single
+// pointer to share its memory.
 class FAIRSEQ2_API memory_holder {
 public:
     explicit
@@ -43,11 +45,27 @@ public:
             deallocator_(addr_, size_, ctx_);
     }
 
+    void
+    retain() noexcept
+    {
+        ref_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Deletes the holder, and therefore frees the memory, once the last
+    // reference is released.
+    void
+    release() noexcept
+    {
+        if (ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete this;  // NOLINT(cppcoreguidelines-owning-memory)
+    }
+
 private:
     const void *addr_;
     std::size_t size_;
     void *ctx_;
     memory_deallocator deallocator_;
+    std::atomic<std::size_t> ref_count_{1};
 };
 
 // A `memory_block` is intended to be used for zero-copy memory sharing. The
@@ -85,29 +103,61 @@ public:
     template <typename U, typename = std::enable_if_t<std::is_convertible_v<U *, T*>>>
     basic_memory_block(const basic_memory_block<U> &other) noexcept
         : data_{other.data_}, size_{other.size_}, holder_{other.holder_}
-    {}
+    {
+        xretain();
+    }
 
-    basic_memory_block(const basic_memory_block &) noexcept = default;
-    basic_memory_block &operator=(const basic_memory_block &) noexcept = default;
+    basic_memory_block(const basic_memory_block &other) noexcept
+        : data_{other.data_}, size_{other.size_}, holder_{other.holder_}
+    {
+        xretain();
+    }
+
+    basic_memory_block &operator=(const basic_memory_block &other) noexcept
+    {
+        if (this != &other) {
+            // Retain first in case `other` is a slice sharing our holder.
+            if (other.holder_ != nullptr)
+                other.holder_->retain();
+
+            xrelease();
+
+            data_ = other.data_;
+            size_ = other.size_;
+
+            holder_ = other.holder_;
+        }
+
+        return *this;
+    }
 
     basic_memory_block(basic_memory_block &&other) noexcept
-        : data_{other.data_}, size_{other.size_}, holder_{std::move(other.holder_)}
+        : data_{other.data_}, size_{other.size_}, holder_{other.holder_}
     {
         other.data_ = nullptr;
         other.size_ = 0;
+
+        other.holder_ = nullptr;
     }
 
     basic_memory_block &operator=(basic_memory_block &&other) noexcept
     {
-        data_ = std::exchange(other.data_, nullptr);
-        size_ = std::exchange(other.size_, 0);
+        if (this != &other) {
+            xrelease();
 
-        holder_ = std::move(other.holder_);
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+
+            holder_ = std::exchange(other.holder_, nullptr);
+        }
 
         return *this;
     }
 
-   ~basic_memory_block() = default;
+   ~basic_memory_block()
+    {
+        xrelease();
+    }
 
     basic_memory_block
     share_slice(size_type offset) const noexcept
@@ -176,14 +226,31 @@ private:
     basic_memory_block(const basic_memory_block &other, pointer data, std::size_t size) noexcept
       : data_{data}, size_{size}
     {
-        if (size_ > 0)
+        if (size_ > 0) {
             holder_ = other.holder_;
+
+            xretain();
+        }
+    }
+
+    void
+    xretain() const noexcept
+    {
+        if (holder_ != nullptr)
+            holder_->retain();
+    }
+
+    void
+    xrelease() const noexcept
+    {
+        if (holder_ != nullptr)
+            holder_->release();
     }
 
 private:
     pointer data_ = nullptr;
     size_type size_ = 0;
-    std::shared_ptr<memory_holder> holder_{};
+    memory_holder *holder_ = nullptr;
 };
 
 template <typename T>
@@ -194,7 +261,7 @@ basic_memory_block<T>::basic_memory_block(
     // As a contract, we take the ownership of `data`. This means we have to
     // make sure that we don't leak in case of a failure.
     try {
-        holder_ = std::make_shared<memory_holder>(data, size, ctx, deallocator);
+        holder_ = new memory_holder(data, size, ctx, deallocator);  // NOLINT(cppcoreguidelines-owning-memory)
     } catch (...) {
         if (deallocator != nullptr)
             deallocator(data, size, ctx);
@@ -0,0 +1,79 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <fairseq2n/data/data.h>
+
+#include <cstdint>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+using namespace fairseq2n;
+
+TEST(test_data, copy_constructor_shares_list)
+{
+    data d1 = data_list{data{std::int64_t{1}}, data{std::int64_t{2}}};
+
+    const data d2 = d1;  // NOLINT(performance-unnecessary-copy-initialization)
+
+    EXPECT_EQ(&std::as_const(d1).as_list(), &d2.as_list());
+}
+
+TEST(test_data, as_list_clones_shared_list_on_write)
+{
+    data d1 = data_list{data{std::int64_t{1}}, data{std::int64_t{2}}};
+
+    data d2 = d1;
+
+    d2.as_list().emplace_back(std::int64_t{3});
+
+    EXPECT_EQ(std::as_const(d1).as_list().size(), 2);
+    EXPECT_EQ(std::as_const(d2).as_list().size(), 3);
+}
+
+TEST(test_data, as_list_does_not_clone_unshared_list)
+{
+    data d = data_list{data{std::int64_t{1}}};
+
+    const data_list *ptr = &std::as_const(d).as_list();
+
+    EXPECT_EQ(&d.as_list(), ptr);
+}
+
+TEST(test_data, as_dict_clones_only_touched_path)
+{
+    data_dict inner{{"a", data{std::int64_t{1}}}};
+
+    data_dict outer{{"x", data{inner}}, {"y", data{inner}}};
+
+    data d1 = outer;
+
+    data d2 = d1;
+
+    d2.as_dict()["x"].as_dict()["a"] = data{std::int64_t{2}};
+
+    const data_dict &d1_dict = std::as_const(d1).as_dict();
+    const data_dict &d2_dict = std::as_const(d2).as_dict();
+
+    EXPECT_EQ(d1_dict.at("x").as_dict().at("a").as_int(), 1);
+    EXPECT_EQ(d2_dict.at("x").as_dict().at("a").as_int(), 2);
+
+    // The untouched entry must still be shared between both instances.
+    EXPECT_EQ(&d1_dict.at("y").as_dict(), &d2_dict.at("y").as_dict());
+}
+
+TEST(test_data, move_as_list_leaves_copies_intact)
+{
+    data d1 = data_list{data{std::int64_t{1}}, data{std::int64_t{2}}};
+
+    data d2 = d1;
+
+    data_list l = std::move(d2).as_list();
+
+    EXPECT_EQ(l.size(), 2);
+
+    EXPECT_EQ(std::as_const(d1).as_list().size(), 2);
+}
@@ -106,6 +106,36 @@ TEST(test_memory_block, destructor_works)
     EXPECT_EQ(*data, a.size());
 }
 
+TEST(test_memory_block, destructor_works_when_block_is_shared)
+{
+    std::array<std::byte, sizeof(std::size_t)> a{};
+
+    auto *data = reinterpret_cast<std::size_t *>(a.data());
+
+    {
+        memory_block b{a.data(), a.size(), nullptr, test_dealloc};
+
+        memory_block c{};
+
+        {
+            memory_block d = b;  // NOLINT(performance-unnecessary-copy-initialization)
+
+            c = d.share_first(1);
+
+            b = {};
+        }
+
+        // `c` still refers to the memory.
+        EXPECT_EQ(*data, 0);
+
+        c = c;  // NOLINT(clang-diagnostic-self-assign-overloaded)
+
+        EXPECT_EQ(*data, 0);
+    }
+
+    EXPECT_EQ(*data, a.size());
+}
+
 TEST(test_memory_block, cast_works)
 {
     std::array<std::byte, 16> a{};
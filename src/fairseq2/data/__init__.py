@@ -7,18 +7,25 @@
 from fairseq2.data.data_pipeline import ByteStreamError as ByteStreamError
 from fairseq2.data.data_pipeline import CollateOptionsOverride as CollateOptionsOverride
 from fairseq2.data.data_pipeline import Collater as Collater
+from fairseq2.data.data_pipeline import DataHasher as DataHasher
 from fairseq2.data.data_pipeline import DataPipeline as DataPipeline
 from fairseq2.data.data_pipeline import DataPipelineBuilder as DataPipelineBuilder
 from fairseq2.data.data_pipeline import DataPipelineError as DataPipelineError
+from fairseq2.data.data_pipeline import FileCache as FileCache
+from fairseq2.data.data_pipeline import FileCompression as FileCompression
 from fairseq2.data.data_pipeline import FileMapper as FileMapper
 from fairseq2.data.data_pipeline import FileMapperOutput as FileMapperOutput
 from fairseq2.data.data_pipeline import RecordError as RecordError
 from fairseq2.data.data_pipeline import SequenceData as SequenceData
 from fairseq2.data.data_pipeline import create_bucket_sizes as create_bucket_sizes
+from fairseq2.data.data_pipeline import get_file_cache as get_file_cache
 from fairseq2.data.data_pipeline import (
     get_last_failed_example as get_last_failed_example,
 )
 from fairseq2.data.data_pipeline import list_files as list_files
 from fairseq2.data.data_pipeline import read_sequence as read_sequence
 from fairseq2.data.data_pipeline import read_zipped_records as read_zipped_records
+from fairseq2.data.data_pipeline import set_file_cache as set_file_cache
+from fairseq2.data.data_pipeline import write_records as write_records
+from fairseq2.data.data_pipeline import write_tensors as write_tensors
 from fairseq2.data.vocabulary_info import VocabularyInfo as VocabularyInfo
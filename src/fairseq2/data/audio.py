@@ -6,17 +6,38 @@
 
 from __future__ import annotations
 
-from typing import TYPE_CHECKING, Optional, TypedDict, Union, final
+from pathlib import Path
+from typing import TYPE_CHECKING, Optional, Sequence, TypedDict, Union, final
 
 from fairseq2n import DOC_MODE
 from torch import Tensor
 from typing_extensions import NotRequired
 
+from fairseq2.data.data_pipeline import DataPipeline
 from fairseq2.memory import MemoryBlock
 from fairseq2.typing import DataType, Device
 
 if TYPE_CHECKING or DOC_MODE:
 
+    @final
+    class AudioAugmenter:
+        def __init__(
+            self,
+            noise_pathnames: Sequence[str] = (),
+            rir_pathnames: Sequence[str] = (),
+            noise_probability: float = 1.0,
+            min_snr: float = 5.0,
+            max_snr: float = 20.0,
+            reverb_probability: float = 1.0,
+            channel_last: bool = False,
+            root_dir: Optional[Path] = None,
+            seed: Optional[int] = None,
+        ) -> None:
+            ...
+
+        def __call__(self, waveform: WaveformToFbankInput) -> WaveformToFbankInput:
+            ...
+
     @final
     class AudioDecoder:
         def __init__(
@@ -49,14 +70,90 @@ if TYPE_CHECKING or DOC_MODE:
         def __call__(self, waveform: WaveformToFbankInput) -> WaveformToFbankOutput:
             ...
 
+    @final
+    class WaveformToLogMelConverter:
+        def __init__(
+            self,
+            num_mel_bins: int = 80,
+            num_fft: int = 400,
+            hop_length: int = 160,
+            waveform_scale: float = 1.0,
+            channel_last: bool = False,
+            keep_waveform: bool = False,
+            dtype: Optional[DataType] = None,
+            device: Optional[Device] = None,
+            pin_memory: bool = False,
+        ) -> None:
+            ...
+
+        def __call__(self, waveform: WaveformToFbankInput) -> WaveformToLogMelOutput:
+            ...
+
+    @final
+    class WaveformToMfccConverter:
+        def __init__(
+            self,
+            num_mel_bins: int = 23,
+            num_ceps: int = 13,
+            cepstral_lifter: float = 22.0,
+            waveform_scale: float = 1.0,
+            channel_last: bool = False,
+            standardize: bool = False,
+            keep_waveform: bool = False,
+            dtype: Optional[DataType] = None,
+            device: Optional[Device] = None,
+            pin_memory: bool = False,
+        ) -> None:
+            ...
+
+        def __call__(self, waveform: WaveformToFbankInput) -> WaveformToMfccOutput:
+            ...
+
+    @final
+    class VoiceActivitySegmenter:
+        def __init__(
+            self,
+            frame_duration: float = 0.02,
+            start_threshold: float = -35.0,
+            end_threshold: float = -45.0,
+            max_zero_crossing_rate: float = 0.4,
+            min_silence_duration: float = 0.3,
+            min_segment_duration: float = 0.25,
+            max_segment_duration: float = 30.0,
+            padding_duration: float = 0.1,
+            waveform_scale: float = 1.0,
+            channel_last: bool = False,
+        ) -> None:
+            ...
+
+        def __call__(self, waveform: WaveformToFbankInput) -> DataPipeline:
+            ...
+
 else:
+    from fairseq2n.bindings.data.audio import AudioAugmenter as AudioAugmenter
     from fairseq2n.bindings.data.audio import AudioDecoder as AudioDecoder
+    from fairseq2n.bindings.data.audio import (
+        VoiceActivitySegmenter as VoiceActivitySegmenter,
+    )
     from fairseq2n.bindings.data.audio import (
         WaveformToFbankConverter as WaveformToFbankConverter,
     )
+    from fairseq2n.bindings.data.audio import (
+        WaveformToLogMelConverter as WaveformToLogMelConverter,
+    )
+    from fairseq2n.bindings.data.audio import (
+        WaveformToMfccConverter as WaveformToMfccConverter,
+    )
 
     def _set_module_name() -> None:
-        for t in [AudioDecoder, WaveformToFbankConverter]:
+        for t in [
+            AudioAugmenter,
+            AudioDecoder,
+            VoiceActivitySegmenter,
+            WaveformToFbankConverter,
+            WaveformToLogMelConverter,
+            WaveformToMfccConverter,
+        ]:
             t.__module__ = __name__
 
     _set_module_name()
@@ -77,3 +174,22 @@ class WaveformToFbankOutput(TypedDict):
     fbank: Tensor
     waveform: NotRequired[Tensor]
     sample_rate: float
+
+
+class WaveformToLogMelOutput(TypedDict):
+    log_mel: Tensor
+    waveform: NotRequired[Tensor]
+    sample_rate: float
+
+
+class WaveformToMfccOutput(TypedDict):
+    mfcc: Tensor
+    waveform: NotRequired[Tensor]
+    sample_rate: float
+
+
+class VoiceActivitySegment(TypedDict):
+    waveform: Tensor
+    sample_rate: float
+    start_sample: int
+    end_sample: int
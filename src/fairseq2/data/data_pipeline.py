@@ -6,10 +6,13 @@
 
 from __future__ import annotations
 
+from enum import Enum
 from pathlib import Path
 from typing import (
     TYPE_CHECKING,
     Any,
+    AsyncIterator,
+    Awaitable,
     Callable,
     Dict,
     Iterator,
@@ -25,7 +28,7 @@ from typing import (
 
 from fairseq2n import DOC_MODE
 from torch import Tensor
-from typing_extensions import Self
+from typing_extensions import NotRequired, Self
 
 from fairseq2.memory import MemoryBlock
 
@@ -49,6 +52,24 @@ if TYPE_CHECKING or DOC_MODE:
             so it's not safe to have several iterators over the same DataPipeline.
             """
 
+        def __aiter__(self) -> _DataPipelineAsyncIterator:
+            """Return an asynchronous iterator over the examples in the data
+            pipeline.
+
+            The examples are read by a native background thread, and the event
+            loop is notified through a file descriptor once each one is ready,
+            so ``async for`` never blocks the event loop. It requires an event
+            loop that supports :meth:`~asyncio.loop.add_reader`.
+
+            Cancelling a pending ``__anext__()`` (e.g. on timeout) does not
+            lose the example being read; it is returned by the next call. To
+            stop iterating early, ``await`` the ``aclose()`` method of the
+            iterator; it does not block the event loop.
+
+            As with :meth:`__iter__`, it is not safe to have several iterators
+            over the same DataPipeline.
+            """
+
         def reset(self, reset_rng: bool = False) -> None:
             """Move back to the first example in the data pipeline."""
 
@@ -148,6 +169,25 @@ if TYPE_CHECKING or DOC_MODE:
                 If ``True``, calls each data pipeline sequentially.
             """
 
+    @final
+    class _DataPipelineAsyncIterator(AsyncIterator[Any]):
+        """An asynchronous iterator over the examples in a data pipeline."""
+
+        def __aiter__(self) -> Self:
+            ...
+
+        def __anext__(self) -> Awaitable[Any]:
+            ...
+
+        def aclose(self) -> Awaitable[None]:
+            """Stop iterating.
+
+            The in-flight read, if any, is cancelled without blocking the event
+            loop. The returned awaitable completes once the background thread
+            has exited; only then the data pipeline can be reset and used
+            again.
+            """
+
     @final
     class DataPipelineBuilder:
         """API to create DataPipeline"""
@@ -230,6 +270,13 @@ if TYPE_CHECKING or DOC_MODE:
             """Prefetch examples in the background while the current example is
             being processed.
 
+            Resetting, reloading, or destroying the pipeline cancels the
+            in-flight upstream work of the background thread instead of waiting
+            for it. Cancellation is cooperative: :meth:`map` checks for it between
+            examples, and file streams between reads of the underlying file, so a
+            read that is blocked (e.g. on a pipe or a network file system) is not
+            abandoned and still has to return first.
+
             :param num_examples:
                 The number of examples to prefetch.
             """
@@ -239,6 +286,28 @@ if TYPE_CHECKING or DOC_MODE:
         ) -> Self:
             ...
 
+        def restore_order(
+            self, max_num_buffered: int, index_selector: str = "index"
+        ) -> Self:
+            """Re-emit examples in the order given by their original index.
+
+            This is the counterpart of :meth:`sort_for_inference`. Examples are
+            buffered until the one with the next expected index arrives. If an
+            example is a list (e.g. a batch returned by
+            :meth:`sort_for_inference`), its elements are reordered individually.
+
+            :param max_num_buffered:
+                The maximum number of examples to buffer. Once reached, the
+                missing indices are assumed to be dropped upstream (e.g. by
+                :meth:`filter`) and skipped. Must be at least as large as the
+                number of examples by which the upstream data pipeline reorders
+                its output (e.g. the ``window_size`` of
+                :meth:`sort_for_inference`); an example that arrives after its
+                index was skipped raises an error.
+            :param index_selector:
+                The column holding the original index of each example.
+            """
+
         def shard(
             self, shard_idx: int, num_shards: int, allow_uneven: bool = False
         ) -> Self:
@@ -250,7 +319,12 @@ if TYPE_CHECKING or DOC_MODE:
                 The number of shards.
             """
 
-        def shuffle(self, shuffle_window: int, seed: Optional[int] = None) -> Self:
+        def shuffle(
+            self,
+            shuffle_window: int,
+            seed: Optional[int] = None,
+            warmup_window: int = 0,
+        ) -> Self:
             """Shuffle examples using a fixed sized buffer.
 
             :param shuffle_window:
@@ -258,14 +332,123 @@ if TYPE_CHECKING or DOC_MODE:
                 will be randomly sampled from this buffer, and selected examples
                 will be replaced with new examples. If ``0``, all examples will
                 be loaded into memory for full shuffling.
+            :param seed:
+                The seed to initialize the random number generator.
+            :param warmup_window:
+                If greater than ``0``, the first example is returned as soon as
+                ``warmup_window`` examples are buffered instead of waiting for
+                the whole shuffle window to fill. The buffer then grows by one
+                example for every returned example until it reaches
+                ``shuffle_window``. This trades shuffle quality for latency: the
+                ``i``-th example during warm-up is sampled from only
+                ``warmup_window + i`` examples, so examples read early in the
+                stream are more likely to be returned early.
             """
 
         def skip(self, num_examples: int) -> Self:
             """Skip ``num_examples`` examples."""
 
+        def sort_for_inference(
+            self,
+            window_size: int,
+            batch_size: int,
+            selector: Optional[str] = None,
+            index_key: str = "index",
+        ) -> Self:
+            """Read ``window_size`` examples at a time, sort them by length, and
+            combine them into batches of ``batch_size`` examples.
+
+            Sorting minimizes padding in offline inference. The longest examples
+            come first within each window. Each example must be a ``dict`` and
+            gets its original index stored under ``index_key``; use
+            :meth:`restore_order` to re-emit the outputs in input order.
+
+            Example usage::
+
+                pipeline = (
+                    read_sequence(examples)
+                    .sort_for_inference(window_size=1024, batch_size=32, selector="seq")
+                    .map(run_model)  # Returns a list of dicts with "index".
+                    .restore_order(max_num_buffered=1024)
+                    .and_return()
+                )
+
+            :param window_size:
+                The number of examples to sort at a time.
+            :param batch_size:
+                The number of examples in each batch.
+            :param selector:
+                The column to determine the length of each example. See
+                :ref:`reference/data:column syntax` for more details.
+            :param index_key:
+                The key under which to store the original index of each example.
+            """
+
+        def stratified_sample(
+            self,
+            selector: str,
+            reservoir_size: int = 1000,
+            weights: Optional[Mapping[str, float]] = None,
+            temperature: Optional[float] = None,
+            seed: Optional[int] = None,
+        ) -> Self:
+            """Resample examples to follow a target class distribution.
+
+            Examples are buffered in per-class reservoirs. For each output, a
+            class is sampled from the target distribution and a random example
+            is taken from its reservoir; if the reservoir is empty, examples are
+            read until the class shows up again. A class is only known once one
+            of its examples has been read.
+
+            :param selector:
+                The column holding the class of each example. The class must be
+                a ``str`` or an ``int``.
+            :param reservoir_size:
+                The maximum number of examples buffered per class. Once full,
+                new examples replace buffered ones via reservoir sampling.
+            :param weights:
+                The explicit target distribution as a mapping from class names
+                (``str(cls)`` for ``int`` classes) to weights. Examples of the
+                classes not in ``weights`` are dropped.
+            :param temperature:
+                If specified, samples each class with a probability proportional
+                to ``n ** (1 / temperature)``, where ``n`` is the number of its
+                examples read so far. ``1.0`` keeps the natural distribution,
+                and larger values move it towards uniform. If neither
+                ``weights`` nor ``temperature`` is specified, classes are
+                sampled uniformly.
+            :param seed:
+                The seed to initialize the random number generator.
+            """
+
         def take(self, num_examples: int) -> Self:
             """Return at most ``num_examples`` examples."""
 
+        def take_random(
+            self,
+            num_examples: int,
+            weight_selector: Optional[str] = None,
+            seed: Optional[int] = None,
+        ) -> Self:
+            """Return a uniform random sample of ``num_examples`` examples.
+
+            The sample is drawn with reservoir sampling in a single pass over
+            the data pipeline, using memory proportional to ``num_examples``
+            and without drawing a random number for each skipped example. The
+            sampled examples are returned in their original order. If the data
+            pipeline has fewer than ``num_examples`` examples, all of them are
+            returned.
+
+            :param num_examples:
+                The number of examples to sample.
+            :param weight_selector:
+                The column holding the (non-negative) sampling weight of each
+                example. If ``None``, all examples are equally likely. See
+                :ref:`reference/data:column syntax` for more details.
+            :param seed:
+                The seed to initialize the random number generator.
+            """
+
         def yield_from(self, fn: Callable[[Any], DataPipeline]) -> Self:
             """
             Map every example to a data pipeline and yield the examples returned
@@ -304,6 +487,80 @@ if TYPE_CHECKING or DOC_MODE:
         """Read each file in a zip archive"""
         ...
 
+    class FileCompression(Enum):
+        NONE = 0
+        GZIP = 1
+
+    def write_records(
+        pipeline: DataPipeline,
+        path: Path,
+        compression: FileCompression = FileCompression.NONE,
+        block_size: Optional[int] = None,
+    ) -> int:
+        """Drain ``pipeline`` and write its examples to ``path`` as records.
+
+        Each example must be a :class:`~fairseq2.memory.MemoryBlock` or a
+        ``str``, and is written as its size in bytes, a 64-bit little-endian
+        integer, followed by its bytes.
+
+        The file is written without holding the GIL by a background thread in
+        blocks of ``block_size`` bytes (1 MiB by default). The output goes to a
+        temporary file that is atomically renamed to ``path`` once the pipeline
+        is exhausted; if an error occurs, ``path`` is left untouched.
+
+        :param pipeline:
+            The pipeline to drain.
+        :param path:
+            The path of the output file.
+        :param compression:
+            The compression to apply to the output file.
+        :param block_size:
+            The size of the blocks handed to the background thread.
+
+        :returns:
+            The number of records written.
+        """
+        ...
+
+    def write_tensors(
+        pipeline: DataPipeline,
+        path: Path,
+        index_path: Optional[Path] = None,
+        compression: FileCompression = FileCompression.NONE,
+        block_size: Optional[int] = None,
+    ) -> int:
+        """Drain ``pipeline`` and write the elements of its tensors to ``path``.
+
+        The examples must be tensors of the same data type. Their elements are
+        written back to back in row-major order, so the file can be read with
+        :func:`numpy.fromfile` or :func:`torch.from_file`. The file is written
+        the same way as in :func:`write_records`.
+
+        :param pipeline:
+            The pipeline to drain.
+        :param path:
+            The path of the output file.
+        :param index_path:
+            If not ``None``, also writes an entry per tensor to the specified
+            path made of its element offset, its data type code, its number of
+            dimensions, and its size in each dimension, all as 64-bit
+            little-endian integers. The data type codes are 0 for
+            ``torch.bool``, 1 for ``torch.uint8``, 2 for ``torch.int8``, 3 for
+            ``torch.int16``, 4 for ``torch.int32``, 5 for ``torch.int64``, 6
+            for ``torch.float16``, 7 for ``torch.bfloat16``, 8 for
+            ``torch.float32``, and 9 for ``torch.float64``; other data types
+            are not supported. The index is never compressed and is written
+            after the data file.
+        :param compression:
+            The compression to apply to the output file.
+        :param block_size:
+            The size of the blocks handed to the background thread.
+
+        :returns:
+            The number of tensors written.
+        """
+        ...
+
     class CollateOptionsOverride:
         """Overrides how the collater should create batch for a particular column.
 
@@ -320,6 +577,10 @@ if TYPE_CHECKING or DOC_MODE:
             selector: str,
             pad_value: Optional[int] = None,
             pad_to_multiple: int = 1,
+            pack: bool = False,
+            padding_mask: bool = False,
+            segment_ids: bool = False,
+            position_ids: bool = False,
         ) -> None:
             ...
 
@@ -335,6 +596,22 @@ if TYPE_CHECKING or DOC_MODE:
         def pad_to_multiple(self) -> int:
             ...
 
+        @property
+        def pack(self) -> bool:
+            ...
+
+        @property
+        def padding_mask(self) -> bool:
+            ...
+
+        @property
+        def segment_ids(self) -> bool:
+            ...
+
+        @property
+        def position_ids(self) -> bool:
+            ...
+
     @final
     class Collater:
         """Concatenate a list of inputs into a single inputs.
@@ -367,6 +644,26 @@ if TYPE_CHECKING or DOC_MODE:
         :param overrides:
             List of overrides :py:class:`CollateOptionsOverride`.
             Allows to override ``pad_value`` and ``pad_to_multiple`` for specific columns.
+
+        :param pack:
+            If ``True``, the tensors are concatenated into a single row of shape
+            :math:`(1,S,*)` instead of being padded. ``seq_lens`` then holds the
+            total length and ``segment_lens`` the length of each input tensor.
+
+        :param padding_mask:
+            If ``True``, also returns a boolean ``padding_mask`` of shape
+            :math:`(N,S)` that is ``True`` at non-pad positions.
+
+        :param segment_ids:
+            If ``True``, also returns ``segment_ids`` of shape :math:`(N,S)`
+            holding for each position the index of its input tensor in the
+            bucket, or -1 for pad positions.
+
+        :param position_ids:
+            If ``True``, also returns ``position_ids`` of shape :math:`(N,S)`
+            holding for each position its offset within its input tensor, or 0
+            for pad positions. Combined with ``pack``, this makes the positions
+            restart at each packed tensor.
         """
 
         def __init__(
@@ -374,6 +671,10 @@ if TYPE_CHECKING or DOC_MODE:
             pad_value: Optional[int] = None,
             pad_to_multiple: int = 1,
             overrides: Optional[Sequence[CollateOptionsOverride]] = None,
+            pack: bool = False,
+            padding_mask: bool = False,
+            segment_ids: bool = False,
+            position_ids: bool = False,
         ) -> None:
             ...
 
@@ -381,6 +682,43 @@ if TYPE_CHECKING or DOC_MODE:
             """Concatenate the input tensors"""
             ...
 
+    @final
+    class DataHasher:
+        """Compute a stable 64-bit content hash of examples.
+
+        Unlike :func:`hash`, the returned value does not change across
+        processes or machines, so it can be used to deduplicate examples, key
+        caches, or verify that several ranks read the same batch. The keys of a
+        dictionary are hashed independent of their insertion order. Python
+        objects that are not natively supported by the data pipeline cannot be
+        hashed.
+
+        :param selector:
+            The columns to hash. If ``None``, the entire example is hashed.
+            See :ref:`reference/data:column syntax` for more details.
+        :param key:
+            If not ``None``, the example must be a dictionary and the hash is
+            stored under ``key`` instead of replacing the example.
+        :param seed:
+            The seed of the hash function.
+        """
+
+        def __init__(
+            self,
+            selector: Optional[str] = None,
+            key: Optional[str] = None,
+            seed: int = 0,
+        ) -> None:
+            ...
+
+        def hash(self, data: Any) -> int:
+            """Return the hash of ``data`` as an unsigned 64-bit integer."""
+            ...
+
+        def __call__(self, data: Any) -> Any:
+            """Return the hash of ``data`` as a signed 64-bit integer."""
+            ...
+
     @final
     class FileMapper:
         """For a given file name, returns the file content as bytes.
@@ -396,12 +734,20 @@ if TYPE_CHECKING or DOC_MODE:
             Enables an LRU cache on the last ``cached_fd_count`` files read.
             ``FileMapper`` will memory map all the cached file,
             so this is especially useful for reading several slices of the same file.
+
+        :param readahead:
+            If ``True``, hints the kernel (via ``MADV_WILLNEED``) to start
+            reading the returned bytes before they are first accessed. This is
+            only a hint; the kernel may read fewer pages or none, in which case
+            the accesses block on page faults as usual. The call itself stays
+            synchronous.
         """
 
         def __init__(
             self,
             root_dir: Optional[Path] = None,
             cached_fd_count: Optional[int] = None,
+            readahead: bool = False,
         ) -> None:
             ...
 
@@ -418,6 +764,62 @@ if TYPE_CHECKING or DOC_MODE:
             """
             ...
 
+    @final
+    class FileCache:
+        """Keep local copies of files that live on slow (e.g. network) storage.
+
+        Once set with :func:`set_file_cache`, every file read by the data
+        pipeline (e.g. by :class:`FileMapper` or ``read_text``) is copied as a
+        whole to ``cache_dir`` the first time it is opened and is read from
+        there afterwards, as long as its size and modification time do not
+        change. Once the total size of the cached files would exceed
+        ``max_size`` bytes, the least-recently-used ones are evicted.
+
+        Copies are populated atomically, so several processes on the same host
+        can share ``cache_dir``; in that case ``max_size`` is enforced
+        approximately. Files in ``cache_dir`` that were not created by the
+        cache are neither counted towards ``max_size`` nor evicted.
+
+        :param cache_dir:
+            The local directory to hold the cached files.
+        :param max_size:
+            The maximum total size of the cached files in bytes. Larger files
+            are never cached.
+        """
+
+        def __init__(self, cache_dir: Path, max_size: int) -> None:
+            ...
+
+        @property
+        def cache_dir(self) -> Path:
+            ...
+
+        @property
+        def max_size(self) -> int:
+            ...
+
+        @property
+        def num_hits(self) -> int:
+            """The number of files opened from the cache by this process."""
+
+        @property
+        def num_misses(self) -> int:
+            """The number of files opened from their original location by this
+            process."""
+
+    def get_file_cache() -> Optional[FileCache]:
+        """Return the file cache set with :func:`set_file_cache`, if any."""
+        ...
+
+    def set_file_cache(cache: Optional[FileCache]) -> None:
+        """Set the file cache used by all data pipelines of this process.
+
+        :param cache:
+            The cache to use. If ``None``, files are read from their original
+            location.
+        """
+        ...
+
     class ByteStreamError(RuntimeError):
         """Raised when a dataset file can't be read."""
 
@@ -430,6 +832,7 @@ else:
         CollateOptionsOverride as CollateOptionsOverride,
     )
     from fairseq2n.bindings.data.data_pipeline import Collater as Collater
+    from fairseq2n.bindings.data.data_pipeline import DataHasher as DataHasher
     from fairseq2n.bindings.data.data_pipeline import DataPipeline as DataPipeline
     from fairseq2n.bindings.data.data_pipeline import (
         DataPipelineBuilder as DataPipelineBuilder,
@@ -437,8 +840,13 @@ else:
     from fairseq2n.bindings.data.data_pipeline import (
         DataPipelineError as DataPipelineError,
     )
+    from fairseq2n.bindings.data.data_pipeline import (
+        FileCompression as FileCompression,
+    )
+    from fairseq2n.bindings.data.data_pipeline import FileCache as FileCache
     from fairseq2n.bindings.data.data_pipeline import FileMapper as FileMapper
     from fairseq2n.bindings.data.data_pipeline import RecordError as RecordError
+    from fairseq2n.bindings.data.data_pipeline import get_file_cache as get_file_cache
     from fairseq2n.bindings.data.data_pipeline import (
         get_last_failed_example as get_last_failed_example,
     )
@@ -447,21 +855,31 @@ else:
     from fairseq2n.bindings.data.data_pipeline import (
         read_zipped_records as read_zipped_records,
     )
+    from fairseq2n.bindings.data.data_pipeline import set_file_cache as set_file_cache
+    from fairseq2n.bindings.data.data_pipeline import write_records as write_records
+    from fairseq2n.bindings.data.data_pipeline import write_tensors as write_tensors
 
     def _set_module_name() -> None:
         ctypes = [
             ByteStreamError,
             CollateOptionsOverride,
             Collater,
+            DataHasher,
             DataPipeline,
             DataPipelineBuilder,
             DataPipelineError,
+            FileCache,
+            FileCompression,
             FileMapper,
             RecordError,
+            get_file_cache,
             get_last_failed_example,
             list_files,
             read_sequence,
             read_zipped_records,
+            set_file_cache,
+            write_records,
+            write_tensors,
         ]
 
         for t in ctypes:
@@ -474,6 +892,10 @@ class SequenceData(TypedDict):
     seqs: Tensor
     seq_lens: Tensor
     is_ragged: bool
+    segment_lens: NotRequired[Tensor]
+    padding_mask: NotRequired[Tensor]
+    segment_ids: NotRequired[Tensor]
+    position_ids: NotRequired[Tensor]
 
 
 class FileMapperOutput(TypedDict):
@@ -6,10 +6,11 @@
 
 from __future__ import annotations
 
-from typing import TYPE_CHECKING, Optional, TypedDict, final
+from typing import TYPE_CHECKING, List, Optional, TypedDict, Union, final
 
 from fairseq2n import DOC_MODE
 from torch import Tensor
+from typing_extensions import NotRequired
 
 from fairseq2.memory import MemoryBlock
 from fairseq2.typing import Device
@@ -22,10 +23,18 @@ if TYPE_CHECKING or DOC_MODE:
             self,
             device: Optional[Device] = None,
             pin_memory: bool = False,
+            random_crop: bool = False,
+            min_crop_scale: float = 0.08,
+            max_crop_scale: float = 1.0,
+            min_crop_ratio: float = 3.0 / 4.0,
+            max_crop_ratio: float = 4.0 / 3.0,
+            seed: Optional[int] = None,
         ) -> None:
             ...
 
-        def __call__(self, memory_block: MemoryBlock) -> ImageDecoderOutput:
+        def __call__(
+            self, image: Union[MemoryBlock, ImageDecoderInput]
+        ) -> ImageDecoderOutput:
             ...
 
 else:
@@ -38,6 +47,11 @@ else:
     _set_module_name()
 
 
+class ImageDecoderInput(TypedDict):
+    data: MemoryBlock
+    crop_box: NotRequired[List[int]]
+
+
 class ImageDecoderOutput(TypedDict):
     bit_depth: float
     color_type: float
@@ -45,3 +59,4 @@ class ImageDecoderOutput(TypedDict):
     height: float
     width: float
     image: Tensor
+    crop_box: NotRequired[List[int]]
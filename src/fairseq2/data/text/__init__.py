@@ -4,9 +4,17 @@
 # This source code is licensed under the BSD-style license found in the
 # LICENSE file in the root directory of this source tree.
 
+from fairseq2.data.text.converters import NormalizationForm as NormalizationForm
+from fairseq2.data.text.converters import RegexFilter as RegexFilter
+from fairseq2.data.text.converters import RegexReplacer as RegexReplacer
 from fairseq2.data.text.converters import StrSplitter as StrSplitter
 from fairseq2.data.text.converters import StrToIntConverter as StrToIntConverter
 from fairseq2.data.text.converters import StrToTensorConverter as StrToTensorConverter
+from fairseq2.data.text.converters import TextNormalizer as TextNormalizer
+from fairseq2.data.text.converters import VocabLookup as VocabLookup
+from fairseq2.data.text.converters import (
+    vocab_info_from_vocab_lookup as vocab_info_from_vocab_lookup,
+)
 from fairseq2.data.text.sentencepiece import (
     BasicSentencePieceTokenizer as BasicSentencePieceTokenizer,
 )
@@ -52,5 +60,6 @@ from fairseq2.data.text.text_tokenizer import load_text_tokenizer as load_text_t
 from fairseq2.data.text.text_tokenizer import (
     setup_text_tokenizer as setup_text_tokenizer,
 )
+from fairseq2.data.text.text_writer import write_text as write_text
 
 TextTokenizer = AbstractTextTokenizer  # compat
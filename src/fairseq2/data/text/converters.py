@@ -4,15 +4,77 @@
 # This source code is licensed under the BSD-style license found in the
 # LICENSE file in the root directory of this source tree.
 
-from typing import TYPE_CHECKING, Dict, List, Optional, Sequence, Union, final
+from enum import Enum
+from pathlib import Path
+from typing import TYPE_CHECKING, Any, Dict, List, Optional, Sequence, Union, final
 
 from fairseq2n import DOC_MODE
 from torch import Tensor
 
-from fairseq2.typing import DataType
+from fairseq2.data.vocabulary_info import VocabularyInfo
+from fairseq2.typing import DataType, Device
 
 if TYPE_CHECKING or DOC_MODE:
 
+    @final
+    class RegexFilter:
+        """Filter examples by matching their strings against a regular expression.
+
+        Meant to be passed to :meth:`DataPipelineBuilder.filter`. The pattern
+        uses the `RE2 <https://github.com/google/re2/wiki/Syntax>`_ syntax and
+        is matched in linear time without acquiring the GIL.
+
+        :param pattern:
+            The regular expression to search for in the strings.
+        :param selector:
+            The column(s) to match. If ``None``, the example itself must be a
+            string. An example matches if any of its selected strings matches.
+        :param exclude:
+            If ``True``, drops the matching examples instead of keeping them.
+
+        Example usage::
+
+            # Drop lines that contain a URL.
+            pipeline = read_text("file.txt").filter(RegexFilter(r"https?://", exclude=True))
+        """
+
+        def __init__(
+            self,
+            pattern: str,
+            selector: Optional[str] = None,
+            exclude: bool = False,
+        ) -> None:
+            ...
+
+        def __call__(self, data: Any) -> bool:
+            ...
+
+    @final
+    class RegexReplacer:
+        """Replace all matches of a regular expression in strings.
+
+        The pattern uses the `RE2 <https://github.com/google/re2/wiki/Syntax>`_
+        syntax. Strings with no match are returned without a copy.
+
+        :param pattern:
+            The regular expression to replace.
+        :param rewrite:
+            The replacement string. It can refer to capturing groups of
+            ``pattern`` as ``\\1`` to ``\\9``, and to the whole match as
+            ``\\0``.
+        :param selector:
+            The column(s) to apply the replacement to. If ``None``, the example
+            itself must be a string.
+        """
+
+        def __init__(
+            self, pattern: str, rewrite: str, selector: Optional[str] = None
+        ) -> None:
+            ...
+
+        def __call__(self, data: Any) -> Any:
+            ...
+
     @final
     class StrSplitter:
         """Split string on a given character.
@@ -72,7 +134,125 @@ if TYPE_CHECKING or DOC_MODE:
         def __call__(self, s: str) -> Tensor:
             ...
 
+    class NormalizationForm(Enum):
+        NFC = 0
+        NFKC = 1
+
+    @final
+    class TextNormalizer:
+        """Normalize strings to a Unicode normalization form.
+
+        :param form:
+            The Unicode normalization form to apply.
+        :param case_fold:
+            If ``True``, applies Unicode full case folding before normalizing.
+        :param collapse_whitespace:
+            If ``True``, replaces each run of whitespace with a single space and
+            strips leading and trailing whitespace.
+
+        Pure ASCII strings that are already normalized are returned as is
+        without any copy.
+        """
+
+        def __init__(
+            self,
+            form: NormalizationForm = NormalizationForm.NFC,
+            case_fold: bool = False,
+            collapse_whitespace: bool = False,
+        ) -> None:
+            ...
+
+        def __call__(self, s: str) -> str:
+            ...
+
+    @final
+    class VocabLookup:
+        """Map the words or the characters of strings to their vocabulary indices.
+
+        The vocabulary file has one token per line, and the index of a token is
+        its zero-based line number. Anything after the first tab character of a
+        line, such as a token frequency, is ignored.
+
+        :param path:
+            The path to the vocabulary file.
+        :param char_level:
+            If ``True``, looks up the UTF-8 code points of the input string;
+            otherwise, looks up the words separated by ``sep``.
+        :param sep:
+            The character that separates words. Consecutive separators are
+            treated as one.
+        :param unk_token:
+            The token to use for words or characters not in the vocabulary. If
+            ``None``, such inputs raise an error.
+        :param bos_token:
+            The beginning of sequence token.
+        :param eos_token:
+            The end of sequence token.
+        :param pad_token:
+            The padding token.
+        :param add_bos:
+            If ``True``, prepends ``bos_token`` to each sequence.
+        :param add_eos:
+            If ``True``, appends ``eos_token`` to each sequence.
+        :param device:
+            The device on which to construct the index tensors.
+        :param pin_memory:
+            If ``True``, uses pinned memory for the index tensors.
+
+        The input can also be a list of already split tokens.
+
+        Example usage::
+
+            lookup = VocabLookup("dict.txt", unk_token="<unk>", eos_token="</s>", add_eos=True)
+
+            pipeline = read_text("train.txt").map(lookup).and_return()
+        """
+
+        def __init__(
+            self,
+            path: Path,
+            char_level: bool = False,
+            sep: str = " ",
+            unk_token: Optional[str] = None,
+            bos_token: Optional[str] = None,
+            eos_token: Optional[str] = None,
+            pad_token: Optional[str] = None,
+            add_bos: bool = False,
+            add_eos: bool = False,
+            device: Optional[Device] = None,
+            pin_memory: bool = False,
+        ) -> None:
+            ...
+
+        def __call__(self, text: Union[str, Sequence[str]]) -> Tensor:
+            ...
+
+        def token_to_index(self, token: str) -> Optional[int]:
+            """Return the index of ``token``, or ``None`` if it is not in the vocabulary."""
+
+        @property
+        def unk_idx(self) -> Optional[int]:
+            ...
+
+        @property
+        def bos_idx(self) -> Optional[int]:
+            ...
+
+        @property
+        def eos_idx(self) -> Optional[int]:
+            ...
+
+        @property
+        def pad_idx(self) -> Optional[int]:
+            ...
+
+        @property
+        def vocabulary_size(self) -> int:
+            ...
+
 else:
+    from fairseq2n.bindings.data.text.converters import RegexFilter as RegexFilter
+    from fairseq2n.bindings.data.text.converters import RegexReplacer as RegexReplacer
     from fairseq2n.bindings.data.text.converters import StrSplitter as StrSplitter
     from fairseq2n.bindings.data.text.converters import (
         StrToIntConverter as StrToIntConverter,
@@ -81,8 +261,38 @@ else:
         StrToTensorConverter as StrToTensorConverter,
     )
 
+    from fairseq2n.bindings.data.text.converters import (
+        NormalizationForm as NormalizationForm,
+    )
+    from fairseq2n.bindings.data.text.converters import (
+        TextNormalizer as TextNormalizer,
+    )
+    from fairseq2n.bindings.data.text.converters import VocabLookup as VocabLookup
+
     def _set_module_name() -> None:
-        for t in [StrSplitter, StrToIntConverter, StrToTensorConverter]:
+        ctypes = [
+            NormalizationForm,
+            RegexFilter,
+            RegexReplacer,
+            StrSplitter,
+            StrToIntConverter,
+            StrToTensorConverter,
+            TextNormalizer,
+            VocabLookup,
+        ]
+
+        for t in ctypes:
             t.__module__ = __name__
 
     _set_module_name()
+
+
+def vocab_info_from_vocab_lookup(lookup: VocabLookup) -> VocabularyInfo:
+    """Return the vocabulary information of ``lookup``."""
+    return VocabularyInfo(
+        lookup.vocabulary_size,
+        lookup.unk_idx,
+        lookup.bos_idx,
+        lookup.eos_idx,
+        lookup.pad_idx,
+    )
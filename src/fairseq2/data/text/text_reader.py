@@ -6,7 +6,7 @@
 
 from enum import Enum
 from pathlib import Path
-from typing import TYPE_CHECKING, Optional
+from typing import TYPE_CHECKING, Optional, Union
 
 from fairseq2n import DOC_MODE
 
@@ -29,8 +29,32 @@ if TYPE_CHECKING or DOC_MODE:
         skip_empty: bool = False,
         memory_map: bool = False,
         block_size: Optional[int] = None,
+        num_parallel_scans: int = 1,
+        index: Union[bool, Path] = False,
+        shuffle: bool = False,
+        seed: Optional[int] = None,
     ) -> DataPipelineBuilder:
-        """Open a text file and return a data pipeline reading lines one by one."""
+        """Open a text file and return a data pipeline reading lines one by one.
+
+        :param num_parallel_scans:
+            If greater than one, memory maps the file and scans it for line
+            endings in parallel using the specified number of threads. Each
+            thread scans ``block_size`` bytes (16 MiB by default) at a time.
+            The lines are still returned in their original order. The file
+            must be UTF-8 encoded.
+        :param index:
+            If ``True`` or a path, reads the lines through a line offset index
+            stored at the specified path, or next to the file with an ``.idx``
+            suffix if ``True``. The index is built on first use, and rebuilt
+            if the file changes. The file must be UTF-8 encoded and is always
+            memory mapped. With an index, the position of the pipeline can be
+            restored without rescanning the file.
+        :param shuffle:
+            If ``True``, reads the lines in a random order. Requires ``index``.
+        :param seed:
+            The seed to initialize the random number generator used for
+            shuffling.
+        """
         ...
 
 else:
@@ -0,0 +1,58 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+from pathlib import Path
+from typing import TYPE_CHECKING, Optional
+
+from fairseq2n import DOC_MODE
+
+from fairseq2.data.data_pipeline import DataPipeline, FileCompression
+from fairseq2.data.text.text_reader import LineEnding
+
+if TYPE_CHECKING or DOC_MODE:
+
+    def write_text(
+        pipeline: DataPipeline,
+        path: Path,
+        key: Optional[str] = None,
+        line_ending: LineEnding = LineEnding.LF,
+        compression: FileCompression = FileCompression.NONE,
+        block_size: Optional[int] = None,
+    ) -> int:
+        """Drain ``pipeline`` and write its examples to ``path`` line by line.
+
+        The file is written without holding the GIL by a background thread,
+        and is atomically renamed to ``path`` once the pipeline is exhausted.
+        See :func:`~fairseq2.data.write_records` for details.
+
+        :param pipeline:
+            The pipeline to drain. Its examples must be strings.
+        :param path:
+            The path of the output file.
+        :param key:
+            If not ``None``, the examples must be dicts and their string at
+            ``key`` is written instead.
+        :param line_ending:
+            The line ending to append to each line. Must be ``LF`` or
+            ``CRLF``.
+        :param compression:
+            The compression to apply to the output file.
+        :param block_size:
+            The size of the blocks handed to the background thread.
+
+        :returns:
+            The number of lines written.
+        """
+        ...
+
+else:
+    from fairseq2n.bindings.data.text.text_writer import write_text as write_text
+
+    def _set_module_name() -> None:
+        for t in [write_text]:
+            t.__module__ = __name__
+
+    _set_module_name()
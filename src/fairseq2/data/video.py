@@ -0,0 +1,48 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+from __future__ import annotations
+
+from typing import TYPE_CHECKING, Optional, TypedDict, final
+
+from fairseq2n import DOC_MODE
+from torch import Tensor
+
+from fairseq2.memory import MemoryBlock
+from fairseq2.typing import Device
+
+if TYPE_CHECKING or DOC_MODE:
+
+    @final
+    class VideoDecoder:
+        def __init__(
+            self,
+            num_frames: int = 8,
+            random_sampling: bool = False,
+            device: Optional[Device] = None,
+            pin_memory: bool = False,
+            seed: Optional[int] = None,
+        ) -> None:
+            ...
+
+        def __call__(self, video: MemoryBlock) -> VideoDecoderOutput:
+            ...
+
+else:
+    from fairseq2n.bindings.data.video import VideoDecoder as VideoDecoder
+
+    def _set_module_name() -> None:
+        for t in [VideoDecoder]:
+            t.__module__ = __name__
+
+    _set_module_name()
+
+
+class VideoDecoderOutput(TypedDict):
+    video: Tensor
+    timestamps: Tensor
+    frame_rate: float
+    duration: float
@@ -5,12 +5,36 @@
 # LICENSE file in the root directory of this source tree.
 
 import sys
-from typing import List, Optional, Protocol, Sequence, final
+from typing import TYPE_CHECKING, List, Optional, Protocol, Sequence, final
 
 import torch
+from fairseq2n import DOC_MODE
 from torch import Tensor
 from torch.nn.functional import pad
 
+if TYPE_CHECKING or DOC_MODE:
+
+    def _block_ngram_repeats(
+        seqs: Tensor, probs: Tensor, ngram_size: int, lprob: bool = False
+    ) -> None:
+        ...
+
+    @final
+    class _BannedSequenceTable:
+        def __init__(self, banned_seqs: Sequence[Tensor]) -> None:
+            ...
+
+        def ban(self, seqs: Tensor, probs: Tensor, lprob: bool = False) -> None:
+            ...
+
+else:
+    from fairseq2n.bindings.generation import (
+        BannedSequenceTable as _BannedSequenceTable,
+    )
+    from fairseq2n.bindings.generation import (
+        block_ngram_repeats as _block_ngram_repeats,
+    )
+
 
 class StepProcessor(Protocol):
     """Processes next-step probabilities during sequence generation."""
@@ -36,6 +60,7 @@ class BannedSequenceProcessor(StepProcessor):
 
     _banned_seqs: Optional[Tensor]
     _banned_mask: Optional[Tensor]
+    _banned_table: Optional[_BannedSequenceTable]
 
     def __init__(self, banned_seqs: Sequence[Tensor]) -> None:
         """
@@ -47,6 +72,7 @@ class BannedSequenceProcessor(StepProcessor):
         if batch_size == 0:
             self._banned_seqs = None
             self._banned_mask = None
+            self._banned_table = None
 
             return
 
@@ -87,10 +113,19 @@ class BannedSequenceProcessor(StepProcessor):
                 self._banned_seqs[row, -seq_lens[row] :] = seq
                 self._banned_mask[row, -seq_lens[row] :] = False
 
+        # On CPU, the native table matches the prefixes by hash in parallel over
+        # the batch instead of comparing them against every banned sequence.
+        self._banned_table = _BannedSequenceTable(banned_seqs)
+
     def __call__(self, seqs: Tensor, probs: Tensor, lprob: bool = False) -> None:
         if self._banned_seqs is None:
             return
 
+        if self._banned_table is not None and probs.device.type == "cpu":
+            self._banned_table.ban(seqs, probs, lprob)
+
+            return
+
         ban_value = -torch.inf if lprob else 0
 
         banned_prefix_len = self._banned_seqs.size(1) - 1
@@ -151,6 +186,11 @@ class NGramRepeatBlockProcessor(StepProcessor):
         if ngram_size >= seq_len:
             return
 
+        if probs.device.type == "cpu":
+            _block_ngram_repeats(seqs, probs, ngram_size, lprob)
+
+            return
+
         # This is an edge case where we do not allow any of the previous values.
         if ngram_size == 1:
             # (N, 1)
@@ -0,0 +1,159 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import wave
+from pathlib import Path
+
+import pytest
+import torch
+from torch import Tensor
+
+from fairseq2.data import read_sequence
+from fairseq2.data.audio import AudioAugmenter
+from tests.common import assert_close
+
+
+def write_wav(path: Path, samples: Tensor, sample_rate: int = 16_000) -> None:
+    pcm = (samples.clamp(-1.0, 1.0) * 32767).to(torch.int16)
+
+    with wave.open(str(path), "wb") as f:
+        f.setnchannels(1)
+        f.setsampwidth(2)
+        f.setframerate(sample_rate)
+        f.writeframes(pcm.numpy().tobytes())
+
+
+def make_speech(num_samples: int = 16_000) -> Tensor:
+    t = torch.arange(num_samples, dtype=torch.float32) / 16_000
+
+    return 0.5 * torch.sin(2 * torch.pi * 200 * t)
+
+
+class TestAudioAugmenter:
+    def test_call_adds_noise_at_snr(self, tmp_path: Path) -> None:
+        noise_path = tmp_path.joinpath("noise.wav")
+
+        write_wav(noise_path, torch.rand((40_000,)) - 0.5)
+
+        augmenter = AudioAugmenter([str(noise_path)], min_snr=10.0, max_snr=10.0)
+
+        waveform = make_speech()
+
+        expected_waveform = waveform.clone()
+
+        augmenter({"waveform": waveform, "sample_rate": 16_000})
+
+        # The waveform is modified in place.
+        noise = waveform - expected_waveform
+
+        signal_power = expected_waveform.square().mean()
+
+        noise_power = noise.square().mean()
+
+        snr = 10 * torch.log10(signal_power / noise_power)
+
+        assert abs(snr.item() - 10.0) < 1e-3
+
+    def test_call_loops_short_noise_clips(self, tmp_path: Path) -> None:
+        noise_path = tmp_path.joinpath("noise.wav")
+
+        write_wav(noise_path, torch.rand((3_000,)) - 0.5)
+
+        augmenter = AudioAugmenter([str(noise_path)])
+
+        waveform = make_speech().unsqueeze(0)
+
+        expected_waveform = waveform.clone()
+
+        augmenter({"waveform": waveform, "sample_rate": 16_000})
+
+        noise = waveform - expected_waveform
+
+        torch.testing.assert_close(  # type: ignore[attr-defined]
+            noise[:, :3_000], noise[:, 3_000:6_000], atol=1e-5, rtol=0
+        )
+
+    def test_call_adds_reverb(self, tmp_path: Path) -> None:
+        rir = torch.zeros((800,))
+
+        rir[10] = 0.5
+
+        rir_path = tmp_path.joinpath("rir.wav")
+
+        write_wav(rir_path, rir)
+
+        augmenter = AudioAugmenter(rir_pathnames=[str(rir_path)])
+
+        waveform = make_speech()
+
+        expected_waveform = waveform.clone()
+
+        augmenter({"waveform": waveform, "sample_rate": 16_000})
+
+        # A single impulse is an identity once normalized and aligned with the
+        # direct path.
+        torch.testing.assert_close(  # type: ignore[attr-defined]
+            waveform, expected_waveform, atol=1e-5, rtol=0
+        )
+
+    def test_call_is_reproducible_when_seed_is_specified(self, tmp_path: Path) -> None:
+        noise_paths = []
+
+        for i in range(4):
+            noise_path = tmp_path.joinpath(f"noise{i}.wav")
+
+            write_wav(noise_path, torch.rand((20_000,)) - 0.5)
+
+            noise_paths.append(str(noise_path))
+
+        def augment() -> Tensor:
+            augmenter = AudioAugmenter(noise_paths, seed=2)
+
+            pipeline = (
+                read_sequence([make_speech() for _ in range(4)])
+                .map(lambda w: {"waveform": w, "sample_rate": 16_000})
+                .map(augmenter)
+                .and_return()
+            )
+
+            return torch.stack([e["waveform"] for e in pipeline])
+
+        assert_close(augment(), augment())
+
+    def test_call_raises_error_when_sample_rates_do_not_match(
+        self, tmp_path: Path
+    ) -> None:
+        noise_path = tmp_path.joinpath("noise.wav")
+
+        write_wav(noise_path, torch.rand((1000,)) - 0.5, sample_rate=8_000)
+
+        augmenter = AudioAugmenter([str(noise_path)])
+
+        with pytest.raises(
+            ValueError,
+            match=r"must match the sample rate of the input waveform \(16000\), but is 8000 instead\.$",
+        ):
+            augmenter({"waveform": make_speech(), "sample_rate": 16_000})
+
+    def test_init_raises_error_when_no_clip_is_specified(self) -> None:
+        with pytest.raises(
+            ValueError,
+            match=r"^`noise_pathnames` and `rir_pathnames` must not be both empty\.$",
+        ):
+            AudioAugmenter()
+
+    def test_init_raises_error_when_max_snr_is_less_than_min_snr(
+        self, tmp_path: Path
+    ) -> None:
+        noise_path = tmp_path.joinpath("noise.wav")
+
+        write_wav(noise_path, torch.rand((1000,)) - 0.5)
+
+        with pytest.raises(
+            ValueError,
+            match=r"^`max_snr` must be greater than or equal to `min_snr` \(10\), but is 5 instead\.$",
+        ):
+            AudioAugmenter([str(noise_path)], min_snr=10.0, max_snr=5.0)
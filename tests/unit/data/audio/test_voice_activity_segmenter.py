@@ -0,0 +1,129 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import math
+from typing import List, Tuple
+
+import pytest
+import torch
+from torch import Tensor
+
+from fairseq2.data import read_sequence
+from fairseq2.data.audio import VoiceActivitySegmenter
+from tests.common import assert_equal
+
+
+def make_waveform(parts: List[Tuple[float, float]]) -> Tensor:
+    """Concatenates 200 Hz sine tones of the specified (duration, amplitude)."""
+    pieces = []
+
+    for duration, amplitude in parts:
+        t = torch.arange(int(duration * 16_000), dtype=torch.float32) / 16_000
+
+        pieces.append(amplitude * torch.sin(2 * math.pi * 200 * t))
+
+    return torch.cat(pieces)
+
+
+class TestVoiceActivitySegmenter:
+    def test_call_works(self) -> None:
+        parts = [
+            (1.0, 0.0),
+            (2.0, 0.5),
+            (1.0, 0.0),
+            (0.1, 0.5),
+            (1.0, 0.0),
+            (1.0, 0.5),
+            (0.5, 0.0),
+        ]
+
+        waveform = make_waveform(parts)
+
+        segmenter = VoiceActivitySegmenter()
+
+        segments = list(segmenter({"waveform": waveform, "sample_rate": 16_000}))
+
+        # The 100 ms burst is shorter than `min_segment_duration`.
+        assert len(segments) == 2
+
+        offsets = [(s["start_sample"], s["end_sample"]) for s in segments]
+
+        assert offsets == [(14_400, 49_600), (80_000, 99_200)]
+
+        for segment in segments:
+            assert segment["sample_rate"] == 16_000
+
+            start, end = segment["start_sample"], segment["end_sample"]
+
+            assert_equal(segment["waveform"], waveform[start:end])
+
+    def test_call_works_in_yield_from(self) -> None:
+        waveform = make_waveform([(0.5, 0.0), (1.0, 0.5), (1.0, 0.0)])
+
+        segmenter = VoiceActivitySegmenter()
+
+        example = {"waveform": waveform.unsqueeze(0), "sample_rate": 16_000, "id": 3}
+
+        pipeline = read_sequence([example]).yield_from(segmenter).and_return()
+
+        for _ in range(2):
+            segments = list(pipeline)
+
+            assert len(segments) == 1
+
+            segment = segments[0]
+
+            assert segment["id"] == 3
+
+            assert segment["waveform"].shape == (1, 16_000 + 2 * 1_600)
+
+            assert segment["start_sample"] == 6_400
+            assert segment["end_sample"] == 25_600
+
+            pipeline.reset()
+
+    def test_call_splits_long_segments(self) -> None:
+        waveform = make_waveform([(0.5, 0.0), (2.5, 0.5), (0.5, 0.0)])
+
+        segmenter = VoiceActivitySegmenter(max_segment_duration=1.0)
+
+        segments = list(segmenter({"waveform": waveform, "sample_rate": 16_000}))
+
+        assert len(segments) == 3
+
+        # The pieces of a split segment are contiguous.
+        for prev, curr in zip(segments, segments[1:]):
+            assert prev["end_sample"] == curr["start_sample"]
+
+        assert segments[0]["start_sample"] == 6_400
+        assert segments[-1]["end_sample"] == 49_600
+
+    def test_call_returns_no_segments_when_audio_is_silent(self) -> None:
+        waveform = torch.zeros((32_000,))
+
+        segmenter = VoiceActivitySegmenter()
+
+        segments = list(segmenter({"waveform": waveform, "sample_rate": 16_000}))
+
+        assert segments == []
+
+    def test_init_raises_error_when_end_threshold_is_greater_than_start_threshold(
+        self,
+    ) -> None:
+        with pytest.raises(
+            ValueError,
+            match=r"^`end_threshold` must be less than or equal to `start_threshold` \(-35\), but is -30 instead\.$",
+        ):
+            VoiceActivitySegmenter(end_threshold=-30.0)
+
+    def test_call_raises_error_when_input_is_not_dict(self) -> None:
+        segmenter = VoiceActivitySegmenter()
+
+        with pytest.raises(
+            ValueError,
+            match=r"^The input data must be of type `dict` containing a waveform tensor and its sample rate, but is of type `int` instead\.$",
+        ):
+            segmenter(1)  # type: ignore[arg-type]
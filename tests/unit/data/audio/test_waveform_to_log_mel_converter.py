@@ -0,0 +1,139 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import math
+from pathlib import Path
+from typing import Final
+
+import pytest
+import torch
+from torch import Tensor
+
+from fairseq2.data.audio import (
+    AudioDecoder,
+    AudioDecoderOutput,
+    WaveformToLogMelConverter,
+)
+from fairseq2.memory import MemoryBlock
+from tests.common import device
+
+TEST_OGG_PATH: Final = Path(__file__).parent.joinpath("test.ogg")
+
+
+class TestWaveformToLogMelConverter:
+    def test_call_works(self) -> None:
+        audio = self.get_audio()
+
+        converter = WaveformToLogMelConverter(channel_last=True)
+
+        output = converter(audio)
+
+        log_mel = output["log_mel"]
+
+        num_samples = audio["waveform"].size(0)
+
+        assert log_mel.dtype == torch.float32
+
+        assert log_mel.shape == (num_samples // 160, 80)
+
+    def test_call_matches_whisper(self) -> None:
+        audio = self.get_audio()
+
+        converter = WaveformToLogMelConverter(channel_last=True)
+
+        log_mel = converter(audio)["log_mel"]
+
+        expected_log_mel = self.compute_reference(audio["waveform"].squeeze(-1))
+
+        torch.testing.assert_close(  # type: ignore[attr-defined]
+            log_mel, expected_log_mel, rtol=1e-4, atol=1e-4
+        )
+
+    def test_call_works_when_keep_waveform_is_true(self) -> None:
+        audio = self.get_audio()
+
+        converter = WaveformToLogMelConverter(channel_last=True, keep_waveform=True)
+
+        output = converter(audio)
+
+        assert "waveform" in output
+
+    def test_call_raises_error_when_waveform_has_multiple_channels(self) -> None:
+        converter = WaveformToLogMelConverter()
+
+        waveform = torch.zeros((2, 1000), device=device)
+
+        with pytest.raises(
+            ValueError,
+            match=r"^The input waveform must have a single channel, but has 2 channels instead\.$",
+        ):
+            converter({"waveform": waveform, "sample_rate": 16000.0})
+
+    def test_init_raises_error_when_hop_length_is_not_positive(self) -> None:
+        with pytest.raises(
+            ValueError,
+            match=r"^`hop_length` must be greater than 0, but is 0 instead\.$",
+        ):
+            WaveformToLogMelConverter(hop_length=0)
+
+    @staticmethod
+    def compute_reference(waveform: Tensor) -> Tensor:
+        # The reference implementation of Whisper, with the mel filters of
+        # `librosa.filters.mel()`, i.e. Slaney-style mel scale and area
+        # normalization.
+        waveform = waveform.cpu().float()
+
+        window = torch.hann_window(400)
+
+        stft = torch.stft(waveform, 400, 160, window=window, return_complex=True)
+
+        magnitudes = stft[..., :-1].abs() ** 2
+
+        def hz_to_mel(hz: float) -> float:
+            if hz < 1000.0:
+                return hz * 3.0 / 200.0
+
+            return 15.0 + math.log(hz / 1000.0) / (math.log(6.4) / 27.0)
+
+        def mel_to_hz(mel: float) -> float:
+            if mel < 15.0:
+                return mel * 200.0 / 3.0
+
+            return 1000.0 * math.exp((math.log(6.4) / 27.0) * (mel - 15.0))
+
+        mel_step = hz_to_mel(8000.0) / 81
+
+        mel_freqs = torch.tensor(
+            [mel_to_hz(i * mel_step) for i in range(82)], dtype=torch.float64
+        )
+
+        fft_freqs = torch.arange(201, dtype=torch.float64) * (16000.0 / 400)
+
+        lower = (fft_freqs - mel_freqs[:-2, None]) / mel_freqs.diff()[:-1, None]
+        upper = (mel_freqs[2:, None] - fft_freqs) / mel_freqs.diff()[1:, None]
+
+        filters = torch.clamp(torch.minimum(lower, upper), min=0.0)
+
+        filters *= (2.0 / (mel_freqs[2:] - mel_freqs[:-2]))[:, None]
+
+        mel_spec = filters.float() @ magnitudes
+
+        log_spec = torch.clamp(mel_spec, min=1e-10).log10()
+
+        log_spec = torch.maximum(log_spec, log_spec.max() - 8.0)
+
+        log_spec = (log_spec + 4.0) / 4.0
+
+        return log_spec.transpose(0, 1).to(device)
+
+    @staticmethod
+    def get_audio() -> AudioDecoderOutput:
+        decoder = AudioDecoder(dtype=torch.float32, device=device)
+
+        with TEST_OGG_PATH.open("rb") as fb:
+            block = MemoryBlock(fb.read())
+
+        return decoder(block)
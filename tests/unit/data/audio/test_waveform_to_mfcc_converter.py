@@ -0,0 +1,134 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import math
+from pathlib import Path
+from typing import Final
+
+import pytest
+import torch
+from torch import Tensor
+
+from fairseq2.data.audio import (
+    AudioDecoder,
+    AudioDecoderOutput,
+    WaveformToMfccConverter,
+)
+from fairseq2.memory import MemoryBlock
+from tests.common import device
+
+TEST_OGG_PATH: Final = Path(__file__).parent.joinpath("test.ogg")
+
+
+class TestWaveformToMfccConverter:
+    def test_call_works(self) -> None:
+        audio = self.get_audio()
+
+        converter = WaveformToMfccConverter(channel_last=True)
+
+        output = converter(audio)
+
+        mfcc = output["mfcc"]
+
+        assert mfcc.dtype == torch.float32
+
+        assert mfcc.shape == (178, 13)
+
+    def test_call_matches_kaldi(self) -> None:
+        audio = self.get_audio()
+
+        converter = WaveformToMfccConverter(channel_last=True)
+
+        mfcc = converter(audio)["mfcc"]
+
+        expected_mfcc = self.compute_reference(audio["waveform"].squeeze(-1))
+
+        torch.testing.assert_close(  # type: ignore[attr-defined]
+            mfcc.cpu(), expected_mfcc, rtol=1e-3, atol=1e-2
+        )
+
+    def test_call_works_when_standardize_is_true(self) -> None:
+        audio = self.get_audio()
+
+        converter = WaveformToMfccConverter(channel_last=True, standardize=True)
+
+        mfcc = converter(audio)["mfcc"]
+
+        assert mfcc.mean() == pytest.approx(0.0, abs=0.001)
+
+    def test_init_raises_error_when_num_ceps_is_greater_than_num_mel_bins(
+        self,
+    ) -> None:
+        with pytest.raises(
+            ValueError,
+            match=r"^`num_ceps` must be greater than 0 and less than or equal to `num_mel_bins` \(23\), but is 24 instead\.$",
+        ):
+            WaveformToMfccConverter(num_ceps=24)
+
+    @staticmethod
+    def compute_reference(waveform: Tensor) -> Tensor:
+        # The algorithm of Kaldi's `compute-mfcc-feats` with its default
+        # options, except that the energy is not used in place of C0. int16
+        # samples are converted to float without scaling, as Kaldi expects.
+        waveform = waveform.cpu().double()
+
+        # 25ms frames with a shift of 10ms; partial frames are dropped.
+        frames = waveform.unfold(0, 400, 160)
+
+        frames = frames - frames.mean(dim=-1, keepdim=True)
+
+        # Pre-emphasis, where the first sample is treated as its own
+        # predecessor.
+        frames = frames - 0.97 * torch.cat([frames[:, :1], frames[:, :-1]], dim=-1)
+
+        # The Povey window.
+        window = torch.hann_window(400, periodic=False, dtype=torch.float64) ** 0.85
+
+        power_spec = torch.fft.rfft(frames * window, n=512).abs() ** 2
+
+        def hz_to_mel(hz: Tensor) -> Tensor:
+            return 1127.0 * torch.log1p(hz / 700.0)
+
+        # 23 triangular filters, equally spaced on the mel scale between 20Hz
+        # and the Nyquist frequency. The Nyquist bin is not used.
+        mel_low = hz_to_mel(torch.tensor(20.0, dtype=torch.float64))
+        mel_high = hz_to_mel(torch.tensor(8000.0, dtype=torch.float64))
+
+        mel_delta = (mel_high - mel_low) / 24
+
+        mel_edges = mel_low + torch.arange(25, dtype=torch.float64) * mel_delta
+
+        fft_mels = hz_to_mel(torch.arange(256, dtype=torch.float64) * (16000.0 / 512))
+
+        lower = (fft_mels - mel_edges[:-2, None]) / mel_delta
+        upper = (mel_edges[2:, None] - fft_mels) / mel_delta
+
+        filters = torch.clamp(torch.minimum(lower, upper), min=0.0)
+
+        fbank = power_spec[:, :256] @ filters.transpose(0, 1)
+
+        fbank = torch.clamp(fbank, min=torch.finfo(torch.float32).eps).log()
+
+        # The orthonormal DCT-II, followed by the cepstral lifter.
+        n = torch.arange(23, dtype=torch.float64)
+        k = torch.arange(13, dtype=torch.float64)
+
+        dct = torch.cos(math.pi / 23 * (n[:, None] + 0.5) * k) * math.sqrt(2.0 / 23)
+
+        dct[:, 0] = math.sqrt(1.0 / 23)
+
+        lifter = 1.0 + 11.0 * torch.sin(math.pi * k / 22.0)
+
+        return ((fbank @ dct) * lifter).float()
+
+    @staticmethod
+    def get_audio() -> AudioDecoderOutput:
+        decoder = AudioDecoder(dtype=torch.int16, device=device)
+
+        with TEST_OGG_PATH.open("rb") as fb:
+            block = MemoryBlock(fb.read())
+
+        return decoder(block)
@@ -4,6 +4,10 @@
 # This source code is licensed under the BSD-style license found in the
 # LICENSE file in the root directory of this source tree.
 
+import asyncio
+import time
+from typing import Any, List
+
 import pytest
 
 from fairseq2.data import DataPipelineError, get_last_failed_example, read_sequence
@@ -109,6 +113,127 @@ class TestDataPipeline:
 
         assert run_count == max_num_warnings + 1
 
+    def test_async_iteration_works(self) -> None:
+        seq: List[Any] = [1, (2, 3), "foo", {"a": 4}]
+
+        pipeline = read_sequence(seq).and_return()
+
+        async def read() -> List[Any]:
+            return [e async for e in pipeline]
+
+        for _ in range(2):
+            assert asyncio.run(read()) == seq
+
+            pipeline.reset()
+
+    def test_async_iteration_does_not_block_event_loop(self) -> None:
+        def slow(d: int) -> int:
+            time.sleep(0.05)
+
+            return d
+
+        pipeline = read_sequence([1, 2, 3]).map(slow).and_return()
+
+        num_ticks = 0
+
+        async def tick() -> None:
+            nonlocal num_ticks
+
+            while True:
+                await asyncio.sleep(0.001)
+
+                num_ticks += 1
+
+        async def read() -> List[int]:
+            ticker = asyncio.create_task(tick())
+
+            output = [e async for e in pipeline]
+
+            ticker.cancel()
+
+            return output
+
+        assert asyncio.run(read()) == [1, 2, 3]
+
+        assert num_ticks > 10
+
+    def test_async_iteration_does_not_lose_example_when_cancelled(self) -> None:
+        def slow(d: int) -> int:
+            time.sleep(0.05)
+
+            return d
+
+        pipeline = read_sequence([1, 2, 3]).map(slow).and_return()
+
+        async def read() -> List[int]:
+            it = pipeline.__aiter__()
+
+            with pytest.raises(asyncio.TimeoutError):
+                await asyncio.wait_for(it.__anext__(), timeout=0.001)
+
+            return [e async for e in it]
+
+        assert asyncio.run(read()) == [1, 2, 3]
+
+    def test_async_iteration_can_be_closed_while_reading(self) -> None:
+        def slow(d: int) -> int:
+            time.sleep(0.2)
+
+            return d
+
+        pipeline = read_sequence([1, 2, 3]).map(slow).and_return()
+
+        async def read() -> None:
+            it = pipeline.__aiter__()
+
+            assert await it.__anext__() == 1
+
+            # Start reading the second example and abandon the wait while
+            # `slow` is still running.
+            with pytest.raises(asyncio.TimeoutError):
+                await asyncio.wait_for(it.__anext__(), timeout=0.01)
+
+            start_time = time.perf_counter()
+
+            closed = it.aclose()
+
+            # Closing must not wait for `slow` to return.
+            assert time.perf_counter() - start_time < 0.1
+
+            await closed
+
+            with pytest.raises(StopAsyncIteration):
+                await it.__anext__()
+
+        asyncio.run(read())
+
+        pipeline.reset()
+
+        assert list(pipeline) == [1, 2, 3]
+
+    def test_async_iteration_sets_last_failed_example(self) -> None:
+        def fn(d: int) -> bool:
+            if d == 3:
+                raise ValueError("foo")
+
+            return True
+
+        pipeline = read_sequence([3, 4]).filter(fn).and_return()
+
+        async def read() -> None:
+            it = pipeline.__aiter__()
+
+            with pytest.raises(DataPipelineError):
+                await it.__anext__()
+
+            assert get_last_failed_example() == 3
+
+            assert await it.__anext__() == 4
+
+            assert get_last_failed_example() is None
+
+        asyncio.run(read())
+
     def test_load_state_dict_raises_error_when_tape_is_corrupt(self) -> None:
         seq = [1, 2, 3, 4, 5]
 
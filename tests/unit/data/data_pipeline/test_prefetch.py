@@ -4,7 +4,9 @@
 # This source code is licensed under the BSD-style license found in the
 # LICENSE file in the root directory of this source tree.
 
+import time
 from itertools import islice
+from typing import List
 
 import pytest
 
@@ -34,6 +36,60 @@ class TestPrefetchOp:
 
             pipeline.reset()
 
+    @pytest.mark.parametrize("num_examples", [1, 4, 20])
+    def test_op_works_after_reset_when_upstream_work_is_cancelled(
+        self, num_examples: int
+    ) -> None:
+        seq = list(range(1, 100))
+
+        # Resetting cancels the in-flight work of both prefetch threads and of
+        # the parallel map; the pipeline must still be usable afterwards.
+        pipeline = (
+            read_sequence(seq)
+            .map(lambda d: d, num_parallel_calls=4)
+            .prefetch(num_examples)
+            .map(lambda d: d * 2, num_parallel_calls=4)
+            .prefetch(num_examples)
+            .and_return()
+        )
+
+        for _ in range(2):
+            assert list(islice(pipeline, 50)) == [d * 2 for d in seq[:50]]
+
+            pipeline.reset()
+
+        assert list(pipeline) == [d * 2 for d in seq]
+
+    def test_op_cancels_upstream_work_on_reset(self) -> None:
+        calls: List[int] = []
+
+        def slow_fn(d: int) -> int:
+            calls.append(d)
+
+            time.sleep(0.01)
+
+            return d
+
+        # The prefetch thread maps the first batch of 100 examples and, since
+        # its queue has room, immediately starts mapping the second one.
+        pipeline = (
+            read_sequence(list(range(300)))
+            .map(slow_fn, num_parallel_calls=100)
+            .prefetch(200)
+            .and_return()
+        )
+
+        it = iter(pipeline)
+
+        assert next(it) == 0
+
+        pipeline.reset()
+
+        # Without cancellation, `reset()` would wait for the whole second batch
+        # to be mapped. With it, at most the calls that were already running on
+        # the worker threads complete.
+        assert 100 <= len(calls) < 200
+
     @pytest.mark.parametrize("num_examples", [0, 1, 4, 20])
     def test_op_works_when_no_data_is_specified(self, num_examples: int) -> None:
         pipeline = read_sequence([]).prefetch(num_examples).and_return()
@@ -0,0 +1,134 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import pytest
+
+from fairseq2.data import DataPipelineError, read_sequence
+
+
+class TestRestoreOrderOp:
+    def test_op_works(self) -> None:
+        seq = [{"index": i} for i in [2, 0, 1, 5, 3, 4]]
+
+        pipeline = read_sequence(seq).restore_order(max_num_buffered=2).and_return()
+
+        for _ in range(2):
+            assert [e["index"] for e in pipeline] == [0, 1, 2, 3, 4, 5]
+
+            pipeline.reset()
+
+    def test_op_works_when_examples_are_batched(self) -> None:
+        seq = [[{"index": 3}, {"index": 1}], [{"index": 2}, {"index": 0}]]
+
+        pipeline = read_sequence(seq).restore_order(max_num_buffered=4).and_return()
+
+        assert [e["index"] for e in pipeline] == [0, 1, 2, 3]
+
+    def test_op_works_when_index_selector_is_specified(self) -> None:
+        seq = [{"meta": {"idx": i}, "value": i * 10} for i in [1, 0, 2]]
+
+        pipeline = read_sequence(seq).restore_order(2, "meta.idx").and_return()
+
+        assert [e["value"] for e in pipeline] == [0, 10, 20]
+
+    def test_op_works_when_indices_have_gaps(self) -> None:
+        seq = [{"index": i} for i in [4, 1, 6, 3]]
+
+        pipeline = read_sequence(seq).restore_order(max_num_buffered=4).and_return()
+
+        assert [e["index"] for e in pipeline] == [1, 3, 4, 6]
+
+    def test_op_works_when_max_num_buffered_is_specified(self) -> None:
+        # Index 0 never arrives, so the op skips it once two examples are
+        # buffered instead of waiting for the end of the data pipeline.
+        seq = [{"index": i} for i in [2, 1, 3, 4]]
+
+        pipeline = read_sequence(seq).restore_order(max_num_buffered=2).and_return()
+
+        it = iter(pipeline)
+
+        assert next(it)["index"] == 1
+
+        assert [e["index"] for e in it] == [2, 3, 4]
+
+    def test_op_saves_and_restores_its_state(self) -> None:
+        seq = [{"index": i} for i in [1, 0, 3, 2, 5, 4]]
+
+        pipeline = read_sequence(seq).restore_order(max_num_buffered=2).and_return()
+
+        d = None
+
+        it = iter(pipeline)
+
+        # Move to the third example.
+        for _ in range(3):
+            d = next(it)
+
+        assert d == {"index": 2}
+
+        state_dict = pipeline.state_dict()
+
+        # Read a few examples before we roll back.
+        for _ in range(2):
+            d = next(it)
+
+        assert d == {"index": 4}
+
+        # Expected to roll back to the third example.
+        pipeline.load_state_dict(state_dict)
+
+        assert [e["index"] for e in it] == [3, 4, 5]
+
+    def test_op_raises_error_when_index_is_duplicate(self) -> None:
+        seq = [{"index": 1}, {"index": 1}]
+
+        pipeline = read_sequence(seq).restore_order(max_num_buffered=2).and_return()
+
+        with pytest.raises(
+            DataPipelineError,
+            match=r"^The original index of each example must be unique, but the index 1 has already been seen\.$",
+        ):
+            next(iter(pipeline))
+
+    def test_op_raises_error_when_index_is_duplicate_of_emitted_example(
+        self,
+    ) -> None:
+        seq = [{"index": 0}, {"index": 1}, {"index": 0}]
+
+        pipeline = read_sequence(seq).restore_order(max_num_buffered=2).and_return()
+
+        it = iter(pipeline)
+
+        assert [next(it)["index"] for _ in range(2)] == [0, 1]
+
+        with pytest.raises(
+            DataPipelineError,
+            match=r"^The original index of each example must be unique, but the index 0 has already been seen\.$",
+        ):
+            next(it)
+
+    def test_op_raises_error_when_example_arrives_after_being_skipped(self) -> None:
+        # The upstream reorders its output by three examples, but only two are
+        # buffered, so index 0 is skipped before it arrives.
+        seq = [{"index": i} for i in [1, 2, 3, 0]]
+
+        pipeline = read_sequence(seq).restore_order(max_num_buffered=2).and_return()
+
+        it = iter(pipeline)
+
+        assert [next(it)["index"] for _ in range(3)] == [1, 2, 3]
+
+        with pytest.raises(
+            DataPipelineError,
+            match=r"^The example with the original index 0 has arrived after its position was skipped\. `max_num_buffered` \(2\) must be greater than or equal to the number of examples by which the upstream data pipeline reorders its output\.$",
+        ):
+            next(it)
+
+    def test_op_raises_error_when_max_num_buffered_is_zero(self) -> None:
+        with pytest.raises(
+            ValueError, match=r"^`max_num_buffered` must be greater than zero\.$"
+        ):
+            read_sequence([]).restore_order(max_num_buffered=0)
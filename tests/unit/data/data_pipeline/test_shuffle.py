@@ -5,6 +5,7 @@
 # LICENSE file in the root directory of this source tree.
 
 from itertools import islice
+from typing import List
 
 import pytest
 
@@ -54,6 +55,89 @@ class TestShuffleOp:
 
             pipeline.reset(reset_rng=True)
 
+    @pytest.mark.parametrize("length", [5, 100, 2000])
+    def test_op_works_when_warmup_window_is_specified(self, length: int) -> None:
+        seq = list(range(length))
+
+        pipeline = (
+            read_sequence(seq).shuffle(1000, seed=1234, warmup_window=10).and_return()
+        )
+
+        output = list(pipeline)
+
+        assert output != seq
+
+        assert sorted(output) == seq
+
+        pipeline.reset(reset_rng=True)
+
+        assert list(pipeline) == output
+
+    def test_op_does_not_wait_for_full_window_when_warmup_window_is_specified(
+        self,
+    ) -> None:
+        num_read: List[int] = [0]
+
+        def count_read(example: int) -> int:
+            num_read[0] += 1
+
+            return example
+
+        seq = list(range(1000))
+
+        pipeline = (
+            read_sequence(seq)
+            .map(count_read)
+            .shuffle(100, warmup_window=10)
+            .and_return()
+        )
+
+        it = iter(pipeline)
+
+        next(it)
+
+        # The warm-up window, plus one example to replace the returned one and
+        # one to grow the window.
+        assert num_read[0] == 12
+
+        for _ in range(100):
+            next(it)
+
+        # The window stops growing once it reaches the shuffle window.
+        assert num_read[0] == 201
+
+    # With a window of 1000, the warm-up ends once the window is full; with a
+    # window of 1500, it ends once `read_sequence` is exhausted. A state saved
+    # after 1500 examples is past the end of the warm-up in both cases.
+    @pytest.mark.parametrize(
+        "window,num_examples", [(1000, 100), (1500, 100), (1000, 1500), (1500, 1500)]
+    )
+    def test_op_saves_and_restores_its_state_during_warmup(
+        self, window: int, num_examples: int
+    ) -> None:
+        seq = list(range(2000))
+
+        pipeline = (
+            read_sequence(seq)
+            .shuffle(window, seed=1234, warmup_window=10)
+            .and_return()
+        )
+
+        it = iter(pipeline)
+
+        for _ in range(num_examples):
+            next(it)
+
+        state_dict = pipeline.state_dict()
+
+        expected_output = list(pipeline)
+
+        pipeline.reset()
+
+        pipeline.load_state_dict(state_dict)
+
+        assert list(pipeline) == expected_output
+
     def test_op_saves_its_state_after_internal_buffer_is_emptied(self) -> None:
         class Foo:
             pass
@@ -0,0 +1,125 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+from typing import Any, Dict, List
+
+import pytest
+
+from fairseq2.data import DataPipelineError, read_sequence
+
+
+def make_examples(lens: List[int]) -> List[Dict[str, Any]]:
+    return [{"seq": list(range(n))} for n in lens]
+
+
+class TestSortForInferenceOp:
+    def test_op_works(self) -> None:
+        examples = make_examples([2, 5, 1, 4, 3, 6, 1])
+
+        pipeline = (
+            read_sequence(examples)
+            .sort_for_inference(window_size=4, batch_size=3, selector="seq")
+            .and_return()
+        )
+
+        for _ in range(2):
+            batches = [[e["index"] for e in batch] for batch in pipeline]
+
+            # The first window holds [0, 1, 2, 3] and the second [4, 5, 6]; each
+            # window is sorted by length in descending order.
+            assert batches == [[1, 3, 0], [2], [5, 4, 6]]
+
+            pipeline.reset()
+
+    def test_op_works_when_lengths_are_equal(self) -> None:
+        examples = make_examples([3, 3, 3, 3])
+
+        pipeline = (
+            read_sequence(examples)
+            .sort_for_inference(window_size=4, batch_size=2, selector="seq")
+            .and_return()
+        )
+
+        batches = [[e["index"] for e in batch] for batch in pipeline]
+
+        # The sort is stable.
+        assert batches == [[0, 1], [2, 3]]
+
+    def test_op_works_with_restore_order(self) -> None:
+        examples = make_examples([2, 5, 1, 4, 3, 6, 1, 7, 2])
+
+        pipeline = (
+            read_sequence(examples)
+            .sort_for_inference(window_size=5, batch_size=2, selector="seq")
+            .restore_order(max_num_buffered=5)
+            .and_return()
+        )
+
+        for _ in range(2):
+            output = list(pipeline)
+
+            assert [e["index"] for e in output] == list(range(9))
+
+            assert [len(e["seq"]) for e in output] == [2, 5, 1, 4, 3, 6, 1, 7, 2]
+
+            pipeline.reset()
+
+    def test_op_saves_and_restores_its_state(self) -> None:
+        examples = make_examples([2, 5, 1, 4, 3, 6, 1])
+
+        pipeline = (
+            read_sequence(examples)
+            .sort_for_inference(window_size=4, batch_size=3, selector="seq")
+            .and_return()
+        )
+
+        d = None
+
+        it = iter(pipeline)
+
+        # Move to the second batch.
+        for _ in range(2):
+            d = next(it)
+
+        assert d is not None
+
+        assert [e["index"] for e in d] == [2]
+
+        state_dict = pipeline.state_dict()
+
+        # Read a batch before we roll back.
+        d = next(it)
+
+        assert [e["index"] for e in d] == [5, 4, 6]
+
+        # Expected to roll back to the second batch.
+        pipeline.load_state_dict(state_dict)
+
+        d = next(it)
+
+        assert [e["index"] for e in d] == [5, 4, 6]
+
+        with pytest.raises(StopIteration):
+            next(it)
+
+    def test_op_raises_error_when_example_is_not_dict(self) -> None:
+        pipeline = (
+            read_sequence([1, 2, 3])
+            .sort_for_inference(window_size=2, batch_size=2)
+            .and_return()
+        )
+
+        with pytest.raises(
+            DataPipelineError,
+            match=r"^The input data must be of type `dict` to hold its original index, but is of type `int` instead\.$",
+        ):
+            next(iter(pipeline))
+
+    def test_op_raises_error_when_window_size_is_zero(self) -> None:
+        with pytest.raises(
+            ValueError, match=r"^`window_size` must be greater than zero\.$"
+        ):
+            read_sequence([]).sort_for_inference(window_size=0, batch_size=2)
@@ -0,0 +1,148 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+from collections import Counter
+from typing import Any, Dict, List
+
+import pytest
+
+from fairseq2.data import DataPipelineError, read_sequence
+
+
+def make_examples(counts: Dict[str, int]) -> List[Dict[str, Any]]:
+    examples = []
+
+    for cls, count in counts.items():
+        examples += [{"cls": cls, "idx": i} for i in range(count)]
+
+    return examples
+
+
+class TestStratifiedSampleOp:
+    def test_op_works(self) -> None:
+        # Interleave the classes so that every class shows up early.
+        examples = make_examples({"a": 900, "b": 90, "c": 10})
+
+        examples.sort(key=lambda e: e["idx"])
+
+        pipeline = (
+            read_sequence(examples)
+            .stratified_sample("cls", reservoir_size=10, seed=1)
+            .take(300)
+            .and_return()
+        )
+
+        counter = Counter(e["cls"] for e in pipeline)
+
+        # Uniform sampling is limited by the 10 examples of "c", after which
+        # only "a" and "b" are left.
+        assert counter["c"] == 10
+
+        assert 80 <= counter["b"] <= 90
+
+    def test_op_emits_all_examples_when_take_is_not_used(self) -> None:
+        examples = make_examples({"a": 50, "b": 5})
+
+        pipeline = (
+            read_sequence(examples)
+            .stratified_sample("cls", reservoir_size=100, seed=1)
+            .and_return()
+        )
+
+        for _ in range(2):
+            output = list(pipeline)
+
+            assert sorted((e["cls"], e["idx"]) for e in output) == sorted(
+                (e["cls"], e["idx"]) for e in examples
+            )
+
+            pipeline.reset()
+
+    def test_op_works_when_weights_are_specified(self) -> None:
+        examples = make_examples({"a": 100, "b": 100, "c": 100})
+
+        examples.sort(key=lambda e: e["idx"])
+
+        pipeline = (
+            read_sequence(examples)
+            .stratified_sample("cls", weights={"a": 3.0, "b": 1.0}, seed=1)
+            .take(40)
+            .and_return()
+        )
+
+        counter = Counter(e["cls"] for e in pipeline)
+
+        # The classes not in `weights` are dropped.
+        assert counter["c"] == 0
+
+        assert counter["a"] > counter["b"]
+
+    def test_op_works_when_class_is_int(self) -> None:
+        examples = [{"cls": i % 2, "idx": i} for i in range(10)]
+
+        pipeline = (
+            read_sequence(examples)
+            .stratified_sample("cls", weights={"1": 1.0}, seed=1)
+            .and_return()
+        )
+
+        assert sorted(e["idx"] for e in pipeline) == [1, 3, 5, 7, 9]
+
+    def test_op_is_reproducible_when_seed_is_specified(self) -> None:
+        examples = make_examples({"a": 30, "b": 10})
+
+        def sample() -> List[Any]:
+            pipeline = (
+                read_sequence(examples)
+                .stratified_sample("cls", reservoir_size=4, temperature=2.0, seed=3)
+                .and_return()
+            )
+
+            return list(pipeline)
+
+        assert sample() == sample()
+
+    def test_op_saves_and_restores_its_state(self) -> None:
+        examples = make_examples({"a": 30, "b": 10, "c": 5})
+
+        pipeline = (
+            read_sequence(examples)
+            .stratified_sample("cls", reservoir_size=4, seed=2)
+            .and_return()
+        )
+
+        it = iter(pipeline)
+
+        for _ in range(10):
+            next(it)
+
+        state_dict = pipeline.state_dict()
+
+        expected_output = [next(it) for _ in range(10)]
+
+        pipeline.load_state_dict(state_dict)
+
+        assert [next(it) for _ in range(10)] == expected_output
+
+    def test_op_raises_error_when_class_is_not_str_or_int(self) -> None:
+        pipeline = read_sequence([{"cls": 1.0}]).stratified_sample("cls").and_return()
+
+        with pytest.raises(
+            DataPipelineError,
+            match=r"^The class of the input data cannot be determined\.$",
+        ):
+            next(iter(pipeline))
+
+    def test_op_raises_error_when_weights_and_temperature_are_specified(
+        self,
+    ) -> None:
+        with pytest.raises(
+            ValueError,
+            match=r"^`weights` and `temperature` must not be specified at the same time\.$",
+        ):
+            read_sequence([]).stratified_sample(
+                "cls", weights={"a": 1.0}, temperature=1.0
+            )
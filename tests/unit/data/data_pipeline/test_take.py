@@ -6,7 +6,7 @@
 
 import pytest
 
-from fairseq2.data import read_sequence
+from fairseq2.data import DataPipeline, read_sequence
 
 
 class TestTakeOp:
@@ -36,6 +36,15 @@ class TestTakeOp:
 
             pipeline.reset()
 
+    def test_op_works_when_read_in_bulk(self) -> None:
+        # `bucket` reads its input in chunks, which `take` forwards to `count`.
+        pipeline = DataPipeline.count().skip(2).take(10).bucket(4).and_return()
+
+        for _ in range(2):
+            assert list(pipeline) == [[2, 3, 4, 5], [6, 7, 8, 9], [10, 11]]
+
+            pipeline.reset()
+
     def test_op_saves_and_restores_its_state(self) -> None:
         seq = [1, 2, 3, 4, 5, 6, 7, 8, 9]
 
@@ -0,0 +1,120 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+from collections import Counter
+from typing import List
+
+import pytest
+
+from fairseq2.data import DataPipeline, DataPipelineError, read_sequence
+
+
+class TestTakeRandomOp:
+    def test_op_works(self) -> None:
+        pipeline = DataPipeline.count().take(1000).take_random(10).and_return()
+
+        for _ in range(2):
+            output = list(pipeline)
+
+            assert len(output) == 10
+
+            assert output == sorted(set(output))
+
+            assert all(0 <= e < 1000 for e in output)
+
+            pipeline.reset()
+
+    def test_op_works_when_num_examples_exceeds_length(self) -> None:
+        pipeline = read_sequence([1, 2, 3, 4]).take_random(10).and_return()
+
+        for _ in range(2):
+            assert list(pipeline) == [1, 2, 3, 4]
+
+            pipeline.reset()
+
+    def test_op_works_when_num_examples_is_zero(self) -> None:
+        pipeline = read_sequence([1, 2, 3, 4]).take_random(0).and_return()
+
+        assert list(pipeline) == []
+
+    def test_op_samples_uniformly(self) -> None:
+        pipeline = DataPipeline.count().take(20).take_random(5, seed=1).and_return()
+
+        counter: Counter[int] = Counter()
+
+        for _ in range(2000):
+            counter.update(pipeline)
+
+            pipeline.reset()
+
+        # Each example is expected to be sampled 500 times.
+        assert all(400 <= counter[i] <= 600 for i in range(20))
+
+    def test_op_works_when_weight_selector_is_specified(self) -> None:
+        seq = [{"idx": i, "weight": 0 if i % 2 else 1.0} for i in range(50)]
+
+        pipeline = (
+            read_sequence(seq)
+            .take_random(10, weight_selector="weight", seed=1)
+            .and_return()
+        )
+
+        for _ in range(2):
+            output = [e["idx"] for e in pipeline]
+
+            assert len(output) == 10
+
+            # Examples with a weight of zero are never sampled.
+            assert all(i % 2 == 0 for i in output)
+
+            pipeline.reset()
+
+    def test_op_is_reproducible_when_seed_is_specified(self) -> None:
+        def sample() -> List[int]:
+            pipeline = DataPipeline.count().take(100).take_random(5, seed=4)
+
+            return list(pipeline.and_return())
+
+        assert sample() == sample()
+
+    def test_op_saves_and_restores_its_state(self) -> None:
+        pipeline = DataPipeline.count().take(100).take_random(10, seed=2).and_return()
+
+        it = iter(pipeline)
+
+        # Move to the fifth example.
+        for _ in range(5):
+            next(it)
+
+        state_dict = pipeline.state_dict()
+
+        expected_output = list(it)
+
+        pipeline.load_state_dict(state_dict)
+
+        assert list(pipeline) == expected_output
+
+    def test_op_raises_error_when_pipeline_is_infinite(self) -> None:
+        pipeline = DataPipeline.count().take_random(10).and_return()
+
+        with pytest.raises(
+            DataPipelineError,
+            match=r"^A random sample cannot be taken from an infinite data pipeline\.$",
+        ):
+            next(iter(pipeline))
+
+    def test_op_raises_error_when_weight_is_not_number(self) -> None:
+        pipeline = (
+            read_sequence([{"weight": "foo"}])
+            .take_random(1, weight_selector="weight")
+            .and_return()
+        )
+
+        with pytest.raises(
+            DataPipelineError,
+            match=r"^The weight of the input data cannot be determined\.$",
+        ):
+            next(iter(pipeline))
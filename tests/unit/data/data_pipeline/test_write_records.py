@@ -0,0 +1,87 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import gzip
+import struct
+from pathlib import Path
+from typing import List
+
+import pytest
+
+from fairseq2.data import FileCompression, read_sequence, write_records
+from fairseq2.memory import MemoryBlock
+
+
+def parse_records(data: bytes) -> List[bytes]:
+    records = []
+
+    offset = 0
+
+    while offset < len(data):
+        (size,) = struct.unpack_from("<Q", data, offset)
+
+        offset += 8
+
+        records.append(data[offset : offset + size])
+
+        offset += size
+
+    return records
+
+
+class TestWriteRecordsOp:
+    def test_op_works(self, tmp_path: Path) -> None:
+        path = tmp_path / "records.bin"
+
+        seq = [MemoryBlock(b"foo"), "bär", MemoryBlock(b""), "x" * 1000]
+
+        pipeline = read_sequence(seq).and_return()
+
+        assert write_records(pipeline, path, block_size=7) == 4
+
+        records = parse_records(path.read_bytes())
+
+        assert records == [b"foo", "bär".encode(), b"", b"x" * 1000]
+
+        assert list(tmp_path.iterdir()) == [path]
+
+    def test_op_works_when_compression_is_gzip(self, tmp_path: Path) -> None:
+        path = tmp_path / "records.bin.gz"
+
+        seq = [f"record {i}" for i in range(10000)]
+
+        pipeline = read_sequence(seq).and_return()
+
+        assert write_records(pipeline, path, compression=FileCompression.GZIP) == 10000
+
+        records = parse_records(gzip.decompress(path.read_bytes()))
+
+        assert records == [s.encode() for s in seq]
+
+    def test_op_works_when_pipeline_is_empty(self, tmp_path: Path) -> None:
+        path = tmp_path / "records.bin"
+
+        pipeline = read_sequence([]).and_return()
+
+        assert write_records(pipeline, path) == 0
+
+        assert path.read_bytes() == b""
+
+    def test_op_raises_error_when_example_is_not_memory_block_or_string(
+        self, tmp_path: Path
+    ) -> None:
+        path = tmp_path / "records.bin"
+
+        pipeline = read_sequence(["foo", 2]).and_return()
+
+        with pytest.raises(
+            ValueError,
+            match=r"^The example 1 in the pipeline must be of type `memory_block` or `string`, but is of type `int` instead\.$",
+        ):
+            write_records(pipeline, path)
+
+        # The partial output must be discarded.
+        assert list(tmp_path.iterdir()) == []
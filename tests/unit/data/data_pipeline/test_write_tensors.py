@@ -0,0 +1,135 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import math
+import struct
+from pathlib import Path
+from typing import List
+
+import pytest
+import torch
+from torch import Tensor
+
+from fairseq2.data import read_sequence, write_tensors
+from fairseq2.typing import DataType
+from tests.common import assert_equal, device
+
+
+class TestWriteTensorsOp:
+    def test_op_works(self, tmp_path: Path) -> None:
+        path = tmp_path / "tensors.bin"
+
+        index_path = tmp_path / "tensors.idx"
+
+        seq = [
+            torch.arange(3, device=device),
+            torch.arange(6, device=device).view(2, 3).t(),
+            torch.arange(0, device=device),
+        ]
+
+        pipeline = read_sequence(seq).and_return()
+
+        assert write_tensors(pipeline, path, index_path=index_path) == 3
+
+        output = torch.from_file(str(path), size=9, dtype=torch.int64)
+
+        assert_equal(output, [0, 1, 2, 0, 3, 1, 4, 2, 5])
+
+        index = torch.from_file(str(index_path), size=13, dtype=torch.int64)
+
+        # offset, dtype, ndim, sizes...
+        assert_equal(index, [0, 5, 1, 3, 3, 5, 2, 3, 2, 9, 5, 1, 0])
+
+    @pytest.mark.parametrize(
+        "dtype", [torch.bool, torch.uint8, torch.int32, torch.bfloat16, torch.float64]
+    )
+    def test_op_output_round_trips(self, tmp_path: Path, dtype: DataType) -> None:
+        path = tmp_path / "tensors.bin"
+
+        index_path = tmp_path / "tensors.idx"
+
+        seq = [
+            torch.arange(6, device=device).view(2, 3).to(dtype),
+            torch.arange(4, device=device).view(1, 2, 2).to(dtype),
+            torch.ones((0, 4), device=device, dtype=dtype),
+        ]
+
+        pipeline = read_sequence(seq).and_return()
+
+        assert write_tensors(pipeline, path, index_path=index_path) == 3
+
+        tensors = self.read_tensors(path, index_path)
+
+        assert len(tensors) == len(seq)
+
+        for tensor, expected_tensor in zip(tensors, seq):
+            assert tensor.dtype == expected_tensor.dtype
+
+            assert_equal(tensor, expected_tensor.cpu())
+
+    @staticmethod
+    def read_tensors(path: Path, index_path: Path) -> List[Tensor]:
+        dtypes = [
+            torch.bool,
+            torch.uint8,
+            torch.int8,
+            torch.int16,
+            torch.int32,
+            torch.int64,
+            torch.float16,
+            torch.bfloat16,
+            torch.float32,
+            torch.float64,
+        ]
+
+        data = bytearray(path.read_bytes())
+
+        index_data = index_path.read_bytes()
+
+        index = struct.unpack(f"<{len(index_data) // 8}q", index_data)
+
+        tensors = []
+
+        i = 0
+
+        while i < len(index):
+            offset, dtype_code, ndim = index[i : i + 3]
+
+            shape = index[i + 3 : i + 3 + ndim]
+
+            i += 3 + ndim
+
+            dtype = dtypes[dtype_code]
+
+            numel = math.prod(shape)
+
+            if numel == 0:
+                tensor = torch.empty(shape, dtype=dtype)
+            else:
+                itemsize = torch.empty((), dtype=dtype).element_size()
+
+                tensor = torch.frombuffer(
+                    data, dtype=dtype, count=numel, offset=offset * itemsize
+                )
+
+            tensors.append(tensor.view(shape))
+
+        return tensors
+
+    def test_op_raises_error_when_data_types_differ(self, tmp_path: Path) -> None:
+        path = tmp_path / "tensors.bin"
+
+        seq = [torch.zeros(2), torch.zeros(2, dtype=torch.int64)]
+
+        pipeline = read_sequence(seq).and_return()
+
+        with pytest.raises(
+            ValueError,
+            match=r"^The tensor 1 in the pipeline must have the same data type as the first tensor\.$",
+        ):
+            write_tensors(pipeline, path)
+
+        assert not path.exists()
@@ -4,8 +4,10 @@
 # This source code is licensed under the BSD-style license found in the
 # LICENSE file in the root directory of this source tree.
 
+import struct
+import zlib
 from pathlib import Path
-from typing import Any, Final
+from typing import Any, Final, List
 
 import pytest
 import torch
@@ -13,7 +15,7 @@ from fairseq2n import supports_image
 
 from fairseq2.data.image import ImageDecoder
 from fairseq2.memory import MemoryBlock
-from tests.common import assert_close, device
+from tests.common import assert_close, assert_equal, device
 
 TEST_PNG_PATH: Final = Path(__file__).parent.joinpath("test.png")
 TEST_JPG_PATH: Final = Path(__file__).parent.joinpath("test.jpg")
@@ -57,31 +59,31 @@ class TestImageDecoder:
 
         assert_close(image.sum(), torch.tensor(4656924, device=device))
 
-    #    def test_call_works_on_jpg(self) -> None:
-    #        decoder = ImageDecoder(device=device)
-    #
-    #        with TEST_JPG_PATH.open("rb") as fb:
-    #            block = MemoryBlock(fb.read())
-    #
-    #        output = decoder(block)
-    #
-    #        assert output["bit_depth"] == 8.0
-    #
-    #        assert output["channels"] == 3.0
-    #
-    #        assert output["height"] == 50.0
-    #
-    #        assert output["width"] == 50.0
-    #
-    #        image = output["image"]
-    #
-    #        assert image.shape == torch.Size([50, 50, 3])
-    #
-    #        assert image.dtype == torch.uint8
-    #
-    #        assert image.device == device
-    #
-    #        assert_close(image.sum(), torch.tensor(1747686, device=device))
+    def test_call_works_on_jpg(self) -> None:
+        decoder = ImageDecoder(device=device)
+
+        with TEST_JPG_PATH.open("rb") as fb:
+            block = MemoryBlock(fb.read())
+
+        output = decoder(block)
+
+        assert output["bit_depth"] == 8.0
+
+        assert output["channels"] == 3.0
+
+        assert output["height"] == 50.0
+
+        assert output["width"] == 50.0
+
+        image = output["image"]
+
+        assert image.shape == torch.Size([50, 50, 3])
+
+        assert image.dtype == torch.uint8
+
+        assert image.device == device
+
+        assert_close(image.sum(), torch.tensor(1747686, device=device))
 
     def test_call_raises_error_when_input_is_corrupted_png(self) -> None:
         decoder = ImageDecoder(device=device)
@@ -95,18 +97,93 @@ class TestImageDecoder:
         ):
             decoder(block)
 
-    #    def test_call_raises_error_when_input_is_corrupted_jpg(self) -> None:
-    #        decoder = ImageDecoder(device=device)
-    #
-    #        with TEST_CORRUPT_JPG_PATH.open("rb") as fb:
-    #            block = MemoryBlock(fb.read())
-    #
-    #        with pytest.raises(
-    #            RuntimeError,
-    #            match="JPEG decompression failed.",
-    #        ):
-    #            decoder(block)
-    #
+    def test_call_raises_error_when_input_is_corrupted_jpg(self) -> None:
+        decoder = ImageDecoder(device=device)
+
+        with TEST_CORRUPT_JPG_PATH.open("rb") as fb:
+            block = MemoryBlock(fb.read())
+
+        with pytest.raises(
+            RuntimeError,
+            match="JPEG decompression failed.",
+        ):
+            decoder(block)
+
+    @pytest.mark.parametrize("path", [TEST_PNG_PATH, TEST_JPG_PATH])
+    def test_call_works_when_crop_box_is_specified(self, path: Path) -> None:
+        decoder = ImageDecoder()
+
+        with path.open("rb") as fb:
+            block = MemoryBlock(fb.read())
+
+        image = decoder(block)["image"]
+
+        output = decoder({"data": block, "crop_box": [3, 9, 20, 30]})
+
+        assert output["height"] == 20.0
+        assert output["width"] == 30.0
+
+        assert output["crop_box"] == [3, 9, 20, 30]
+
+        # The crop must be identical to the same region of the full image.
+        assert_equal(output["image"], image[3:23, 9:39])
+
+    @pytest.mark.parametrize("bit_depth", [1, 2, 4])
+    def test_call_works_when_png_has_low_bit_depth(self, bit_depth: int) -> None:
+        pixels = [[(x + 2 * y) % (1 << bit_depth) for x in range(10)] for y in range(6)]
+
+        block = MemoryBlock(self.make_grayscale_png(pixels, bit_depth))
+
+        decoder = ImageDecoder(device=device)
+
+        output = decoder(block)
+
+        assert output["bit_depth"] == float(bit_depth)
+
+        image = output["image"]
+
+        assert image.shape == torch.Size([6, 10, 1])
+
+        assert_equal(image.squeeze(-1), pixels)
+
+        output = decoder({"data": block, "crop_box": [1, 3, 3, 4]})
+
+        assert_equal(output["image"], image[1:4, 3:7])
+
+    def test_call_works_when_random_crop_is_true(self) -> None:
+        decoder = ImageDecoder(random_crop=True, seed=2)
+
+        with TEST_JPG_PATH.open("rb") as fb:
+            block = MemoryBlock(fb.read())
+
+        image = decoder(block)["image"]
+
+        for _ in range(20):
+            output = decoder(block)
+
+            top, left, height, width = output["crop_box"]
+
+            assert 0 <= top and top + height <= 50
+            assert 0 <= left and left + width <= 50
+
+            assert height * width >= 0.08 * 50 * 50 - 50
+
+            expected_image = image[top : top + height, left : left + width]
+
+            assert_equal(output["image"], expected_image)
+
+    def test_call_raises_error_when_crop_box_is_out_of_bounds(self) -> None:
+        decoder = ImageDecoder()
+
+        with TEST_PNG_PATH.open("rb") as fb:
+            block = MemoryBlock(fb.read())
+
+        with pytest.raises(
+            ValueError,
+            match=r"^The crop box `\[60, 0, 20, 10\]` must be non-empty and must lie within the image of height 70 and width 70\.$",
+        ):
+            decoder({"data": block, "crop_box": [60, 0, 20, 10]})
+
     @pytest.mark.parametrize(
         "value,type_name", [(None, "pyobj"), (123, "int"), ("s", "string")]
     )
@@ -117,7 +194,7 @@ class TestImageDecoder:
 
         with pytest.raises(
             ValueError,
-            match=rf"^The input data must be of type `memory_block`, but is of type `{type_name}` instead\.$",
+            match=rf"^The input data must be of type `memory_block` or `dict`, but is of type `{type_name}` instead\.$",
         ):
             decoder(value)
 
@@ -142,3 +219,40 @@ class TestImageDecoder:
             match=r"^Unsupported image file. Only jpeg and png are currently supported\.$",
         ):
             decoder(block)
+
+    @staticmethod
+    def make_grayscale_png(pixels: List[List[int]], bit_depth: int) -> bytes:
+        def make_chunk(kind: bytes, data: bytes) -> bytes:
+            crc = zlib.crc32(kind + data)
+
+            return struct.pack(">I", len(data)) + kind + data + struct.pack(">I", crc)
+
+        height, width = len(pixels), len(pixels[0])
+
+        header = struct.pack(">IIBBBBB", width, height, bit_depth, 0, 0, 0, 0)
+
+        rows = bytearray()
+
+        for row in pixels:
+            # Filter type "None".
+            rows.append(0)
+
+            bits, num_bits = 0, 0
+
+            for pixel in row:
+                bits, num_bits = (bits << bit_depth) | pixel, num_bits + bit_depth
+
+                if num_bits == 8:
+                    rows.append(bits)
+
+                    bits, num_bits = 0, 0
+
+            if num_bits > 0:
+                rows.append(bits << (8 - num_bits))
+
+        return (
+            b"\x89PNG\r\n\x1a\n"
+            + make_chunk(b"IHDR", header)
+            + make_chunk(b"IDAT", zlib.compress(bytes(rows)))
+            + make_chunk(b"IEND", b"")
+        )
@@ -137,6 +137,88 @@ class TestCollater:
 
         assert output["foo1"]["is_ragged"] == True
 
+    def test_call_works_when_sequence_masks_are_requested(self) -> None:
+        bucket = [
+            torch.full((3,), 1, device=device, dtype=torch.int64),
+            torch.full((1,), 2, device=device, dtype=torch.int64),
+            torch.full((2,), 3, device=device, dtype=torch.int64),
+        ]
+
+        collater = Collater(
+            pad_value=0,
+            pad_to_multiple=4,
+            padding_mask=True,
+            segment_ids=True,
+            position_ids=True,
+        )
+
+        output = collater(bucket)
+
+        expected_padding_mask = torch.tensor(
+            [
+                [True, True, True, False],
+                [True, False, False, False],
+                [True, True, False, False],
+            ],
+            device=device,
+        )
+
+        expected_segment_ids = torch.tensor(
+            [[0, 0, 0, -1], [1, -1, -1, -1], [2, 2, -1, -1]], device=device
+        )
+
+        expected_position_ids = torch.tensor(
+            [[0, 1, 2, 0], [0, 0, 0, 0], [0, 1, 0, 0]], device=device
+        )
+
+        assert_equal(output["padding_mask"], expected_padding_mask)
+        assert_equal(output["segment_ids"], expected_segment_ids)
+        assert_equal(output["position_ids"], expected_position_ids)
+
+    def test_call_works_when_pack_is_true(self) -> None:
+        bucket = [
+            {"foo": torch.full((3, 2), 1, device=device, dtype=torch.int64)},
+            {"foo": torch.full((1, 2), 2, device=device, dtype=torch.int64)},
+            {"foo": torch.full((2, 2), 3, device=device, dtype=torch.int64)},
+        ]
+
+        collater = Collater(
+            pad_value=0,
+            pad_to_multiple=4,
+            pack=True,
+            padding_mask=True,
+            segment_ids=True,
+            position_ids=True,
+        )
+
+        output = collater(bucket)["foo"]
+
+        expected_seqs = torch.tensor(
+            [[[1, 1], [1, 1], [1, 1], [2, 2], [3, 3], [3, 3], [0, 0], [0, 0]]],
+            device=device,
+            dtype=torch.int64,
+        )
+
+        assert_equal(output["seqs"], expected_seqs)
+
+        assert_equal(output["seq_lens"], torch.tensor([6], device=device))
+
+        assert_equal(output["segment_lens"], torch.tensor([3, 1, 2], device=device))
+
+        assert output["is_ragged"] == True
+
+        expected_padding_mask = torch.tensor(
+            [[True, True, True, True, True, True, False, False]], device=device
+        )
+
+        expected_segment_ids = torch.tensor([[0, 0, 0, 1, 2, 2, -1, -1]], device=device)
+
+        expected_position_ids = torch.tensor([[0, 1, 2, 0, 0, 1, 0, 0]], device=device)
+
+        assert_equal(output["padding_mask"], expected_padding_mask)
+        assert_equal(output["segment_ids"], expected_segment_ids)
+        assert_equal(output["position_ids"], expected_position_ids)
+
     def test_call_works_when_options_are_overriden(self) -> None:
         # fmt: off
         bucket = [
@@ -398,3 +480,18 @@ class TestCollater:
             match=r"^`pad_value` of the selector 'foo' must be set when `pad_to_multiple` is greater than 1\.$",
         ):
             Collater(overrides=[CollateOptionsOverride("foo", pad_to_multiple=2)])
+
+    def test_init_raises_error_when_pad_value_is_none_and_sequence_masks_are_requested(
+        self,
+    ) -> None:
+        with pytest.raises(
+            ValueError,
+            match=r"^`pad_value` must be set when `pack`, `padding_mask`, `segment_ids`, or `position_ids` is set\.$",
+        ):
+            Collater(padding_mask=True)
+
+        with pytest.raises(
+            ValueError,
+            match=r"^`pad_value` of the selector 'foo' must be set when `pack`, `padding_mask`, `segment_ids`, or `position_ids` is set\.$",
+        ):
+            Collater(overrides=[CollateOptionsOverride("foo", pack=True)])
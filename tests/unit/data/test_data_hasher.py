@@ -0,0 +1,116 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import pytest
+import torch
+
+from fairseq2.data import DataHasher, read_sequence
+from fairseq2.memory import MemoryBlock
+from tests.common import device
+
+
+class TestDataHasher:
+    def test_hash_is_stable(self) -> None:
+        hasher = DataHasher()
+
+        # The hash format must not change across versions and platforms.
+        assert hasher.hash("foo") == 8994857709882769329
+
+        assert hasher.hash([1, "a", 2.0]) == 11221366460987388079
+
+    def test_hash_works_when_input_has_all_supported_types(self) -> None:
+        hasher = DataHasher()
+
+        example = {
+            "a": True,
+            "b": 1,
+            "c": 1.5,
+            "d": "foo",
+            "e": MemoryBlock(b"foo"),
+            "f": torch.arange(4, device=device),
+            "g": [1, [2, {"h": 3}]],
+        }
+
+        h = hasher.hash(example)
+
+        assert 0 <= h < 2**64
+
+        assert hasher.hash(example) == h
+
+    def test_hash_distinguishes_types(self) -> None:
+        hasher = DataHasher()
+
+        assert hasher.hash(1) != hasher.hash(True)
+        assert hasher.hash(1) != hasher.hash(1.0)
+        assert hasher.hash("foo") != hasher.hash(MemoryBlock(b"foo"))
+        assert hasher.hash([1, 2]) != hasher.hash([2, 1])
+        assert hasher.hash([[1], 2]) != hasher.hash([1, [2]])
+
+    def test_hash_ignores_dict_key_order(self) -> None:
+        hasher = DataHasher()
+
+        assert hasher.hash({"a": 1, "b": 2}) == hasher.hash({"b": 2, "a": 1})
+        assert hasher.hash({"a": 1, "b": 2}) != hasher.hash({"a": 2, "b": 1})
+
+    def test_hash_ignores_tensor_layout(self) -> None:
+        hasher = DataHasher()
+
+        t = torch.arange(6, device=device).view(2, 3)
+
+        assert hasher.hash(t.t().contiguous().t()) == hasher.hash(t)
+        assert hasher.hash(t) != hasher.hash(t.view(3, 2))
+
+    def test_hash_works_when_seed_is_specified(self) -> None:
+        assert DataHasher(seed=1).hash("foo") != DataHasher(seed=2).hash("foo")
+
+    def test_hash_works_when_selector_is_specified(self) -> None:
+        hasher = DataHasher(selector="a,c")
+
+        h = hasher.hash({"a": 1, "b": 2, "c": 3})
+
+        assert hasher.hash({"a": 1, "b": 4, "c": 3}) == h
+        assert hasher.hash({"a": 1, "b": 2, "c": 4}) != h
+
+    def test_call_works(self) -> None:
+        hasher = DataHasher()
+
+        h = hasher.hash("foo")
+
+        output = hasher("foo")
+
+        assert output == (h if h < 2**63 else h - 2**64)
+
+    def test_call_works_when_key_is_specified(self) -> None:
+        hasher = DataHasher(selector="a", key="h")
+
+        pipeline = read_sequence([{"a": 1}, {"a": 1}, {"a": 2}]).map(hasher).and_return()
+
+        output = list(pipeline)
+
+        assert output[0]["h"] == output[1]["h"]
+        assert output[0]["h"] != output[2]["h"]
+
+        assert output[2]["a"] == 2
+
+    def test_call_raises_error_when_key_is_specified_and_input_is_not_dict(
+        self,
+    ) -> None:
+        hasher = DataHasher(key="h")
+
+        with pytest.raises(
+            ValueError,
+            match=r"^The input data must be of type `dict` when `key` is specified, but is of type `int` instead\.$",
+        ):
+            hasher(1)
+
+    def test_hash_raises_error_when_input_has_python_object(self) -> None:
+        hasher = DataHasher()
+
+        with pytest.raises(
+            ValueError,
+            match=r"^The input data must not contain Python objects since they cannot be hashed in a stable manner\.$",
+        ):
+            hasher.hash([1, object()])
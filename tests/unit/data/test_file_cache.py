@@ -0,0 +1,187 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import os
+from pathlib import Path
+from typing import Iterator, List
+
+import pytest
+
+from fairseq2.data import FileCache, FileMapper, get_file_cache, set_file_cache
+
+
+@pytest.fixture
+def files(tmp_path: Path) -> List[Path]:
+    src_dir = tmp_path.joinpath("src")
+
+    src_dir.mkdir()
+
+    paths = []
+
+    for i in range(4):
+        path = src_dir.joinpath(f"file{i}.bin")
+
+        path.write_bytes(bytes([i]) * 100)
+
+        paths.append(path)
+
+    return paths
+
+
+@pytest.fixture
+def cache(tmp_path: Path) -> Iterator[FileCache]:
+    cache = FileCache(tmp_path.joinpath("cache"), max_size=250)
+
+    set_file_cache(cache)
+
+    try:
+        yield cache
+    finally:
+        set_file_cache(None)
+
+
+def list_entries(cache: FileCache) -> List[Path]:
+    return sorted(cache.cache_dir.iterdir())
+
+
+def read_entry_ids(cache: FileCache) -> List[int]:
+    return sorted(path.read_bytes()[0] for path in list_entries(cache))
+
+
+class TestFileCache:
+    def test_set_file_cache_works(self, cache: FileCache) -> None:
+        assert get_file_cache() is cache
+
+        set_file_cache(None)
+
+        assert get_file_cache() is None
+
+    def test_file_is_read_from_cache(
+        self, files: List[Path], cache: FileCache
+    ) -> None:
+        mapper = FileMapper(cached_fd_count=0)
+
+        for _ in range(3):
+            output = mapper(str(files[0]))
+
+            assert bytes(output["data"]) == bytes([0]) * 100
+
+        assert cache.num_misses == 1
+        assert cache.num_hits == 2
+
+        assert len(list_entries(cache)) == 1
+
+    def test_file_is_copied_again_when_modified(
+        self, files: List[Path], cache: FileCache
+    ) -> None:
+        mapper = FileMapper(cached_fd_count=0)
+
+        mapper(str(files[0]))
+
+        files[0].write_bytes(b"foo")
+
+        output = mapper(str(files[0]))
+
+        assert bytes(output["data"]) == b"foo"
+
+        assert cache.num_misses == 2
+
+    def test_least_recently_used_file_is_evicted(
+        self, files: List[Path], cache: FileCache
+    ) -> None:
+        mapper = FileMapper(cached_fd_count=0)
+
+        mapper(str(files[0]))
+        mapper(str(files[1]))
+
+        # Backdate the entries instead of relying on the timestamp resolution
+        # of the file system to order them.
+        for path in list_entries(cache):
+            t = 1000 + path.read_bytes()[0]
+
+            os.utime(path, (t, t))
+
+        # Mark the entry of the first file as the most-recently-used one.
+        mapper(str(files[0]))
+
+        # The cache has room for two files only.
+        mapper(str(files[2]))
+
+        assert cache.num_misses == 3
+        assert cache.num_hits == 1
+
+        assert read_entry_ids(cache) == [0, 2]
+
+    def test_existing_entries_are_counted_toward_max_size(
+        self, files: List[Path], cache: FileCache
+    ) -> None:
+        mapper = FileMapper(cached_fd_count=0)
+
+        mapper(str(files[0]))
+        mapper(str(files[1]))
+
+        # A new cache over the same directory must account for the entries
+        # left behind by the previous one.
+        new_cache = FileCache(cache.cache_dir, max_size=250)
+
+        set_file_cache(new_cache)
+
+        mapper(str(files[2]))
+
+        assert new_cache.num_misses == 1
+
+        assert len(list_entries(new_cache)) == 2
+
+    def test_file_larger_than_max_size_is_not_cached(
+        self, tmp_path: Path, cache: FileCache
+    ) -> None:
+        path = tmp_path.joinpath("big.bin")
+
+        path.write_bytes(b"x" * 1000)
+
+        output = FileMapper()(str(path))
+
+        assert bytes(output["data"]) == b"x" * 1000
+
+        assert list_entries(cache) == []
+
+    def test_foreign_files_are_not_evicted(
+        self, files: List[Path], cache: FileCache
+    ) -> None:
+        mapper = FileMapper(cached_fd_count=0)
+
+        # Neither file follows the naming scheme of the cache; their sizes
+        # would force the eviction of all entries if they were counted.
+        foreign_paths = [
+            cache.cache_dir.joinpath("notes.txt"),
+            cache.cache_dir.joinpath("foo.cache-tmp"),
+        ]
+
+        for path in foreign_paths:
+            path.write_bytes(b"x" * 200)
+
+            # Make them look like orphaned temporary files.
+            os.utime(path, (1000, 1000))
+
+        mapper(str(files[0]))
+        mapper(str(files[1]))
+
+        entries = [p for p in list_entries(cache) if p not in foreign_paths]
+
+        for path in entries:
+            t = 2000 + path.read_bytes()[0]
+
+            os.utime(path, (t, t))
+
+        mapper(str(files[2]))
+
+        for path in foreign_paths:
+            assert path.read_bytes() == b"x" * 200
+
+        entries = [p for p in list_entries(cache) if p not in foreign_paths]
+
+        # The cache has room for two files only.
+        assert sorted(p.read_bytes()[0] for p in entries) == [1, 2]
@@ -51,6 +51,17 @@ class TestFileMapper:
 
             self.assert_file(output, TEST_BIN_PATH, offset=100, size=200)
 
+    def test_call_works_when_readahead_is_true(self) -> None:
+        mapper = FileMapper(readahead=True)
+
+        # The offset is deliberately not page aligned.
+        pathname = f"{TEST_BIN_PATH}:100:200"
+
+        for _ in range(2):
+            output = mapper(pathname)
+
+            self.assert_file(output, TEST_BIN_PATH, offset=100, size=200)
+
     def test_call_works_when_root_directory_is_specified(self) -> None:
         root_dir = TEST_BIN_PATH.parent.parent
 
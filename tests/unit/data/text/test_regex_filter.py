@@ -0,0 +1,71 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import pytest
+from fairseq2n import supports_regex
+
+from fairseq2.data import read_sequence
+from fairseq2.data.text import RegexFilter
+
+
+@pytest.mark.skipif(
+    not supports_regex(), reason="fairseq2n is not built with regex support"
+)
+class TestRegexFilter:
+    def test_call_works(self) -> None:
+        fn = RegexFilter(r"fo+")
+
+        assert fn("a foo b")
+        assert not fn("bar")
+
+    def test_call_works_when_exclude_is_true(self) -> None:
+        fn = RegexFilter(r"fo+", exclude=True)
+
+        assert not fn("a foo b")
+        assert fn("bar")
+
+    def test_call_works_when_selector_is_specified(self) -> None:
+        fn = RegexFilter(r"^\d+$", selector="a,b")
+
+        assert fn({"a": "foo", "b": "123", "c": "bar"})
+        assert not fn({"a": "foo", "b": "bar", "c": "123"})
+
+    def test_filter_works(self) -> None:
+        fn = RegexFilter(r"https?://", exclude=True)
+
+        seq = ["foo", "see http://example.com", "bar", "https://example.com"]
+
+        pipeline = read_sequence(seq).filter(fn).and_return()
+
+        for _ in range(2):
+            assert list(pipeline) == ["foo", "bar"]
+
+            pipeline.reset()
+
+    def test_init_raises_error_when_pattern_is_invalid(self) -> None:
+        with pytest.raises(
+            ValueError,
+            match=r"^`pattern` must be a valid regular expression, but is '\(foo' instead\. ",
+        ):
+            RegexFilter(r"(foo")
+
+    def test_call_raises_error_when_input_is_not_string(self) -> None:
+        fn = RegexFilter(r"foo")
+
+        with pytest.raises(
+            ValueError,
+            match=r"^The input data must be of type `string`, but is of type `int` instead\.$",
+        ):
+            fn(1)
+
+    def test_call_raises_error_when_selected_element_is_not_string(self) -> None:
+        fn = RegexFilter(r"foo", selector="a")
+
+        with pytest.raises(
+            ValueError,
+            match=r"^The element at 'a' in the input data must be of type `string`, but is of type `int` instead\.$",
+        ):
+            fn({"a": 1})
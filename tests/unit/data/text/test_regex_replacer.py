@@ -0,0 +1,81 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import pytest
+from fairseq2n import supports_regex
+
+from fairseq2.data import read_sequence
+from fairseq2.data.text import RegexReplacer
+
+
+@pytest.mark.skipif(
+    not supports_regex(), reason="fairseq2n is not built with regex support"
+)
+class TestRegexReplacer:
+    def test_call_works(self) -> None:
+        fn = RegexReplacer(r"https?://\S+", "<url>")
+
+        assert fn("see http://a.com and https://b.com") == "see <url> and <url>"
+
+        assert fn("foo") == "foo"
+
+    def test_call_works_when_rewrite_has_groups(self) -> None:
+        fn = RegexReplacer(r"([!?])[!?]+", r"\1")
+
+        assert fn("wow!!! really??") == "wow! really?"
+
+    def test_call_works_when_rewrite_refers_to_whole_match(self) -> None:
+        fn = RegexReplacer(r"\d+", r"<\0>")
+
+        assert fn("a 12 b 3") == "a <12> b <3>"
+
+    def test_call_works_when_selector_is_specified(self) -> None:
+        fn = RegexReplacer(r"\s+", " ", selector="foo,bar[*]")
+
+        example = {"foo": "a  b", "bar": ["c\t\td", "e"], "baz": "f  g"}
+
+        assert fn(example) == {"foo": "a b", "bar": ["c d", "e"], "baz": "f  g"}
+
+    def test_call_raises_error_when_selected_element_is_not_string(self) -> None:
+        fn = RegexReplacer(r"foo", "bar", selector="foo")
+
+        with pytest.raises(
+            ValueError,
+            match=r"^The element at 'foo' in the input data must be of type `string`, but is of type `int` instead\.$",
+        ):
+            fn({"foo": 1})
+
+    def test_map_works(self) -> None:
+        fn = RegexReplacer(r"\s+", " ")
+
+        seq = ["a  b", "c\t\td", "e"]
+
+        pipeline = read_sequence(seq).map(fn, num_parallel_calls=4).and_return()
+
+        assert list(pipeline) == ["a b", "c d", "e"]
+
+    def test_init_raises_error_when_pattern_is_invalid(self) -> None:
+        with pytest.raises(
+            ValueError,
+            match=r"^`pattern` must be a valid regular expression, but is '\(foo' instead\. ",
+        ):
+            RegexReplacer(r"(foo", "")
+
+    def test_init_raises_error_when_rewrite_is_invalid(self) -> None:
+        with pytest.raises(
+            ValueError,
+            match=r"^`rewrite` must be a valid rewrite string for `pattern`, but is '\\1' instead\. ",
+        ):
+            RegexReplacer(r"foo", r"\1")
+
+    def test_call_raises_error_when_input_is_not_string(self) -> None:
+        fn = RegexReplacer(r"foo", "bar")
+
+        with pytest.raises(
+            ValueError,
+            match=r"^The input data must be of type `string`, but is of type `int` instead\.$",
+        ):
+            fn(1)
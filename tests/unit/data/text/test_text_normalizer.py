@@ -0,0 +1,80 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+from typing import Any
+
+import pytest
+from fairseq2n import supports_text_normalization
+
+from fairseq2.data import read_sequence
+from fairseq2.data.text import NormalizationForm, TextNormalizer
+
+
+@pytest.mark.skipif(
+    not supports_text_normalization(),
+    reason="fairseq2n is not built with Unicode text normalization support",
+)
+class TestTextNormalizer:
+    def test_call_works(self) -> None:
+        normalizer = TextNormalizer()
+
+        # "e" followed by a combining acute accent.
+        assert normalizer("café") == "café"
+
+        # NFC does not apply compatibility mappings.
+        assert normalizer("ﬁ") == "ﬁ"
+
+    def test_call_works_when_form_is_nfkc(self) -> None:
+        normalizer = TextNormalizer(form=NormalizationForm.NFKC)
+
+        assert normalizer("ﬁ Ａ") == "fi A"
+
+    @pytest.mark.parametrize(
+        "value,expected",
+        [("Hello World", "hello world"), ("STRASSE Straße", "strasse strasse")],
+    )
+    def test_call_works_when_case_fold_is_true(self, value: str, expected: str) -> None:
+        normalizer = TextNormalizer(case_fold=True)
+
+        assert normalizer(value) == expected
+
+    @pytest.mark.parametrize(
+        "value,expected",
+        [
+            ("  foo \t\n bar  ", "foo bar"),
+            ("foo bar", "foo bar"),
+            ("   ", ""),
+            ("", ""),
+            ("　föo  bar ", "föo bar"),
+        ],
+    )
+    def test_call_works_when_collapse_whitespace_is_true(
+        self, value: str, expected: str
+    ) -> None:
+        normalizer = TextNormalizer(collapse_whitespace=True)
+
+        assert normalizer(value) == expected
+
+    def test_call_works_in_pipeline(self) -> None:
+        normalizer = TextNormalizer(case_fold=True, collapse_whitespace=True)
+
+        pipeline = read_sequence([" Foo  Bar", "BÄZ "]).map(normalizer).and_return()
+
+        assert list(pipeline) == ["foo bar", "bäz"]
+
+    @pytest.mark.parametrize(
+        "value,type_name", [(None, "pyobj"), (123, "int"), (1.2, "float")]
+    )
+    def test_call_raises_error_when_input_is_not_string(
+        self, value: Any, type_name: str
+    ) -> None:
+        normalizer = TextNormalizer()
+
+        with pytest.raises(
+            ValueError,
+            match=rf"^The input data must be of type `string`, but is of type `{type_name}` instead\.$",
+        ):
+            normalizer(value)
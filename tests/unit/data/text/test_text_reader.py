@@ -0,0 +1,197 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+from pathlib import Path
+
+import pytest
+
+from fairseq2.data import DataPipelineError
+from fairseq2.data.text import read_text
+
+
+class TestReadTextWithIndex:
+    @staticmethod
+    def write_lines(path: Path, num_lines: int) -> None:
+        path.write_text("".join(f"line{i}\n" for i in range(num_lines)))
+
+    def test_op_works(self, tmp_path: Path) -> None:
+        path = tmp_path / "file.txt"
+
+        self.write_lines(path, 10)
+
+        pipeline = read_text(path, rtrim=True, index=True).and_return()
+
+        for _ in range(2):
+            assert list(pipeline) == [f"line{i}" for i in range(10)]
+
+            pipeline.reset()
+
+        assert path.with_suffix(".txt.idx").exists()
+
+    def test_op_works_when_index_path_is_specified(self, tmp_path: Path) -> None:
+        path = tmp_path / "file.txt"
+
+        index_path = tmp_path / "file.index"
+
+        self.write_lines(path, 10)
+
+        pipeline = read_text(path, rtrim=True, index=index_path).and_return()
+
+        assert list(pipeline) == [f"line{i}" for i in range(10)]
+
+        assert index_path.exists()
+
+        # Read through the existing index.
+        pipeline = read_text(path, rtrim=True, index=index_path).and_return()
+
+        assert list(pipeline) == [f"line{i}" for i in range(10)]
+
+    def test_op_works_when_file_is_modified(self, tmp_path: Path) -> None:
+        path = tmp_path / "file.txt"
+
+        self.write_lines(path, 10)
+
+        pipeline = read_text(path, rtrim=True, index=True).and_return()
+
+        assert len(list(pipeline)) == 10
+
+        self.write_lines(path, 20)
+
+        pipeline = read_text(path, rtrim=True, index=True).and_return()
+
+        assert list(pipeline) == [f"line{i}" for i in range(20)]
+
+    def test_op_works_when_skip_empty_is_true(self, tmp_path: Path) -> None:
+        path = tmp_path / "file.txt"
+
+        path.write_text("foo\n\nbar\n\n")
+
+        pipeline = read_text(path, rtrim=True, skip_empty=True, index=True).and_return()
+
+        assert list(pipeline) == ["foo", "bar"]
+
+    def test_op_works_when_shuffle_is_true(self, tmp_path: Path) -> None:
+        path = tmp_path / "file.txt"
+
+        self.write_lines(path, 100)
+
+        pipeline = read_text(
+            path, rtrim=True, index=True, shuffle=True, seed=123
+        ).and_return()
+
+        output1 = list(pipeline)
+
+        assert output1 != [f"line{i}" for i in range(100)]
+
+        assert sorted(output1) == sorted(f"line{i}" for i in range(100))
+
+        pipeline.reset(reset_rng=True)
+
+        assert list(pipeline) == output1
+
+    def test_record_reload_position_works(self, tmp_path: Path) -> None:
+        path = tmp_path / "file.txt"
+
+        self.write_lines(path, 100)
+
+        pipeline = read_text(
+            path, rtrim=True, index=True, shuffle=True, seed=123
+        ).and_return()
+
+        it = iter(pipeline)
+
+        for _ in range(40):
+            next(it)
+
+        expected_output = [next(it) for _ in range(20)]
+
+        state_dict = pipeline.state_dict()
+
+        # Move the pipeline to the next epoch.
+        for _ in pipeline:
+            pass
+
+        pipeline.load_state_dict(state_dict)
+
+        it = iter(pipeline)
+
+        for i in range(20):
+            assert next(it) == expected_output[i]
+
+    def test_op_raises_error_when_shuffle_is_true_and_index_is_not_set(
+        self, tmp_path: Path
+    ) -> None:
+        with pytest.raises(
+            ValueError,
+            match=r"^A line index must be specified when the lines are to be shuffled\.$",
+        ):
+            read_text(tmp_path / "file.txt", shuffle=True)
+
+    def test_op_raises_error_when_encoding_is_not_utf8(self, tmp_path: Path) -> None:
+        with pytest.raises(
+            ValueError,
+            match=r"^The encoding must be UTF-8 when a line index is specified, but is UTF-16 instead\.$",
+        ):
+            read_text(tmp_path / "file.txt", encoding="UTF-16", index=True)
+
+
+class TestReadTextWithParallelScans:
+    @pytest.mark.parametrize("line_ending", ["\n", "\r\n"])
+    def test_op_works(self, tmp_path: Path, line_ending: str) -> None:
+        path = tmp_path / "file.txt"
+
+        lines = [f"line{i}" * (i % 7) for i in range(5000)]
+
+        path.write_bytes("".join(l + line_ending for l in lines).encode())
+
+        # Use a small block size so that the file gets split into many ranges.
+        pipeline = read_text(
+            path, rtrim=True, block_size=1024, num_parallel_scans=4
+        ).and_return()
+
+        for _ in range(2):
+            assert list(pipeline) == lines
+
+            pipeline.reset()
+
+    def test_record_reload_position_works(self, tmp_path: Path) -> None:
+        path = tmp_path / "file.txt"
+
+        path.write_text("".join(f"line{i}\n" for i in range(5000)))
+
+        pipeline = read_text(
+            path, rtrim=True, block_size=1024, num_parallel_scans=4
+        ).and_return()
+
+        it = iter(pipeline)
+
+        for _ in range(3000):
+            next(it)
+
+        state_dict = pipeline.state_dict()
+
+        # The position must be compatible with the sequential reader.
+        pipeline = read_text(path, rtrim=True).and_return()
+
+        pipeline.load_state_dict(state_dict)
+
+        assert next(iter(pipeline)) == "line3000"
+
+    def test_op_raises_error_when_file_has_partial_last_line(
+        self, tmp_path: Path
+    ) -> None:
+        path = tmp_path / "file.txt"
+
+        path.write_text("foo\nbar")
+
+        pipeline = read_text(path, num_parallel_scans=2).and_return()
+
+        it = iter(pipeline)
+
+        assert next(it) == "foo\n"
+
+        with pytest.raises(DataPipelineError):
+            next(it)
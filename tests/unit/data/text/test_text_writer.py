@@ -0,0 +1,71 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import gzip
+from pathlib import Path
+
+import pytest
+
+from fairseq2.data import FileCompression, read_sequence
+from fairseq2.data.text import LineEnding, read_text, write_text
+
+
+class TestWriteTextOp:
+    def test_op_works(self, tmp_path: Path) -> None:
+        path = tmp_path / "file.txt"
+
+        lines = [f"line {i}" for i in range(1000)] + ["", "ünïcode"]
+
+        pipeline = read_sequence(lines).and_return()
+
+        assert write_text(pipeline, path) == len(lines)
+
+        assert path.read_bytes() == "".join(f"{s}\n" for s in lines).encode()
+
+        # Round trip through the reader.
+        assert list(read_text(path).and_return()) == lines
+
+    def test_op_works_when_key_and_line_ending_are_specified(
+        self, tmp_path: Path
+    ) -> None:
+        path = tmp_path / "file.txt"
+
+        pipeline = read_sequence([{"text": "foo", "id": 1}, {"text": "bar"}]).and_return()
+
+        write_text(pipeline, path, key="text", line_ending=LineEnding.CRLF)
+
+        assert path.read_bytes() == b"foo\r\nbar\r\n"
+
+    def test_op_works_when_compression_is_gzip(self, tmp_path: Path) -> None:
+        path = tmp_path / "file.txt.gz"
+
+        pipeline = read_sequence(["foo", "bar"]).and_return()
+
+        write_text(pipeline, path, compression=FileCompression.GZIP)
+
+        assert gzip.decompress(path.read_bytes()) == b"foo\nbar\n"
+
+    def test_op_raises_error_when_example_is_not_string(self, tmp_path: Path) -> None:
+        path = tmp_path / "file.txt"
+
+        pipeline = read_sequence(["foo", 1]).and_return()
+
+        with pytest.raises(
+            ValueError,
+            match=r"^The example 1 in the pipeline must be of type `string`, but is of type `int` instead\.$",
+        ):
+            write_text(pipeline, path)
+
+        assert list(tmp_path.iterdir()) == []
+
+    def test_op_raises_error_when_line_ending_is_infer(self, tmp_path: Path) -> None:
+        pipeline = read_sequence(["foo"]).and_return()
+
+        with pytest.raises(
+            ValueError,
+            match=r"^`line_ending` must be `LF` or `CRLF` when writing text\.$",
+        ):
+            write_text(pipeline, tmp_path / "file.txt", line_ending=LineEnding.INFER)
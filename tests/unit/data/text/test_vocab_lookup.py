@@ -0,0 +1,127 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+from pathlib import Path
+
+import pytest
+import torch
+
+from fairseq2.data import VocabularyInfo, read_sequence
+from fairseq2.data.text import VocabLookup, vocab_info_from_vocab_lookup
+from tests.common import assert_equal, device
+
+
+@pytest.fixture
+def vocab_path(tmp_path: Path) -> Path:
+    path = tmp_path / "dict.txt"
+
+    path.write_text(
+        "<unk>\n<s>\n</s>\n<pad>\nhello\t12\nworld\t7\na\nb\né\n", encoding="utf-8"
+    )
+
+    return path
+
+
+class TestVocabLookup:
+    def test_init_works(self, vocab_path: Path) -> None:
+        lookup = VocabLookup(
+            vocab_path,
+            unk_token="<unk>",
+            bos_token="<s>",
+            eos_token="</s>",
+            pad_token="<pad>",
+        )
+
+        assert lookup.vocabulary_size == 9
+
+        assert lookup.token_to_index("world") == 5
+        assert lookup.token_to_index("foo") is None
+
+        info = vocab_info_from_vocab_lookup(lookup)
+
+        assert info == VocabularyInfo(9, 0, 1, 2, 3)
+
+    def test_call_works(self, vocab_path: Path) -> None:
+        lookup = VocabLookup(vocab_path, unk_token="<unk>", device=device)
+
+        indices = lookup("  hello foo  world ")
+
+        assert_equal(indices, torch.tensor([4, 0, 5], device=device))
+
+    def test_call_works_when_char_level_is_true(self, vocab_path: Path) -> None:
+        lookup = VocabLookup(vocab_path, char_level=True, unk_token="<unk>")
+
+        indices = lookup("abéc")
+
+        assert_equal(indices, torch.tensor([6, 7, 8, 0]))
+
+    def test_call_works_when_input_is_list(self, vocab_path: Path) -> None:
+        lookup = VocabLookup(vocab_path, unk_token="<unk>")
+
+        indices = lookup(["world", "hello world", "a"])
+
+        assert_equal(indices, torch.tensor([5, 0, 6]))
+
+    def test_call_works_when_bos_and_eos_are_added(self, vocab_path: Path) -> None:
+        lookup = VocabLookup(
+            vocab_path, bos_token="<s>", eos_token="</s>", add_bos=True, add_eos=True
+        )
+
+        assert_equal(lookup("hello world"), torch.tensor([1, 4, 5, 2]))
+
+        assert_equal(lookup(""), torch.tensor([1, 2]))
+
+    def test_call_works_in_pipeline(self, vocab_path: Path) -> None:
+        lookup = VocabLookup(vocab_path, sep=",", unk_token="<unk>")
+
+        pipeline = read_sequence(["hello,world", "b,,a"]).map(lookup).and_return()
+
+        output = list(pipeline)
+
+        assert_equal(output[0], torch.tensor([4, 5]))
+        assert_equal(output[1], torch.tensor([7, 6]))
+
+    def test_call_raises_error_when_token_is_unknown_and_unk_token_is_not_specified(
+        self, vocab_path: Path
+    ) -> None:
+        lookup = VocabLookup(vocab_path)
+
+        with pytest.raises(
+            ValueError,
+            match=r"^The token 'foo' is not in the vocabulary and `unk_token` is not specified\.$",
+        ):
+            lookup("hello foo")
+
+    def test_init_raises_error_when_special_token_is_not_in_vocabulary(
+        self, vocab_path: Path
+    ) -> None:
+        with pytest.raises(
+            ValueError,
+            match=r"^`eos_token` must be a token in the vocabulary, but is '<eos>' instead\.$",
+        ):
+            VocabLookup(vocab_path, eos_token="<eos>")
+
+    def test_init_raises_error_when_add_bos_is_set_without_bos_token(
+        self, vocab_path: Path
+    ) -> None:
+        with pytest.raises(
+            ValueError,
+            match=r"^`bos_token` must be specified when `add_bos` is set\.$",
+        ):
+            VocabLookup(vocab_path, add_bos=True)
+
+    def test_init_raises_error_when_vocabulary_has_duplicate_token(
+        self, tmp_path: Path
+    ) -> None:
+        path = tmp_path / "dict.txt"
+
+        path.write_text("a\nb\na\n")
+
+        with pytest.raises(
+            RuntimeError,
+            match=r"has a duplicate token 'a' at line 3\.$",
+        ):
+            VocabLookup(path)
@@ -0,0 +1,163 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+from pathlib import Path
+from typing import Final
+
+import pytest
+import torch
+from fairseq2n import supports_video
+
+from fairseq2.data import read_sequence
+from fairseq2.data.video import VideoDecoder
+from fairseq2.memory import MemoryBlock
+from tests.common import assert_close, assert_equal, device
+
+# A 3 second MJPEG video of 64x48 pixels at 10 fps. The frame `i` is gray with
+# all channels set to `8 * i`.
+TEST_AVI_PATH: Final = Path(__file__).parent.joinpath("test.avi")
+
+# The same video encoded with H.264 with a keyframe every 10 frames, so that
+# most frames can only be decoded from a preceding keyframe. It is generated by:
+#
+#   ffmpeg -f lavfi -i color=black:size=64x48:rate=10:duration=3 \
+#       -vf "format=rgb24,geq=r='8*N':g='8*N':b='8*N'" \
+#       -c:v libx264 -g 10 -bf 0 -sc_threshold 0 -crf 10 -pix_fmt yuv420p \
+#       test_inter.mp4
+TEST_INTER_MP4_PATH: Final = Path(__file__).parent.joinpath("test_inter.mp4")
+
+
+def read_test_video(path: Path = TEST_AVI_PATH) -> MemoryBlock:
+    with path.open("rb") as fb:
+        return MemoryBlock(fb.read())
+
+
+@pytest.mark.skipif(
+    not supports_video(), reason="fairseq2n is not built with video decoding support"
+)
+class TestVideoDecoder:
+    def test_call_works(self) -> None:
+        decoder = VideoDecoder(num_frames=3, device=device)
+
+        output = decoder(read_test_video())
+
+        assert output["frame_rate"] == pytest.approx(10.0)
+
+        assert output["duration"] == pytest.approx(3.0)
+
+        video = output["video"]
+
+        assert video.shape == (3, 48, 64, 3)
+
+        assert video.dtype == torch.uint8
+
+        assert video.device == device
+
+        # The middle of each one second segment.
+        expected_timestamps = torch.tensor([0.5, 1.5, 2.5], dtype=torch.float64)
+
+        assert_close(output["timestamps"], expected_timestamps)
+
+        expected_levels = torch.tensor([40.0, 120.0, 200.0], device=device)
+
+        levels = video.float().mean(dim=(1, 2, 3))
+
+        torch.testing.assert_close(  # type: ignore[attr-defined]
+            levels, expected_levels, atol=2.0, rtol=0
+        )
+
+    def test_call_works_when_random_sampling_is_true(self) -> None:
+        decoder = VideoDecoder(num_frames=6, random_sampling=True)
+
+        output = decoder(read_test_video())
+
+        timestamps = output["timestamps"]
+
+        # Each frame is sampled from its own half second segment.
+        for i, timestamp in enumerate(timestamps.tolist()):
+            assert i * 0.5 <= timestamp < (i + 1) * 0.5
+
+        # `timestamps` holds the presentation timestamps of the decoded frames.
+        expected_levels = (timestamps * 10).round().float() * 8
+
+        levels = output["video"].float().mean(dim=(1, 2, 3))
+
+        torch.testing.assert_close(  # type: ignore[attr-defined]
+            levels, expected_levels, atol=2.0, rtol=0
+        )
+
+    def test_call_is_reproducible_when_seed_is_specified(self) -> None:
+        def decode() -> torch.Tensor:
+            decoder = VideoDecoder(num_frames=4, random_sampling=True, seed=2)
+
+            videos = [read_test_video() for _ in range(4)]
+
+            pipeline = read_sequence(videos).map(decoder).and_return()
+
+            return torch.stack([e["timestamps"] for e in pipeline])
+
+        assert_equal(decode(), decode())
+
+    def test_call_works_when_num_frames_exceeds_frame_count(self) -> None:
+        decoder = VideoDecoder(num_frames=60)
+
+        output = decoder(read_test_video())
+
+        video = output["video"]
+
+        assert video.shape == (60, 48, 64, 3)
+
+        # Two consecutive samples fall on each frame.
+        assert_equal(video[0], video[1])
+
+    def test_call_works_when_video_is_inter_coded(self) -> None:
+        video = read_test_video(TEST_INTER_MP4_PATH)
+
+        # Samples every frame, and therefore decodes the video sequentially.
+        all_frames = VideoDecoder(num_frames=30)(video)["video"]
+
+        # Samples the frames 5, 15, and 25, each in the middle of a GOP, which
+        # requires seeking to the preceding keyframe and decoding up to them.
+        output = VideoDecoder(num_frames=3)(video)
+
+        expected_timestamps = torch.tensor([0.5, 1.5, 2.5], dtype=torch.float64)
+
+        assert_close(output["timestamps"], expected_timestamps)
+
+        assert_equal(output["video"], all_frames[5:30:10])
+
+        expected_levels = torch.tensor([40.0, 120.0, 200.0])
+
+        levels = output["video"].float().mean(dim=(1, 2, 3))
+
+        torch.testing.assert_close(  # type: ignore[attr-defined]
+            levels, expected_levels, atol=3.0, rtol=0
+        )
+
+    def test_call_raises_error_when_input_is_not_memory_block(self) -> None:
+        decoder = VideoDecoder()
+
+        with pytest.raises(
+            ValueError,
+            match=r"^The input data must be of type `memory_block`, but is of type `int` instead\.$",
+        ):
+            decoder(1)  # type: ignore[arg-type]
+
+    def test_call_raises_error_when_input_is_not_video(self) -> None:
+        decoder = VideoDecoder()
+
+        with pytest.raises(
+            ValueError,
+            match=r"^The input video cannot be decoded\. See nested exception for details\.$",
+        ):
+            decoder(MemoryBlock(b"foo" * 100))
+
+    def test_init_raises_error_when_num_frames_is_not_positive(self) -> None:
+        with pytest.raises(
+            ValueError,
+            match=r"^`num_frames` must be greater than zero, but is 0 instead\.$",
+        ):
+            VideoDecoder(num_frames=0)
@@ -6,7 +6,7 @@
 
 import torch
 
-from fairseq2.generation import NGramRepeatBlockProcessor
+from fairseq2.generation import BannedSequenceProcessor, NGramRepeatBlockProcessor
 from tests.common import assert_close, device
 
 
@@ -67,3 +67,47 @@ class TestNGramRepeatBlockProcessor:
 
         assert_close(probs[0], [0.1, 0.1, 0.1, 0.1])
         assert_close(probs[1], [0.1, 0.1, 0.1, 0.1])
+
+    def test_call_works_when_lprob_is_true(self) -> None:
+        seqs = torch.tensor([[1, 2, 1, 2, 1]], device=device)
+
+        probs = torch.zeros((1, 4), device=device)
+
+        processor = NGramRepeatBlockProcessor(ngram_size=2)
+
+        processor(seqs, probs, lprob=True)
+
+        assert_close(probs[0], [0.0, 0.0, -torch.inf, 0.0])
+
+
+class TestBannedSequenceProcessor:
+    def test_call_works(self) -> None:
+        banned_seqs = [
+            torch.tensor([3], device=device),
+            torch.tensor([1, 2], device=device),
+            torch.tensor([0, 1, 2, 0], device=device),
+        ]
+
+        seqs = torch.tensor([[5, 0, 1, 2], [0, 0, 0, 1]], device=device)
+
+        probs = torch.full((2, 4), 0.1, device=device)
+
+        processor = BannedSequenceProcessor(banned_seqs)
+
+        processor(seqs, probs)
+
+        assert_close(probs[0], [0.0, 0.1, 0.1, 0.0])
+        assert_close(probs[1], [0.1, 0.1, 0.0, 0.0])
+
+    def test_call_works_when_seq_len_is_less_than_banned_prefix_len(self) -> None:
+        banned_seqs = [torch.tensor([0, 1, 2], device=device)]
+
+        seqs = torch.tensor([[1]], device=device)
+
+        probs = torch.zeros((1, 4), device=device)
+
+        processor = BannedSequenceProcessor(banned_seqs)
+
+        processor(seqs, probs, lprob=True)
+
+        assert_close(probs[0], [0.0, 0.0, 0.0, 0.0])